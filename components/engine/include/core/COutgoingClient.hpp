@@ -15,6 +15,8 @@
 #include <net/IOutgoingClient.hpp>
 
 #include <game/CMove.hpp>
+#include <game/CRPCBatch.hpp>
+#include <game/CRPCDispatcher.hpp>
 
 namespace Kiaro
 {
@@ -34,8 +36,19 @@ namespace Kiaro
                     //! The COutgoingClient's current move state.
                     Game::CMove mMoveState;
 
+                // Private Members
+                private:
+                    //! Handlers for RPCs called by the server.
+                    Game::CRPCDispatcher mRPCDispatcher;
+
+                    //! RPC calls made against the server that have yet to be sent.
+                    Game::CRPCBatch mRPCBatch;
+
                 // Public Methods
                 public:
+                    //! Parameter-less constructor.
+                    COutgoingClient(void);
+
                     /**
                      *  @brief Pure virtual callback method called by the Net::IOutgoingClient implementation
                      *  when the initial connection & authentication stage was passed.
@@ -59,6 +72,23 @@ namespace Kiaro
                     void handshakeHandler(Net::IIncomingClient* sender, Support::CBitStream& in);
                     void scopeHandler(Net::IIncomingClient* sender, Support::CBitStream& in);
                     void simCommitHandler(Net::IIncomingClient* sender, Support::CBitStream& in);
+                    void executeRPCHandler(Net::IIncomingClient* sender, Support::CBitStream& in);
+
+                    /**
+                     *  @brief Calls the given RPC on the server. The call is sent with the next update pulse.
+                     *  @param arguments The arguments of the call.
+                     */
+                    template <typename rpcType, typename... argumentTypes>
+                    void callRPC(const argumentTypes&... arguments)
+                    {
+                        mRPCBatch.call<rpcType>(arguments...);
+                    }
+
+                    //! Returns the dispatcher that RPCs called by the server are handled by.
+                    Game::CRPCDispatcher& getRPCDispatcher(void);
+
+                    //! Sends every pending RPC call to the server.
+                    virtual void onUpdate(void);
 
                 // Protected Methods
                 protected:
@@ -93,6 +93,27 @@ namespace Kiaro
                         ++mMessageTypeCounter;
                     }
 
+                    /**
+                     *  @brief Makes an already registered message type valid at an additional stage.
+                     *  @param serverHandler Server side programming handler. If nullptr, then there is no serverside handler at this stage.
+                     *  @param clientHandler Client side programming handler. If nullptr, then there is no clientside handler at this stage.
+                     *  @param stage The additional stage at which this message type and handlers are valid at.
+                     */
+                    template <typename messageClass>
+                    void registerMessageStage(MessageHandlerSet::MemberDelegateFuncPtr<Game::SGameServer> serverHandler, MessageHandlerSet::MemberDelegateFuncPtr<Core::COutgoingClient> clientHandler, const Net::STAGE_NAME stage)
+                    {
+                        const Common::S32 messageID = Net::IMessage::SharedStatics<messageClass>::sMessageID;
+                        assert(messageID != -1);
+
+                        MessageConstructorPointer messageConstructor = mMessageMap[messageID];
+
+                        if (serverHandler)
+                            mServerStageMap[stage][messageID] = std::make_pair(messageConstructor, serverHandler);
+
+                        if (clientHandler)
+                            mClientStageMap[stage][messageID] = std::make_pair(messageConstructor, clientHandler);
+                    }
+
                     /**
                      *  @brief Registers a networked entity type to be instantiated indirectly across a network.
                      */
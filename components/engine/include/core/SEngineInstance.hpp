@@ -19,6 +19,7 @@
 #include <support/common.hpp>
 #include <support/ISingleton.hpp>
 #include <support/SSynchronousScheduler.hpp>
+#include <support/CFixedTimestep.hpp>
 
 #include <game/SGameServer.hpp>
 #include <core/COutgoingClient.hpp>
@@ -27,12 +28,15 @@
 
 #include <video/CGraphicsWindow.hpp>
 #include <support/CManagementConsole.hpp>
+#include <support/SMetricsRegistry.hpp>
 
 namespace Kiaro
 {
     namespace Net
     {
         class IServer;
+        class CMetricsServer;
+        class CManagementServer;
     }
 
     namespace Engine
@@ -96,9 +100,39 @@ namespace Kiaro
                     //! The management console associated with the engine. If not enabled, this this a nullptr.
                     Support::CManagementConsole* mManagementConsole;
 
+                    //! The listener serving mManagementConsole to remote sessions. If not enabled, this is a nullptr.
+                    Net::CManagementServer* mManagementServer;
+
+                    //! The real time in milliseconds at which mManagementServer is next serviced.
+                    Common::U64 mNextManagementUpdateMS;
+
                     //! All currently active graphics windows.
                     Support::Vector<Video::CGraphicsWindow*> mActiveWindows;
 
+                    //! The fixed timestep the game server, physics and networking are simulated at.
+                    Support::CFixedTimestep mSimulationTimestep;
+
+                    //! The time of the simulation clock in microseconds that mSimulationTimestep was last advanced to.
+                    Common::U64 mSimulatedTimeMicroseconds;
+
+                    //! Set from the signal handler when a profiler capture was requested, and picked up by the main loop.
+                    Support::Atomic<bool> mProfileCaptureRequested;
+
+                    //! The metrics endpoint associated with the engine. If not enabled, this is a nullptr.
+                    Net::CMetricsServer* mMetricsServer;
+
+                    //! The real time in milliseconds at which mMetricsServer is next serviced.
+                    Common::U64 mNextMetricsUpdateMS;
+
+                    //! The ID of the collector refreshing the engine's gauges before every scrape.
+                    Common::U32 mMetricsCollector;
+
+                    //! The distribution of server tick times. Only recorded while metrics are enabled, otherwise this is a nullptr.
+                    Support::CMetricHistogram* mTickTimeMetric;
+
+                    //! The number of simulation steps dropped to catch up. Only recorded while metrics are enabled, otherwise this is a nullptr.
+                    Support::CMetricCounter* mDroppedStepsMetric;
+
                 // Public Methods
                 public:
                     /**
@@ -153,6 +187,19 @@ namespace Kiaro
 
                     void handleThrottleRequest(void);
 
+                    /**
+                     *  @brief Requests a profiler capture with the configured frame count and path. Only sets a flag, so this
+                     *  is safe to call from a signal handler.
+                     */
+                    void requestProfileCapture(void);
+
+                    /**
+                     *  @brief Begins a profiler capture, logging where it will be written.
+                     *  @param frameCount The number of frames to capture.
+                     *  @param path The file to write the capture to.
+                     */
+                    void beginProfileCapture(const Common::U32 frameCount, const Support::String& path);
+
                     /**
                      *  @brief Returns whether or not the engine is running as a dedicated server at the
                      *  time of this call.
@@ -170,9 +217,25 @@ namespace Kiaro
 
                     void addWindow(Video::CGraphicsWindow* window);
 
+                    //! Returns the number of the last simulation tick, which the server, physics and networking share.
+                    Common::U64 getSimulationTick(void) const;
+
+                    /**
+                     *  @brief Returns how far the current frame is between the last simulation tick and the next, for
+                     *  rendering to interpolate simulated state with.
+                     *  @return A value in [0, 1).
+                     */
+                    Common::F32 getInterpolationAlpha(void) const;
+
                 // Private Methods
                 private:
-                    void networkUpdate(void);
+                    /**
+                     *  @brief Services the game server, the active client and the management and metrics endpoints. This runs
+                     *  once per frame on the real clock, outside of the fixed steps, so that pausing or scaling the simulation
+                     *  clock neither times out connections nor freezes the console used to resume it.
+                     *  @param deltaTimeSeconds The real time since the last frame in seconds.
+                     */
+                    void networkUpdate(const Common::F32 deltaTimeSeconds);
 
                     /**
                      *  @brief A helper method used to provide the actual main loop of the
@@ -180,12 +243,47 @@ namespace Kiaro
                      */
                     void runGameLoop(void);
 
+                    /**
+                     *  @brief Advances the simulation timestep to the simulation clock and simulates every step that became
+                     *  due, up to the catch up limit.
+                     */
+                    void runSimulationSteps(void);
+
                     /**
                      *  @brief Internal method called by the synchronous scheduler once every ~4sec if perfstat
                      *  is enabled.
                      */
                     void printPerfStat(void);
 
+                    //! Writes every spike the profiler kept to the console, along with the breakdown of its frame.
+                    void printSpikes(void);
+
+                    /**
+                     *  @brief Writes the network statistics of every active connection to the console.
+                     *  @param detailed Whether or not to include the per message type breakdown.
+                     */
+                    void printNetworkStats(const bool detailed);
+
+                    //! Applies the NetSimulator settings to every active connection and writes them to the console.
+                    void applyNetworkSimulatorSettings(void);
+
+                    /**
+                     *  @brief Applies the settings that can change while the engine runs: the catch up limit and the profiler
+                     *  distribution window and spike budget. NetSimulator settings are applied by applyNetworkSimulatorSettings
+                     *  and everything else is only read at startup.
+                     */
+                    void applySettings(void);
+
+                    //! Writes the simulation tick, connection counts and scheduler state to the console.
+                    void printStatus(void);
+
+                    /**
+                     *  @brief Writes the heap usage of every allocation tag and the allocation rate of the busiest profiler
+                     *  zones to the console. Only available in builds with allocation tracking.
+                     *  @param zoneCount The number of zones to list.
+                     */
+                    void printAllocationStats(const size_t zoneCount);
+
                     /**
                      *  @brief A subroutine to initialize the GUI system.
                      *  @return The status code of the GUI initialization.
@@ -225,6 +323,17 @@ namespace Kiaro
 
                     Common::U32 initializeManagementConsole(void);
 
+                    /**
+                     *  @brief A subroutine that is called to initialize the metrics endpoint, if enabled.
+                     *  @return The status code of the metrics endpoint initialization.
+                     *  @retval 0 No error.
+                     *  @retval !=0 The endpoint could not listen on the configured address.
+                     */
+                    Common::U32 initializeMetrics(void);
+
+                    //! Refreshes the gauges the engine exports. Called by the metrics registry before every scrape.
+                    void collectMetrics(void);
+
                     /**
                      *  @brief A subroutine that is called to initialize the sound code.
                      *  @return The status code of the sound system initialization.
@@ -21,8 +21,6 @@
 //! The maximum length of strings to be considered valid when read through CBitStream.
 #define MAXIMUM_ARBITRARY_STRING_LENGTH 256
 
-//! How long each worker thread should sleep per iteration.
-#define WORKER_SLEEP_TIME_MS 64
 #define WORKER_THREAD_POOL_SIZE 6
 
 #ifndef CMAKE_CONFIG
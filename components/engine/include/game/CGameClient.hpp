@@ -16,6 +16,8 @@
 #include <net/IServer.hpp>
 #include <net/IIncomingClient.hpp>
 
+#include <game/CRPCBatch.hpp>
+
 namespace Kiaro
 {
     namespace Engine
@@ -35,14 +37,30 @@ namespace Kiaro
                 protected:
                     IControllable* mControlObject;
 
+                    //! RPC calls made against this client that have yet to be sent.
+                    CRPCBatch mRPCBatch;
+
                 // Public Methods
                 public:
-                    CGameClient(Net::RemoteHostContext client);
+                    CGameClient(Net::RemoteHostContext client, Net::IServer* server);
 
                     void setControlObject(IControllable* object);
                     IControllable* getControlObject(void) const NOTHROW;
 
                     void disconnect(const Support::String& reason);
+
+                    /**
+                     *  @brief Calls the given RPC on this client. The call is sent with the server's next tick.
+                     *  @param arguments The arguments of the call.
+                     */
+                    template <typename rpcType, typename... argumentTypes>
+                    void callRPC(const argumentTypes&... arguments)
+                    {
+                        mRPCBatch.call<rpcType>(arguments...);
+                    }
+
+                    //! Queues every pending RPC call for sending.
+                    void flushRPCs(void);
             };
         } // End NameSpace Game
     }
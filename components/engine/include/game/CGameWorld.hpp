@@ -14,7 +14,9 @@
 
 #include <support/ISingleton.hpp>
 #include <support/CBitStream.hpp>
+#include <support/SAllocationTracker.hpp>
 #include <support/UnorderedSet.hpp>
+#include <support/Vector.hpp>
 #include <support/String.hpp>
 
 #include <support/common.hpp>
@@ -42,6 +44,12 @@ namespace Kiaro
                     //! A set of all entities registered to the game world for updates.
                     Support::UnorderedSet<IEntity*> mEntities;
 
+                    //! The entities of mEntities stored contiguously so that updates can be split across threads.
+                    Support::Vector<IEntity*> mEntityList;
+
+                    //! Whether or not mEntityList must be rebuilt because entities were added or removed.
+                    bool mEntityListDirty;
+
                     //! Pointer to the gamemode programming that is currently running.
                     IGameMode* mGameMode;
 
@@ -94,6 +102,8 @@ namespace Kiaro
                     /**
                      *  @brief Pushes an empty to the CGameWorld, triggering all entities to be updated.
                      *  @param deltaTimeSeconds The delta time in seconds that has passed since the last call.
+                     *  @note Entities are updated in parallel on the job system of the SThreadSystem, so IEntity::update
+                     *  implementations must not touch other entities or shared state without synchronizing.
                      */
                     void update(const Common::F32 deltaTimeSeconds);
 
@@ -160,6 +170,7 @@ namespace Kiaro
                         className* result = nullptr;
 
                         #ifndef ENGINE_ENTITY_ARENA_ALLOCATIONS
+                            ALLOCATION_SCOPE(Entities);
                             result = new className(params...);
 
                             #ifdef ENGINE_ENTITY_TRACKER
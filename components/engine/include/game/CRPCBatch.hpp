@@ -0,0 +1,87 @@
+/**
+ *  @file CRPCBatch.hpp
+ *  @brief Include file declaring the CRPCBatch class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_GAME_CRPCBATCH_HPP_
+#define _INCLUDE_GAME_CRPCBATCH_HPP_
+
+#include <support/common.hpp>
+
+#include <game/RPC.hpp>
+#include <game/messages/ExecuteRPC.hpp>
+
+namespace Kiaro
+{
+    namespace Engine
+    {
+        namespace Game
+        {
+            /**
+             *  @brief The CRPCBatch collects every RPC call made against a single connection so that they can be sent as one message
+             *  per delivery type once per tick rather than as one message per call.
+             */
+            class CRPCBatch
+            {
+                // Private Members
+                private:
+                    //! The pending calls per RPC_DELIVERY.
+                    Messages::ExecuteRPC mBatches[RPC_DELIVERY_COUNT];
+
+                    //! The sequence number to give the next RPC_ORDERED batch.
+                    Common::U16 mNextOrderedSequence;
+
+                // Public Methods
+                public:
+                    //! Parameter-less constructor.
+                    CRPCBatch(void);
+
+                    /**
+                     *  @brief Queues a call to the given RPC type. It will be sent with the next flush.
+                     *  @param arguments The arguments of the call.
+                     */
+                    template <typename rpcType, typename... argumentTypes>
+                    void call(const argumentTypes&... arguments)
+                    {
+                        mBatches[rpcType::sDelivery].template addCall<rpcType>(arguments...);
+                    }
+
+                    /**
+                     *  @brief Sends every queued call over the given connection.
+                     *  @param connection The connection to send over. This may be any type providing send(IMessage*, bool reliable).
+                     */
+                    template <typename connectionType>
+                    void flush(connectionType& connection)
+                    {
+                        for (Common::U32 iteration = 0; iteration < RPC_DELIVERY_COUNT; ++iteration)
+                        {
+                            Messages::ExecuteRPC& batch = mBatches[iteration];
+
+                            if (batch.getCallCount() == 0)
+                            {
+                                continue;
+                            }
+
+                            if (iteration == RPC_ORDERED)
+                            {
+                                batch.mSequence = mNextOrderedSequence++;
+                            }
+
+                            connection.send(&batch, iteration == RPC_RELIABLE);
+                            batch.clear();
+                        }
+                    }
+
+                    //! Returns the number of calls waiting for the next flush.
+                    Common::U32 getPendingCallCount(void) const;
+            };
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
+#endif // _INCLUDE_GAME_CRPCBATCH_HPP_
@@ -0,0 +1,91 @@
+/**
+ *  @file CRPCDispatcher.hpp
+ *  @brief Include file declaring the CRPCDispatcher class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_GAME_CRPCDISPATCHER_HPP_
+#define _INCLUDE_GAME_CRPCDISPATCHER_HPP_
+
+#include <support/common.hpp>
+#include <support/UnorderedMap.hpp>
+
+#include <game/RPC.hpp>
+#include <game/messages/ExecuteRPC.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        class IIncomingClient;
+    } // End NameSpace Net
+
+    namespace Engine
+    {
+        namespace Game
+        {
+            /**
+             *  @brief The CRPCDispatcher processes received RPC batches by handing each call to the handler bound to its RPC ID.
+             *  @details RPC_ORDERED batches carry a sequence number per sender; a batch older than the newest one already processed
+             *  from the same sender is discarded in its entirety.
+             */
+            class CRPCDispatcher
+            {
+                // Private Members
+                private:
+                    //! A type erased handler that unpacks the arguments of a call and invokes the bound handler with them.
+                    typedef std::function<void(Net::IIncomingClient*, Support::CBitStream&)> Invoker;
+
+                    //! All bound handlers by RPC ID.
+                    Support::UnorderedMap<Common::U16, Invoker> mInvokers;
+
+                    //! The sequence number of the newest RPC_ORDERED batch processed per sender.
+                    Support::UnorderedMap<Net::IIncomingClient*, Common::U16> mOrderedSequences;
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Binds a handler to the given RPC type, replacing any handler already bound to it.
+                     *  @param handler The handler to call for every received call of the RPC type.
+                     */
+                    template <typename rpcType>
+                    void bind(const typename rpcType::Handler& handler)
+                    {
+                        mInvokers[rpcType::sID] = [handler](Net::IIncomingClient* sender, Support::CBitStream& in)
+                        {
+                            rpcType::unpackAndInvoke(handler, sender, in);
+                        };
+                    }
+
+                    /**
+                     *  @brief Removes the handler bound to the given RPC type.
+                     */
+                    template <typename rpcType>
+                    void unbind(void)
+                    {
+                        mInvokers.erase(rpcType::sID);
+                    }
+
+                    /**
+                     *  @brief Processes every call in the given batch.
+                     *  @param sender The client the batch was received from. This is nullptr when the batch came from a server.
+                     *  @param batch The received batch.
+                     *  @throw std::out_of_range Thrown when a call refers to an RPC ID that has no handler bound.
+                     */
+                    void dispatch(Net::IIncomingClient* sender, const Messages::ExecuteRPC& batch);
+
+                    /**
+                     *  @brief Forgets all state kept for the given sender. Call this when the sender disconnects.
+                     *  @param sender The sender to forget.
+                     */
+                    void forget(Net::IIncomingClient* sender);
+            };
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
+#endif // _INCLUDE_GAME_CRPCDISPATCHER_HPP_
@@ -26,6 +26,7 @@
 #include <support/UnorderedSet.hpp>
 #include <support/String.hpp>
 #include <support/SSettingsRegistry.hpp>
+#include <support/SAllocationTracker.hpp>
 
 #include <core/config.hpp>
 
@@ -119,6 +120,7 @@ namespace Kiaro
                     template <typename entityName>
                     static IEntity* constructNetworkEntity(Support::CBitStream& payload)
                     {
+                        ALLOCATION_SCOPE(Entities);
                         IEntity* result = new entityName(payload);
                         return result;
                     }
@@ -0,0 +1,146 @@
+/**
+ *  @file RPC.hpp
+ *  @brief Include file declaring the RPC template used to describe remote procedure calls.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_GAME_RPC_HPP_
+#define _INCLUDE_GAME_RPC_HPP_
+
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include <support/common.hpp>
+#include <support/String.hpp>
+#include <support/CBitStream.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        class IIncomingClient;
+    } // End NameSpace Net
+
+    namespace Engine
+    {
+        namespace Game
+        {
+            //! The delivery guarantees an RPC may be sent with.
+            enum RPC_DELIVERY
+            {
+                //! The call may be lost and may arrive out of order relative to other unreliable calls.
+                RPC_UNRELIABLE = 0,
+                //! The call may be lost but is never processed after a call that was sent later.
+                RPC_ORDERED = 1,
+                //! The call always arrives, in the order it was sent.
+                RPC_RELIABLE = 2,
+
+                //! The number of delivery types.
+                RPC_DELIVERY_COUNT = 3,
+            };
+
+            /**
+             *  @brief Packs a single RPC argument into the given stream.
+             *  @param out The stream to pack into.
+             *  @param argument The argument to pack.
+             */
+            template <typename argumentType>
+            static inline void packRPCArgument(Support::CBitStream& out, const argumentType& argument)
+            {
+                static_assert(std::is_arithmetic<argumentType>::value || std::is_enum<argumentType>::value, "RPC arguments must be primitives or strings!");
+                out << argument;
+            }
+
+            static inline void packRPCArgument(Support::CBitStream& out, const Support::String& argument)
+            {
+                out.writeString(argument);
+            }
+
+            /**
+             *  @brief Unpacks a single RPC argument from the given stream.
+             *  @param in The stream to unpack from.
+             *  @param argument The argument to unpack into.
+             */
+            template <typename argumentType>
+            static inline void unpackRPCArgument(Support::CBitStream& in, argumentType& argument)
+            {
+                static_assert(std::is_arithmetic<argumentType>::value || std::is_enum<argumentType>::value, "RPC arguments must be primitives or strings!");
+                in >> argument;
+            }
+
+            static inline void unpackRPCArgument(Support::CBitStream& in, Support::String& argument)
+            {
+                argument = in.popString();
+            }
+
+            /**
+             *  @brief Describes a remote procedure call by its compile time ID, its delivery and the types of its arguments.
+             *  @details RPC types are declared once in game/rpcs.hpp. Calls are packed by an CRPCBatch and processed on the
+             *  receiving end by an CRPCDispatcher, which looks handlers up by ID instead of by name.
+             *  @param identifier The ID of the RPC. This must be unique among all declared RPC types.
+             *  @param delivery The delivery guarantee calls to this RPC are sent with.
+             *  @param parameterTypes The types of the arguments. These must be primitives or Support::String.
+             */
+            template <Common::U16 identifier, RPC_DELIVERY delivery, typename... parameterTypes>
+            class RPC
+            {
+                // Public Members
+                public:
+                    //! The ID of this RPC.
+                    static constexpr Common::U16 sID = identifier;
+
+                    //! The delivery guarantee calls to this RPC are sent with.
+                    static constexpr RPC_DELIVERY sDelivery = delivery;
+
+                    //! The type of a handler for this RPC. The sender is nullptr when the call came from a server.
+                    typedef std::function<void(Net::IIncomingClient*, const parameterTypes&...)> Handler;
+
+                // Private Methods
+                private:
+                    template <size_t... indices>
+                    static void invoke(const Handler& handler, Net::IIncomingClient* sender, Support::CBitStream& in, std::index_sequence<indices...>)
+                    {
+                        std::tuple<parameterTypes...> arguments;
+
+                        // Braced initializers guarantee left to right evaluation
+                        const bool unpacked[] = { true, (unpackRPCArgument(in, std::get<indices>(arguments)), true)... };
+                        (void)unpacked;
+
+                        handler(sender, std::get<indices>(arguments)...);
+                    }
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Packs the arguments of a call to this RPC.
+                     *  @param out The stream to pack into.
+                     *  @param arguments The arguments of the call.
+                     */
+                    static void packArguments(Support::CBitStream& out, const parameterTypes&... arguments)
+                    {
+                        const bool packed[] = { true, (packRPCArgument(out, arguments), true)... };
+                        (void)packed;
+                    }
+
+                    /**
+                     *  @brief Unpacks the arguments of a call to this RPC and calls the given handler with them.
+                     *  @param handler The handler to call.
+                     *  @param sender The client the call was received from.
+                     *  @param in The stream to unpack from.
+                     */
+                    static void unpackAndInvoke(const Handler& handler, Net::IIncomingClient* sender, Support::CBitStream& in)
+                    {
+                        invoke(handler, sender, in, std::index_sequence_for<parameterTypes...>());
+                    }
+            };
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
+#endif // _INCLUDE_GAME_RPC_HPP_
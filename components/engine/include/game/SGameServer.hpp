@@ -20,9 +20,14 @@
 #include <support/ISingleton.hpp>
 #include <support/SSynchronousScheduler.hpp>
 #include <support/UnorderedMap.hpp>
+#include <support/UnorderedSet.hpp>
+#include <support/Deque.hpp>
 
 #include <net/stages.hpp>
 #include <net/IMessage.hpp>
+#include <net/CInboundMessageRing.hpp>
+
+#include <game/CRPCDispatcher.hpp>
 
 namespace Kiaro
 {
@@ -45,11 +50,54 @@ namespace Kiaro
                     //! The physical simulation in use.
                     Phys::CSimulation* mSimulation;
 
-                    //! Scheduled event created for use with the SSynchronousScheduler.
-                    Support::CScheduledEvent* mUpdatePulse;
+                    //! The number of the simulation tick currently or last simulated.
+                    Common::U64 mTickNumber;
+
+                    //! Received payloads we still haven't processed for any given client.
+                    Support::UnorderedMap<Net::IIncomingClient*, Net::CInboundMessageRing*> mInboundRings;
+
+                    //! Clients with pending inbound messages, in the order they will next be serviced.
+                    Support::Deque<Net::IIncomingClient*> mReadyClients;
+
+                    //! Clients we have asked to disconnect whose payloads are now ignored.
+                    Support::UnorderedSet<Net::IIncomingClient*> mDroppedClients;
+
+                    //! The maximum number of messages processed per client on a single tick. Zero means no limit.
+                    const Common::U32 mMessagesPerTick;
+
+                    //! The maximum number of received packets buffered per client. Zero means no limit.
+                    const Common::U32 mMaxQueuedStreams;
+
+                    //! The maximum number of received bytes buffered per client.
+                    const Common::U32 mMaxQueuedBytes;
+
+                    //! Handlers for RPCs called by clients.
+                    CRPCDispatcher mRPCDispatcher;
+
+                // Private Methods
+                private:
+                    /**
+                     *  @brief Processes queued inbound messages for all clients. Clients are serviced one message at a time in
+                     *  round-robin order until each has either drained its ring or used up its mMessagesPerTick budget, so a
+                     *  single busy client cannot starve the others. A message that fails to process is logged and the rest of its
+                     *  payload dropped, and the client keeps being serviced.
+                     */
+                    void processInboundMessages(void);
+
+                    /**
+                     *  @brief Processes the next message in the given client's ring.
+                     *  @param sender The client that sent the message.
+                     *  @param ring The inbound ring of the client.
+                     *  @throw std::out_of_range Thrown when the message type is unknown or not allowed in the client's stage.
+                     *  @throw std::underflow_error Thrown when the message is truncated.
+                     */
+                    void processMessage(Net::IIncomingClient* sender, Net::CInboundMessageRing* ring);
 
-                    //! Any queued streams we still haven't processed for any given client.
-                    Support::UnorderedMap<Net::IIncomingClient*, Support::Queue<Support::CBitStream*>> mQueuedStreams;
+                    /**
+                     *  @brief Drops all queued inbound data for the given client.
+                     *  @param client The client to drop inbound data for.
+                     */
+                    void releaseInboundRing(Net::IIncomingClient* client);
 
                 // Public Methods
                 public:
@@ -65,7 +113,25 @@ namespace Kiaro
                      */
                     void setGamemode(IGameMode* game);
 
-                    virtual void update(void);
+                    /**
+                     *  @brief Simulates a single fixed step of the game: processes inbound messages, steps the physical
+                     *  simulation and dispatches everything queued for the clients.
+                     *  @param tickNumber The number of the tick being simulated, shared with the physics and networking.
+                     *  @param stepSeconds The length of the step in seconds.
+                     */
+                    virtual void update(const Common::U64 tickNumber, const Common::F32 stepSeconds);
+
+                    /**
+                     *  @brief Services the network, queueing whatever was received for the next step. This is called once per
+                     *  frame on the real clock rather than per step, so clients neither time out nor see their bandwidth
+                     *  distorted while the simulation clock is paused or scaled. While paused, inbound messages are processed
+                     *  here as well so that client queues do not overflow.
+                     *  @param deltaTimeSeconds The real time since the last call in seconds.
+                     */
+                    void updateNetwork(const Common::F32 deltaTimeSeconds);
+
+                    //! Returns the number of the simulation tick currently or last simulated.
+                    Common::U64 getTickNumber(void) const;
 
                     /**
                      *  @brief Called when the client passes the initial authentication stages.
@@ -105,6 +171,10 @@ namespace Kiaro
                     void initialScope(Net::IIncomingClient* client);
 
                     void handshakeHandler(Net::IIncomingClient* sender, Support::CBitStream& in);
+                    void executeRPCHandler(Net::IIncomingClient* sender, Support::CBitStream& in);
+
+                    //! Returns the dispatcher that RPCs called by clients are handled by.
+                    CRPCDispatcher& getRPCDispatcher(void);
 
                 // Protected Methods
                 protected:
@@ -1,6 +1,6 @@
 /**
  *  @file ExecuteRPC.hpp
- *  @brief The common include file for the Kiaro application defining things such as error values.
+ *  @brief Include file declaring the ExecuteRPC message, which carries a batch of remote procedure calls.
  *
  *  This software is licensed under the Draconic Free License version 1. Please refer
  *  to LICENSE.txt for more information.
@@ -15,6 +15,9 @@
 #include <stdexcept>
 
 #include <net/IMessage.hpp>
+#include <net/config.hpp>
+
+#include <game/RPC.hpp>
 
 namespace Kiaro
 {
@@ -23,46 +26,127 @@ namespace Kiaro
         class IIncomingClient;
     }
 
-    namespace Game
+    namespace Engine
     {
-        namespace Messages
+        namespace Game
         {
-            class ExecuteRPC : public Net::IMessage
+            namespace Messages
             {
-                public:
-                    Support::String mName;
-
-                    ExecuteRPC(Support::CBitStream* in = nullptr, Net::IIncomingClient* sender = nullptr) : IMessage(in, sender)
-                    {
-                    }
-
-                    virtual void packEverything(Support::CBitStream& out) const
-                    {
-                        IMessage::packBaseData<ExecuteRPC>(out);
-                        out << mName;
-                    }
-
-                    void unpack(Support::CBitStream& in)
-                    {
-                        if (in.getPointer() <= getMinimumPacketPayloadLength())
+                /**
+                 *  @brief The ExecuteRPC message carries every RPC call of a single delivery type made against a connection during a tick.
+                 *  @details Each call is stored as its RPC ID, the length of its arguments and then the packed arguments themselves so that
+                 *  the receiving end can process each call without knowing about the others.
+                 */
+                class ExecuteRPC : public Net::IMessage
+                {
+                    // Public Members
+                    public:
+                        //! The RPC_DELIVERY of every call in this batch.
+                        Common::U8 mDelivery;
+
+                        //! The sequence number of this batch, used to discard stale RPC_ORDERED batches.
+                        Common::U16 mSequence;
+
+                    // Private Members
+                    private:
+                        //! The number of calls in this batch.
+                        Common::U16 mCallCount;
+
+                        //! The packed calls.
+                        Support::CBitStream mCalls;
+
+                        //! Scratch space used to pack the arguments of a call before its length is known.
+                        Support::CBitStream mArguments;
+
+                    // Public Methods
+                    public:
+                        ExecuteRPC(Support::CBitStream* in = nullptr, Net::IIncomingClient* sender = nullptr) : IMessage(in, sender), mDelivery(RPC_RELIABLE),
+                        mSequence(0), mCallCount(0), mCalls(NETSTREAM_DEFAULT_SIZE, nullptr, 0, NETSTREAM_RESIZE_FACTOR),
+                        mArguments(NETSTREAM_DEFAULT_SIZE, nullptr, 0, NETSTREAM_RESIZE_FACTOR)
+                        {
+                        }
+
+                        /**
+                         *  @brief Appends a call to the given RPC to this batch.
+                         *  @param arguments The arguments of the call.
+                         */
+                        template <typename rpcType, typename... argumentTypes>
+                        void addCall(const argumentTypes&... arguments)
+                        {
+                            mArguments.setPointer(0);
+                            rpcType::packArguments(mArguments, arguments...);
+
+                            const Common::U32 argumentsLength = mArguments.getPointer();
+                            mCalls << static_cast<Common::U16>(rpcType::sID) << argumentsLength;
+                            mCalls.writeBytes(mArguments.getBlock(), argumentsLength);
+
+                            ++mCallCount;
+                        }
+
+                        //! Removes every call from this batch.
+                        void clear(void)
+                        {
+                            mCalls.setPointer(0);
+                            mCallCount = 0;
+                        }
+
+                        Common::U16 getCallCount(void) const
+                        {
+                            return mCallCount;
+                        }
+
+                        //! Returns a pointer to the packed calls.
+                        const void* getCalls(void) const
+                        {
+                            return mCalls.getBlock();
+                        }
+
+                        //! Returns the length of the packed calls in bytes.
+                        size_t getCallsLength(void) const
+                        {
+                            return mCalls.getPointer();
+                        }
+
+                        virtual void packEverything(Support::CBitStream& out) const
                         {
-                            throw std::underflow_error("Unable to unpack ExecuteRPC packet; too small of a payload!");
+                            const Common::U32 callsLength = mCalls.getPointer();
+
+                            IMessage::packBaseData<ExecuteRPC>(out);
+                            out << mDelivery << mSequence << mCallCount << callsLength;
+                            out.writeBytes(mCalls.getBlock(), callsLength);
                         }
 
-                        in >> mName;
-                    }
-
-                    virtual size_t getMinimumPacketPayloadLength(void) const
-                    {
-                        return sizeof(Common::U32);
-                    }
-
-                    virtual size_t getRequiredMemory(void) const
-                    {
-                        return mName.length();
-                    }
-            };
-        } // End NameSpace Packets
-    } // End NameSpace Game
+                        void unpack(Support::CBitStream& in)
+                        {
+                            if (in.getSize() - in.getPointer() < getMinimumPacketPayloadLength())
+                            {
+                                throw std::underflow_error("Unable to unpack ExecuteRPC packet; too small of a payload!");
+                            }
+
+                            Common::U32 callsLength = 0;
+                            in >> mDelivery >> mSequence >> mCallCount >> callsLength;
+
+                            if (mDelivery >= RPC_DELIVERY_COUNT)
+                            {
+                                throw std::out_of_range("Unable to unpack ExecuteRPC packet; unknown delivery type!");
+                            }
+
+                            mCalls.setPointer(0);
+                            mCalls.writeBytes(in.popBytes(callsLength), callsLength);
+                        }
+
+                        virtual size_t getMinimumPacketPayloadLength(void) const
+                        {
+                            return sizeof(Common::U8) + sizeof(Common::U16) + sizeof(Common::U16) + sizeof(Common::U32);
+                        }
+
+                        virtual size_t getRequiredMemory(void) const
+                        {
+                            return getMinimumPacketPayloadLength() + mCalls.getPointer();
+                        }
+                };
+            } // End NameSpace Messages
+        } // End NameSpace Game
+    } // End NameSpace Engine
 } // End NameSpace Kiaro
-#endif // _INCLUDE_KIARO_GAME_MESSAGES_DISCONNECT_HPP_
+#endif // _INCLUDE_KIARO_GAME_MESSAGES_EXECUTERPC_HPP_
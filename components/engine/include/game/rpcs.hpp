@@ -0,0 +1,39 @@
+/**
+ *  @file rpcs.hpp
+ *  @brief Include file declaring all of the RPC types known to the engine.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_GAME_RPCS_HPP_
+#define _INCLUDE_GAME_RPCS_HPP_
+
+#include <game/RPC.hpp>
+
+namespace Kiaro
+{
+    namespace Engine
+    {
+        namespace Game
+        {
+            //! Namespace containing all the RPC types that can be called from server to client and vice versa.
+            namespace RPCs
+            {
+                //! The IDs of all RPC types. New RPC types must be appended so that existing IDs remain stable.
+                enum RPC_ID
+                {
+                    //! Server to client: A message to display to the player.
+                    RPC_SERVERMESSAGE = 0,
+                };
+
+                //! Displays a message to the player.
+                typedef RPC<RPC_SERVERMESSAGE, RPC_RELIABLE, Support::String> ServerMessage;
+            } // End NameSpace RPCs
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
+#endif // _INCLUDE_GAME_RPCS_HPP_
@@ -12,6 +12,7 @@
 #include <core/COutgoingClient.hpp>
 
 #include <game/messages/messages.hpp>
+#include <game/rpcs.hpp>
 
 #include <support/Console.hpp>
 
@@ -26,6 +27,14 @@ namespace Kiaro
     {
         namespace Core
         {
+            COutgoingClient::COutgoingClient(void)
+            {
+                mRPCDispatcher.bind<Game::RPCs::ServerMessage>([](Net::IIncomingClient* sender, const Support::String& message)
+                {
+                    CONSOLE_INFOF("Server: %s", message.data());
+                });
+            }
+
             void COutgoingClient::onConnected(void)
             {
                 CONSOLE_INFO("Established connection to remote host.");
@@ -70,6 +79,24 @@ namespace Kiaro
                 receivedCommit.unpack(in);
             }
 
+            void COutgoingClient::executeRPCHandler(Net::IIncomingClient* sender, Support::CBitStream& in)
+            {
+                Game::Messages::ExecuteRPC receivedBatch;
+                receivedBatch.unpack(in);
+
+                mRPCDispatcher.dispatch(nullptr, receivedBatch);
+            }
+
+            Game::CRPCDispatcher& COutgoingClient::getRPCDispatcher(void)
+            {
+                return mRPCDispatcher;
+            }
+
+            void COutgoingClient::onUpdate(void)
+            {
+                mRPCBatch.flush(*this);
+            }
+
             void COutgoingClient::onReceivePacket(Support::CBitStream& incomingStream)
             {
                 Core::SCoreRegistry* registry = Core::SCoreRegistry::getInstance();
@@ -77,23 +104,24 @@ namespace Kiaro
 
                 while (!incomingStream.isFull())
                 {
+                    const size_t messageStart = incomingStream.getPointer();
+
                     Net::IMessage basePacket;
                     basePacket.unpack(incomingStream);
 
                     // Look up handlers for unstaged messages first
                     Core::SCoreRegistry::MessageHandlerSet::MemberDelegateFuncPtr<COutgoingClient> responder = registry->lookupClientMessageHandler(Net::STAGE_UNSTAGED, basePacket.getType());
 
-                    if (responder)
+                    // Then staged messages
+                    if (!responder)
                     {
-                        (this->*responder)(nullptr, incomingStream);
-                        continue;
+                        responder = registry->lookupClientMessageHandler(static_cast<Net::STAGE_NAME>(mCurrentStage), basePacket.getType());
                     }
 
-                    // Then staged messages
-                    responder = registry->lookupClientMessageHandler(static_cast<Net::STAGE_NAME>(mCurrentStage), basePacket.getType());
                     if (responder)
                     {
                         (this->*responder)(nullptr, incomingStream);
+                        mStats.recordReceivedMessage(basePacket.getType(), incomingStream.getPointer() - messageStart);
                         continue;
                     }
 
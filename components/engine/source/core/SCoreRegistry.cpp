@@ -77,6 +77,10 @@ namespace Kiaro
                 // Loading stage registration
                 this->registerMessage<Game::Messages::Scope>(nullptr, &Core::COutgoingClient::scopeHandler, Net::STAGE_LOADING);
                 this->registerMessage<Game::Messages::SimCommit>(nullptr, &Core::COutgoingClient::simCommitHandler, Net::STAGE_LOADING);
+
+                // RPCs are valid from loading onwards
+                this->registerMessage<Game::Messages::ExecuteRPC>(&Game::SGameServer::executeRPCHandler, &Core::COutgoingClient::executeRPCHandler, Net::STAGE_LOADING);
+                this->registerMessageStage<Game::Messages::ExecuteRPC>(&Game::SGameServer::executeRPCHandler, &Core::COutgoingClient::executeRPCHandler, Net::STAGE_GAMEPLAY);
             }
 
             void SCoreRegistry::registerEntityTypes(void)
@@ -9,6 +9,8 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <cstdlib>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -22,18 +24,26 @@
 
 #include <core/config.hpp>
 #include <net/IIncomingClient.hpp>
+#include <net/CMetricsServer.hpp>
+#include <net/CManagementServer.hpp>
+#include <net/CNetworkStats.hpp>
+#include <net/config.hpp>
 
 #include <video/CSceneGraph.hpp>
 
 #include <support/SProfiler.hpp>
+#include <support/SAllocationTracker.hpp>
 
 #include <sound/SSoundManager.hpp>
 
 #include <game/messages/messages.hpp>
+#include <game/rpcs.hpp>
+#include <game/CGameClient.hpp>
 #include <gui/SGUIManager.hpp>
 
 #include <core/SCoreRegistry.hpp>
 #include <support/FSystemInfo.hpp>
+#include <support/platform/thread.hpp>
 #include <support/SSignalHandler.hpp>
 #include <support/tasking/SThreadSystem.hpp>
 
@@ -100,6 +110,9 @@ namespace Kiaro
                 CONSOLE_ERRORF("Entity Arena Allocations Size: %u", ENGINE_ENTITY_ARENA_ALLOCATION_SIZE);
                 CONSOLE_ERROR("Build Settings End ---------------------------------------");
                 #endif // ENGINE_ENTITY_ARENA_ALLOCATIONS
+
+                // The process is going down, so get the dump out of the console queue now
+                Support::Console::flush();
             }
 
             void SEngineInstance::addWindow(Video::CGraphicsWindow* window)
@@ -112,16 +125,35 @@ namespace Kiaro
                 CONSOLE_ERROR("Received a request from the operating system to throttle CPU usage. Support for this is currently unimplemented and will be ignored.");
             }
 
+            void SEngineInstance::requestProfileCapture(void)
+            {
+                mProfileCaptureRequested.store(true);
+            }
+
+            void SEngineInstance::beginProfileCapture(const Common::U32 frameCount, const Support::String& path)
+            {
+                if (Support::SProfiler::getPointer()->beginCapture(frameCount, path))
+                {
+                    CONSOLE_INFOF("Capturing %u frames to '%s'.", frameCount, path.data());
+                }
+                else
+                {
+                    CONSOLE_ERROR("Cannot begin a profiler capture while another is running.");
+                }
+            }
+
             Kiaro::Common::S32 SEngineInstance::start(const Common::S32 argc, Common::C8* argv[])
             {
-                // Before doing anything, read CPU data
+                // Before doing anything, read CPU data and calibrate the clock so no frame pays for it later
                 Support::getCPUInformation();
+                Support::FTime::calibrateCounter();
 
                 // Install signal handlers.
                 Support::SSignalHandler* signalHandler = Support::SSignalHandler::getInstance();
                 signalHandler->mSignalHandlers[Support::SSignalHandler::SignalType::Termination] = new Support::SSignalHandler::SignalHandlerType::MemberDelegateType<SEngineInstance>(&SEngineInstance::kill, this);
                 signalHandler->mSignalHandlers[Support::SSignalHandler::SignalType::Crash] = new Support::SSignalHandler::SignalHandlerType::StaticDelegateType(handleProcessCrash);
                 signalHandler->mSignalHandlers[Support::SSignalHandler::SignalType::CPUUsage] = new Support::SSignalHandler::SignalHandlerType::MemberDelegateType<SEngineInstance>(&SEngineInstance::handleThrottleRequest, this);
+                signalHandler->mSignalHandlers[Support::SSignalHandler::SignalType::ProfileCapture] = new Support::SSignalHandler::SignalHandlerType::MemberDelegateType<SEngineInstance>(&SEngineInstance::requestProfileCapture, this);
 
                 mRunning = false;
                 al_init();
@@ -147,6 +179,9 @@ namespace Kiaro
                     CONSOLE_INFOF("Mounted game directory '%s' successfully.", directory.c_str());
                 }
 
+                Support::SProfiler::getPointer()->setThreadName("Main");
+                this->applySettings();
+
                 // TODO (Robert MacGregor#9): Return error codes for the netcode
                 // Init the taskers
                 Support::Tasking::SThreadSystem* threadSystem = Support::Tasking::SThreadSystem::getInstance();
@@ -154,10 +189,17 @@ namespace Kiaro
                 Support::Tasking::SAsynchronousTaskManager* asyncTaskManager = Support::Tasking::SAsynchronousTaskManager::getInstance();
 
                 this->initializeManagementConsole();
+                this->initializeMetrics();
 
                 // Initialize the time pulses
                 this->initializeScheduledEvents();
 
+                // The main thread pumps the network, so it runs ahead of every pool and takes the slot after the runtime workers.
+                // Threads inherit the placement of their creator, so this happens once every other thread has been started
+                Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+                const Platform::Thread::AFFINITY_POLICY runtimeAffinity = static_cast<Platform::Thread::AFFINITY_POLICY>(settings->getValue<Common::U8>("System::RuntimeThreadAffinity"));
+                Platform::Thread::placeCurrentThread("Main", runtimeAffinity, settings->getValue<Common::U8>("System::RuntimeThreadCount"), false, Platform::Thread::PRIORITY_NETWORK);
+
                 mRunning = true;
                 this->runGameLoop();
                 return 1;
@@ -180,7 +222,10 @@ namespace Kiaro
             }
 
             SEngineInstance::SEngineInstance(void) : mEngineMode(MODE_CLIENT), mTargetServerAddress("127.0.0.1"), mTargetServerPort(11595),
-            mRunning(false), mActiveClient(nullptr), mPerfStatSchedule(nullptr), mManagementConsole(nullptr)
+            mRunning(false), mActiveClient(nullptr), mPerfStatSchedule(nullptr), mManagementConsole(nullptr), mManagementServer(nullptr), mNextManagementUpdateMS(0),
+            mSimulationTimestep(ENGINE_TICKRATE * 1000ULL, 1), mSimulatedTimeMicroseconds(Support::FTime::getSimTimeNanoseconds() / 1000),
+            mProfileCaptureRequested(false), mMetricsServer(nullptr), mNextMetricsUpdateMS(0), mMetricsCollector(0), mTickTimeMetric(nullptr),
+            mDroppedStepsMetric(nullptr)
             {
             }
 
@@ -194,14 +239,46 @@ namespace Kiaro
                 }
 
                 mPerfStatSchedule = nullptr;
+
+                if (mManagementServer)
+                {
+                    delete mManagementServer;
+                    mManagementServer = nullptr;
+                }
+
+                if (mMetricsServer)
+                {
+                    Support::SMetricsRegistry::getInstance()->removeCollector(mMetricsCollector);
+
+                    delete mMetricsServer;
+                    mMetricsServer = nullptr;
+                }
+
+                // Let the thread pools finish what they were doing before anything their work might touch is destroyed
+                const Common::U32 shutdownTimeoutMS = Support::SSettingsRegistry::getInstance()->getValue<Common::U32>("System::ShutdownTimeoutMS");
+                Support::Tasking::SAsynchronousTaskManager* asyncTaskManager = Support::Tasking::SAsynchronousTaskManager::getPointer();
+                Support::Tasking::SThreadSystem* threadSystem = Support::Tasking::SThreadSystem::getPointer();
+
+                if (asyncTaskManager && !asyncTaskManager->shutdown(true, shutdownTimeoutMS))
+                {
+                    CONSOLE_ERRORF("Asynchronous workers did not finish within %u ms, abandoning their remaining tasks.", shutdownTimeoutMS);
+                }
+
+                if (threadSystem && !threadSystem->getJobSystem()->shutdown(true, shutdownTimeoutMS))
+                {
+                    CONSOLE_ERRORF("Runtime workers did not finish within %u ms, abandoning their remaining jobs.", shutdownTimeoutMS);
+                }
+
                 // TODO: Check the destroy order
                 //   Net::SClient::destroy();
 
                 Game::SGameServer::destroy();
                 Input::SInputListener::destroy();
+                Support::Tasking::SAsynchronousTaskManager::destroy();
                 Support::SSynchronousScheduler::destroy();
                 Support::SSettingsRegistry::destroy();
                 Support::Tasking::SThreadSystem::destroy();
+                Support::SMetricsRegistry::destroy();
 
                 PHYSFS_deinit();
                 enet_deinitialize();
@@ -233,14 +310,295 @@ namespace Kiaro
 
                 });
 
+                // Network statistics; pass "detail" for the per message type breakdown
+                mManagementConsole->registerFunction("netstats", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    this->printNetworkStats(parameters.size() != 0 && parameters[0] == "detail");
+                });
+
+                mManagementConsole->registerFunction("netstats_reset", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                    if (server)
+                    {
+                        for (auto it = server->clientsBegin(); it != server->clientsEnd(); ++it)
+                        {
+                            (*it)->getStats().reset();
+                        }
+                    }
+
+                    if (mActiveClient)
+                    {
+                        mActiveClient->getStats().reset();
+                    }
+                });
+
+                // Sends a message to every connected client
+                mManagementConsole->registerFunction("say", +[](const Support::Vector<Support::String>& parameters)
+                {
+                    Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                    if (!server)
+                    {
+                        CONSOLE_ERROR("No server is running.");
+                        return;
+                    }
+
+                    Support::String message;
+                    for (const Support::String& parameter : parameters)
+                    {
+                        message += message.empty() ? parameter : " " + parameter;
+                    }
+
+                    for (auto it = server->clientsBegin(); it != server->clientsEnd(); ++it)
+                    {
+                        static_cast<Game::CGameClient*>(*it)->callRPC<Game::RPCs::ServerMessage>(message);
+                    }
+                });
+
+                // Network condition simulator; "netsim" shows the impairments, "netsim <on|off>" toggles them and "netsim <Setting> <value>" changes one
+                mManagementConsole->registerFunction("netsim", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+
+                    if (parameters.size() == 1 && (parameters[0] == "on" || parameters[0] == "off"))
+                    {
+                        settings->setValue<bool>("NetSimulator::Enabled", parameters[0] == "on");
+                    }
+                    else if (parameters.size() == 2)
+                    {
+                        settings->setStringValue("NetSimulator::" + parameters[0], parameters[1]);
+                    }
+                    else if (parameters.size() != 0)
+                    {
+                        CONSOLE_ERROR("Usage: netsim [on|off] | [<Setting> <value>]");
+                        return;
+                    }
+
+                    this->applyNetworkSimulatorSettings();
+                });
+
+                // Frames whose main loop went over the spike budget; "spikes clear" discards them
+                mManagementConsole->registerFunction("spikes", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    if (parameters.size() == 1 && parameters[0] == "clear")
+                    {
+                        Support::SProfiler::getPointer()->clearSpikes();
+                        return;
+                    }
+
+                    this->printSpikes();
+                });
+
+                // Profiler capture; "profile [frames] [path]" falls back to the configured frame count and path
+                mManagementConsole->registerFunction("profile", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+
+                    if (parameters.size() > 2)
+                    {
+                        CONSOLE_ERROR("Usage: profile [frames] [path]");
+                        return;
+                    }
+
+                    const Common::U32 frameCount = parameters.size() >= 1 ? static_cast<Common::U32>(std::strtoul(parameters[0].data(), nullptr, 10)) : settings->getValue<Common::U32>("Profiler::CaptureFrames");
+                    const Support::String path = parameters.size() == 2 ? parameters[1] : settings->getValue<Support::String>("Profiler::CapturePath");
+
+                    if (frameCount == 0)
+                    {
+                        CONSOLE_ERROR("Usage: profile [frames] [path]");
+                        return;
+                    }
+
+                    this->beginProfileCapture(frameCount, path);
+                });
+
+                // Lists every command
+                mManagementConsole->registerFunction("help", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    Support::String names;
+                    for (const Support::String& name : mManagementConsole->getFunctionNames())
+                    {
+                        names += names.empty() ? name : " " + name;
+                    }
+
+                    CONSOLE_INFOF("Commands: %s", names.data());
+                });
+
+                // Profiler percentiles per zone, followed by the network statistics
+                mManagementConsole->registerFunction("perfstat", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    this->printPerfStat();
+                });
+
+                mManagementConsole->registerFunction("status", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    this->printStatus();
+                });
+
+                // Heap usage per allocation tag and the zones allocating the most per frame; "memstat [zones]" lists more zones
+                mManagementConsole->registerFunction("memstat", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    if (parameters.size() > 1)
+                    {
+                        CONSOLE_ERROR("Usage: memstat [zones]");
+                        return;
+                    }
+
+                    this->printAllocationStats(parameters.size() == 1 ? std::strtoul(parameters[0].data(), nullptr, 10) : 10);
+                });
+
+                // Settings; "settings" lists them all, "get <Section::Name>" shows one and "set <Section::Name> <value>" changes one live
+                mManagementConsole->registerFunction("settings", +[](const Support::Vector<Support::String>& parameters)
+                {
+                    Support::SSettingsRegistry::getInstance()->dumpSettings();
+                });
+
+                mManagementConsole->registerFunction("get", +[](const Support::Vector<Support::String>& parameters)
+                {
+                    if (parameters.size() != 1)
+                    {
+                        CONSOLE_ERROR("Usage: get <Section::Name>");
+                        return;
+                    }
+
+                    CONSOLE_INFOF("%s = %s", parameters[0].data(), Support::SSettingsRegistry::getInstance()->getStringValue(parameters[0]).data());
+                });
+
+                mManagementConsole->registerFunction("set", [this](const Support::Vector<Support::String>& parameters)
+                {
+                    Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+
+                    if (parameters.size() < 2)
+                    {
+                        CONSOLE_ERROR("Usage: set <Section::Name> <value>");
+                        return;
+                    }
+
+                    // String values may contain spaces
+                    Support::String value;
+                    for (size_t iteration = 1; iteration < parameters.size(); ++iteration)
+                    {
+                        value += value.empty() ? parameters[iteration] : " " + parameters[iteration];
+                    }
+
+                    settings->setStringValue(parameters[0], value);
+                    this->applySettings();
+
+                    if (parameters[0].compare(0, 14, "NetSimulator::") == 0)
+                    {
+                        this->applyNetworkSimulatorSettings();
+                    }
+
+                    CONSOLE_INFOF("%s = %s", parameters[0].data(), settings->getStringValue(parameters[0]).data());
+                });
+
                 CONSOLE_INFO("Management console initialized.");
+
+                try
+                {
+                    mManagementServer = new Net::CManagementServer(mManagementConsole, settings->getValue<Support::String>("System::ManagementConsoleBind"),
+                                                                   settings->getValue<Common::U16>("System::ManagementConsolePort"));
+                }
+                catch (std::runtime_error& e)
+                {
+                    CONSOLE_ERRORF("Failed to listen for management sessions: %s", e.what());
+                    return 1;
+                }
+
+                return 0;
+            }
+
+            Common::U32 SEngineInstance::initializeMetrics(void)
+            {
+                Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+
+                if (!settings->getValue<bool>("System::MetricsEnabled"))
+                {
+                    return 0;
+                }
+
+                const Support::String bindAddress = settings->getValue<Support::String>("System::MetricsBind");
+
+                try
+                {
+                    mMetricsServer = new Net::CMetricsServer(bindAddress, settings->getValue<Common::U16>("System::MetricsPort"));
+                }
+                catch (std::runtime_error& e)
+                {
+                    CONSOLE_ERRORF("Failed to initialize the metrics endpoint: %s", e.what());
+                    return 1;
+                }
+
+                // Tick time buckets are spread around the tick interval
+                const Common::F64 tickSeconds = mSimulationTimestep.getStepSeconds();
+                Support::SMetricsRegistry* registry = Support::SMetricsRegistry::getInstance();
+
+                mTickTimeMetric = registry->getHistogram("kge_tick_seconds", "Time taken by a server tick.", { tickSeconds / 8.0, tickSeconds / 4.0,
+                                                         tickSeconds / 2.0, tickSeconds, tickSeconds * 2.0, tickSeconds * 4.0 });
+                mDroppedStepsMetric = registry->getCounter("kge_simulation_dropped_steps_total", "Simulation steps dropped to catch up after a stall.");
+                mMetricsCollector = registry->addCollector([this](void)
+                {
+                    this->collectMetrics();
+                });
+
                 return 0;
             }
 
+            void SEngineInstance::collectMetrics(void)
+            {
+                Support::SMetricsRegistry* registry = Support::SMetricsRegistry::getInstance();
+                Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                registry->getGauge("kge_players", "Connected players.")->set(server ? server->getClientCount() : 0);
+                registry->getGauge("kge_scheduled_events", "Events waiting in the synchronous scheduler.")->set(Support::SSynchronousScheduler::getInstance()->getEventCount());
+                registry->getGauge("kge_simulation_tick", "The number of the last simulation tick.")->set(static_cast<Common::F64>(this->getSimulationTick()));
+
+                // The network totals only grow, so the counters are caught up to them
+                const Support::Pair<const Common::C8*, Common::U64> networkTotals[] =
+                {
+                    { "kge_network_sent_packets_total", Net::CNetworkStats::getTotalPacketsSent() },
+                    { "kge_network_received_packets_total", Net::CNetworkStats::getTotalPacketsReceived() },
+                    { "kge_network_sent_bytes_total", Net::CNetworkStats::getTotalBytesSent() },
+                    { "kge_network_received_bytes_total", Net::CNetworkStats::getTotalBytesReceived() },
+                };
+
+                for (const Support::Pair<const Common::C8*, Common::U64>& networkTotal : networkTotals)
+                {
+                    Support::CMetricCounter* counter = registry->getCounter(networkTotal.first, "Network traffic across every connection.");
+                    counter->increment(networkTotal.second - counter->getValue());
+                }
+
+                const Support::Vector<Support::SProfiler::ZoneDistribution> distributions = Support::SProfiler::getPointer()->getDistributions();
+                for (const Support::SProfiler::ZoneDistribution& distribution : distributions)
+                {
+                    const Support::String& zone = distribution.mName;
+                    const Support::String help = "Time per frame spent in a profiler zone, over the profiler's distribution window.";
+
+                    registry->getGauge("kge_zone_frame_seconds", help, { { "zone", zone }, { "quantile", "0.5" } })->set(distribution.mMedianSeconds);
+                    registry->getGauge("kge_zone_frame_seconds", help, { { "zone", zone }, { "quantile", "0.95" } })->set(distribution.mP95Seconds);
+                    registry->getGauge("kge_zone_frame_seconds", help, { { "zone", zone }, { "quantile", "0.99" } })->set(distribution.mP99Seconds);
+                    registry->getGauge("kge_zone_frame_max_seconds", "Longest time per frame spent in a profiler zone, over the profiler's distribution window.",
+                                       { { "zone", zone } })->set(distribution.mMaxSeconds);
+                }
+
+                if (Support::SAllocationTracker::sEnabled)
+                {
+                    for (const Support::SAllocationTracker::Statistics& statistics : Support::SAllocationTracker::getTagStatistics())
+                    {
+                        registry->getGauge("kge_heap_live_bytes", "Heap bytes not freed yet, by allocation tag.", { { "tag", statistics.mName } })->set(static_cast<Common::F64>(statistics.mLiveBytes));
+                        registry->getGauge("kge_heap_live_allocations", "Heap allocations not freed yet, by allocation tag.", { { "tag", statistics.mName } })->set(static_cast<Common::F64>(statistics.mLiveAllocations));
+                        registry->getGauge("kge_heap_frame_allocations", "Heap allocations per frame, by allocation tag.", { { "tag", statistics.mName } })->set(statistics.mAllocationsPerFrame);
+                    }
+                }
+            }
+
             void SEngineInstance::runGameLoop(void)
             {
                 // Start the Loop
                 Common::F32 deltaTimeSeconds = 0.0f;
+                Common::U64 lastFrameNanoseconds = Support::FTime::getNanoseconds();
 
                 while (mRunning)
                 {
@@ -250,16 +608,34 @@ namespace Kiaro
                     #endif
 
 
+                        // The simulation clock moves by the length of the last frame, including any time spent idling
+                        const Common::U64 frameNanoseconds = Support::FTime::getNanoseconds();
+                        Support::FTime::advanceSimTime(frameNanoseconds - lastFrameNanoseconds);
+                        deltaTimeSeconds = static_cast<Common::F32>(frameNanoseconds - lastFrameNanoseconds) / 1000000000.0f;
+                        lastFrameNanoseconds = frameNanoseconds;
+
+                        // Captures requested by signal begin here, as the handler itself must not do any work
+                        if (mProfileCaptureRequested.exchange(false))
+                        {
+                            Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+                            this->beginProfileCapture(settings->getValue<Common::U32>("Profiler::CaptureFrames"), settings->getValue<Support::String>("Profiler::CapturePath"));
+                        }
+
                         // Update all our subsystems
-                        Support::FTime::timer timerID = Support::FTime::startTimer();
                         PROFILER_BEGIN(MainLoop);
 
-                        Support::Tasking::SThreadSystem::getInstance()->update();
-                        std::this_thread::sleep_for(std::chrono::nanoseconds(500000));
+                        Support::Tasking::SThreadSystem* threadSystem = Support::Tasking::SThreadSystem::getInstance();
+                        Support::SSynchronousScheduler* scheduler = Support::SSynchronousScheduler::getInstance();
+
+                        const bool completedThreadFrame = threadSystem->update();
                         Support::Tasking::SAsynchronousTaskManager::getInstance()->tick();
 
                         // Pump a time pulse at the scheduler
-                        Support::SSynchronousScheduler::getInstance()->update();
+                        scheduler->update();
+
+                        // Receive whatever arrived since the last frame, then simulate whatever steps the last frame made due
+                        this->networkUpdate(deltaTimeSeconds);
+                        this->runSimulationSteps();
 
                         // Update all active windows
                         for (auto iterator = mActiveWindows.begin(); iterator != mActiveWindows.end(); ++iterator)
@@ -279,14 +655,38 @@ namespace Kiaro
                             Sound::SSoundManager::getInstance()->update();
                         }
 
+                        // Idling is left out of the main loop zone, so that its distribution and spikes only reflect actual work
                         PROFILER_END(MainLoop);
-                        deltaTimeSeconds = Support::FTime::stopTimer(timerID);
+
+                        // Without windows to render, nothing needs the main thread until the next scheduled event or simulation step
+                        // is due or the running phase completes, so we block until then rather than spinning. Phases of a frame
+                        // run back to back.
+                        if (mActiveWindows.empty())
+                        {
+                            const Common::U64 stepIdleMS = mSimulationTimestep.getTimeUntilNextStepMicroseconds() / 1000;
+                            const Common::U32 idleMS = static_cast<Common::U32>(std::min<Common::U64>(scheduler->getTimeUntilNextEventMS(), stepIdleMS));
+
+                            if (threadSystem->isPhaseRunning())
+                            {
+                                threadSystem->waitForPhase(idleMS);
+                            }
+                            else if ((completedThreadFrame || threadSystem->getPhaseCount() == 0) && idleMS != 0)
+                            {
+                                std::this_thread::sleep_for(std::chrono::milliseconds(idleMS));
+                            }
+                        }
+
+                        // Every frame is one profiler sample
+                        Support::SProfiler::getPointer()->update();
                     #if _ENGINE_USE_GLOBAL_EXCEPTION_CATCH_ > 0
                     }
                     catch(std::exception& e)
                     {
                         CONSOLE_ERRORF("An internal exception of type '%s' has occurred:\n%s", typeid(e).name(), e.what());
 
+                        // The exception skipped the ends of whatever scopes were open
+                        Support::SProfiler::getPointer()->abandonScopes();
+
                         // Something is probably up, we should leave if we have an active client.
                         if (mActiveClient)
                         {
@@ -328,6 +728,85 @@ namespace Kiaro
                 // TODO (Robert MacGregor#9): Initialize Allegro with PhysFS
             }
 
+            void SEngineInstance::runSimulationSteps(void)
+            {
+                // Stepping by the simulation clock makes pausing and scaling it apply to the simulation as well
+                const Common::U64 simTimeMicroseconds = Support::FTime::getSimTimeNanoseconds() / 1000;
+                const Common::U64 droppedStepCount = mSimulationTimestep.getDroppedStepCount();
+
+                mSimulationTimestep.addTime(simTimeMicroseconds - mSimulatedTimeMicroseconds);
+                mSimulatedTimeMicroseconds = simTimeMicroseconds;
+
+                if (mSimulationTimestep.getDroppedStepCount() != droppedStepCount)
+                {
+                    CONSOLE_WARNINGF("Simulation fell behind, dropping %u steps.", static_cast<Common::U32>(mSimulationTimestep.getDroppedStepCount() - droppedStepCount));
+
+                    if (mDroppedStepsMetric)
+                    {
+                        mDroppedStepsMetric->increment(mSimulationTimestep.getDroppedStepCount() - droppedStepCount);
+                    }
+                }
+
+                Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                while (mSimulationTimestep.consumeStep())
+                {
+                    const Common::U64 tickNumber = mSimulationTimestep.getTickNumber();
+
+                    if (server)
+                    {
+                        const Common::U64 tickStart = Support::FTime::getNanoseconds();
+                        server->update(tickNumber, mSimulationTimestep.getStepSeconds());
+
+                        if (mTickTimeMetric)
+                        {
+                            mTickTimeMetric->observe((Support::FTime::getNanoseconds() - tickStart) / 1000000000.0);
+                        }
+                    }
+
+                }
+            }
+
+            void SEngineInstance::networkUpdate(const Common::F32 deltaTimeSeconds)
+            {
+                Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                if (server)
+                {
+                    server->updateNetwork(deltaTimeSeconds);
+                }
+
+                if (mActiveClient)
+                {
+                    mActiveClient->update();
+                }
+
+                const Common::U64 currentTimeMS = Support::FTime::getMilliseconds();
+
+                // Commands run between frames on the main thread, so they may touch anything the main loop does
+                if (mManagementServer && currentTimeMS >= mNextManagementUpdateMS)
+                {
+                    mManagementServer->update();
+                    mNextManagementUpdateMS = currentTimeMS + MANAGEMENTSERVER_UPDATE_INTERVAL_MS;
+                }
+
+                if (mMetricsServer && currentTimeMS >= mNextMetricsUpdateMS)
+                {
+                    mMetricsServer->update();
+                    mNextMetricsUpdateMS = currentTimeMS + METRICSSERVER_UPDATE_INTERVAL_MS;
+                }
+            }
+
+            Common::U64 SEngineInstance::getSimulationTick(void) const
+            {
+                return mSimulationTimestep.getTickNumber();
+            }
+
+            Common::F32 SEngineInstance::getInterpolationAlpha(void) const
+            {
+                return mSimulationTimestep.getInterpolationAlpha();
+            }
+
             void SEngineInstance::initializeScheduledEvents(void)
             {
                 Support::SSynchronousScheduler* syncScheduler = Support::SSynchronousScheduler::getInstance();
@@ -366,12 +845,140 @@ namespace Kiaro
             void SEngineInstance::printPerfStat(void)
             {
                 Support::SProfiler* profiler = Support::SProfiler::getPointer();
-                auto averages = profiler->getSampleAverages();
+                const Support::Vector<Support::SProfiler::ZoneDistribution> distributions = profiler->getDistributions();
                 CONSOLE_INFO("Performance Statistics---------------------------");
 
-                for (auto average: averages)
+                for (const Support::SProfiler::ZoneDistribution& distribution : distributions)
+                {
+                    CONSOLE_INFOF("%s: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms over %llu frames", distribution.mName.data(),
+                                  distribution.mMedianSeconds * 1000.0, distribution.mP95Seconds * 1000.0, distribution.mP99Seconds * 1000.0,
+                                  distribution.mMaxSeconds * 1000.0, static_cast<unsigned long long>(distribution.mFrameCount));
+                }
+
+                // Steady allocation churn fragments the heap of long running servers
+                if (Support::SAllocationTracker::sEnabled)
+                {
+                    const Support::SAllocationTracker::Statistics totals = Support::SAllocationTracker::getTotalStatistics();
+                    CONSOLE_INFOF("Heap: %llu bytes live in %llu allocations, %.1f allocations and %.0f bytes per frame",
+                                  static_cast<unsigned long long>(totals.mLiveBytes), static_cast<unsigned long long>(totals.mLiveAllocations),
+                                  totals.mAllocationsPerFrame, totals.mBytesPerFrame);
+                }
+
+                this->printNetworkStats(false);
+            }
+
+            void SEngineInstance::printSpikes(void)
+            {
+                const Support::Vector<Support::SProfiler::Spike> spikes = Support::SProfiler::getPointer()->getSpikes();
+                CONSOLE_INFOF("Spikes (%u)---------------------------------------", static_cast<Common::U32>(spikes.size()));
+
+                for (const Support::SProfiler::Spike& spike : spikes)
+                {
+                    CONSOLE_INFOF("Frame %llu: %.3f ms", static_cast<unsigned long long>(spike.mFrame), spike.mSeconds * 1000.0);
+
+                    for (const Support::SProfiler::HierarchyNode& node : spike.mBreakdown)
+                    {
+                        CONSOLE_INFOF("%*s%s: %.3f ms total, %.3f ms self, %llu calls", static_cast<int>(node.mDepth * 2 + 2), "", node.mName.data(),
+                                      node.mTotalSeconds * 1000.0, node.mSelfSeconds * 1000.0, static_cast<unsigned long long>(node.mCallCount));
+                    }
+                }
+            }
+
+            void SEngineInstance::applySettings(void)
+            {
+                Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+                Support::SProfiler* profiler = Support::SProfiler::getPointer();
+
+                mSimulationTimestep.setMaxStepsPerUpdate(std::max<Common::U32>(1, settings->getValue<Common::U32>("System::MaxCatchUpSteps")));
+                profiler->setDistributionWindow(std::max<Common::U32>(1, settings->getValue<Common::U32>("Profiler::DistributionFrames")));
+                profiler->setSpikeBudget("MainLoop", settings->getValue<Common::U32>("Profiler::SpikeBudgetMS") / 1000.0f);
+            }
+
+            void SEngineInstance::printStatus(void)
+            {
+                Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                CONSOLE_INFOF("Simulation tick %llu, %llu steps dropped", static_cast<unsigned long long>(mSimulationTimestep.getTickNumber()),
+                              static_cast<unsigned long long>(mSimulationTimestep.getDroppedStepCount()));
+                CONSOLE_INFOF("Server: %s, %u clients", server ? "Running" : "Not running", server ? server->getClientCount() : 0);
+                CONSOLE_INFOF("Client: %s", mActiveClient ? "Connected" : "Not connected");
+                CONSOLE_INFOF("Scheduled events: %u", static_cast<Common::U32>(Support::SSynchronousScheduler::getInstance()->getEventCount()));
+            }
+
+            void SEngineInstance::printAllocationStats(const size_t zoneCount)
+            {
+                if (!Support::SAllocationTracker::sEnabled)
+                {
+                    CONSOLE_ERROR("Allocation tracking is not available in this build. Build with --define memtrack=on.");
+                    return;
+                }
+
+                const Support::SAllocationTracker::Statistics totals = Support::SAllocationTracker::getTotalStatistics();
+                CONSOLE_INFOF("Heap Statistics: %llu bytes live in %llu allocations, %.1f allocations and %.0f bytes per frame",
+                              static_cast<unsigned long long>(totals.mLiveBytes), static_cast<unsigned long long>(totals.mLiveAllocations),
+                              totals.mAllocationsPerFrame, totals.mBytesPerFrame);
+
+                for (const Support::SAllocationTracker::Statistics& statistics : Support::SAllocationTracker::getTagStatistics())
+                {
+                    CONSOLE_INFOF("%s: %llu bytes live in %llu allocations, %.1f allocations and %.0f bytes per frame", statistics.mName.data(),
+                                  static_cast<unsigned long long>(statistics.mLiveBytes), static_cast<unsigned long long>(statistics.mLiveAllocations),
+                                  statistics.mAllocationsPerFrame, statistics.mBytesPerFrame);
+                }
+
+                const Support::Vector<Support::SAllocationTracker::Statistics> zones = Support::SAllocationTracker::getZoneStatistics();
+                CONSOLE_INFOF("Busiest Zones (%u of %u)-----------------------", static_cast<Common::U32>(std::min(zoneCount, zones.size())),
+                              static_cast<Common::U32>(zones.size()));
+
+                for (size_t index = 0; index < zones.size() && index < zoneCount; ++index)
+                {
+                    const Support::SAllocationTracker::Statistics& statistics = zones[index];
+                    CONSOLE_INFOF("%s: %.1f allocations and %.0f bytes per frame, %llu allocations in total", statistics.mName.data(),
+                                  statistics.mAllocationsPerFrame, statistics.mBytesPerFrame, static_cast<unsigned long long>(statistics.mAllocationCount));
+                }
+            }
+
+            void SEngineInstance::applyNetworkSimulatorSettings(void)
+            {
+                const Net::CNetworkConditioner::Parameters parameters = Net::CNetworkConditioner::getConfiguredParameters();
+                Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                if (server)
+                {
+                    server->getConditioner().setParameters(parameters);
+                }
+
+                if (mActiveClient)
+                {
+                    mActiveClient->getConditioner().setParameters(parameters);
+                }
+
+                CONSOLE_INFOF("Network Simulator: %s, %ums latency, %ums jitter, %u%% loss, %u%% duplication, %u%% reordering, %u bytes/sec, seed %u",
+                parameters.mEnabled ? "Enabled" : "Disabled", parameters.mLatencyMS, parameters.mJitterMS, parameters.mLossPercent, parameters.mDuplicatePercent,
+                parameters.mReorderPercent, parameters.mBandwidth, parameters.mSeed);
+            }
+
+            void SEngineInstance::printNetworkStats(const bool detailed)
+            {
+                Game::SGameServer* server = Game::SGameServer::getPointer();
+
+                if (server)
+                {
+                    CONSOLE_INFOF("Network Statistics (%u clients)-----------------", server->getClientCount());
+
+                    for (auto it = server->clientsBegin(); it != server->clientsEnd(); ++it)
+                    {
+                        Net::IIncomingClient* client = *it;
+
+                        Common::C8 name[32];
+                        sprintf(name, "%s:%u", client->getIPAddressString().data(), client->getPort());
+                        client->getStats().print(name, detailed);
+                    }
+                }
+
+                if (mActiveClient && mActiveClient->isConnected())
                 {
-                    CONSOLE_INFOF("%s: %f sec", average.first.data(), average.second);
+                    CONSOLE_INFO("Network Statistics (server connection)---------");
+                    mActiveClient->getStats().print("Server", detailed);
                 }
             }
         } // End Namespace Engine
@@ -17,7 +17,7 @@ namespace Kiaro
     {
         namespace Game
         {
-            CGameAIClient::CGameAIClient(void) : CGameClient(nullptr)
+            CGameAIClient::CGameAIClient(void) : CGameClient(nullptr, nullptr)
             {
             }
 
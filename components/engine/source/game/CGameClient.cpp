@@ -21,10 +21,15 @@ namespace Kiaro
     {
         namespace Game
         {
-            CGameClient::CGameClient(Net::RemoteHostContext client) : Net::IIncomingClient(client, nullptr), mControlObject(nullptr)
+            CGameClient::CGameClient(Net::RemoteHostContext client, Net::IServer* server) : Net::IIncomingClient(client, server), mControlObject(nullptr)
             {
             }
 
+            void CGameClient::flushRPCs(void)
+            {
+                mRPCBatch.flush(*this);
+            }
+
             void CGameClient::setControlObject(IControllable* object)
             {
                 mControlObject = object;
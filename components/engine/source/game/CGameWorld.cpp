@@ -10,6 +10,7 @@
  */
 
 #include <support/Console.hpp>
+#include <support/tasking/FParallel.hpp>
 #include <game/IEntity.hpp>
 
 #include <game/IGameMode.hpp>
@@ -24,16 +25,21 @@ namespace Kiaro
         {
             void CGameWorld::update(const Common::F32 deltaTimeSeconds)
             {
-                // FIXME: Implement bitmask checking for updated entities
-                for (Support::UnorderedSet<Game::IEntity*>::iterator it = mEntities.begin(); it != mEntities.end(); it++)
+                if (mEntityListDirty)
                 {
-                    Game::IEntity* entity = *it;
+                    mEntityList.assign(mEntities.begin(), mEntities.end());
+                    mEntityListDirty = false;
+                }
 
+                // FIXME: Implement bitmask checking for updated entities
+                Support::Tasking::FParallel::parallelForEach(*Support::Tasking::SThreadSystem::getInstance()->getJobSystem(), mEntityList.data(), mEntityList.size(),
+                [deltaTimeSeconds](Game::IEntity* entity)
+                {
                     if (entity && entity->mFlags & Game::FLAG_UPDATING)
                     {
                         entity->update(deltaTimeSeconds);
                     }
-                }
+                });
             }
 
             void CGameWorld::clear(void)
@@ -45,6 +51,8 @@ namespace Kiaro
                 }
 
                 mEntities.clear();
+                mEntityList.clear();
+                mEntityListDirty = false;
             }
 
             void CGameWorld::addEntity(IEntity* entity)
@@ -55,6 +63,7 @@ namespace Kiaro
                 if (it == mEntities.end())
                 {
                     mEntities.insert(mEntities.end(), entity);
+                    mEntityListDirty = true;
                 }
 
                 Core::SObjectRegistry::getInstance()->addObject(entity);
@@ -65,6 +74,7 @@ namespace Kiaro
                 assert(entity);
 
                 mEntities.erase(entity);
+                mEntityListDirty = true;
                 Core::SObjectRegistry::getInstance()->removeObject(entity);
             }
 
@@ -72,6 +82,7 @@ namespace Kiaro
             {
                 IEntity* erased = reinterpret_cast<IEntity*>(Core::SObjectRegistry::getInstance()->getObject(id));
                 mEntities.erase(erased);
+                mEntityListDirty = true;
 
                 return erased;
             }
@@ -122,7 +133,7 @@ namespace Kiaro
                 return mGameMode;
             }
 
-            CGameWorld::CGameWorld(void) : mGameMode(nullptr)
+            CGameWorld::CGameWorld(void) : mEntityListDirty(false), mGameMode(nullptr)
             {
             }
 
@@ -0,0 +1,41 @@
+/**
+ *  @file CRPCBatch.cpp
+ *  @brief Source file implementing the CRPCBatch class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <game/CRPCBatch.hpp>
+
+namespace Kiaro
+{
+    namespace Engine
+    {
+        namespace Game
+        {
+            CRPCBatch::CRPCBatch(void) : mNextOrderedSequence(0)
+            {
+                for (Common::U32 iteration = 0; iteration < RPC_DELIVERY_COUNT; ++iteration)
+                {
+                    mBatches[iteration].mDelivery = iteration;
+                }
+            }
+
+            Common::U32 CRPCBatch::getPendingCallCount(void) const
+            {
+                Common::U32 result = 0;
+
+                for (Common::U32 iteration = 0; iteration < RPC_DELIVERY_COUNT; ++iteration)
+                {
+                    result += mBatches[iteration].getCallCount();
+                }
+
+                return result;
+            }
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
@@ -0,0 +1,65 @@
+/**
+ *  @file CRPCDispatcher.cpp
+ *  @brief Source file implementing the CRPCDispatcher class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <game/CRPCDispatcher.hpp>
+
+#include <support/support.hpp>
+
+namespace Kiaro
+{
+    namespace Engine
+    {
+        namespace Game
+        {
+            void CRPCDispatcher::dispatch(Net::IIncomingClient* sender, const Messages::ExecuteRPC& batch)
+            {
+                if (batch.mDelivery == RPC_ORDERED)
+                {
+                    auto searchResult = mOrderedSequences.find(sender);
+
+                    // Sequence numbers wrap around, so compare by signed distance
+                    if (searchResult != mOrderedSequences.end() && static_cast<Common::S16>(batch.mSequence - searchResult->second) <= 0)
+                    {
+                        return;
+                    }
+
+                    mOrderedSequences[sender] = batch.mSequence;
+                }
+
+                // Read the calls in place
+                Support::CBitStream calls(const_cast<void*>(batch.getCalls()), batch.getCallsLength());
+
+                for (Common::U16 iteration = 0; iteration < batch.getCallCount(); ++iteration)
+                {
+                    Common::U16 identifier = 0;
+                    Common::U32 argumentsLength = 0;
+                    calls >> identifier >> argumentsLength;
+
+                    auto invoker = mInvokers.find(identifier);
+
+                    if (invoker == mInvokers.end())
+                    {
+                        Support::throwFormattedException<std::out_of_range>("CRPCDispatcher: Received call to unknown RPC ID %u!", identifier);
+                    }
+
+                    // Unpack the arguments from their own stream so that a handler can never read into the next call
+                    Support::CBitStream arguments(const_cast<void*>(calls.popBytes(argumentsLength)), argumentsLength);
+                    invoker->second(sender, arguments);
+                }
+            }
+
+            void CRPCDispatcher::forget(Net::IIncomingClient* sender)
+            {
+                mOrderedSequences.erase(sender);
+            }
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
@@ -9,6 +9,8 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <algorithm>
+
 #include <support/SSettingsRegistry.hpp>
 
 #include <game/SGameServer.hpp>
@@ -20,6 +22,7 @@
 
 #include <game/messages/messages.hpp>
 
+#include <support/FTime.hpp>
 #include <support/SProfiler.hpp>
 
 #include <core/SCoreRegistry.hpp>
@@ -40,16 +43,17 @@ namespace Kiaro
 
             Net::IIncomingClient* SGameServer::onReceiveClientChallenge(Net::RemoteHostContext client)
             {
-                CGameClient* incoming = new CGameClient(client);
+                CGameClient* incoming = new CGameClient(client, this);
                 return incoming;
             }
 
-            SGameServer::SGameServer(const Support::String& listenAddress, const Common::U16& listenPort, const Common::U32& maximumClientCount) : Net::IServer(listenAddress, listenPort, maximumClientCount)
+            SGameServer::SGameServer(const Support::String& listenAddress, const Common::U16& listenPort, const Common::U32& maximumClientCount) : Net::IServer(listenAddress, listenPort, maximumClientCount),
+            mTickNumber(0), mMessagesPerTick(Support::SSettingsRegistry::getInstance()->getValue<Common::U32>("Server::MessagesPerTick")),
+            mMaxQueuedStreams(Support::SSettingsRegistry::getInstance()->getValue<Common::U32>("Server::MaxQueuedStreams")),
+            mMaxQueuedBytes(Support::SSettingsRegistry::getInstance()->getValue<Common::U32>("Server::MaxQueuedBytes"))
             {
+                // Updates are driven by the fixed timestep of the SEngineInstance
                 mSimulation = new Phys::CSimulation();
-
-                // Add our update to the scheduler
-                mUpdatePulse = Support::SSynchronousScheduler::getInstance()->schedule(ENGINE_TICKRATE, true, this, &SGameServer::update);
             }
 
             void SGameServer::handshakeHandler(Net::IIncomingClient* sender, Support::CBitStream& in)
@@ -72,17 +76,31 @@ namespace Kiaro
                 this->onClientConnected(sender);
             }
 
+            void SGameServer::executeRPCHandler(Net::IIncomingClient* sender, Support::CBitStream& in)
+            {
+                Game::Messages::ExecuteRPC receivedBatch;
+                receivedBatch.unpack(in);
+
+                mRPCDispatcher.dispatch(sender, receivedBatch);
+            }
+
+            CRPCDispatcher& SGameServer::getRPCDispatcher(void)
+            {
+                return mRPCDispatcher;
+            }
+
             SGameServer::~SGameServer(void)
             {
                 assert(mSimulation);
-                assert(mUpdatePulse);
 
                 delete mSimulation;
 
-                mSimulation = nullptr;
-                mUpdatePulse->cancel();
+                for (auto&& ring: mInboundRings)
+                {
+                    delete ring.second;
+                }
 
-                mUpdatePulse = nullptr;
+                mSimulation = nullptr;
             }
 
             void SGameServer::onClientConnected(Net::IIncomingClient* client)
@@ -127,113 +145,179 @@ namespace Kiaro
                 }
             }
 
-            void SGameServer::update(void)
+            void SGameServer::update(const Common::U64 tickNumber, const Common::F32 stepSeconds)
             {
+                mTickNumber = tickNumber;
+
                 PROFILER_BEGIN(Server);
-                Net::IServer::update(0);
+                this->processInboundMessages();
+                mSimulation->step(stepSeconds);
                 PROFILER_END(Server);
 
                 // Dispatch everything we have queued
                 for (Net::IIncomingClient* client: mConnectedClientSet)
                 {
+                    static_cast<CGameClient*>(client)->flushRPCs();
                     client->dispatchQueuedMessages();
                 }
             }
 
+            void SGameServer::updateNetwork(const Common::F32 deltaTimeSeconds)
+            {
+                Net::IServer::update(deltaTimeSeconds);
+
+                // No steps are simulated while paused, so nothing else would drain the client queues
+                if (Support::FTime::isSimTimePaused())
+                {
+                    this->processInboundMessages();
+                }
+            }
+
+            Common::U64 SGameServer::getTickNumber(void) const
+            {
+                return mTickNumber;
+            }
+
             void SGameServer::onClientDisconnected(Net::IIncomingClient* client)
             {
-                auto searchResult = mQueuedStreams.find(client);
+                this->releaseInboundRing(client);
+                mDroppedClients.erase(client);
+                mRPCDispatcher.forget(client);
+            }
+
+            void SGameServer::releaseInboundRing(Net::IIncomingClient* client)
+            {
+                auto searchResult = mInboundRings.find(client);
 
-                if (searchResult != mQueuedStreams.end())
+                if (searchResult != mInboundRings.end())
                 {
-                    // Nuke anything in the queued streams
-                    while (mQueuedStreams[client].size() != 0)
-                    {
-                        delete mQueuedStreams[client].front();
-                        mQueuedStreams[client].pop();
-                    }
+                    delete searchResult->second;
+                    mInboundRings.erase(searchResult);
+                }
 
-                    mQueuedStreams.erase(client);
+                auto readyResult = std::find(mReadyClients.begin(), mReadyClients.end(), client);
+
+                if (readyResult != mReadyClients.end())
+                {
+                    mReadyClients.erase(readyResult);
                 }
             }
 
             void SGameServer::onReceivePacket(Support::CBitStream& incomingStream, Net::IIncomingClient* sender)
             {
-                Core::SEngineInstance* engine = Core::SEngineInstance::getInstance();
-                Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+                if (mDroppedClients.find(sender) != mDroppedClients.end())
+                {
+                    return;
+                }
 
-                const Common::U32 messageLimit = settings->getValue<Common::U32>("Server::MessagesPerTick");
-                const Common::U32 queueLimit = settings->getValue<Common::U32>("Server::MaxQueuedStreams");
+                Net::CInboundMessageRing*& ring = mInboundRings[sender];
 
-                Support::CBitStream& processedStream = incomingStream;
+                if (!ring)
+                {
+                    ring = new Net::CInboundMessageRing(mMaxQueuedStreams, mMaxQueuedBytes);
+                }
+
+                const bool wasEmpty = ring->isEmpty();
+
+                // The payload is only valid for the duration of this call, so this is the one copy we make of it
+                const size_t payloadStart = incomingStream.getPointer();
+                const Common::U8* payload = reinterpret_cast<const Common::U8*>(incomingStream.getBlock()) + payloadStart;
 
-                // If we still have queued streams, make sure we're not exceeding the max stream count
-                if (queueLimit != 0)
+                if (!ring->push(payload, incomingStream.getSize() - payloadStart))
                 {
-                    auto searchResult = mQueuedStreams.find(sender);
+                    // Anything still queued is thrown away; the client will be cleaned up in the disconnect routine
+                    this->releaseInboundRing(sender);
+                    mDroppedClients.insert(sender);
+                    sender->disconnect("Too much queued data.");
+                    return;
+                }
 
-                    if (searchResult != mQueuedStreams.end())
+                if (wasEmpty && !ring->isEmpty())
+                {
+                    mReadyClients.push_back(sender);
+                }
+            }
+
+            void SGameServer::processInboundMessages(void)
+            {
+                // Each round gives every ready client one message; clients are rotated to the back while they have more
+                for (Common::U32 round = 0; !mReadyClients.empty() && (mMessagesPerTick == 0 || round < mMessagesPerTick); ++round)
+                {
+                    const size_t readyCount = mReadyClients.size();
+
+                    for (size_t iteration = 0; iteration < readyCount && !mReadyClients.empty(); ++iteration)
                     {
-                        // Too much queued data?
-                        if (mQueuedStreams[sender].size() > queueLimit)
+                        Net::IIncomingClient* sender = mReadyClients.front();
+                        mReadyClients.pop_front();
+
+                        try
+                        {
+                            this->processMessage(sender, mInboundRings[sender]);
+                        }
+                        catch (std::exception& e)
                         {
-                            // We deal with any queued streams they might have in the disconnect routine
-                            sender->disconnect("Too much queued data.");
-                            return;
+                            CONSOLE_ERRORF("Failed to process message from client %s: %s", sender->getIPAddressString().data(), e.what());
+
+                            // The rest of the payload can't be interpreted either, but later payloads may be fine
+                            auto searchResult = mInboundRings.find(sender);
+
+                            if (searchResult != mInboundRings.end() && !searchResult->second->isEmpty())
+                            {
+                                searchResult->second->pop();
+                            }
                         }
 
-                        // If the queued stream list isn't empty, we process the first one first
-                        if (mQueuedStreams[sender].size() != 0)
+                        // The handler may have dropped the client's ring entirely
+                        auto searchResult = mInboundRings.find(sender);
+
+                        if (searchResult != mInboundRings.end() && !searchResult->second->isEmpty())
                         {
-                            processedStream = *mQueuedStreams[sender].front();
+                            mReadyClients.push_back(sender);
                         }
                     }
                 }
 
-                // Process messages in our stream up to the message count
-                for (Common::U32 iteration = 0; (messageLimit != 0 && iteration < messageLimit) && !incomingStream.isFull(); ++iteration)
+                for (auto&& ring : mInboundRings)
                 {
-                    Net::IMessage basePacket;
-                    basePacket.unpack(incomingStream);
+                    ring.first->getStats().setIncomingQueueDepth(ring.second->getSpanCount(), ring.second->getByteCount());
+                }
+            }
 
-                    Core::SCoreRegistry* registry = Core::SCoreRegistry::getInstance();
-                    auto responder = registry->lookupServerMessageHandler(Net::STAGE_UNSTAGED, basePacket.getType());
+            void SGameServer::processMessage(Net::IIncomingClient* sender, Net::CInboundMessageRing* ring)
+            {
+                Net::CInboundMessageRing::Span& span = ring->front();
 
-                    if (responder)
-                    {
-                        (this->*responder)(sender, incomingStream);
-                        continue;
-                    }
+                // Read the payload in place
+                Support::CBitStream incomingStream(ring->getData(span), span.mLength);
+                incomingStream.setPointer(span.mCursor);
 
-                    // If we got to this point, look it up by the client's stage
-                    responder = registry->lookupServerMessageHandler(sender->getConnectionStage(), basePacket.getType());
-                    if (responder)
-                    {
-                        (this->*responder)(sender, incomingStream);
-                        continue;
-                    }
+                const size_t messageStart = span.mCursor;
+
+                Net::IMessage basePacket;
+                basePacket.unpack(incomingStream);
 
-                    // Not a valid message
-                    Support::throwFormattedException<std::out_of_range>("SGameServer: Out of stage or unknown message type encountered at stage 0 processing: %u for client %s", basePacket.getType(), sender->getIPAddressString());
+                Core::SCoreRegistry* registry = Core::SCoreRegistry::getInstance();
+                auto responder = registry->lookupServerMessageHandler(Net::STAGE_UNSTAGED, basePacket.getType());
+
+                // If we didn't find anything, look it up by the client's stage
+                if (!responder)
+                {
+                    responder = registry->lookupServerMessageHandler(sender->getConnectionStage(), basePacket.getType());
                 }
 
-                // If the stream still isn't done, queue it up (and it's not already in the queue...)
-                if (!incomingStream.isFull() && &processedStream == &incomingStream)
+                if (!responder)
                 {
-                    auto searchResult = mQueuedStreams.find(sender);
+                    Support::throwFormattedException<std::out_of_range>("SGameServer: Out of stage or unknown message type encountered at stage 0 processing: %u for client %s", basePacket.getType(), sender->getIPAddressString().data());
+                }
 
-                    if (searchResult == mQueuedStreams.end())
-                    {
-                        mQueuedStreams[sender] = Support::Queue<Support::CBitStream*>();
-                    }
+                (this->*responder)(sender, incomingStream);
 
-                    Support::CBitStream* streamCopy = new Support::CBitStream(incomingStream);
-                    mQueuedStreams[sender].push(streamCopy);
-                }
-                else if (incomingStream.isFull() && &processedStream != &incomingStream) // But the stream is done and it's a queued stream, we delete it
+                span.mCursor = incomingStream.getPointer();
+                sender->getStats().recordReceivedMessage(basePacket.getType(), span.mCursor - messageStart);
+
+                if (incomingStream.isFull())
                 {
-                    mQueuedStreams[sender].pop();
-                    delete &processedStream;
+                    ring->pop();
                 }
             }
         } // End NameSpace Game
@@ -0,0 +1,166 @@
+/**
+ *  @file CRPCDispatcher.cpp
+ *  @brief Source file containing coding for the RPC batching & dispatch tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <gtest/gtest.h>
+
+#include <support/Vector.hpp>
+
+#include <net/config.hpp>
+
+#include <game/CRPCBatch.hpp>
+#include <game/CRPCDispatcher.hpp>
+
+namespace Kiaro
+{
+    namespace Engine
+    {
+        namespace Game
+        {
+            typedef RPC<0, RPC_RELIABLE, Common::U32, Support::String> TestReliableRPC;
+            typedef RPC<1, RPC_ORDERED, Common::F32> TestOrderedRPC;
+            typedef RPC<2, RPC_UNRELIABLE> TestUnreliableRPC;
+
+            //! Stands in for a network connection, recording every message sent over it.
+            class TestConnection
+            {
+                public:
+                    struct SentMessage
+                    {
+                        Support::CBitStream* mStream;
+                        bool mReliable;
+                    };
+
+                    Support::Vector<SentMessage> mSent;
+
+                    ~TestConnection(void)
+                    {
+                        for (SentMessage& message : mSent)
+                        {
+                            delete message.mStream;
+                        }
+                    }
+
+                    void send(Net::IMessage* message, const bool reliable)
+                    {
+                        SentMessage sent;
+                        sent.mStream = new Support::CBitStream(NETSTREAM_DEFAULT_SIZE, nullptr, 0, NETSTREAM_RESIZE_FACTOR);
+                        sent.mReliable = reliable;
+
+                        message->packEverything(*sent.mStream);
+                        mSent.push_back(sent);
+                    }
+
+                    //! Unpacks the given sent message as it would be on the receiving end and dispatches it.
+                    void receive(CRPCDispatcher& dispatcher, const size_t index)
+                    {
+                        Support::CBitStream& stream = *mSent[index].mStream;
+                        Support::CBitStream in(stream.getBlock(), stream.getPointer());
+
+                        Net::IMessage header;
+                        header.unpack(in);
+
+                        Messages::ExecuteRPC batch;
+                        batch.unpack(in);
+
+                        EXPECT_TRUE(in.isFull());
+                        dispatcher.dispatch(nullptr, batch);
+                    }
+            };
+
+            TEST(RPC, Batching)
+            {
+                CRPCBatch batch;
+                TestConnection connection;
+
+                batch.call<TestReliableRPC>(1u, Support::String("First"));
+                batch.call<TestReliableRPC>(2u, Support::String("Second"));
+                batch.call<TestOrderedRPC>(3.5f);
+                batch.call<TestUnreliableRPC>();
+                EXPECT_EQ(batch.getPendingCallCount(), 4);
+
+                // One message per delivery type
+                batch.flush(connection);
+                EXPECT_EQ(batch.getPendingCallCount(), 0);
+                ASSERT_EQ(connection.mSent.size(), 3);
+
+                Support::Vector<Support::String> reliableCalls;
+                Common::F32 orderedValue = 0.0f;
+                Common::U32 unreliableCalls = 0;
+
+                CRPCDispatcher dispatcher;
+                dispatcher.bind<TestReliableRPC>([&reliableCalls](Net::IIncomingClient* sender, const Common::U32& value, const Support::String& text)
+                {
+                    reliableCalls.push_back(std::to_string(value) + text);
+                });
+                dispatcher.bind<TestOrderedRPC>([&orderedValue](Net::IIncomingClient* sender, const Common::F32& value)
+                {
+                    orderedValue = value;
+                });
+                dispatcher.bind<TestUnreliableRPC>([&unreliableCalls](Net::IIncomingClient* sender)
+                {
+                    ++unreliableCalls;
+                });
+
+                for (size_t iteration = 0; iteration < connection.mSent.size(); ++iteration)
+                {
+                    connection.receive(dispatcher, iteration);
+                }
+
+                EXPECT_EQ(reliableCalls, Support::Vector<Support::String>({ "1First", "2Second" }));
+                EXPECT_EQ(orderedValue, 3.5f);
+                EXPECT_EQ(unreliableCalls, 1);
+
+                // Only the reliable batch is sent reliably
+                EXPECT_FALSE(connection.mSent[0].mReliable);
+                EXPECT_FALSE(connection.mSent[1].mReliable);
+                EXPECT_TRUE(connection.mSent[2].mReliable);
+            }
+
+            TEST(RPC, OrderedDiscardsStale)
+            {
+                CRPCBatch batch;
+                TestConnection connection;
+
+                batch.call<TestOrderedRPC>(1.0f);
+                batch.flush(connection);
+                batch.call<TestOrderedRPC>(2.0f);
+                batch.flush(connection);
+
+                Support::Vector<Common::F32> received;
+
+                CRPCDispatcher dispatcher;
+                dispatcher.bind<TestOrderedRPC>([&received](Net::IIncomingClient* sender, const Common::F32& value)
+                {
+                    received.push_back(value);
+                });
+
+                // The second batch arrives first, so the first is stale by the time it arrives
+                connection.receive(dispatcher, 1);
+                connection.receive(dispatcher, 0);
+                connection.receive(dispatcher, 1);
+
+                EXPECT_EQ(received, Support::Vector<Common::F32>({ 2.0f }));
+            }
+
+            TEST(RPC, UnknownRPC)
+            {
+                CRPCBatch batch;
+                TestConnection connection;
+
+                batch.call<TestUnreliableRPC>();
+                batch.flush(connection);
+
+                CRPCDispatcher dispatcher;
+                EXPECT_THROW(connection.receive(dispatcher, 0), std::out_of_range);
+            }
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
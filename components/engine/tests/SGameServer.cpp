@@ -0,0 +1,213 @@
+/**
+ *  @file SGameServer.cpp
+ *  @brief Source file containing coding for the SGameServer inbound message processing tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <support/Vector.hpp>
+#include <support/SSettingsRegistry.hpp>
+
+#include <net/config.hpp>
+#include <net/IIncomingClient.hpp>
+
+#include <game/CRPCBatch.hpp>
+#include <game/SGameServer.hpp>
+#include <core/SCoreRegistry.hpp>
+
+namespace Kiaro
+{
+    namespace Engine
+    {
+        namespace Game
+        {
+            typedef RPC<0, RPC_RELIABLE, Common::U32> TestServerRPC;
+
+            //! Stands in for a connected client without a real ENet peer behind it.
+            class TestClient : public Net::IIncomingClient
+            {
+                public:
+                    ENetPeer mPeer;
+
+                    Common::U32 mDisconnectCount;
+
+                    TestClient(Net::IServer* server) : Net::IIncomingClient(&mPeer, server), mDisconnectCount(0)
+                    {
+                        std::memset(&mPeer, 0, sizeof(mPeer));
+                        this->setConnectionStage(Net::STAGE_LOADING);
+                    }
+
+                    ~TestClient(void)
+                    {
+                        // There is nothing to tell ENet about
+                        mIsConnected = false;
+                    }
+
+                    void disconnect(const Support::String& reason)
+                    {
+                        ++mDisconnectCount;
+                    }
+            };
+
+            //! Packs messages into a payload as the client would send them.
+            class TestPayload
+            {
+                public:
+                    Support::CBitStream mStream;
+
+                    TestPayload(void) : mStream(NETSTREAM_DEFAULT_SIZE, nullptr, 0, NETSTREAM_RESIZE_FACTOR)
+                    {
+                    }
+
+                    void send(Net::IMessage* message, const bool reliable)
+                    {
+                        message->packEverything(mStream);
+                    }
+
+                    //! Hands the payload to the server as if it had just been received from the given client.
+                    void deliver(Net::IServer* server, Net::IIncomingClient* sender)
+                    {
+                        Support::CBitStream received(mStream.getBlock(), mStream.getPointer());
+                        server->onReceivePacket(received, sender);
+                    }
+            };
+
+            //! Delivers a payload calling TestServerRPC once with the given value.
+            static void deliverCall(SGameServer* server, Net::IIncomingClient* sender, const Common::U32 value)
+            {
+                CRPCBatch batch;
+                TestPayload payload;
+
+                batch.call<TestServerRPC>(value);
+                batch.flush(payload);
+                payload.deliver(server, sender);
+            }
+
+            //! Creates a server processing as many messages per tick as given.
+            static SGameServer* createServer(const Common::U32 messagesPerTick)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U32>("Server::MessagesPerTick", messagesPerTick);
+
+                // Message type identifiers are assigned as the registry is created
+                Core::SCoreRegistry::getInstance();
+                return SGameServer::getInstance("127.0.0.1", 0, 8);
+            }
+
+            TEST(SGameServer, RoundRobin)
+            {
+                SGameServer* server = createServer(0);
+
+                Support::Vector<std::pair<Net::IIncomingClient*, Common::U32>> calls;
+                server->getRPCDispatcher().bind<TestServerRPC>([&calls](Net::IIncomingClient* sender, const Common::U32& value)
+                {
+                    calls.push_back(std::make_pair(sender, value));
+                });
+
+                {
+                    TestClient first(server);
+                    TestClient second(server);
+
+                    deliverCall(server, &first, 1);
+                    deliverCall(server, &first, 2);
+                    deliverCall(server, &first, 3);
+                    deliverCall(server, &second, 4);
+
+                    // The busy client does not get to process its whole backlog before the other gets a turn
+                    server->update(1, 0.032f);
+
+                    ASSERT_EQ(calls.size(), 4);
+                    EXPECT_EQ(calls[0], std::make_pair(static_cast<Net::IIncomingClient*>(&first), 1u));
+                    EXPECT_EQ(calls[1], std::make_pair(static_cast<Net::IIncomingClient*>(&second), 4u));
+                    EXPECT_EQ(calls[2], std::make_pair(static_cast<Net::IIncomingClient*>(&first), 2u));
+                    EXPECT_EQ(calls[3], std::make_pair(static_cast<Net::IIncomingClient*>(&first), 3u));
+
+                    server->onClientDisconnected(&first);
+                    server->onClientDisconnected(&second);
+                }
+
+                SGameServer::destroy();
+            }
+
+            TEST(SGameServer, MessagesPerTick)
+            {
+                SGameServer* server = createServer(1);
+
+                Support::Vector<Common::U32> calls;
+                server->getRPCDispatcher().bind<TestServerRPC>([&calls](Net::IIncomingClient* sender, const Common::U32& value)
+                {
+                    calls.push_back(value);
+                });
+
+                {
+                    TestClient client(server);
+
+                    deliverCall(server, &client, 1);
+                    deliverCall(server, &client, 2);
+
+                    // The rest of the backlog waits for the next tick
+                    server->update(1, 0.032f);
+                    EXPECT_EQ(calls, Support::Vector<Common::U32>({ 1 }));
+
+                    server->update(2, 0.032f);
+                    EXPECT_EQ(calls, Support::Vector<Common::U32>({ 1, 2 }));
+
+                    server->onClientDisconnected(&client);
+                }
+
+                SGameServer::destroy();
+            }
+
+            TEST(SGameServer, MalformedMessages)
+            {
+                SGameServer* server = createServer(0);
+
+                Support::Vector<Common::U32> calls;
+                server->getRPCDispatcher().bind<TestServerRPC>([&calls](Net::IIncomingClient* sender, const Common::U32& value)
+                {
+                    calls.push_back(value);
+                });
+
+                {
+                    TestClient client(server);
+                    deliverCall(server, &client, 1);
+
+                    // A message type no handler exists for, followed by a message the server should never get to
+                    TestPayload unknown;
+                    unknown.mStream << static_cast<Common::U32>(0xFFFFFFFF) << static_cast<Common::U32>(0);
+                    unknown.mStream << static_cast<Common::U32>(0xFFFFFFFF) << static_cast<Common::U32>(0);
+                    unknown.deliver(server, &client);
+
+                    // A message cut short before its header ends
+                    TestPayload truncated;
+                    truncated.mStream << static_cast<Common::U16>(1);
+                    truncated.deliver(server, &client);
+
+                    deliverCall(server, &client, 2);
+
+                    // Bad payloads are dropped and the client keeps being serviced
+                    server->update(1, 0.032f);
+                    EXPECT_EQ(calls, Support::Vector<Common::U32>({ 1, 2 }));
+                    EXPECT_EQ(client.mDisconnectCount, 0);
+                    EXPECT_EQ(client.getStats().getQueuedIncomingPackets(), 0);
+
+                    // And later payloads still arrive
+                    deliverCall(server, &client, 3);
+                    server->update(2, 0.032f);
+                    EXPECT_EQ(calls, Support::Vector<Common::U32>({ 1, 2, 3 }));
+
+                    server->onClientDisconnected(&client);
+                }
+
+                SGameServer::destroy();
+            }
+        } // End NameSpace Game
+    } // End NameSpace Engine
+} // End NameSpace Kiaro
@@ -9,8 +9,12 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#ifndef _INCLUDE_NET_CHTTPOBJECT_HPP_
+#define _INCLUDE_NET_CHTTPOBJECT_HPP_
+
 #include <curl/curl.h>
 
+#include <support/common.hpp>
 #include <support/String.hpp>
 #include <support/UnorderedMap.hpp>
 
@@ -18,6 +22,8 @@ namespace Kiaro
 {
     namespace Net
     {
+        class SHTTPClient;
+
         /**
          *  @brief A base class for the HTTP and HTTPS classes to derive shared attributes and functionality from.
          */
@@ -69,10 +75,16 @@ namespace Kiaro
                     //! The total length of the web server response.
                     size_t mResponseLength;
 
+                    //! The number of bytes allocated for mResponse. This only ever grows so the buffer is reused across requests.
+                    size_t mResponseCapacity;
+
                     //! The response data from the HTTP server.
                     void* mResponse;
                 };
 
+                //! The HTTP status code of the last completed request, or zero if none completed.
+                long mResponseCode;
+
                 //! A pointer to the HTTP transfer context in use or to be used.
                 HTTPTransferContext mHTTPTransferContext;
 
@@ -135,15 +147,24 @@ namespace Kiaro
                  *  @brief Dispatches the HTTP request with the current request payload within the context of the current thread. In other words, if you want the
                  *  engine to continue to perform with any semblance of speed, ensure that this is only ever called from within the context of some auxilliary thread
                  *  and not main.
+                 *  @return True if the transfer completed. False otherwise.
+                 *  @see SHTTPClient::dispatch for a non-blocking alternative.
                  */
-                void dispatchRequest(void);
+                bool dispatchRequest(void);
 
                 /**
-                 *  @brief Gets the server raw response body.
+                 *  @brief Gets the server raw response body. The body is always followed by a NULL byte that is not counted in the response length,
+                 *  so textual responses may be read as C strings directly.
                  *  @return A pointer to the server raw response data.
                  */
                 void* getResponseBody(void);
 
+                /**
+                 *  @brief Gets the HTTP status code of the last completed request.
+                 *  @return The HTTP status code, or zero if no request has completed.
+                 */
+                long getResponseCode(void);
+
                 /**
                  *  @brief Gets the server raw repsonse length.
                  *  @return The server raw response length in bytes.
@@ -152,6 +173,21 @@ namespace Kiaro
 
             // Private Methods
             private:
+                friend class SHTTPClient;
+
+                /**
+                 *  @brief Configures the given CURL easy handle to perform this request and resets the response state.
+                 *  @param handle The easy handle to configure.
+                 *  @return The header list in use by the handle. This must be freed with curl_slist_free_all once the transfer has completed.
+                 */
+                curl_slist* prepareHandle(CURL* handle);
+
+                /**
+                 *  @brief Records the result of a completed transfer.
+                 *  @param handle The easy handle the transfer was performed with.
+                 */
+                void finishTransfer(CURL* handle);
+
                 /**
                  *  @brief The CURL data read callback to use when sending arbitrary data payloads to the HTTP server.
                  *  @param The output buffer to write to.
@@ -167,3 +203,4 @@ namespace Kiaro
         };
     } // End NameSpace Net
 } // End NameSpace Kiaro
+#endif // _INCLUDE_NET_CHTTPOBJECT_HPP_
@@ -0,0 +1,132 @@
+/**
+ *  @file CInboundMessageRing.hpp
+ *  @brief Include file declaring the Net::CInboundMessageRing class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_NET_CINBOUNDMESSAGERING_HPP_
+#define _INCLUDE_NET_CINBOUNDMESSAGERING_HPP_
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        /**
+         *  @brief A bounded ring of received message payloads for a single remote host.
+         *  @details Each received payload is copied exactly once into a contiguous byte ring and tracked as a span. Spans
+         *  carry their own read cursor, so partially processed payloads remain in place until every message within them
+         *  has been consumed and no further copies are made for backlogged data. The number of bytes stored is bounded at
+         *  construction, as is the number of spans unless a span limit of zero is given. A push that would exceed either
+         *  bound fails instead of growing.
+         */
+        class CInboundMessageRing
+        {
+            // Public Members
+            public:
+                //! A region of the byte ring holding a single received payload.
+                struct Span
+                {
+                    //! The offset of the payload in the byte ring.
+                    size_t mOffset;
+
+                    //! The length of the payload in bytes.
+                    size_t mLength;
+
+                    //! How far into the payload message processing has advanced.
+                    size_t mCursor;
+                };
+
+            // Private Members
+            private:
+                //! The byte storage for all payloads.
+                Common::U8* mBytes;
+
+                //! The size of mBytes.
+                const size_t mByteCapacity;
+
+                //! Where the next payload will be written in mBytes.
+                size_t mByteHead;
+
+                //! The span storage.
+                Span* mSpans;
+
+                //! The size of mSpans.
+                size_t mSpanCapacity;
+
+                //! The maximum number of spans that may be stored. Zero means no limit, in which case mSpans grows as needed.
+                const size_t mSpanLimit;
+
+                //! The index of the oldest span.
+                size_t mSpanTail;
+
+                //! The number of spans currently stored.
+                size_t mSpanCount;
+
+                //! The number of bytes currently stored, not counting any padding skipped at the end of the ring.
+                size_t mByteCount;
+
+            // Private Methods
+            private:
+                //! Doubles the size of mSpans, moving the queued spans to its start.
+                void growSpans(void);
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the bounds of the ring.
+                 *  @param spanLimit The maximum number of payloads that may be queued at once. Zero means no limit.
+                 *  @param byteCapacity The maximum number of payload bytes that may be queued at once.
+                 */
+                CInboundMessageRing(const size_t spanLimit, const size_t byteCapacity);
+
+                //! Standard destructor.
+                ~CInboundMessageRing(void);
+
+                CInboundMessageRing(const CInboundMessageRing&) = delete;
+                CInboundMessageRing& operator=(const CInboundMessageRing&) = delete;
+
+                /**
+                 *  @brief Copies a received payload into the ring.
+                 *  @param data A pointer to the payload.
+                 *  @param length The length of the payload in bytes.
+                 *  @return True if the payload was queued. False if the ring could not hold it.
+                 */
+                bool push(const void* data, const size_t length);
+
+                /**
+                 *  @brief Returns the oldest span in the ring.
+                 *  @warning The ring must not be empty.
+                 */
+                Span& front(void);
+
+                /**
+                 *  @brief Returns a pointer to the start of the payload described by the given span.
+                 *  @param span A span obtained from this ring.
+                 */
+                Common::U8* getData(const Span& span);
+
+                //! Removes the oldest span from the ring, releasing its bytes.
+                void pop(void);
+
+                //! Removes every span from the ring.
+                void clear(void);
+
+                bool isEmpty(void) const;
+
+                //! Returns the number of spans currently queued.
+                size_t getSpanCount(void) const;
+
+                //! Returns the number of payload bytes currently queued.
+                size_t getByteCount(void) const;
+        };
+    } // End NameSpace Net
+} // End NameSpace Kiaro
+#endif // _INCLUDE_NET_CINBOUNDMESSAGERING_HPP_
@@ -0,0 +1,104 @@
+/**
+ *  @file CManagementServer.hpp
+ *  @brief Include file declaring the CManagementServer class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_NET_CMANAGEMENTSERVER_HPP_
+#define _INCLUDE_NET_CMANAGEMENTSERVER_HPP_
+
+#include <support/common.hpp>
+#include <support/String.hpp>
+#include <support/Vector.hpp>
+#include <support/CManagementConsole.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        /**
+         *  @brief Serves a CManagementConsole over TCP or a Unix domain socket, so that a running server can be inspected
+         *  and tuned with nothing more than netcat.
+         *  @details Sessions are line based: every line received is evaluated as a command and answered with the console
+         *  output written while it ran, followed by a prompt. "quit" ends a session. The listener never blocks, and as
+         *  commands run inside update they run on the thread calling it, normally the main thread between frames. Output
+         *  written by other threads while a command runs is included in its answer.
+         *
+         *  The listener is built on POSIX sockets. On other platforms, constructing it throws.
+         */
+        class CManagementServer
+        {
+            // Private Members
+            private:
+                //! A connected session.
+                struct Session
+                {
+                    //! The socket of the session.
+                    Common::S32 mSocket;
+
+                    //! Received input that does not form a complete line yet.
+                    Support::String mInput;
+
+                    //! Output waiting to be sent.
+                    Support::String mOutput;
+
+                    //! Whether or not the session is closed once its output has been sent.
+                    bool mClosing;
+                };
+
+                //! The console commands are evaluated with.
+                Support::CManagementConsole* mConsole;
+
+                //! The listening socket.
+                Common::S32 mListenSocket;
+
+                //! The port we are listening on, or zero for a Unix domain socket.
+                Common::U16 mPort;
+
+                //! The path of the Unix domain socket we are listening on, removed again on destruction. Empty for TCP.
+                Support::String mSocketPath;
+
+                //! Every connected session.
+                Support::Vector<Session*> mSessions;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the console to serve and the address to listen on.
+                 *  @param console The console to evaluate commands with. It must outlive the server.
+                 *  @param address The IPv4 address to bind to, such as 127.0.0.1, or "unix:" followed by the path of a Unix
+                 *  domain socket to create.
+                 *  @param port The port to bind to. Zero picks a free one, see getPort. Ignored for Unix domain sockets.
+                 *  @throw std::runtime_error Thrown when the address is invalid or cannot be bound, or always on Windows, which has no Winsock variant yet.
+                 */
+                CManagementServer(Support::CManagementConsole* console, const Support::String& address, const Common::U16 port);
+
+                //! Standard destructor. Closes every session.
+                ~CManagementServer(void);
+
+                //! Accepts new sessions, runs every complete command line received and sends pending output without blocking.
+                void update(void);
+
+                //! Returns the port the server is listening on, or zero for a Unix domain socket.
+                Common::U16 getPort(void) const;
+
+                //! Returns the number of connected sessions.
+                size_t getSessionCount(void) const;
+
+            // Private Methods
+            private:
+                /**
+                 *  @brief Evaluates a command line received from a session and queues the output written meanwhile.
+                 *  @param session The session the line was received from.
+                 *  @param line The command line, without its line break.
+                 */
+                void runCommand(Session* session, const Support::String& line);
+        };
+    } // End NameSpace Net
+} // End NameSpace Kiaro
+#endif // _INCLUDE_NET_CMANAGEMENTSERVER_HPP_
@@ -0,0 +1,94 @@
+/**
+ *  @file CMetricsServer.hpp
+ *  @brief Include file declaring the CMetricsServer class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_NET_CMETRICSSERVER_HPP_
+#define _INCLUDE_NET_CMETRICSSERVER_HPP_
+
+#include <support/common.hpp>
+#include <support/String.hpp>
+#include <support/Vector.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        /**
+         *  @brief A tiny HTTP listener that answers GET /metrics with the contents of the SMetricsRegistry, so that Prometheus
+         *  compatible monitoring can scrape the process.
+         *  @details The listener never blocks: update accepts pending connections, reads whatever part of their requests
+         *  arrived and writes whatever part of the response fits, so it can be driven from the main loop. Every connection
+         *  serves a single request. As the metric collectors run inside update, they run on the thread calling it.
+         *
+         *  The listener is built on POSIX sockets. On other platforms, constructing it throws.
+         */
+        class CMetricsServer
+        {
+            // Private Members
+            private:
+                //! A connection that was accepted but not answered completely yet.
+                struct Connection
+                {
+                    //! The socket of the connection.
+                    Common::S32 mSocket;
+
+                    //! The part of the request received so far.
+                    Support::String mRequest;
+
+                    //! The response, once the request is complete.
+                    Support::String mResponse;
+
+                    //! The number of bytes of mResponse sent so far.
+                    size_t mSentBytes;
+
+                    //! When the connection was accepted, in milliseconds of the real clock.
+                    Common::U64 mAcceptedMS;
+                };
+
+                //! The listening socket.
+                Common::S32 mListenSocket;
+
+                //! The port we are listening on.
+                Common::U16 mPort;
+
+                //! Every connection being served.
+                Support::Vector<Connection> mConnections;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the address to listen on.
+                 *  @param address The IPv4 address to bind to, such as 127.0.0.1 or 0.0.0.0.
+                 *  @param port The port to bind to. Zero picks a free one, see getPort.
+                 *  @throw std::runtime_error Thrown when the address is invalid or cannot be bound, or always on Windows, which has no Winsock variant yet.
+                 */
+                CMetricsServer(const Support::String& address, const Common::U16 port);
+
+                //! Standard destructor. Closes every connection.
+                ~CMetricsServer(void);
+
+                //! Accepts, reads and answers whatever connections are ready without blocking.
+                void update(void);
+
+                //! Returns the port the server is listening on.
+                Common::U16 getPort(void) const;
+
+            // Private Methods
+            private:
+                /**
+                 *  @brief Builds the response to a complete request.
+                 *  @param request The request, at least up to the end of its headers.
+                 *  @return The full HTTP response.
+                 */
+                static Support::String buildResponse(const Support::String& request);
+        };
+    } // End NameSpace Net
+} // End NameSpace Kiaro
+#endif // _INCLUDE_NET_CMETRICSSERVER_HPP_
@@ -0,0 +1,217 @@
+/**
+ *  @file CNetworkConditioner.hpp
+ *  @brief Include file declaring the Net::CNetworkConditioner class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_NET_CNETWORKCONDITIONER_HPP_
+#define _INCLUDE_NET_CNETWORKCONDITIONER_HPP_
+
+#include <map>
+#include <random>
+
+#include <enet/enet.h>
+
+#include <support/common.hpp>
+#include <support/UnorderedMap.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        /**
+         *  @brief An impairment layer sitting between the netcode and ENet used to simulate poor network conditions on a single machine.
+         *  @details Outgoing packets are held back before being handed to ENet and incoming packets are held back before being handed
+         *  to the netcode. Every packet is delayed by the configured latency plus a random amount of jitter and may then be throttled
+         *  by a bandwidth cap. Unreliable packets may additionally be dropped, duplicated or held back long enough to be reordered.
+         *  Reliable packets are never dropped, duplicated or reordered since ENet would never surface that; instead a simulated loss
+         *  costs them a retransmission delay.
+         *
+         *  The random number generator is seeded from the configuration so runs are reproducible. When disabled, packets pass straight
+         *  through without being copied or queued.
+         */
+        class CNetworkConditioner
+        {
+            // Public Members
+            public:
+                //! The impairments to apply.
+                struct Parameters
+                {
+                    //! Whether or not any impairment is applied at all.
+                    bool mEnabled;
+
+                    //! The fixed one way delay in milliseconds.
+                    Common::U32 mLatencyMS;
+
+                    //! The maximum random delay in milliseconds added on top of mLatencyMS.
+                    Common::U32 mJitterMS;
+
+                    //! The chance in percent that a packet is lost.
+                    Common::U32 mLossPercent;
+
+                    //! The chance in percent that an unreliable packet is delivered twice.
+                    Common::U32 mDuplicatePercent;
+
+                    //! The chance in percent that an unreliable packet is held back long enough to arrive after later packets.
+                    Common::U32 mReorderPercent;
+
+                    //! The maximum throughput in bytes per second in each direction. Zero means no limit.
+                    Common::U32 mBandwidth;
+
+                    //! The seed for the random number generator.
+                    Common::U32 mSeed;
+                };
+
+            // Private Members
+            private:
+                //! A packet waiting to be released.
+                struct DelayedPacket
+                {
+                    //! The peer the packet is travelling to or from.
+                    ENetPeer* mPeer;
+
+                    //! The channel the packet travels on.
+                    Common::U8 mChannel;
+
+                    //! The packet itself.
+                    ENetPacket* mPacket;
+                };
+
+                //! Packets ordered by release time; packets with equal release times keep insertion order.
+                typedef std::multimap<Common::U64, DelayedPacket> DelayQueue;
+
+                //! A single direction of travel.
+                struct Direction
+                {
+                    //! Packets waiting to be released.
+                    DelayQueue mQueue;
+
+                    //! Bytes that may currently be released under the bandwidth cap.
+                    Common::F64 mTokens;
+
+                    //! The last time mTokens was refilled.
+                    Common::U64 mLastRefillMS;
+
+                    //! The latest release time handed out per peer to a reliable packet, used to keep reliable packets in order.
+                    Support::UnorderedMap<ENetPeer*, Common::U64> mLastReliableReleaseMS;
+                };
+
+                //! The current impairments.
+                Parameters mParameters;
+
+                //! The random number generator driving all impairments.
+                std::mt19937 mRandom;
+
+                //! Packets travelling from us to the remote end.
+                Direction mOutgoing;
+
+                //! Packets travelling from the remote end to us.
+                Direction mIncoming;
+
+            // Private Methods
+            private:
+                /**
+                 *  @brief Rolls against the given percentage.
+                 *  @param percent The chance of success in percent.
+                 *  @return True if the roll succeeded.
+                 */
+                bool roll(const Common::U32 percent);
+
+                /**
+                 *  @brief Queues a packet in the given direction with all impairments applied.
+                 *  @return True if the packet was queued. False if it was dropped; the packet is not destroyed in that case.
+                 */
+                bool enqueue(Direction& direction, ENetPeer* peer, const Common::U8 channel, ENetPacket* packet, const Common::U64 currentTimeMS);
+
+                /**
+                 *  @brief Pops the next packet due for release in the given direction, honoring the bandwidth cap.
+                 *  @return True if a packet was popped.
+                 */
+                bool release(Direction& direction, const Common::U64 currentTimeMS, DelayedPacket& out);
+
+                /**
+                 *  @brief Destroys every packet queued in the given direction for the given peer.
+                 *  @param peer The peer to purge. If nullptr, all packets are destroyed.
+                 */
+                static void purge(Direction& direction, ENetPeer* peer);
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Reads the impairments from the NetSimulator section of the SSettingsRegistry.
+                 *  @return The configured impairments.
+                 */
+                static Parameters getConfiguredParameters(void);
+
+                //! Parameter-less constructor. The configured impairments are used.
+                CNetworkConditioner(void);
+
+                /**
+                 *  @brief Constructor accepting the impairments to use.
+                 *  @param parameters The impairments to use.
+                 */
+                CNetworkConditioner(const Parameters& parameters);
+
+                //! Standard destructor. Any packets still queued are destroyed.
+                ~CNetworkConditioner(void);
+
+                /**
+                 *  @brief Replaces the current impairments. Packets already queued keep their release times.
+                 *  @param parameters The new impairments to use.
+                 */
+                void setParameters(const Parameters& parameters);
+
+                const Parameters& getParameters(void) const;
+
+                /**
+                 *  @brief Hands a packet to ENet, possibly after a delay.
+                 *  @param peer The peer to send to.
+                 *  @param channel The channel to send on.
+                 *  @param packet The packet to send. Ownership is taken in all cases.
+                 *  @param currentTimeMS The current time in milliseconds.
+                 */
+                void send(ENetPeer* peer, const Common::U8 channel, ENetPacket* packet, const Common::U64 currentTimeMS);
+
+                /**
+                 *  @brief Offers a packet received from ENet to the conditioner.
+                 *  @param peer The peer the packet was received from.
+                 *  @param channel The channel the packet arrived on.
+                 *  @param packet The received packet.
+                 *  @param currentTimeMS The current time in milliseconds.
+                 *  @return True if the conditioner took ownership of the packet, in which case it will later be returned by popIncoming
+                 *  or was dropped. False if the packet should be processed immediately.
+                 */
+                bool receive(ENetPeer* peer, const Common::U8 channel, ENetPacket* packet, const Common::U64 currentTimeMS);
+
+                /**
+                 *  @brief Pops the next received packet that is due for processing.
+                 *  @param currentTimeMS The current time in milliseconds.
+                 *  @param peer Set to the peer the packet was received from.
+                 *  @param packet Set to the packet. The caller takes ownership.
+                 *  @return True if a packet was popped.
+                 */
+                bool popIncoming(const Common::U64 currentTimeMS, ENetPeer*& peer, ENetPacket*& packet);
+
+                /**
+                 *  @brief Hands every outgoing packet that is due to ENet.
+                 *  @param currentTimeMS The current time in milliseconds.
+                 */
+                void flushOutgoing(const Common::U64 currentTimeMS);
+
+                /**
+                 *  @brief Destroys every packet queued to or from the given peer. Call this when a peer disconnects.
+                 *  @param peer The peer to purge.
+                 */
+                void purge(ENetPeer* peer);
+
+                //! Returns the number of packets currently held back in both directions.
+                size_t getQueuedPacketCount(void) const;
+        };
+    } // End NameSpace Net
+} // End NameSpace Kiaro
+#endif // _INCLUDE_NET_CNETWORKCONDITIONER_HPP_
@@ -0,0 +1,189 @@
+/**
+ *  @file CNetworkStats.hpp
+ *  @brief Include file declaring the Net::CNetworkStats class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_NET_CNETWORKSTATS_HPP_
+#define _INCLUDE_NET_CNETWORKSTATS_HPP_
+
+#include <enet/enet.h>
+
+#include <support/common.hpp>
+#include <support/String.hpp>
+#include <support/Map.hpp>
+#include <support/CBitStream.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        /**
+         *  @brief Statistics gathered for a single network connection.
+         *  @details Link quality figures (round trip time, packet loss, data in transit) are sampled from the ENet peer while byte,
+         *  packet and per message type totals are accumulated by the netcode itself as data is sent and received. Throughput is
+         *  derived from the accumulated byte totals once per NETSTATS_SAMPLE_INTERVAL_MS.
+         */
+        class CNetworkStats
+        {
+            // Public Members
+            public:
+                //! Totals kept for a single message type.
+                struct MessageTypeStats
+                {
+                    //! The number of messages of this type sent.
+                    Common::U64 mSentCount;
+
+                    //! The number of bytes sent in messages of this type.
+                    Common::U64 mSentBytes;
+
+                    //! The number of messages of this type received.
+                    Common::U64 mReceivedCount;
+
+                    //! The number of bytes received in messages of this type.
+                    Common::U64 mReceivedBytes;
+                };
+
+            // Private Members
+            private:
+                //! The mean round trip time in milliseconds as reported by ENet.
+                Common::U32 mRoundTripTimeMS;
+
+                //! The round trip time variance in milliseconds as reported by ENet.
+                Common::U32 mRoundTripTimeVarianceMS;
+
+                //! The packet loss ratio of reliable traffic in the range [0, 1] as reported by ENet.
+                Common::F32 mPacketLoss;
+
+                //! The number of reliable bytes sent but not yet acknowledged.
+                Common::U32 mReliableBytesInTransit;
+
+                //! The number of received payloads waiting to be processed.
+                Common::U32 mQueuedIncomingPackets;
+
+                //! The number of received bytes waiting to be processed.
+                Common::U32 mQueuedIncomingBytes;
+
+                //! Total packets sent.
+                Common::U64 mPacketsSent;
+
+                //! Total packets received.
+                Common::U64 mPacketsReceived;
+
+                //! Total bytes sent.
+                Common::U64 mBytesSent;
+
+                //! Total bytes received.
+                Common::U64 mBytesReceived;
+
+                //! Outgoing throughput over the last sample window in bytes per second.
+                Common::F32 mOutgoingBytesPerSecond;
+
+                //! Incoming throughput over the last sample window in bytes per second.
+                Common::F32 mIncomingBytesPerSecond;
+
+                //! The time the current throughput sample window was opened.
+                Common::U64 mSampleStartMS;
+
+                //! The value of mBytesSent when the current sample window was opened.
+                Common::U64 mSampleStartBytesSent;
+
+                //! The value of mBytesReceived when the current sample window was opened.
+                Common::U64 mSampleStartBytesReceived;
+
+                //! Totals per message type ID.
+                Support::Map<Common::U32, MessageTypeStats> mMessageTypes;
+
+            // Public Methods
+            public:
+                //! Parameter-less constructor.
+                CNetworkStats(void);
+
+                /**
+                 *  @brief Samples the link quality figures from the given peer and updates throughput if the sample window has elapsed.
+                 *  @param peer The ENet peer of the connection. If nullptr, only throughput is updated.
+                 *  @param currentTimeMS The current time in milliseconds.
+                 */
+                void sample(const ENetPeer* peer, const Common::U64 currentTimeMS);
+
+                /**
+                 *  @brief Records a packet handed to ENet for sending.
+                 *  @param bytes The size of the packet in bytes.
+                 */
+                void recordSentPacket(const size_t bytes);
+
+                /**
+                 *  @brief Records a packet received from ENet.
+                 *  @param bytes The size of the packet in bytes.
+                 */
+                void recordReceivedPacket(const size_t bytes);
+
+                /**
+                 *  @brief Records a message written for sending.
+                 *  @param type The message type ID.
+                 *  @param bytes The size of the packed message in bytes.
+                 */
+                void recordSentMessage(const Common::U32 type, const size_t bytes);
+
+                /**
+                 *  @brief Records a message that was just packed into the given stream, reading its type ID from the message header.
+                 *  @param stream The stream the message was packed into.
+                 *  @param messageStart The position in the stream at which the message begins.
+                 */
+                void recordSentMessage(Support::CBitStream& stream, const size_t messageStart);
+
+                /**
+                 *  @brief Records a message that was processed.
+                 *  @param type The message type ID.
+                 *  @param bytes The size of the message in bytes.
+                 */
+                void recordReceivedMessage(const Common::U32 type, const size_t bytes);
+
+                /**
+                 *  @brief Sets the current depth of the connection's inbound queue.
+                 *  @param packets The number of payloads waiting.
+                 *  @param bytes The number of bytes waiting.
+                 */
+                void setIncomingQueueDepth(const Common::U32 packets, const Common::U32 bytes);
+
+                //! Resets all accumulated totals. Sampled link quality figures are kept.
+                void reset(void);
+
+                Common::U32 getRoundTripTimeMS(void) const;
+                Common::U32 getRoundTripTimeVarianceMS(void) const;
+                Common::F32 getPacketLoss(void) const;
+                Common::U32 getReliableBytesInTransit(void) const;
+                Common::U32 getQueuedIncomingPackets(void) const;
+                Common::U32 getQueuedIncomingBytes(void) const;
+                Common::U64 getPacketsSent(void) const;
+                Common::U64 getPacketsReceived(void) const;
+                Common::U64 getBytesSent(void) const;
+                Common::U64 getBytesReceived(void) const;
+                Common::F32 getOutgoingBytesPerSecond(void) const;
+                Common::F32 getIncomingBytesPerSecond(void) const;
+                const Support::Map<Common::U32, MessageTypeStats>& getMessageTypeStats(void) const;
+
+                //! Returns the number of packets sent by every connection of the process so far.
+                static Common::U64 getTotalPacketsSent(void);
+                //! Returns the number of packets received by every connection of the process so far.
+                static Common::U64 getTotalPacketsReceived(void);
+                //! Returns the number of bytes sent by every connection of the process so far.
+                static Common::U64 getTotalBytesSent(void);
+                //! Returns the number of bytes received by every connection of the process so far.
+                static Common::U64 getTotalBytesReceived(void);
+
+                /**
+                 *  @brief Writes a summary of the statistics to the console.
+                 *  @param name The name to identify the connection with.
+                 *  @param detailed Whether or not to include the per message type breakdown.
+                 */
+                void print(const Support::String& name, const bool detailed) const;
+        };
+    } // End NameSpace Net
+} // End NameSpace Kiaro
+#endif // _INCLUDE_NET_CNETWORKSTATS_HPP_
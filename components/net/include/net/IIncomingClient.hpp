@@ -20,6 +20,7 @@
 #include <support/types.hpp>
 
 #include <net/stages.hpp>
+#include <net/CNetworkStats.hpp>
 
 namespace Kiaro
 {
@@ -46,6 +47,9 @@ namespace Kiaro
                 //! A pointer to the internally used ENet peer.
                 ENetPeer* mInternalClient;
 
+                //! The server this client is connected to.
+                IServer* mServer;
+
                 //! A boolean representing whether or not this CIncomingClient has the opposite endianness.
                 bool mIsOppositeEndian;
 
@@ -64,6 +68,14 @@ namespace Kiaro
 
                 Support::CBitStream mUnreliableStream;
 
+                //! Statistics gathered for this connection.
+                CNetworkStats mStats;
+
+            // Private Methods
+            private:
+                //! Hands a packet to the server for sending, or directly to ENet if we have no server.
+                void sendPacket(ENetPacket* packet);
+
             // Public Methods
             public:
                 /**
@@ -140,6 +152,18 @@ namespace Kiaro
                  *  streams.
                  */
                 void dispatchQueuedMessages(void);
+
+                /**
+                 *  @brief Returns the statistics gathered for this connection.
+                 *  @return A reference to the connection statistics.
+                 */
+                CNetworkStats& getStats(void);
+
+                /**
+                 *  @brief Samples the link quality figures of this connection from ENet.
+                 *  @param currentTimeMS The current time in milliseconds.
+                 */
+                void updateStats(const Common::U64 currentTimeMS);
         };
     } // End Namespace Network
 } // End Namespace Kiaro
@@ -17,6 +17,8 @@
 
 //#include <game/SGameWorld.hpp>
 #include <net/IServer.hpp>
+#include <net/CNetworkStats.hpp>
+#include <net/CNetworkConditioner.hpp>
 
 #include <support/CBitStream.hpp>
 
@@ -41,9 +43,6 @@ namespace Kiaro
         {
             // Protected Members
             protected:
-                //! A pointer to the scheduled event for our update pulse.
-                Support::CScheduledEvent* mUpdatePulse;
-
                 //! Whether or not the server we are currently connected to has opposite endianness than us.
                 bool mOppositeEndian;
 
@@ -70,6 +69,12 @@ namespace Kiaro
 
                 Support::CBitStream mOutgoingStream;
 
+                //! Statistics gathered for the connection to the remote server.
+                CNetworkStats mStats;
+
+                //! The network condition simulator all traffic passes through.
+                CNetworkConditioner mConditioner;
+
             // Public Methods
             public:
                 /**
@@ -99,6 +104,9 @@ namespace Kiaro
                  */
                 virtual void onConnectFailed(void) = 0;
 
+                //! Callback method called at the start of every update pulse while connected. Does nothing by default.
+                virtual void onUpdate(void);
+
                 /**
                  *  @brief Pure virtual callback method for when a packet has been received by the internal
                  *  IOutgoingClient implementation.
@@ -130,6 +138,11 @@ namespace Kiaro
                  */
                 Common::U16 getPort(void) const NOEXCEPT;
 
+                /**
+                 *  @brief Services the connection, dispatching received packets and flushing outgoing traffic. The owner
+                 *  calls this once per simulation tick for as long as the client exists, including after disconnecting so
+                 *  that the disconnect completes.
+                 */
                 void update(void);
 
                 void send(IMessage* packet, const bool reliable);
@@ -141,6 +154,14 @@ namespace Kiaro
                  */
                 bool isConnected(void);
 
+                /**
+                 *  @brief Returns the statistics gathered for the connection to the remote server.
+                 *  @return A reference to the connection statistics.
+                 */
+                CNetworkStats& getStats(void);
+
+                CNetworkConditioner& getConditioner(void);
+
                 /**
                  *  @brief Dispatches any queued packets so that they are sent to their intended destinations
                  *  immediately instead of waiting for the next network update.
@@ -162,6 +183,9 @@ namespace Kiaro
                  */
                 void processPacket(Support::CBitStream& incomingStream);
 
+                //! Processes and then destroys a packet received from the remote server.
+                void receivePacket(ENetPacket* packet);
+
                 //! Internally called method when the IOutgoingClient connected to a remote host.
                 void internalOnConnected(void);
         };
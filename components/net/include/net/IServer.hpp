@@ -18,6 +18,8 @@
 #include <support/String.hpp>
 #include <support/CBitStream.hpp>
 
+#include <net/CNetworkConditioner.hpp>
+
 #include "support/common.hpp"
 
 namespace Kiaro
@@ -70,6 +72,9 @@ namespace Kiaro
                 //! The internally used E-Net host object that represents our server.
                 ENetHost* mInternalHost;
 
+                //! The network condition simulator all traffic passes through.
+                CNetworkConditioner mConditioner;
+
             // Public Methods
             public:
                 /**
@@ -125,6 +130,16 @@ namespace Kiaro
 
                 virtual void onReceivePacket(Support::CBitStream& in, Net::IIncomingClient* sender) = 0;
 
+                /**
+                 *  @brief Hands a packet to the given peer by way of the network condition simulator.
+                 *  @param peer The peer to send to.
+                 *  @param channel The channel to send on.
+                 *  @param packet The packet to send. Ownership is taken.
+                 */
+                void sendPacket(ENetPeer* peer, const Common::U8 channel, ENetPacket* packet);
+
+                CNetworkConditioner& getConditioner(void);
+
             // Protected Methods
             protected:
                 /**
@@ -145,6 +160,9 @@ namespace Kiaro
             // Private Methods
             protected:
                 void processPacket(Support::CBitStream& incomingStream, Net::IIncomingClient* sender);
+
+                //! Processes and then destroys a packet received from the given peer.
+                void receivePacket(ENetPeer* peer, ENetPacket* packet);
         };
     } // End Namespace Network
 } // End Namespace Kiaro
@@ -0,0 +1,127 @@
+/**
+ *  @file SHTTPClient.hpp
+ *  @brief Include file declaring the SHTTPClient singleton class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_NET_SHTTPCLIENT_HPP_
+#define _INCLUDE_NET_SHTTPCLIENT_HPP_
+
+#include <functional>
+
+#include <curl/curl.h>
+
+#include <support/ISingleton.hpp>
+#include <support/SSynchronousScheduler.hpp>
+#include <support/UnorderedMap.hpp>
+#include <support/Vector.hpp>
+
+#include <net/CHTTPObject.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        /**
+         *  @brief The SHTTPClient is a singleton that performs CHTTPObject requests asynchronously using a single CURL multi handle.
+         *  @details Transfers are advanced by a recurring SSynchronousScheduler event without ever blocking, so completion callbacks
+         *  are always raised on the main thread. Connections are kept alive in the multi handle's connection cache and easy handles
+         *  are recycled, so repeated requests against the same host (such as master server heartbeats) reuse their connection.
+         *  @warning The SHTTPClient is not thread safe; only use it from the main thread.
+         */
+        class SHTTPClient : public Support::ISingleton<SHTTPClient>
+        {
+            // Public Members
+            public:
+                /**
+                 *  @brief The callback type raised when a request completes.
+                 *  @param request The request that completed.
+                 *  @param success Whether or not the transfer completed. This does not take the HTTP status code into account.
+                 */
+                typedef std::function<void(CHTTPObject* request, const bool success)> CompletionCallback;
+
+            // Private Members
+            private:
+                //! A request that is currently being serviced.
+                struct HTTPTransfer
+                {
+                    //! The easy handle performing the transfer.
+                    CURL* mHandle;
+
+                    //! The header list in use by mHandle.
+                    curl_slist* mHeaders;
+
+                    //! The callback to raise on completion.
+                    CompletionCallback mCallback;
+                };
+
+                //! The multi handle driving all transfers.
+                CURLM* mMultiHandle;
+
+                //! Easy handles that have completed their transfers and are waiting to be reused.
+                Support::Vector<CURL*> mIdleHandles;
+
+                //! All requests currently being serviced.
+                Support::UnorderedMap<CHTTPObject*, HTTPTransfer> mTransfers;
+
+                //! Scheduled event created for use with the SSynchronousScheduler.
+                Support::CScheduledEvent* mUpdatePulse;
+
+            // Private Methods
+            private:
+                /**
+                 *  @brief Removes a transfer from the multi handle and recycles its easy handle.
+                 *  @param transfer The transfer to release.
+                 */
+                void releaseTransfer(HTTPTransfer& transfer);
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Begins performing the given request without blocking.
+                 *  @param request The request to perform. The SHTTPClient does not take ownership of the request; it must remain valid until
+                 *  the completion callback has been raised or the request has been cancelled.
+                 *  @param callback The callback to raise on the main thread once the request completes. May be empty.
+                 *  @throw std::runtime_error Thrown if the request is already pending.
+                 *  @throw std::out_of_range Thrown if the request type is unknown.
+                 */
+                void dispatch(CHTTPObject* request, CompletionCallback callback = CompletionCallback());
+
+                /**
+                 *  @brief Aborts a pending request. Its completion callback will not be raised.
+                 *  @param request The request to abort.
+                 *  @return True if the request was pending. False otherwise.
+                 */
+                bool cancel(CHTTPObject* request);
+
+                /**
+                 *  @brief Returns whether or not the given request is currently being serviced.
+                 *  @param request The request to check.
+                 */
+                bool isPending(CHTTPObject* request) const;
+
+                //! Returns the number of requests currently being serviced.
+                size_t getPendingCount(void) const;
+
+                /**
+                 *  @brief Advances all pending transfers and raises the completion callbacks of any that have finished. This is called
+                 *  automatically by the SSynchronousScheduler.
+                 */
+                void update(void);
+
+            // Protected Methods
+            protected:
+                //! Parameter-less constructor.
+                SHTTPClient(void);
+
+                //! Standard destructor.
+                ~SHTTPClient(void);
+        };
+    } // End NameSpace Net
+} // End NameSpace Kiaro
+#endif // _INCLUDE_NET_SHTTPCLIENT_HPP_
@@ -16,4 +16,43 @@
 #define NETSTREAM_DEFAULT_SIZE 256
 #define NETSTREAM_RESIZE_FACTOR 256
 
+//! The length in milliseconds of the window that CNetworkStats measures throughput over.
+#define NETSTATS_SAMPLE_INTERVAL_MS 1000
+
+//! How often in milliseconds the SHTTPClient services its pending transfers.
+#define HTTPCLIENT_UPDATE_INTERVAL_MS 16
+
+//! The maximum number of idle CURL easy handles the SHTTPClient keeps around for reuse.
+#define HTTPCLIENT_MAX_IDLE_HANDLES 8
+
+//! The additional delay in milliseconds applied to unreliable packets the CNetworkConditioner chooses to reorder.
+#define NETCONDITIONER_REORDER_DELAY_MS 20
+
+//! How long in milliseconds the CNetworkConditioner's bandwidth cap may burst for after being idle.
+#define NETCONDITIONER_BURST_MS 100
+
+//! How often in milliseconds the CMetricsServer services its connections.
+#define METRICSSERVER_UPDATE_INTERVAL_MS 50
+
+//! The maximum number of connections the CMetricsServer serves at once. Further connections are closed right away.
+#define METRICSSERVER_MAX_CONNECTIONS 8
+
+//! The largest request in bytes the CMetricsServer accepts.
+#define METRICSSERVER_MAX_REQUEST_BYTES 8192
+
+//! How long in milliseconds a CMetricsServer connection may take before it is closed.
+#define METRICSSERVER_TIMEOUT_MS 5000
+
+//! How often in milliseconds the CManagementServer services its sessions, and so how soon management commands run.
+#define MANAGEMENTSERVER_UPDATE_INTERVAL_MS 50
+
+//! The maximum number of sessions the CManagementServer serves at once. Further connections are closed right away.
+#define MANAGEMENTSERVER_MAX_SESSIONS 4
+
+//! The longest command line in bytes the CManagementServer accepts. Sessions sending longer lines are closed.
+#define MANAGEMENTSERVER_MAX_LINE_BYTES 4096
+
+//! The most output in bytes a CManagementServer session may have waiting to be sent. Output beyond that is discarded.
+#define MANAGEMENTSERVER_MAX_OUTPUT_BYTES 1048576
+
 #endif // _INCLUDE_NET_CONFIG_HPP_
@@ -0,0 +1,313 @@
+/**
+ *  @file CManagementServer.cpp
+ *  @brief Source file implementing the CManagementServer class methods with POSIX sockets.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include <support/Console.hpp>
+#include <support/types.hpp>
+
+#include <net/config.hpp>
+#include <net/CManagementServer.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        //! Guards sCaptureTarget, which the console thread appends to.
+        static Support::Mutex sCaptureMutex;
+
+        //! The output of the session whose command is running, if any.
+        static Support::String* sCaptureTarget = nullptr;
+
+        //! Console responder appending everything written while a command runs to the output of its session.
+        static void captureOutput(Support::Console::MESSAGE_TYPE type, const Support::String& message)
+        {
+            std::lock_guard<Support::Mutex> lock(sCaptureMutex);
+
+            if (sCaptureTarget && sCaptureTarget->size() + message.size() < MANAGEMENTSERVER_MAX_OUTPUT_BYTES)
+            {
+                *sCaptureTarget += "(";
+                *sCaptureTarget += Support::Console::messageTypeText(type);
+                *sCaptureTarget += ") ";
+                *sCaptureTarget += message;
+                *sCaptureTarget += "\n";
+            }
+        }
+
+        //! Puts the given socket into non blocking mode.
+        static bool setNonBlocking(const Common::S32 socketHandle)
+        {
+            const Common::S32 flags = fcntl(socketHandle, F_GETFL, 0);
+            return flags >= 0 && fcntl(socketHandle, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+
+        CManagementServer::CManagementServer(Support::CManagementConsole* console, const Support::String& address, const Common::U16 port) : mConsole(console),
+        mListenSocket(-1), mPort(port)
+        {
+            static const Support::String unixPrefix = "unix:";
+
+            sockaddr_storage bindAddress;
+            socklen_t bindAddressLength = 0;
+            memset(&bindAddress, 0x00, sizeof(bindAddress));
+
+            if (address.compare(0, unixPrefix.size(), unixPrefix) == 0)
+            {
+                sockaddr_un& unixAddress = reinterpret_cast<sockaddr_un&>(bindAddress);
+                const Support::String path = address.substr(unixPrefix.size());
+
+                if (path.empty() || path.size() >= sizeof(unixAddress.sun_path))
+                {
+                    throw std::runtime_error("CManagementServer: Invalid socket path '" + path + "'.");
+                }
+
+                unixAddress.sun_family = AF_UNIX;
+                memcpy(unixAddress.sun_path, path.data(), path.size());
+                bindAddressLength = sizeof(sockaddr_un);
+
+                // A previous run may have left its socket behind
+                unlink(path.data());
+                mSocketPath = path;
+                mPort = 0;
+            }
+            else
+            {
+                sockaddr_in& inetAddress = reinterpret_cast<sockaddr_in&>(bindAddress);
+                inetAddress.sin_family = AF_INET;
+                inetAddress.sin_port = htons(port);
+                bindAddressLength = sizeof(sockaddr_in);
+
+                if (inet_pton(AF_INET, address.data(), &inetAddress.sin_addr) != 1)
+                {
+                    throw std::runtime_error("CManagementServer: Invalid bind address '" + address + "'.");
+                }
+            }
+
+            mListenSocket = socket(bindAddress.ss_family, SOCK_STREAM, 0);
+
+            if (mSocketPath.empty())
+            {
+                const Common::S32 reuseAddress = 1;
+                setsockopt(mListenSocket, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+            }
+
+            // Unix domain sockets are only usable by the user running the engine
+            if (mListenSocket < 0 || bind(mListenSocket, reinterpret_cast<sockaddr*>(&bindAddress), bindAddressLength) != 0 ||
+                (!mSocketPath.empty() && chmod(mSocketPath.data(), S_IRUSR | S_IWUSR) != 0) || listen(mListenSocket, MANAGEMENTSERVER_MAX_SESSIONS) != 0 ||
+                !setNonBlocking(mListenSocket))
+            {
+                const Support::String reason = strerror(errno);
+
+                if (mListenSocket >= 0)
+                {
+                    close(mListenSocket);
+                }
+
+                throw std::runtime_error("CManagementServer: Failed to listen on " + address + ": " + reason);
+            }
+
+            if (mSocketPath.empty())
+            {
+                getsockname(mListenSocket, reinterpret_cast<sockaddr*>(&bindAddress), &bindAddressLength);
+                mPort = ntohs(reinterpret_cast<sockaddr_in&>(bindAddress).sin_port);
+
+                CONSOLE_INFOF("Management console listening on %s:%u.", address.data(), mPort);
+            }
+            else
+            {
+                CONSOLE_INFOF("Management console listening on %s.", mSocketPath.data());
+            }
+
+            // The responder is shared by every server and only captures while a command runs
+            static std::once_flag registerCapture;
+            std::call_once(registerCapture, []()
+            {
+                const Support::Console::MESSAGE_TYPE types[] = { Support::Console::MESSAGE_INFO, Support::Console::MESSAGE_WARNING, Support::Console::MESSAGE_ERROR,
+                                                                 Support::Console::MESSAGE_FATAL, Support::Console::MESSAGE_DEBUG };
+
+                for (const Support::Console::MESSAGE_TYPE type : types)
+                {
+                    Support::Console::registerListener(captureOutput, type);
+                }
+            });
+        }
+
+        CManagementServer::~CManagementServer(void)
+        {
+            for (Session* session : mSessions)
+            {
+                close(session->mSocket);
+                delete session;
+            }
+
+            close(mListenSocket);
+
+            if (!mSocketPath.empty())
+            {
+                unlink(mSocketPath.data());
+            }
+        }
+
+        void CManagementServer::runCommand(Session* session, const Support::String& line)
+        {
+            {
+                std::lock_guard<Support::Mutex> lock(sCaptureMutex);
+                sCaptureTarget = &session->mOutput;
+            }
+
+            try
+            {
+                mConsole->eval(line);
+            }
+            catch (std::exception& e)
+            {
+                CONSOLE_ERRORF("Command failed: %s", e.what());
+            }
+
+            // Everything the command wrote has to pass through the console thread first
+            Support::Console::flush();
+
+            std::lock_guard<Support::Mutex> lock(sCaptureMutex);
+            sCaptureTarget = nullptr;
+            session->mOutput += "> ";
+        }
+
+        void CManagementServer::update(void)
+        {
+            // Accept everything that is pending
+            while (true)
+            {
+                const Common::S32 socketHandle = accept(mListenSocket, nullptr, nullptr);
+
+                if (socketHandle < 0)
+                {
+                    break;
+                }
+
+                if (mSessions.size() >= MANAGEMENTSERVER_MAX_SESSIONS || !setNonBlocking(socketHandle))
+                {
+                    static const Common::C8 refusal[] = "Too many management sessions.\n";
+                    send(socketHandle, refusal, sizeof(refusal) - 1, MSG_NOSIGNAL);
+                    close(socketHandle);
+                    continue;
+                }
+
+                Session* session = new Session();
+                session->mSocket = socketHandle;
+                session->mClosing = false;
+                session->mOutput = "Management console. Type 'help' for a list of commands and 'quit' to leave.\n> ";
+                mSessions.push_back(session);
+            }
+
+            for (auto iterator = mSessions.begin(); iterator != mSessions.end();)
+            {
+                Session* session = *iterator;
+                bool disconnected = false;
+
+                // Read whatever arrived and run every complete line
+                while (!session->mClosing)
+                {
+                    Common::C8 chunk[1024];
+                    const ssize_t received = recv(session->mSocket, chunk, sizeof(chunk), 0);
+
+                    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        break;
+                    }
+                    else if (received <= 0)
+                    {
+                        disconnected = true;
+                        break;
+                    }
+
+                    session->mInput.append(chunk, received);
+
+                    size_t lineEnd;
+                    while (!session->mClosing && (lineEnd = session->mInput.find('\n')) != Support::String::npos)
+                    {
+                        Support::String line = session->mInput.substr(0, lineEnd);
+                        session->mInput.erase(0, lineEnd + 1);
+
+                        if (!line.empty() && line.back() == '\r')
+                        {
+                            line.pop_back();
+                        }
+
+                        if (line == "quit" || line == "exit")
+                        {
+                            session->mOutput += "Goodbye.\n";
+                            session->mClosing = true;
+                        }
+                        else
+                        {
+                            this->runCommand(session, line);
+                        }
+                    }
+
+                    if (session->mInput.size() > MANAGEMENTSERVER_MAX_LINE_BYTES)
+                    {
+                        session->mOutput += "Command line too long.\n";
+                        session->mClosing = true;
+                    }
+                }
+
+                // Write as much of the output as fits
+                while (!disconnected && !session->mOutput.empty())
+                {
+                    const ssize_t sent = send(session->mSocket, session->mOutput.data(), session->mOutput.size(), MSG_NOSIGNAL);
+
+                    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        break;
+                    }
+                    else if (sent <= 0)
+                    {
+                        disconnected = true;
+                        break;
+                    }
+
+                    session->mOutput.erase(0, sent);
+                }
+
+                if (disconnected || (session->mClosing && session->mOutput.empty()))
+                {
+                    close(session->mSocket);
+                    delete session;
+                    iterator = mSessions.erase(iterator);
+                }
+                else
+                {
+                    ++iterator;
+                }
+            }
+        }
+
+        Common::U16 CManagementServer::getPort(void) const
+        {
+            return mPort;
+        }
+
+        size_t CManagementServer::getSessionCount(void) const
+        {
+            return mSessions.size();
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
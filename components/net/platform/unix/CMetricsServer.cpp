@@ -0,0 +1,212 @@
+/**
+ *  @file CMetricsServer.cpp
+ *  @brief Source file implementing the CMetricsServer class methods with POSIX sockets.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <support/Console.hpp>
+#include <support/FTime.hpp>
+#include <support/SMetricsRegistry.hpp>
+
+#include <net/config.hpp>
+#include <net/CMetricsServer.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        //! Puts the given socket into non blocking mode.
+        static bool setNonBlocking(const Common::S32 socketHandle)
+        {
+            const Common::S32 flags = fcntl(socketHandle, F_GETFL, 0);
+            return flags >= 0 && fcntl(socketHandle, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+
+        CMetricsServer::CMetricsServer(const Support::String& address, const Common::U16 port) : mListenSocket(-1), mPort(port)
+        {
+            sockaddr_in bindAddress;
+            memset(&bindAddress, 0x00, sizeof(bindAddress));
+            bindAddress.sin_family = AF_INET;
+            bindAddress.sin_port = htons(port);
+
+            if (inet_pton(AF_INET, address.data(), &bindAddress.sin_addr) != 1)
+            {
+                throw std::runtime_error("CMetricsServer: Invalid bind address '" + address + "'.");
+            }
+
+            mListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+
+            const Common::S32 reuseAddress = 1;
+            setsockopt(mListenSocket, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+
+            if (mListenSocket < 0 || bind(mListenSocket, reinterpret_cast<sockaddr*>(&bindAddress), sizeof(bindAddress)) != 0 ||
+                listen(mListenSocket, METRICSSERVER_MAX_CONNECTIONS) != 0 || !setNonBlocking(mListenSocket))
+            {
+                const Support::String reason = strerror(errno);
+
+                if (mListenSocket >= 0)
+                {
+                    close(mListenSocket);
+                }
+
+                throw std::runtime_error("CMetricsServer: Failed to listen on " + address + ":" + std::to_string(port) + ": " + reason);
+            }
+
+            socklen_t addressLength = sizeof(bindAddress);
+            getsockname(mListenSocket, reinterpret_cast<sockaddr*>(&bindAddress), &addressLength);
+            mPort = ntohs(bindAddress.sin_port);
+
+            CONSOLE_INFOF("Serving metrics on %s:%u.", address.data(), mPort);
+        }
+
+        CMetricsServer::~CMetricsServer(void)
+        {
+            for (Connection& connection : mConnections)
+            {
+                close(connection.mSocket);
+            }
+
+            close(mListenSocket);
+        }
+
+        Support::String CMetricsServer::buildResponse(const Support::String& request)
+        {
+            Support::String status = "200 OK";
+            Support::String contentType = "text/plain; version=0.0.4; charset=utf-8";
+            Support::String body;
+
+            // Only the request line matters; any query string is ignored
+            const Support::String requestLine = request.substr(0, request.find("\r\n"));
+
+            if (requestLine.compare(0, 4, "GET ") != 0)
+            {
+                status = "405 Method Not Allowed";
+                contentType = "text/plain";
+                body = "Only GET is supported.\n";
+            }
+            else if (requestLine.compare(4, 9, "/metrics ") != 0 && requestLine.compare(4, 9, "/metrics?") != 0)
+            {
+                status = "404 Not Found";
+                contentType = "text/plain";
+                body = "Metrics are served at /metrics.\n";
+            }
+            else
+            {
+                body = Support::SMetricsRegistry::getInstance()->exportText();
+            }
+
+            Support::String response = "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType + "\r\nContent-Length: " + std::to_string(body.size());
+            response += "\r\nConnection: close\r\n\r\n";
+            response += body;
+            return response;
+        }
+
+        void CMetricsServer::update(void)
+        {
+            // Accept everything that is pending
+            while (true)
+            {
+                const Common::S32 socketHandle = accept(mListenSocket, nullptr, nullptr);
+
+                if (socketHandle < 0)
+                {
+                    break;
+                }
+
+                if (mConnections.size() >= METRICSSERVER_MAX_CONNECTIONS || !setNonBlocking(socketHandle))
+                {
+                    close(socketHandle);
+                    continue;
+                }
+
+                Connection connection;
+                connection.mSocket = socketHandle;
+                connection.mSentBytes = 0;
+                connection.mAcceptedMS = Support::FTime::getNanoseconds() / 1000000ULL;
+                mConnections.push_back(connection);
+            }
+
+            const Common::U64 currentTimeMS = Support::FTime::getNanoseconds() / 1000000ULL;
+
+            for (auto iterator = mConnections.begin(); iterator != mConnections.end();)
+            {
+                Connection& connection = *iterator;
+                bool finished = currentTimeMS - connection.mAcceptedMS >= METRICSSERVER_TIMEOUT_MS;
+
+                // Read until the headers are complete. Requests we serve have no body.
+                while (!finished && connection.mResponse.empty())
+                {
+                    Common::C8 chunk[1024];
+                    const ssize_t received = recv(connection.mSocket, chunk, sizeof(chunk), 0);
+
+                    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        break;
+                    }
+                    else if (received <= 0 || connection.mRequest.size() + received > METRICSSERVER_MAX_REQUEST_BYTES)
+                    {
+                        finished = true;
+                        break;
+                    }
+
+                    connection.mRequest.append(chunk, received);
+
+                    if (connection.mRequest.find("\r\n\r\n") != Support::String::npos)
+                    {
+                        connection.mResponse = buildResponse(connection.mRequest);
+                    }
+                }
+
+                // Write as much of the response as fits
+                while (!finished && !connection.mResponse.empty())
+                {
+                    const ssize_t sent = send(connection.mSocket, connection.mResponse.data() + connection.mSentBytes, connection.mResponse.size() - connection.mSentBytes,
+                                              MSG_NOSIGNAL);
+
+                    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        break;
+                    }
+                    else if (sent <= 0)
+                    {
+                        finished = true;
+                        break;
+                    }
+
+                    connection.mSentBytes += sent;
+                    finished = connection.mSentBytes == connection.mResponse.size();
+                }
+
+                if (finished)
+                {
+                    close(connection.mSocket);
+                    iterator = mConnections.erase(iterator);
+                }
+                else
+                {
+                    ++iterator;
+                }
+            }
+        }
+
+        Common::U16 CMetricsServer::getPort(void) const
+        {
+            return mPort;
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
@@ -0,0 +1,47 @@
+/**
+ *  @file CManagementServer.cpp
+ *  @brief Source file implementing the CManagementServer class methods on platforms without POSIX sockets.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <net/CManagementServer.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        CManagementServer::CManagementServer(Support::CManagementConsole* console, const Support::String&, const Common::U16 port) : mConsole(console),
+        mListenSocket(-1), mPort(port)
+        {
+            // The listener is written against POSIX sockets; there is no Winsock variant yet
+            throw std::runtime_error("CManagementServer: Serving the management console requires POSIX sockets, which this platform lacks.");
+        }
+
+        CManagementServer::~CManagementServer(void)
+        {
+
+        }
+
+        void CManagementServer::update(void)
+        {
+
+        }
+
+        Common::U16 CManagementServer::getPort(void) const
+        {
+            return mPort;
+        }
+
+        size_t CManagementServer::getSessionCount(void) const
+        {
+            return mSessions.size();
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
@@ -0,0 +1,41 @@
+/**
+ *  @file CMetricsServer.cpp
+ *  @brief Source file implementing the CMetricsServer class methods on platforms without POSIX sockets.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <net/CMetricsServer.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        CMetricsServer::CMetricsServer(const Support::String&, const Common::U16 port) : mListenSocket(-1), mPort(port)
+        {
+            // The listener is written against POSIX sockets; there is no Winsock variant yet
+            throw std::runtime_error("CMetricsServer: Serving metrics requires POSIX sockets, which this platform lacks.");
+        }
+
+        CMetricsServer::~CMetricsServer(void)
+        {
+
+        }
+
+        void CMetricsServer::update(void)
+        {
+
+        }
+
+        Common::U16 CMetricsServer::getPort(void) const
+        {
+            return mPort;
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
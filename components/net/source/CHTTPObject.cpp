@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <cstring>
+#include <stdexcept>
 
 #include <net/CHTTPObject.hpp>
 
@@ -31,8 +32,9 @@ namespace Kiaro
             }
 
             const size_t bytesWritten = context->mPOSTPayloadLengthRemaining < bytesToWrite ? context->mPOSTPayloadLengthRemaining : bytesToWrite;
+            const size_t payloadOffset = context->mPOSTPayloadLength - context->mPOSTPayloadLengthRemaining;
 
-            memcpy(outputPointer, context->mPOSTPayload, bytesWritten);
+            memcpy(outputPointer, reinterpret_cast<Common::U8*>(context->mPOSTPayload) + payloadOffset, bytesWritten);
             context->mPOSTPayloadLengthRemaining -= bytesWritten;
 
             return bytesWritten;
@@ -40,22 +42,43 @@ namespace Kiaro
 
         size_t CHTTPObject::curlWriteCallback(void* inputPointer, size_t blockSize, size_t blockCount, void* userPointer)
         {
-            static_assert(sizeof(size_t) == sizeof(void*), "sizeof(size_t) must be sizeof(void*) for this code to work correctly! (This is a bug.)");
-
             HTTPTransferContext* context = reinterpret_cast<HTTPTransferContext*>(userPointer);
 
             const size_t bytesWritten = blockSize * blockCount;
             const size_t newSize = context->mResponseLength + bytesWritten;
 
-            context->mResponse = realloc(context->mResponse, newSize);
-            void* outputPointer = reinterpret_cast<void*>(reinterpret_cast<size_t>(context->mResponse) + context->mResponseLength);
+            // Grow geometrically, always leaving room for the NULL terminator
+            if (newSize + 1 > context->mResponseCapacity)
+            {
+                size_t newCapacity = context->mResponseCapacity ? context->mResponseCapacity : 1024;
+
+                while (newSize + 1 > newCapacity)
+                {
+                    newCapacity *= 2;
+                }
+
+                void* newResponse = realloc(context->mResponse, newCapacity);
+
+                // Returning anything other than the number of bytes given aborts the transfer
+                if (!newResponse)
+                {
+                    return 0;
+                }
 
-            memcpy(outputPointer, inputPointer, bytesWritten);
+                context->mResponse = newResponse;
+                context->mResponseCapacity = newCapacity;
+            }
+
+            Common::U8* response = reinterpret_cast<Common::U8*>(context->mResponse);
+
+            memcpy(&response[context->mResponseLength], inputPointer, bytesWritten);
+            response[newSize] = 0x00;
             context->mResponseLength = newSize;
-            return 0;
+
+            return bytesWritten;
         }
 
-        CHTTPObject::CHTTPObject(void)
+        CHTTPObject::CHTTPObject(void) : mRequestType(HTTP_REQUEST_GET), mResponseCode(0)
         {
             // Zero out all of the context memory
             memset(&mHTTPTransferContext, 0x00, sizeof(HTTPTransferContext));
@@ -105,32 +128,31 @@ namespace Kiaro
             }
         }
 
-        void CHTTPObject::dispatchRequest(void)
+        curl_slist* CHTTPObject::prepareHandle(CURL* curl)
         {
-            CURL* curl = curl_easy_init();
             curl_easy_setopt(curl, CURLOPT_URL, mURL.data());
 
-            // Initialize the response section
+            // Reset the response section; the buffer itself is kept around for the next response
+            mHTTPTransferContext.mResponseLength = 0;
+            mResponseCode = 0;
+
             if (mHTTPTransferContext.mResponse)
             {
-                free(mHTTPTransferContext.mResponse);
+                reinterpret_cast<Common::U8*>(mHTTPTransferContext.mResponse)[0] = 0x00;
             }
 
-            // We just use realloc on this anyway
-            mHTTPTransferContext.mResponse = malloc(1);
-
             // Set the request type
             switch (mRequestType)
             {
                 case HTTP_REQUEST_GET:
                 {
-                    curl_easy_setopt(curl, CURLOPT_POST, 0);
+                    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
                     break;
                 }
 
                 case HTTP_REQUEST_POST:
                 {
-                    curl_easy_setopt(curl, CURLOPT_POST, 1);
+                    curl_easy_setopt(curl, CURLOPT_POST, 1L);
                     break;
                 }
 
@@ -156,12 +178,22 @@ namespace Kiaro
             }
 
             // Setup the data transfer if necessary
-            if (mHTTPTransferContext.mPOSTPayload && mRequestType == HTTP_REQUEST_POST)
+            if (mRequestType == HTTP_REQUEST_POST)
             {
-                mHTTPTransferContext.mPOSTPayloadLengthRemaining = mHTTPTransferContext.mPOSTPayloadLength;
+                if (mHTTPTransferContext.mPOSTPayload)
+                {
+                    mHTTPTransferContext.mPOSTPayloadLengthRemaining = mHTTPTransferContext.mPOSTPayloadLength;
 
-                curl_easy_setopt(curl, CURLOPT_READDATA, &mHTTPTransferContext);
-                curl_easy_setopt(curl, CURLOPT_READFUNCTION, curlReadCallback);
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(mHTTPTransferContext.mPOSTPayloadLength));
+                    curl_easy_setopt(curl, CURLOPT_READDATA, &mHTTPTransferContext);
+                    curl_easy_setopt(curl, CURLOPT_READFUNCTION, curlReadCallback);
+                }
+                else
+                {
+                    // Otherwise CURL would attempt to read the body from stdin
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, 0L);
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");
+                }
             }
 
             // Setup the data receive
@@ -169,8 +201,8 @@ namespace Kiaro
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, &mHTTPTransferContext);
 
             // If we're using SSL protocols, verify everything
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 1);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
 
             // Set the user agent if we have one set
             if (mUserAgent != "")
@@ -178,11 +210,27 @@ namespace Kiaro
                 curl_easy_setopt(curl, CURLOPT_USERAGENT, mUserAgent.data());
             }
 
+            return requestHeaders;
+        }
+
+        void CHTTPObject::finishTransfer(CURL* handle)
+        {
+            curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &mResponseCode);
+        }
+
+        bool CHTTPObject::dispatchRequest(void)
+        {
+            CURL* curl = curl_easy_init();
+            curl_slist* requestHeaders = this->prepareHandle(curl);
+
             // Finally do something
-            curl_easy_perform(curl);
+            const CURLcode result = curl_easy_perform(curl);
+            this->finishTransfer(curl);
 
             curl_easy_cleanup(curl);
             curl_slist_free_all(requestHeaders);
+
+            return result == CURLE_OK;
         }
 
         void CHTTPObject::setPOSTPayload(void* payload, size_t payloadLength)
@@ -200,5 +248,10 @@ namespace Kiaro
         {
             return mHTTPTransferContext.mResponseLength;
         }
+
+        long CHTTPObject::getResponseCode(void)
+        {
+            return mResponseCode;
+        }
     } // End NameSpace Net
 } // End NameSpace Kiaro
@@ -0,0 +1,143 @@
+/**
+ *  @file CInboundMessageRing.cpp
+ *  @brief Source code file defining logic for the Net::CInboundMessageRing class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <cstring>
+#include <cassert>
+
+#include <net/CInboundMessageRing.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        //! The initial size of the span storage of rings without a span limit.
+        static const size_t sInitialSpanCapacity = 16;
+
+        CInboundMessageRing::CInboundMessageRing(const size_t spanLimit, const size_t byteCapacity) : mBytes(new Common::U8[byteCapacity]),
+        mByteCapacity(byteCapacity), mByteHead(0), mSpans(nullptr), mSpanCapacity(spanLimit == 0 ? sInitialSpanCapacity : spanLimit),
+        mSpanLimit(spanLimit), mSpanTail(0), mSpanCount(0), mByteCount(0)
+        {
+            mSpans = new Span[mSpanCapacity];
+        }
+
+        CInboundMessageRing::~CInboundMessageRing(void)
+        {
+            delete[] mBytes;
+            delete[] mSpans;
+        }
+
+        bool CInboundMessageRing::push(const void* data, const size_t length)
+        {
+            if (length == 0)
+                return true;
+
+            if ((mSpanLimit != 0 && mSpanCount == mSpanLimit) || length > mByteCapacity)
+                return false;
+
+            size_t offset = 0;
+
+            if (mSpanCount != 0)
+            {
+                const size_t tailOffset = mSpans[mSpanTail].mOffset;
+
+                // Stored data is contiguous; try the end of the ring first and then wrap around to the front
+                if (mByteHead > tailOffset)
+                {
+                    if (mByteCapacity - mByteHead >= length)
+                        offset = mByteHead;
+                    else if (tailOffset >= length)
+                        offset = 0;
+                    else
+                        return false;
+                }
+                // Stored data wraps; the only free space is between the head and the tail
+                else if (tailOffset - mByteHead >= length)
+                    offset = mByteHead;
+                else
+                    return false;
+            }
+
+            if (mSpanCount == mSpanCapacity)
+                this->growSpans();
+
+            std::memcpy(&mBytes[offset], data, length);
+            mByteHead = offset + length;
+            mByteCount += length;
+
+            Span& span = mSpans[(mSpanTail + mSpanCount) % mSpanCapacity];
+            span.mOffset = offset;
+            span.mLength = length;
+            span.mCursor = 0;
+            ++mSpanCount;
+
+            return true;
+        }
+
+        void CInboundMessageRing::growSpans(void)
+        {
+            Span* spans = new Span[mSpanCapacity * 2];
+
+            for (size_t index = 0; index < mSpanCount; ++index)
+                spans[index] = mSpans[(mSpanTail + index) % mSpanCapacity];
+
+            delete[] mSpans;
+            mSpans = spans;
+            mSpanCapacity *= 2;
+            mSpanTail = 0;
+        }
+
+        CInboundMessageRing::Span& CInboundMessageRing::front(void)
+        {
+            assert(mSpanCount != 0);
+            return mSpans[mSpanTail];
+        }
+
+        Common::U8* CInboundMessageRing::getData(const Span& span)
+        {
+            return &mBytes[span.mOffset];
+        }
+
+        void CInboundMessageRing::pop(void)
+        {
+            assert(mSpanCount != 0);
+
+            mByteCount -= mSpans[mSpanTail].mLength;
+            mSpanTail = (mSpanTail + 1) % mSpanCapacity;
+            --mSpanCount;
+
+            if (mSpanCount == 0)
+                this->clear();
+        }
+
+        void CInboundMessageRing::clear(void)
+        {
+            mSpanTail = 0;
+            mSpanCount = 0;
+            mByteHead = 0;
+            mByteCount = 0;
+        }
+
+        bool CInboundMessageRing::isEmpty(void) const
+        {
+            return mSpanCount == 0;
+        }
+
+        size_t CInboundMessageRing::getSpanCount(void) const
+        {
+            return mSpanCount;
+        }
+
+        size_t CInboundMessageRing::getByteCount(void) const
+        {
+            return mByteCount;
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
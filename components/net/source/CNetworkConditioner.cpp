@@ -0,0 +1,263 @@
+/**
+ *  @file CNetworkConditioner.cpp
+ *  @brief Source code file defining logic for the Net::CNetworkConditioner class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+
+#include <support/SSettingsRegistry.hpp>
+
+#include <net/CNetworkConditioner.hpp>
+#include <net/config.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        CNetworkConditioner::Parameters CNetworkConditioner::getConfiguredParameters(void)
+        {
+            Support::SSettingsRegistry* settings = Support::SSettingsRegistry::getInstance();
+
+            Parameters result;
+            result.mEnabled = settings->getValue<bool>("NetSimulator::Enabled");
+            result.mLatencyMS = settings->getValue<Common::U32>("NetSimulator::LatencyMS");
+            result.mJitterMS = settings->getValue<Common::U32>("NetSimulator::JitterMS");
+            result.mLossPercent = settings->getValue<Common::U32>("NetSimulator::LossPercent");
+            result.mDuplicatePercent = settings->getValue<Common::U32>("NetSimulator::DuplicatePercent");
+            result.mReorderPercent = settings->getValue<Common::U32>("NetSimulator::ReorderPercent");
+            result.mBandwidth = settings->getValue<Common::U32>("NetSimulator::Bandwidth");
+            result.mSeed = settings->getValue<Common::U32>("NetSimulator::Seed");
+
+            return result;
+        }
+
+        CNetworkConditioner::CNetworkConditioner(void) : CNetworkConditioner(getConfiguredParameters())
+        {
+        }
+
+        CNetworkConditioner::CNetworkConditioner(const Parameters& parameters)
+        {
+            mOutgoing.mTokens = 0.0;
+            mOutgoing.mLastRefillMS = 0;
+            mIncoming.mTokens = 0.0;
+            mIncoming.mLastRefillMS = 0;
+
+            this->setParameters(parameters);
+        }
+
+        CNetworkConditioner::~CNetworkConditioner(void)
+        {
+            purge(mOutgoing, nullptr);
+            purge(mIncoming, nullptr);
+        }
+
+        void CNetworkConditioner::setParameters(const Parameters& parameters)
+        {
+            mParameters = parameters;
+            mRandom.seed(parameters.mSeed);
+        }
+
+        const CNetworkConditioner::Parameters& CNetworkConditioner::getParameters(void) const
+        {
+            return mParameters;
+        }
+
+        bool CNetworkConditioner::roll(const Common::U32 percent)
+        {
+            if (percent == 0)
+            {
+                return false;
+            }
+
+            return std::uniform_int_distribution<Common::U32>(0, 99)(mRandom) < percent;
+        }
+
+        bool CNetworkConditioner::enqueue(Direction& direction, ENetPeer* peer, const Common::U8 channel, ENetPacket* packet, const Common::U64 currentTimeMS)
+        {
+            const bool reliable = packet->flags & ENET_PACKET_FLAG_RELIABLE;
+            std::uniform_int_distribution<Common::U32> jitter(0, mParameters.mJitterMS);
+
+            Common::U64 releaseTimeMS = currentTimeMS + mParameters.mLatencyMS + jitter(mRandom);
+
+            if (this->roll(mParameters.mLossPercent))
+            {
+                if (!reliable)
+                {
+                    return false;
+                }
+
+                // ENet would resend a lost reliable packet once the loss is noticed, so it arrives a round trip late instead
+                releaseTimeMS += 2 * mParameters.mLatencyMS + jitter(mRandom);
+            }
+
+            if (reliable)
+            {
+                // Reliable packets are always surfaced in order, so never release one before its predecessor
+                Common::U64& lastReleaseMS = direction.mLastReliableReleaseMS[peer];
+                releaseTimeMS = std::max(releaseTimeMS, lastReleaseMS);
+                lastReleaseMS = releaseTimeMS;
+            }
+            else if (this->roll(mParameters.mReorderPercent))
+            {
+                releaseTimeMS += mParameters.mJitterMS + NETCONDITIONER_REORDER_DELAY_MS;
+            }
+
+            DelayedPacket delayed;
+            delayed.mPeer = peer;
+            delayed.mChannel = channel;
+            delayed.mPacket = packet;
+            direction.mQueue.insert(DelayQueue::value_type(releaseTimeMS, delayed));
+
+            if (!reliable && this->roll(mParameters.mDuplicatePercent))
+            {
+                delayed.mPacket = enet_packet_create(packet->data, packet->dataLength, packet->flags);
+                direction.mQueue.insert(DelayQueue::value_type(currentTimeMS + mParameters.mLatencyMS + jitter(mRandom), delayed));
+            }
+
+            return true;
+        }
+
+        bool CNetworkConditioner::release(Direction& direction, const Common::U64 currentTimeMS, DelayedPacket& out)
+        {
+            if (direction.mQueue.empty())
+            {
+                return false;
+            }
+
+            auto next = direction.mQueue.begin();
+
+            // Once disabled, anything still held back is released immediately
+            if (mParameters.mEnabled)
+            {
+                if (next->first > currentTimeMS)
+                {
+                    return false;
+                }
+
+                if (mParameters.mBandwidth != 0)
+                {
+                    // Time may have been reset underneath us
+                    if (currentTimeMS < direction.mLastRefillMS)
+                    {
+                        direction.mLastRefillMS = currentTimeMS;
+                    }
+
+                    const Common::F64 burstBytes = static_cast<Common::F64>(mParameters.mBandwidth) * NETCONDITIONER_BURST_MS / 1000.0;
+                    direction.mTokens += static_cast<Common::F64>(mParameters.mBandwidth) * (currentTimeMS - direction.mLastRefillMS) / 1000.0;
+                    direction.mTokens = std::min(direction.mTokens, burstBytes);
+                    direction.mLastRefillMS = currentTimeMS;
+
+                    // Allow the bucket to go into debt so that packets larger than the burst size still get through eventually
+                    if (direction.mTokens <= 0.0)
+                    {
+                        return false;
+                    }
+
+                    direction.mTokens -= next->second.mPacket->dataLength;
+                }
+            }
+
+            out = next->second;
+            direction.mQueue.erase(next);
+            return true;
+        }
+
+        void CNetworkConditioner::purge(Direction& direction, ENetPeer* peer)
+        {
+            for (auto it = direction.mQueue.begin(); it != direction.mQueue.end();)
+            {
+                if (peer && it->second.mPeer != peer)
+                {
+                    ++it;
+                    continue;
+                }
+
+                enet_packet_destroy(it->second.mPacket);
+                it = direction.mQueue.erase(it);
+            }
+
+            if (peer)
+            {
+                direction.mLastReliableReleaseMS.erase(peer);
+            }
+            else
+            {
+                direction.mLastReliableReleaseMS.clear();
+            }
+        }
+
+        void CNetworkConditioner::send(ENetPeer* peer, const Common::U8 channel, ENetPacket* packet, const Common::U64 currentTimeMS)
+        {
+            if (!mParameters.mEnabled)
+            {
+                enet_peer_send(peer, channel, packet);
+                return;
+            }
+
+            if (!this->enqueue(mOutgoing, peer, channel, packet, currentTimeMS))
+            {
+                enet_packet_destroy(packet);
+                return;
+            }
+
+            // Anything already due, such as with no latency configured, goes out right away
+            this->flushOutgoing(currentTimeMS);
+        }
+
+        bool CNetworkConditioner::receive(ENetPeer* peer, const Common::U8 channel, ENetPacket* packet, const Common::U64 currentTimeMS)
+        {
+            if (!mParameters.mEnabled)
+            {
+                return false;
+            }
+
+            if (!this->enqueue(mIncoming, peer, channel, packet, currentTimeMS))
+            {
+                enet_packet_destroy(packet);
+            }
+
+            return true;
+        }
+
+        bool CNetworkConditioner::popIncoming(const Common::U64 currentTimeMS, ENetPeer*& peer, ENetPacket*& packet)
+        {
+            DelayedPacket delayed;
+
+            if (!this->release(mIncoming, currentTimeMS, delayed))
+            {
+                return false;
+            }
+
+            peer = delayed.mPeer;
+            packet = delayed.mPacket;
+            return true;
+        }
+
+        void CNetworkConditioner::flushOutgoing(const Common::U64 currentTimeMS)
+        {
+            DelayedPacket delayed;
+
+            while (this->release(mOutgoing, currentTimeMS, delayed))
+            {
+                enet_peer_send(delayed.mPeer, delayed.mChannel, delayed.mPacket);
+            }
+        }
+
+        void CNetworkConditioner::purge(ENetPeer* peer)
+        {
+            purge(mOutgoing, peer);
+            purge(mIncoming, peer);
+        }
+
+        size_t CNetworkConditioner::getQueuedPacketCount(void) const
+        {
+            return mOutgoing.mQueue.size() + mIncoming.mQueue.size();
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
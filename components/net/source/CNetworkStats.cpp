@@ -0,0 +1,247 @@
+/**
+ *  @file CNetworkStats.cpp
+ *  @brief Source code file defining logic for the Net::CNetworkStats class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <support/Console.hpp>
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+
+#include <net/CNetworkStats.hpp>
+#include <net/config.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        //! Totals across every connection, which unlike the per connection figures survive disconnects.
+        static Support::Atomic<Common::U64> sTotalPacketsSent(0);
+        static Support::Atomic<Common::U64> sTotalPacketsReceived(0);
+        static Support::Atomic<Common::U64> sTotalBytesSent(0);
+        static Support::Atomic<Common::U64> sTotalBytesReceived(0);
+
+        CNetworkStats::CNetworkStats(void) : mRoundTripTimeMS(0), mRoundTripTimeVarianceMS(0), mPacketLoss(0.0f), mReliableBytesInTransit(0),
+        mQueuedIncomingPackets(0), mQueuedIncomingBytes(0), mOutgoingBytesPerSecond(0.0f), mIncomingBytesPerSecond(0.0f), mSampleStartMS(0)
+        {
+            this->reset();
+        }
+
+        void CNetworkStats::sample(const ENetPeer* peer, const Common::U64 currentTimeMS)
+        {
+            if (peer)
+            {
+                mRoundTripTimeMS = peer->roundTripTime;
+                mRoundTripTimeVarianceMS = peer->roundTripTimeVariance;
+                mPacketLoss = static_cast<Common::F32>(peer->packetLoss) / ENET_PEER_PACKET_LOSS_SCALE;
+                mReliableBytesInTransit = peer->reliableDataInTransit;
+            }
+
+            // Time may have been reset underneath us
+            if (currentTimeMS < mSampleStartMS)
+            {
+                mSampleStartMS = currentTimeMS;
+            }
+
+            const Common::U64 elapsedMS = currentTimeMS - mSampleStartMS;
+
+            if (elapsedMS >= NETSTATS_SAMPLE_INTERVAL_MS)
+            {
+                const Common::F32 elapsedSeconds = elapsedMS / 1000.0f;
+
+                mOutgoingBytesPerSecond = (mBytesSent - mSampleStartBytesSent) / elapsedSeconds;
+                mIncomingBytesPerSecond = (mBytesReceived - mSampleStartBytesReceived) / elapsedSeconds;
+
+                mSampleStartMS = currentTimeMS;
+                mSampleStartBytesSent = mBytesSent;
+                mSampleStartBytesReceived = mBytesReceived;
+            }
+        }
+
+        void CNetworkStats::recordSentPacket(const size_t bytes)
+        {
+            ++mPacketsSent;
+            mBytesSent += bytes;
+
+            sTotalPacketsSent.fetch_add(1, std::memory_order_relaxed);
+            sTotalBytesSent.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void CNetworkStats::recordReceivedPacket(const size_t bytes)
+        {
+            ++mPacketsReceived;
+            mBytesReceived += bytes;
+
+            sTotalPacketsReceived.fetch_add(1, std::memory_order_relaxed);
+            sTotalBytesReceived.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void CNetworkStats::recordSentMessage(const Common::U32 type, const size_t bytes)
+        {
+            MessageTypeStats& stats = mMessageTypes[type];
+            ++stats.mSentCount;
+            stats.mSentBytes += bytes;
+        }
+
+        void CNetworkStats::recordSentMessage(Support::CBitStream& stream, const size_t messageStart)
+        {
+            const size_t messageEnd = stream.getPointer();
+
+            if (messageEnd - messageStart < sizeof(Common::U32))
+            {
+                return;
+            }
+
+            // Every message begins with its type ID
+            Common::U32 type;
+            memcpy(&type, reinterpret_cast<Common::U8*>(stream.getBlock()) + messageStart, sizeof(type));
+
+            this->recordSentMessage(type, messageEnd - messageStart);
+        }
+
+        void CNetworkStats::recordReceivedMessage(const Common::U32 type, const size_t bytes)
+        {
+            MessageTypeStats& stats = mMessageTypes[type];
+            ++stats.mReceivedCount;
+            stats.mReceivedBytes += bytes;
+        }
+
+        void CNetworkStats::setIncomingQueueDepth(const Common::U32 packets, const Common::U32 bytes)
+        {
+            mQueuedIncomingPackets = packets;
+            mQueuedIncomingBytes = bytes;
+        }
+
+        void CNetworkStats::reset(void)
+        {
+            mPacketsSent = 0;
+            mPacketsReceived = 0;
+            mBytesSent = 0;
+            mBytesReceived = 0;
+
+            mSampleStartBytesSent = 0;
+            mSampleStartBytesReceived = 0;
+
+            mMessageTypes.clear();
+        }
+
+        Common::U32 CNetworkStats::getRoundTripTimeMS(void) const
+        {
+            return mRoundTripTimeMS;
+        }
+
+        Common::U32 CNetworkStats::getRoundTripTimeVarianceMS(void) const
+        {
+            return mRoundTripTimeVarianceMS;
+        }
+
+        Common::F32 CNetworkStats::getPacketLoss(void) const
+        {
+            return mPacketLoss;
+        }
+
+        Common::U32 CNetworkStats::getReliableBytesInTransit(void) const
+        {
+            return mReliableBytesInTransit;
+        }
+
+        Common::U32 CNetworkStats::getQueuedIncomingPackets(void) const
+        {
+            return mQueuedIncomingPackets;
+        }
+
+        Common::U32 CNetworkStats::getQueuedIncomingBytes(void) const
+        {
+            return mQueuedIncomingBytes;
+        }
+
+        Common::U64 CNetworkStats::getPacketsSent(void) const
+        {
+            return mPacketsSent;
+        }
+
+        Common::U64 CNetworkStats::getPacketsReceived(void) const
+        {
+            return mPacketsReceived;
+        }
+
+        Common::U64 CNetworkStats::getBytesSent(void) const
+        {
+            return mBytesSent;
+        }
+
+        Common::U64 CNetworkStats::getBytesReceived(void) const
+        {
+            return mBytesReceived;
+        }
+
+        Common::U64 CNetworkStats::getTotalPacketsSent(void)
+        {
+            return sTotalPacketsSent.load(std::memory_order_relaxed);
+        }
+
+        Common::U64 CNetworkStats::getTotalPacketsReceived(void)
+        {
+            return sTotalPacketsReceived.load(std::memory_order_relaxed);
+        }
+
+        Common::U64 CNetworkStats::getTotalBytesSent(void)
+        {
+            return sTotalBytesSent.load(std::memory_order_relaxed);
+        }
+
+        Common::U64 CNetworkStats::getTotalBytesReceived(void)
+        {
+            return sTotalBytesReceived.load(std::memory_order_relaxed);
+        }
+
+        Common::F32 CNetworkStats::getOutgoingBytesPerSecond(void) const
+        {
+            return mOutgoingBytesPerSecond;
+        }
+
+        Common::F32 CNetworkStats::getIncomingBytesPerSecond(void) const
+        {
+            return mIncomingBytesPerSecond;
+        }
+
+        const Support::Map<Common::U32, CNetworkStats::MessageTypeStats>& CNetworkStats::getMessageTypeStats(void) const
+        {
+            return mMessageTypes;
+        }
+
+        void CNetworkStats::print(const Support::String& name, const bool detailed) const
+        {
+            CONSOLE_INFOF("%s: RTT %ums (+/- %ums), Loss %.2f%%, In Transit %u bytes, Queued %u packets (%u bytes)", name.data(), mRoundTripTimeMS,
+                          mRoundTripTimeVarianceMS, mPacketLoss * 100.0f, mReliableBytesInTransit, mQueuedIncomingPackets, mQueuedIncomingBytes);
+            CONSOLE_INFOF("%s: Out %.1f B/s (%llu packets, %llu bytes), In %.1f B/s (%llu packets, %llu bytes)", name.data(), mOutgoingBytesPerSecond,
+                          mPacketsSent, mBytesSent, mIncomingBytesPerSecond, mPacketsReceived, mBytesReceived);
+
+            if (!detailed)
+            {
+                return;
+            }
+
+            // Heaviest message types first
+            Support::Vector<std::pair<Common::U32, MessageTypeStats>> types(mMessageTypes.begin(), mMessageTypes.end());
+            std::sort(types.begin(), types.end(), [](const std::pair<Common::U32, MessageTypeStats>& lhs, const std::pair<Common::U32, MessageTypeStats>& rhs)
+            {
+                return lhs.second.mSentBytes + lhs.second.mReceivedBytes > rhs.second.mSentBytes + rhs.second.mReceivedBytes;
+            });
+
+            for (auto&& type : types)
+            {
+                CONSOLE_INFOF("%s:   Message %u: Sent %llu (%llu bytes), Received %llu (%llu bytes)", name.data(), type.first, type.second.mSentCount,
+                              type.second.mSentBytes, type.second.mReceivedCount, type.second.mReceivedBytes);
+            }
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
@@ -10,6 +10,7 @@
  */
 
 #include <net/IIncomingClient.hpp>
+#include <net/IServer.hpp>
 
 #include <net/IMessage.hpp>
 #include <net/config.hpp>
@@ -20,7 +21,7 @@ namespace Kiaro
 {
     namespace Net
     {
-        IIncomingClient::IIncomingClient(ENetPeer* connecting, IServer* server) : mInternalClient(connecting), mCurrentConnectionStage(STAGE_AUTHENTICATION),
+        IIncomingClient::IIncomingClient(ENetPeer* connecting, IServer* server) : mInternalClient(connecting), mServer(server), mCurrentConnectionStage(STAGE_AUTHENTICATION),
         mIsConnected(true), mReliableStream(NETSTREAM_DEFAULT_SIZE, nullptr, 0, NETSTREAM_RESIZE_FACTOR), mUnreliableStream(NETSTREAM_DEFAULT_SIZE, nullptr, 0, NETSTREAM_RESIZE_FACTOR)
         {
         }
@@ -35,14 +36,11 @@ namespace Kiaro
 
         void IIncomingClient::send(const IMessage* packet, const bool reliable)
         {
-            if (reliable)
-            {
-                packet->packEverything(mReliableStream);
-            }
-            else
-            {
-                packet->packEverything(mUnreliableStream);
-            }
+            Support::CBitStream& stream = reliable ? mReliableStream : mUnreliableStream;
+            const size_t messageStart = stream.getPointer();
+
+            packet->packEverything(stream);
+            mStats.recordSentMessage(stream, messageStart);
         }
 
         void IIncomingClient::send(const IMessage& message, const bool reliable)
@@ -90,17 +88,41 @@ namespace Kiaro
             if (mReliableStream.getPointer() != 0)
             {
                 enetPacket = enet_packet_create(mReliableStream.getBlock(), mReliableStream.getPointer(), ENET_PACKET_FLAG_RELIABLE);
-                enet_peer_send(mInternalClient, 0, enetPacket);
+                this->sendPacket(enetPacket);
+                mStats.recordSentPacket(mReliableStream.getPointer());
             }
 
             if (mUnreliableStream.getPointer() != 0)
             {
                 enetPacket = enet_packet_create(mUnreliableStream.getBlock(), mUnreliableStream.getPointer(), ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT);
-                enet_peer_send(mInternalClient, 0, enetPacket);
+                this->sendPacket(enetPacket);
+                mStats.recordSentPacket(mUnreliableStream.getPointer());
             }
 
             mReliableStream.setPointer(0);
             mUnreliableStream.setPointer(0);
         }
+
+        void IIncomingClient::sendPacket(ENetPacket* packet)
+        {
+            if (mServer)
+            {
+                mServer->sendPacket(mInternalClient, 0, packet);
+            }
+            else
+            {
+                enet_peer_send(mInternalClient, 0, packet);
+            }
+        }
+
+        CNetworkStats& IIncomingClient::getStats(void)
+        {
+            return mStats;
+        }
+
+        void IIncomingClient::updateStats(const Common::U64 currentTimeMS)
+        {
+            mStats.sample(mInternalClient, currentTimeMS);
+        }
     } // End Namespace Network
 } // End Namespace Kiaro
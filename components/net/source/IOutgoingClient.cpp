@@ -15,6 +15,8 @@
 #include <enet/enet.h>
 
 #include <support/Console.hpp>
+#include <support/FTime.hpp>
+#include <support/SProfiler.hpp>
 
 #include <net/IOutgoingClient.hpp>
 
@@ -61,12 +63,19 @@ namespace Kiaro
             }
 
             packet->packEverything(mOutgoingStream);
+            mStats.recordSentMessage(mOutgoingStream, 0);
+
             ENetPacket* enetPacket = enet_packet_create(mOutgoingStream.getBlock(), mOutgoingStream.getPointer(), packetFlag);
-            enet_peer_send(mInternalPeer, 0, enetPacket);
+            mConditioner.send(mInternalPeer, 0, enetPacket, Support::FTime::getMilliseconds());
+            mStats.recordSentPacket(mOutgoingStream.getPointer());
 
             mOutgoingStream.setPointer(0);
         }
 
+        void IOutgoingClient::onUpdate(void)
+        {
+        }
+
         void IOutgoingClient::processPacket(Support::CBitStream& incomingStream)
         {
             assert(incomingStream.getSize() != 0);
@@ -74,6 +83,19 @@ namespace Kiaro
             this->onReceivePacket(incomingStream);
         }
 
+        void IOutgoingClient::receivePacket(ENetPacket* packet)
+        {
+            assert(packet->data);
+            assert(packet->dataLength);
+
+            mStats.recordReceivedPacket(packet->dataLength);
+
+            Support::CBitStream incomingStream(packet->data, packet->dataLength);
+            this->processPacket(incomingStream);
+
+            enet_packet_destroy(packet);
+        }
+
         Common::U16 IOutgoingClient::getPort(void) const NOEXCEPT
         {
             return mPort;
@@ -116,9 +138,6 @@ namespace Kiaro
                 mConnected = true;
                 mPort = targetPort;
                 this->onConnected();
-
-                // Add our update to the scheduler
-                mUpdatePulse = Support::SSynchronousScheduler::getInstance()->schedule(32, true, this, &IOutgoingClient::update);
                 return;
             }
 
@@ -130,13 +149,6 @@ namespace Kiaro
 
         void IOutgoingClient::disconnect(void)
         {
-            if (mUpdatePulse)
-            {
-                mUpdatePulse->cancel();
-            }
-
-            mUpdatePulse = nullptr;
-
             if (!mConnected)
             {
                 return;
@@ -153,6 +165,16 @@ namespace Kiaro
                 return;
             }
 
+            PROFILER_SCOPE(NetworkReceive);
+
+            if (mConnected)
+            {
+                this->onUpdate();
+            }
+
+            const Common::U64 currentTimeMS = Support::FTime::getMilliseconds();
+            mConditioner.flushOutgoing(currentTimeMS);
+
             ENetEvent event;
 
             while (mInternalHost && enet_host_service(mInternalHost, &event, 0) > 0)
@@ -161,6 +183,8 @@ namespace Kiaro
                 {
                     case ENET_EVENT_TYPE_DISCONNECT:
                     {
+                        mConditioner.purge(mInternalPeer);
+
                         enet_host_destroy(mInternalHost);
                         mInternalHost = nullptr;
                         enet_peer_reset(mInternalPeer);
@@ -180,13 +204,10 @@ namespace Kiaro
                             break;
                         }
 
-                        assert(event.packet->data);
-                        assert(event.packet->dataLength);
-
-                        Support::CBitStream incomingStream(event.packet->data, event.packet->dataLength);
-                        this->processPacket(incomingStream);
-
-                        enet_packet_destroy(event.packet);
+                        if (!mConditioner.receive(event.peer, event.channelID, event.packet, currentTimeMS))
+                        {
+                            this->receivePacket(event.packet);
+                        }
                         break;
                     }
 
@@ -196,6 +217,24 @@ namespace Kiaro
                         break;
                 }
             }
+
+            // Process anything the network condition simulator has held back until now
+            ENetPeer* delayedPeer = nullptr;
+            ENetPacket* delayedPacket = nullptr;
+
+            while (mConditioner.popIncoming(currentTimeMS, delayedPeer, delayedPacket))
+            {
+                if (mConnected)
+                {
+                    this->receivePacket(delayedPacket);
+                }
+                else
+                {
+                    enet_packet_destroy(delayedPacket);
+                }
+            }
+
+            mStats.sample(mInternalPeer, currentTimeMS);
         }
 
         bool IOutgoingClient::isConnected(void)
@@ -203,10 +242,21 @@ namespace Kiaro
             return mConnected;
         }
 
+        CNetworkStats& IOutgoingClient::getStats(void)
+        {
+            return mStats;
+        }
+
+        CNetworkConditioner& IOutgoingClient::getConditioner(void)
+        {
+            return mConditioner;
+        }
+
         void IOutgoingClient::dispatch(void)
         {
             if (mInternalHost)
             {
+                mConditioner.flushOutgoing(Support::FTime::getMilliseconds());
                 enet_host_flush(mInternalHost);
             }
         }
@@ -15,6 +15,8 @@
 #include <net/IIncomingClient.hpp>
 
 #include <support/SSettingsRegistry.hpp>
+#include <support/FTime.hpp>
+#include <support/SProfiler.hpp>
 
 namespace Kiaro
 {
@@ -71,9 +73,14 @@ namespace Kiaro
 
         void IServer::update(const Common::F32 deltaTimeSeconds)
         {
+            PROFILER_SCOPE(NetworkReceive);
+
             // TODO (Robert MacGregor#9): Dispatch commit packets after we're done dispatching sim updates
             // Net::Messages::SimCommit commitPacket;
             // this->globalSend(&commitPacket, true);
+            const Common::U64 currentTimeMS = Support::FTime::getMilliseconds();
+            mConditioner.flushOutgoing(currentTimeMS);
+
             ENetEvent event;
 
             while (enet_host_service(mInternalHost, &event, 0) > 0)
@@ -94,6 +101,8 @@ namespace Kiaro
                     {
                         CONSOLE_INFO("Received client disconnect.");
 
+                        mConditioner.purge(event.peer);
+
                         IIncomingClient* disconnected = reinterpret_cast<IIncomingClient*>(event.peer->data);
                         onClientDisconnected(disconnected);
                         disconnected->mIsConnected = false;
@@ -113,12 +122,10 @@ namespace Kiaro
                             throw std::runtime_error("IServer: Invalid ENet peer data on packet receive!");
                         }
 
-                        IIncomingClient* sender = reinterpret_cast<IIncomingClient*>(event.peer->data);
-                        mLastPacketSender = sender;
-                        Support::CBitStream incomingStream(event.packet->data, event.packet->dataLength);
-                        this->processPacket(incomingStream, sender);
-                        enet_packet_destroy(event.packet);
-                        mLastPacketSender = nullptr;
+                        if (!mConditioner.receive(event.peer, event.channelID, event.packet, currentTimeMS))
+                        {
+                            this->receivePacket(event.peer, event.packet);
+                        }
                         break;
                     }
 
@@ -126,6 +133,25 @@ namespace Kiaro
                         break;
                 }
             }
+
+            // Process anything the network condition simulator has held back until now
+            ENetPeer* delayedPeer = nullptr;
+            ENetPacket* delayedPacket = nullptr;
+
+            while (mConditioner.popIncoming(currentTimeMS, delayedPeer, delayedPacket))
+            {
+                this->receivePacket(delayedPeer, delayedPacket);
+            }
+
+            for (IIncomingClient* client : mPendingClientSet)
+            {
+                client->updateStats(currentTimeMS);
+            }
+
+            for (IIncomingClient* client : mConnectedClientSet)
+            {
+                client->updateStats(currentTimeMS);
+            }
         }
 
         void IServer::processPacket(Support::CBitStream& incomingStream, Net::IIncomingClient* sender)
@@ -133,6 +159,28 @@ namespace Kiaro
             this->onReceivePacket(incomingStream, sender);
         }
 
+        void IServer::receivePacket(ENetPeer* peer, ENetPacket* packet)
+        {
+            IIncomingClient* sender = reinterpret_cast<IIncomingClient*>(peer->data);
+            mLastPacketSender = sender;
+            sender->getStats().recordReceivedPacket(packet->dataLength);
+
+            Support::CBitStream incomingStream(packet->data, packet->dataLength);
+            this->processPacket(incomingStream, sender);
+            enet_packet_destroy(packet);
+            mLastPacketSender = nullptr;
+        }
+
+        void IServer::sendPacket(ENetPeer* peer, const Common::U8 channel, ENetPacket* packet)
+        {
+            mConditioner.send(peer, channel, packet, Support::FTime::getMilliseconds());
+        }
+
+        CNetworkConditioner& IServer::getConditioner(void)
+        {
+            return mConditioner;
+        }
+
         void IServer::onClientConnected(IIncomingClient* client)
         {
             //  Core::SEventManager::get()->mOnClientConnectedEvent.invoke(client);
@@ -176,6 +224,7 @@ namespace Kiaro
         {
             if (mRunning)
             {
+                mConditioner.flushOutgoing(Support::FTime::getMilliseconds());
                 enet_host_flush(mInternalHost);
             }
         }
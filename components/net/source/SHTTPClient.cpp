@@ -0,0 +1,207 @@
+/**
+ *  @file SHTTPClient.cpp
+ *  @brief Source code file implementing the SHTTPClient singleton class methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <support/Console.hpp>
+
+#include <net/SHTTPClient.hpp>
+#include <net/config.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        SHTTPClient::SHTTPClient(void)
+        {
+            curl_global_init(CURL_GLOBAL_DEFAULT);
+
+            mMultiHandle = curl_multi_init();
+
+            if (!mMultiHandle)
+            {
+                throw std::runtime_error("SHTTPClient: Failed to create CURL multi handle!");
+            }
+
+            // Add our update to the scheduler
+            mUpdatePulse = Support::SSynchronousScheduler::getInstance()->schedule(HTTPCLIENT_UPDATE_INTERVAL_MS, true, this, &SHTTPClient::update);
+        }
+
+        SHTTPClient::~SHTTPClient(void)
+        {
+            for (auto&& transfer : mTransfers)
+            {
+                curl_multi_remove_handle(mMultiHandle, transfer.second.mHandle);
+                curl_easy_cleanup(transfer.second.mHandle);
+                curl_slist_free_all(transfer.second.mHeaders);
+            }
+            mTransfers.clear();
+
+            for (CURL* handle : mIdleHandles)
+            {
+                curl_easy_cleanup(handle);
+            }
+            mIdleHandles.clear();
+
+            curl_multi_cleanup(mMultiHandle);
+            mMultiHandle = nullptr;
+
+            mUpdatePulse->cancel();
+            mUpdatePulse = nullptr;
+
+            curl_global_cleanup();
+        }
+
+        void SHTTPClient::dispatch(CHTTPObject* request, CompletionCallback callback)
+        {
+            if (mTransfers.find(request) != mTransfers.end())
+            {
+                throw std::runtime_error("SHTTPClient: Request is already pending!");
+            }
+
+            CURL* handle = nullptr;
+
+            if (mIdleHandles.empty())
+            {
+                handle = curl_easy_init();
+            }
+            else
+            {
+                handle = mIdleHandles.back();
+                mIdleHandles.pop_back();
+            }
+
+            HTTPTransfer transfer;
+            transfer.mHandle = handle;
+            transfer.mCallback = callback;
+
+            try
+            {
+                transfer.mHeaders = request->prepareHandle(handle);
+            }
+            catch (...)
+            {
+                // The handle was never added to the multi handle, so it goes straight back to the pool
+                if (mIdleHandles.size() < HTTPCLIENT_MAX_IDLE_HANDLES)
+                {
+                    curl_easy_reset(handle);
+                    mIdleHandles.push_back(handle);
+                }
+                else
+                {
+                    curl_easy_cleanup(handle);
+                }
+
+                throw;
+            }
+
+            curl_easy_setopt(handle, CURLOPT_PRIVATE, request);
+            curl_multi_add_handle(mMultiHandle, handle);
+
+            mTransfers[request] = transfer;
+        }
+
+        bool SHTTPClient::cancel(CHTTPObject* request)
+        {
+            auto search = mTransfers.find(request);
+
+            if (search == mTransfers.end())
+            {
+                return false;
+            }
+
+            this->releaseTransfer(search->second);
+            mTransfers.erase(search);
+            return true;
+        }
+
+        bool SHTTPClient::isPending(CHTTPObject* request) const
+        {
+            return mTransfers.find(request) != mTransfers.end();
+        }
+
+        size_t SHTTPClient::getPendingCount(void) const
+        {
+            return mTransfers.size();
+        }
+
+        void SHTTPClient::releaseTransfer(HTTPTransfer& transfer)
+        {
+            curl_multi_remove_handle(mMultiHandle, transfer.mHandle);
+            curl_slist_free_all(transfer.mHeaders);
+
+            // Resetting keeps the handle's connection and DNS caches intact
+            if (mIdleHandles.size() < HTTPCLIENT_MAX_IDLE_HANDLES)
+            {
+                curl_easy_reset(transfer.mHandle);
+                mIdleHandles.push_back(transfer.mHandle);
+            }
+            else
+            {
+                curl_easy_cleanup(transfer.mHandle);
+            }
+
+            transfer.mHandle = nullptr;
+            transfer.mHeaders = nullptr;
+        }
+
+        void SHTTPClient::update(void)
+        {
+            if (mTransfers.empty())
+            {
+                return;
+            }
+
+            Common::S32 runningHandles = 0;
+            curl_multi_perform(mMultiHandle, &runningHandles);
+
+            Common::S32 queuedMessages = 0;
+            CURLMsg* message = nullptr;
+
+            while ((message = curl_multi_info_read(mMultiHandle, &queuedMessages)))
+            {
+                if (message->msg != CURLMSG_DONE)
+                {
+                    continue;
+                }
+
+                CHTTPObject* request = nullptr;
+                curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &request);
+
+                auto search = mTransfers.find(request);
+
+                if (search == mTransfers.end())
+                {
+                    continue;
+                }
+
+                const bool success = message->data.result == CURLE_OK;
+
+                if (!success)
+                {
+                    CONSOLE_WARNINGF("SHTTPClient: Request to %s failed: %s", request->getURL().data(), curl_easy_strerror(message->data.result));
+                }
+
+                // Finish up before raising the callback so that it may dispatch the request again
+                request->finishTransfer(message->easy_handle);
+
+                CompletionCallback callback = search->second.mCallback;
+                this->releaseTransfer(search->second);
+                mTransfers.erase(search);
+
+                if (callback)
+                {
+                    callback(request, success);
+                }
+            }
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
@@ -8,23 +8,55 @@
 #include <support/Console.hpp>
 #include <net/CHTTPObject.hpp>
 
+#include "CHTTPTestServer.hpp"
+
 namespace Kiaro
 {
     namespace Net
     {
         TEST(CHTTPObject, SimpleGET)
         {
+            CHTTPTestServer server;
+
             CHTTPObject connection;
             connection.mRequestType = CHTTPObject::HTTP_REQUEST_GET;
-            connection.setURL("https://google.com");
-            connection.dispatchRequest();
+            connection.setURL(server.getURL() + "/");
+            EXPECT_TRUE(connection.dispatchRequest());
 
             const size_t responseLength = connection.getResponseBodyLength();
-            Common::C8* response = reinterpret_cast<Common::C8*>(connection.getResponseBody());
-            response[responseLength - 1] = 0x00;
+            const Common::C8* response = reinterpret_cast<Common::C8*>(connection.getResponseBody());
 
             CONSOLE_INFOF("Response Length: %u bytes", responseLength);
-            std::cout << response << std::endl;
+            EXPECT_EQ(connection.getResponseCode(), 200);
+            EXPECT_EQ(responseLength, strlen(CHTTPTestServer::sGETResponse));
+            EXPECT_STREQ(response, CHTTPTestServer::sGETResponse);
+        }
+
+        TEST(CHTTPObject, LargePOST)
+        {
+            CHTTPTestServer server;
+
+            // Large enough to arrive in many chunks
+            Support::String payload;
+            for (Common::U32 iteration = 0; iteration < 65536; ++iteration)
+            {
+                payload += static_cast<Common::C8>('a' + iteration % 26);
+            }
+
+            CHTTPObject connection;
+            connection.mRequestType = CHTTPObject::HTTP_REQUEST_POST;
+            connection.setURL(server.getURL() + "/echo");
+            connection.setPOSTPayload(&payload[0], payload.size());
+            EXPECT_TRUE(connection.dispatchRequest());
+
+            EXPECT_EQ(connection.getResponseCode(), 200);
+            ASSERT_EQ(connection.getResponseBodyLength(), payload.size());
+            EXPECT_EQ(memcmp(connection.getResponseBody(), payload.data(), payload.size()), 0);
+
+            // The response buffer is reused for the next request
+            connection.mRequestType = CHTTPObject::HTTP_REQUEST_GET;
+            EXPECT_TRUE(connection.dispatchRequest());
+            EXPECT_STREQ(reinterpret_cast<Common::C8*>(connection.getResponseBody()), CHTTPTestServer::sGETResponse);
         }
     } // End NameSpace Net
 } // End NameSpace Kiaro
@@ -0,0 +1,205 @@
+/**
+ *  @file CHTTPTestServer.hpp
+ *  @brief A minimal loopback HTTP server used as a stand-in for remote web servers in the HTTP tests.
+ */
+
+#ifndef _INCLUDE_NET_TESTS_CHTTPTESTSERVER_HPP_
+#define _INCLUDE_NET_TESTS_CHTTPTESTSERVER_HPP_
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <cstdlib>
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/String.hpp>
+#include <support/Vector.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        /**
+         *  @brief Serves HTTP/1.1 keep-alive connections on a random loopback port. GET requests are answered with a fixed body and
+         *  POST requests have their body echoed back. Every accepted connection is counted so tests can verify connection reuse.
+         */
+        class CHTTPTestServer
+        {
+            // Public Members
+            public:
+                //! The body sent in response to GET requests.
+                static constexpr const Common::C8* sGETResponse = "Hello from the KGE test server!";
+
+            // Private Members
+            private:
+                //! The listening socket.
+                Common::S32 mListenSocket;
+
+                //! The port we are listening on.
+                Common::U16 mPort;
+
+                //! The thread accepting connections.
+                Support::Thread* mAcceptThread;
+
+                //! All connection threads and their sockets.
+                Support::Vector<Support::Pair<Support::Thread*, Common::S32>> mConnections;
+
+                //! Guards mConnections.
+                Support::Mutex mConnectionsMutex;
+
+                //! Set when the server is shutting down.
+                Support::Atomic<bool> mShouldTerminate;
+
+                //! The number of accepted connections.
+                Support::Atomic<Common::U32> mConnectionCount;
+
+            // Private Methods
+            private:
+                void acceptLogic(void)
+                {
+                    while (!mShouldTerminate)
+                    {
+                        const Common::S32 connection = accept(mListenSocket, nullptr, nullptr);
+
+                        if (connection < 0)
+                        {
+                            return;
+                        }
+
+                        ++mConnectionCount;
+
+                        std::lock_guard<Support::Mutex> lock(mConnectionsMutex);
+                        mConnections.push_back(Support::Pair<Support::Thread*, Common::S32>(new Support::Thread(&CHTTPTestServer::connectionLogic, this, connection), connection));
+                    }
+                }
+
+                void connectionLogic(const Common::S32 connection)
+                {
+                    Support::String buffer;
+                    Common::C8 chunk[4096];
+
+                    while (!mShouldTerminate)
+                    {
+                        // Read until we have the full header block
+                        size_t headerEnd = buffer.find("\r\n\r\n");
+
+                        while (headerEnd == Support::String::npos)
+                        {
+                            const ssize_t received = recv(connection, chunk, sizeof(chunk), 0);
+
+                            if (received <= 0)
+                            {
+                                return;
+                            }
+
+                            buffer.append(chunk, received);
+                            headerEnd = buffer.find("\r\n\r\n");
+                        }
+
+                        const Support::String headers = buffer.substr(0, headerEnd);
+                        buffer.erase(0, headerEnd + 4);
+
+                        size_t contentLength = 0;
+                        const size_t lengthPosition = headers.find("Content-Length: ");
+
+                        if (lengthPosition != Support::String::npos)
+                        {
+                            contentLength = strtoul(headers.c_str() + lengthPosition + 16, nullptr, 10);
+                        }
+
+                        // Read the body
+                        while (buffer.size() < contentLength)
+                        {
+                            const ssize_t received = recv(connection, chunk, sizeof(chunk), 0);
+
+                            if (received <= 0)
+                            {
+                                return;
+                            }
+
+                            buffer.append(chunk, received);
+                        }
+
+                        const Support::String body = headers.compare(0, 5, "POST ") == 0 ? buffer.substr(0, contentLength) : Support::String(sGETResponse);
+                        buffer.erase(0, contentLength);
+
+                        Support::String response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: ";
+                        response += std::to_string(body.size());
+                        response += "\r\nConnection: keep-alive\r\n\r\n";
+                        response += body;
+
+                        size_t sent = 0;
+                        while (sent < response.size())
+                        {
+                            const ssize_t written = send(connection, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+
+                            if (written <= 0)
+                            {
+                                return;
+                            }
+
+                            sent += written;
+                        }
+                    }
+                }
+
+            // Public Methods
+            public:
+                CHTTPTestServer(void) : mListenSocket(-1), mPort(0), mAcceptThread(nullptr), mShouldTerminate(false), mConnectionCount(0)
+                {
+                    mListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+
+                    sockaddr_in address;
+                    memset(&address, 0x00, sizeof(address));
+                    address.sin_family = AF_INET;
+                    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                    address.sin_port = 0;
+
+                    bind(mListenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+                    listen(mListenSocket, 16);
+
+                    socklen_t addressLength = sizeof(address);
+                    getsockname(mListenSocket, reinterpret_cast<sockaddr*>(&address), &addressLength);
+                    mPort = ntohs(address.sin_port);
+
+                    mAcceptThread = new Support::Thread(&CHTTPTestServer::acceptLogic, this);
+                }
+
+                ~CHTTPTestServer(void)
+                {
+                    mShouldTerminate = true;
+
+                    // Unblock accept and all pending reads
+                    shutdown(mListenSocket, SHUT_RDWR);
+                    close(mListenSocket);
+                    mAcceptThread->join();
+                    delete mAcceptThread;
+
+                    for (auto&& connection : mConnections)
+                    {
+                        shutdown(connection.second, SHUT_RDWR);
+                        connection.first->join();
+                        close(connection.second);
+                        delete connection.first;
+                    }
+                }
+
+                //! Returns the base URL of the server.
+                Support::String getURL(void) const
+                {
+                    return "http://127.0.0.1:" + std::to_string(mPort);
+                }
+
+                //! Returns the number of connections accepted so far.
+                Common::U32 getConnectionCount(void) const
+                {
+                    return mConnectionCount;
+                }
+        };
+    } // End NameSpace Net
+} // End NameSpace Kiaro
+#endif // _INCLUDE_NET_TESTS_CHTTPTESTSERVER_HPP_
@@ -0,0 +1,118 @@
+/**
+ *  @file CInboundMessageRing.cpp
+ *  @brief Testing code for the CInboundMessageRing class.
+ */
+
+#include <gtest/gtest.h>
+
+#include <net/CInboundMessageRing.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        TEST(CInboundMessageRing, PushPop)
+        {
+            CInboundMessageRing ring(4, 64);
+            EXPECT_TRUE(ring.isEmpty());
+
+            const Common::U32 first[] = { 1, 2, 3 };
+            const Common::U32 second[] = { 4, 5 };
+
+            EXPECT_TRUE(ring.push(first, sizeof(first)));
+            EXPECT_TRUE(ring.push(second, sizeof(second)));
+            EXPECT_EQ(ring.getSpanCount(), 2);
+            EXPECT_EQ(ring.getByteCount(), sizeof(first) + sizeof(second));
+
+            CInboundMessageRing::Span& span = ring.front();
+            EXPECT_EQ(span.mLength, sizeof(first));
+            EXPECT_EQ(span.mCursor, 0);
+            EXPECT_EQ(reinterpret_cast<Common::U32*>(ring.getData(span))[2], 3);
+
+            ring.pop();
+            EXPECT_EQ(reinterpret_cast<Common::U32*>(ring.getData(ring.front()))[1], 5);
+
+            ring.pop();
+            EXPECT_TRUE(ring.isEmpty());
+            EXPECT_EQ(ring.getByteCount(), 0);
+        }
+
+        TEST(CInboundMessageRing, Bounds)
+        {
+            CInboundMessageRing ring(2, 16);
+            const Common::U8 payload[16] = { 0 };
+
+            // Too large for the byte ring altogether
+            Common::U8 oversized[17];
+            EXPECT_FALSE(ring.push(oversized, sizeof(oversized)));
+
+            // Span count is bounded
+            EXPECT_TRUE(ring.push(payload, 4));
+            EXPECT_TRUE(ring.push(payload, 4));
+            EXPECT_FALSE(ring.push(payload, 4));
+
+            // Byte count is bounded
+            ring.pop();
+            EXPECT_FALSE(ring.push(payload, 13));
+            EXPECT_TRUE(ring.push(payload, 8));
+            EXPECT_EQ(ring.getByteCount(), 12);
+        }
+
+        TEST(CInboundMessageRing, WrapAround)
+        {
+            CInboundMessageRing ring(4, 16);
+            const Common::U8 first[6] = { 1, 1, 1, 1, 1, 1 };
+            const Common::U8 second[6] = { 2, 2, 2, 2, 2, 2 };
+            const Common::U8 third[6] = { 3, 3, 3, 3, 3, 3 };
+
+            EXPECT_TRUE(ring.push(first, sizeof(first)));
+            EXPECT_TRUE(ring.push(second, sizeof(second)));
+            ring.pop();
+
+            // Does not fit at the end, so it must wrap to the front of the ring without overwriting the second payload
+            EXPECT_TRUE(ring.push(third, sizeof(third)));
+            EXPECT_EQ(ring.front().mOffset, 6);
+            EXPECT_EQ(ring.getData(ring.front())[0], 2);
+
+            ring.pop();
+            EXPECT_EQ(ring.front().mOffset, 0);
+            EXPECT_EQ(ring.getData(ring.front())[5], 3);
+
+            // The span between the head and the old tail is now the only free space
+            EXPECT_TRUE(ring.push(first, 4));
+            EXPECT_FALSE(ring.push(first, 7));
+        }
+
+        TEST(CInboundMessageRing, Unbounded)
+        {
+            // Without a span limit, only the byte capacity bounds the ring
+            CInboundMessageRing ring(0, 256);
+
+            for (Common::U8 value = 0; value < 64; ++value)
+            {
+                // Pop now and then so that the spans wrap before the storage grows
+                if (value == 8)
+                {
+                    ring.pop();
+                }
+
+                EXPECT_TRUE(ring.push(&value, sizeof(value)));
+            }
+
+            EXPECT_EQ(ring.getSpanCount(), 63);
+            EXPECT_EQ(ring.getByteCount(), 63);
+
+            for (Common::U8 value = 1; value < 64; ++value)
+            {
+                EXPECT_EQ(ring.getData(ring.front())[0], value);
+                ring.pop();
+            }
+
+            EXPECT_TRUE(ring.isEmpty());
+
+            const Common::U8 payload[256] = { 0 };
+            EXPECT_TRUE(ring.push(payload, sizeof(payload)));
+            EXPECT_FALSE(ring.push(payload, 1));
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
@@ -0,0 +1,137 @@
+/**
+ *  @file CManagementServer.cpp
+ *  @brief Testing code for the CManagementServer class.
+ */
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <support/Console.hpp>
+
+#include <net/CManagementServer.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        //! Services the server until the session has received the given text, returning everything received.
+        static Support::String receiveUntil(CManagementServer& server, const Common::S32 client, const Support::String& expected)
+        {
+            Support::String response;
+
+            for (Common::U32 iteration = 0; iteration < 500 && response.find(expected) == Support::String::npos; ++iteration)
+            {
+                server.update();
+
+                Common::C8 chunk[4096];
+                const ssize_t received = recv(client, chunk, sizeof(chunk), MSG_DONTWAIT);
+
+                if (received == 0)
+                {
+                    break;
+                }
+                else if (received > 0)
+                {
+                    response.append(chunk, received);
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+
+            return response;
+        }
+
+        //! Runs a session through a command, an unknown command and quitting.
+        static void runSession(CManagementServer& server, const Common::S32 client)
+        {
+            EXPECT_NE(Support::String::npos, receiveUntil(server, client, "> ").find("Management console."));
+            EXPECT_EQ(server.getSessionCount(), 1);
+
+            // Commands may arrive in pieces and several at once
+            const Support::String commands = "echo one two\r\nmissing\n";
+            send(client, commands.data(), 5, MSG_NOSIGNAL);
+            server.update();
+            send(client, commands.data() + 5, commands.size() - 5, MSG_NOSIGNAL);
+
+            // Each command is answered with its output, then a prompt
+            Support::String response = receiveUntil(server, client, "Unknown command: missing");
+            if (response.size() < 2 || response.compare(response.size() - 2, 2, "> ") != 0)
+            {
+                response += receiveUntil(server, client, "> ");
+            }
+
+            EXPECT_NE(Support::String::npos, response.find("(INFO) "));
+            EXPECT_LT(response.find("Echo: one two"), response.find("> "));
+            EXPECT_LT(response.find("> "), response.find("(ERROR) "));
+
+            send(client, "quit\n", 5, MSG_NOSIGNAL);
+            EXPECT_NE(Support::String::npos, receiveUntil(server, client, "Goodbye.\n").find("Goodbye.\n"));
+            EXPECT_EQ(server.getSessionCount(), 0);
+        }
+
+        TEST(CManagementServer, TCP)
+        {
+            Support::CManagementConsole console;
+            console.registerFunction("echo", +[](const Support::Vector<Support::String>& parameters)
+            {
+                CONSOLE_INFOF("Echo: %s %s", parameters[0].data(), parameters[1].data());
+            });
+
+            CManagementServer server(&console, "127.0.0.1", 0);
+            EXPECT_NE(server.getPort(), 0);
+
+            const Common::S32 client = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address;
+            memset(&address, 0x00, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(server.getPort());
+
+            ASSERT_EQ(0, connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+            runSession(server, client);
+            close(client);
+
+            EXPECT_THROW(CManagementServer(&console, "not an address", 0), std::runtime_error);
+        }
+
+        TEST(CManagementServer, Unix)
+        {
+            Support::CManagementConsole console;
+            console.registerFunction("echo", +[](const Support::Vector<Support::String>& parameters)
+            {
+                CONSOLE_INFOF("Echo: %s %s", parameters[0].data(), parameters[1].data());
+            });
+
+            const Support::String path = "/tmp/kge_management_test_" + std::to_string(getpid()) + ".sock";
+            {
+                CManagementServer server(&console, "unix:" + path, 0);
+                EXPECT_EQ(server.getPort(), 0);
+
+                const Common::S32 client = socket(AF_UNIX, SOCK_STREAM, 0);
+                sockaddr_un address;
+                memset(&address, 0x00, sizeof(address));
+                address.sun_family = AF_UNIX;
+                strncpy(address.sun_path, path.data(), sizeof(address.sun_path) - 1);
+
+                ASSERT_EQ(0, connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+                runSession(server, client);
+                close(client);
+            }
+
+            // The socket file goes away with the server
+            EXPECT_NE(0, access(path.data(), F_OK));
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
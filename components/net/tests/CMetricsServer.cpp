@@ -0,0 +1,87 @@
+/**
+ *  @file CMetricsServer.cpp
+ *  @brief Testing code for the CMetricsServer class.
+ */
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <support/SMetricsRegistry.hpp>
+
+#include <net/CMetricsServer.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        //! Sends the given request to the server and services it until the response is complete.
+        static Support::String request(CMetricsServer& server, const Support::String& requestText)
+        {
+            const Common::S32 client = socket(AF_INET, SOCK_STREAM, 0);
+
+            sockaddr_in address;
+            memset(&address, 0x00, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(server.getPort());
+
+            EXPECT_EQ(0, connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+            send(client, requestText.data(), requestText.size(), MSG_NOSIGNAL);
+
+            // The server closes the connection once it has written everything
+            Support::String response;
+            for (Common::U32 iteration = 0; iteration < 500; ++iteration)
+            {
+                server.update();
+
+                Common::C8 chunk[4096];
+                const ssize_t received = recv(client, chunk, sizeof(chunk), MSG_DONTWAIT);
+
+                if (received == 0)
+                {
+                    break;
+                }
+                else if (received > 0)
+                {
+                    response.append(chunk, received);
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+
+            close(client);
+            return response;
+        }
+
+        TEST(CMetricsServer, Scrape)
+        {
+            Support::SMetricsRegistry::getInstance()->getCounter("test_scrapes_total", "Scrapes served.")->increment(7);
+
+            CMetricsServer server("127.0.0.1", 0);
+            EXPECT_NE(server.getPort(), 0);
+
+            const Support::String response = request(server, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+            EXPECT_EQ(0, response.find("HTTP/1.1 200 OK\r\n"));
+            EXPECT_NE(Support::String::npos, response.find("Content-Type: text/plain; version=0.0.4"));
+            EXPECT_NE(Support::String::npos, response.find("\r\n\r\n# HELP test_scrapes_total Scrapes served.\n"));
+            EXPECT_NE(Support::String::npos, response.find("test_scrapes_total 7\n"));
+
+            EXPECT_EQ(0, request(server, "GET / HTTP/1.1\r\n\r\n").find("HTTP/1.1 404 Not Found\r\n"));
+            EXPECT_EQ(0, request(server, "POST /metrics HTTP/1.1\r\n\r\n").find("HTTP/1.1 405 Method Not Allowed\r\n"));
+
+            EXPECT_THROW(CMetricsServer("not an address", 0), std::runtime_error);
+            Support::SMetricsRegistry::destroy();
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
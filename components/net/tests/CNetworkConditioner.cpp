@@ -0,0 +1,207 @@
+/**
+ *  @file CNetworkConditioner.cpp
+ *  @brief Testing code for the CNetworkConditioner class.
+ */
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <support/Vector.hpp>
+
+#include <net/CNetworkConditioner.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        static CNetworkConditioner::Parameters makeParameters(void)
+        {
+            CNetworkConditioner::Parameters result;
+            result.mEnabled = true;
+            result.mLatencyMS = 0;
+            result.mJitterMS = 0;
+            result.mLossPercent = 0;
+            result.mDuplicatePercent = 0;
+            result.mReorderPercent = 0;
+            result.mBandwidth = 0;
+            result.mSeed = 1337;
+
+            return result;
+        }
+
+        static ENetPacket* makePacket(const Common::U32 value, const Common::U32 flags)
+        {
+            return enet_packet_create(&value, sizeof(value), flags);
+        }
+
+        static Common::U32 readPacket(ENetPacket* packet)
+        {
+            const Common::U32 result = *reinterpret_cast<Common::U32*>(packet->data);
+            enet_packet_destroy(packet);
+
+            return result;
+        }
+
+        static Support::Vector<Common::U32> drain(CNetworkConditioner& conditioner, const Common::U64 currentTimeMS)
+        {
+            Support::Vector<Common::U32> result;
+
+            ENetPeer* peer = nullptr;
+            ENetPacket* packet = nullptr;
+
+            while (conditioner.popIncoming(currentTimeMS, peer, packet))
+            {
+                result.push_back(readPacket(packet));
+            }
+
+            return result;
+        }
+
+        TEST(CNetworkConditioner, Latency)
+        {
+            CNetworkConditioner::Parameters parameters = makeParameters();
+            parameters.mLatencyMS = 100;
+            CNetworkConditioner conditioner(parameters);
+
+            ENetPeer peer;
+
+            EXPECT_TRUE(conditioner.receive(&peer, 0, makePacket(1, ENET_PACKET_FLAG_RELIABLE), 1000));
+            EXPECT_TRUE(conditioner.receive(&peer, 0, makePacket(2, ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT), 1050));
+            EXPECT_EQ(conditioner.getQueuedPacketCount(), 2);
+
+            EXPECT_TRUE(drain(conditioner, 1099).empty());
+            EXPECT_EQ(drain(conditioner, 1100), Support::Vector<Common::U32>({ 1 }));
+            EXPECT_EQ(drain(conditioner, 1150), Support::Vector<Common::U32>({ 2 }));
+            EXPECT_EQ(conditioner.getQueuedPacketCount(), 0);
+
+            // Disabled conditioners pass everything straight through
+            parameters.mEnabled = false;
+            conditioner.setParameters(parameters);
+
+            ENetPacket* passthrough = makePacket(3, ENET_PACKET_FLAG_RELIABLE);
+            EXPECT_FALSE(conditioner.receive(&peer, 0, passthrough, 2000));
+            enet_packet_destroy(passthrough);
+        }
+
+        TEST(CNetworkConditioner, ReliableOrdering)
+        {
+            // Heavy jitter and loss must never reorder or drop reliable packets
+            CNetworkConditioner::Parameters parameters = makeParameters();
+            parameters.mLatencyMS = 50;
+            parameters.mJitterMS = 200;
+            parameters.mLossPercent = 50;
+            CNetworkConditioner conditioner(parameters);
+
+            ENetPeer peer;
+
+            for (Common::U32 iteration = 0; iteration < 100; ++iteration)
+            {
+                conditioner.receive(&peer, 0, makePacket(iteration, ENET_PACKET_FLAG_RELIABLE), iteration);
+            }
+
+            Support::Vector<Common::U32> received;
+            for (Common::U64 currentTimeMS = 0; currentTimeMS < 2000; currentTimeMS += 16)
+            {
+                const Support::Vector<Common::U32> delivered = drain(conditioner, currentTimeMS);
+                received.insert(received.end(), delivered.begin(), delivered.end());
+            }
+
+            ASSERT_EQ(received.size(), 100);
+
+            for (Common::U32 iteration = 0; iteration < 100; ++iteration)
+            {
+                EXPECT_EQ(received[iteration], iteration);
+            }
+        }
+
+        TEST(CNetworkConditioner, UnreliableImpairments)
+        {
+            CNetworkConditioner::Parameters parameters = makeParameters();
+            parameters.mLatencyMS = 20;
+            parameters.mLossPercent = 20;
+            parameters.mDuplicatePercent = 20;
+            parameters.mReorderPercent = 20;
+
+            Support::Vector<Common::U32> first;
+
+            // The same seed must produce the same result
+            for (Common::U32 run = 0; run < 2; ++run)
+            {
+                CNetworkConditioner conditioner(parameters);
+                ENetPeer peer;
+
+                for (Common::U32 iteration = 0; iteration < 1000; ++iteration)
+                {
+                    conditioner.receive(&peer, 0, makePacket(iteration, ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT), iteration);
+                }
+
+                const Support::Vector<Common::U32> received = drain(conditioner, 5000);
+
+                if (run == 0)
+                {
+                    first = received;
+                    continue;
+                }
+
+                EXPECT_EQ(received, first);
+            }
+
+            Support::Vector<Common::U32> sorted = first;
+            std::sort(sorted.begin(), sorted.end());
+
+            const size_t uniqueCount = std::unique(sorted.begin(), sorted.end()) - sorted.begin();
+            const size_t duplicateCount = first.size() - uniqueCount;
+            const size_t lostCount = 1000 - uniqueCount;
+
+            EXPECT_NEAR(lostCount, 200, 60);
+            EXPECT_NEAR(duplicateCount, 160, 60);
+            EXPECT_FALSE(std::is_sorted(first.begin(), first.end()));
+        }
+
+        TEST(CNetworkConditioner, Bandwidth)
+        {
+            CNetworkConditioner::Parameters parameters = makeParameters();
+            parameters.mBandwidth = 4000;
+            CNetworkConditioner conditioner(parameters);
+
+            ENetPeer peer;
+            Common::U8 payload[100] = { 0 };
+
+            for (Common::U32 iteration = 0; iteration < 100; ++iteration)
+            {
+                conditioner.receive(&peer, 0, enet_packet_create(payload, sizeof(payload), ENET_PACKET_FLAG_RELIABLE), 1000);
+            }
+
+            // 10,000 bytes at 4,000 bytes per second with a small burst allowance should take roughly 2.4 seconds to get through
+            size_t deliveredCount = 0;
+            Common::U64 currentTimeMS = 1000;
+
+            for (; deliveredCount < 100 && currentTimeMS < 10000; currentTimeMS += 10)
+            {
+                deliveredCount += drain(conditioner, currentTimeMS).size();
+            }
+
+            EXPECT_EQ(deliveredCount, 100);
+            EXPECT_NEAR(currentTimeMS - 1000, 2400, 200);
+        }
+
+        TEST(CNetworkConditioner, Purge)
+        {
+            CNetworkConditioner::Parameters parameters = makeParameters();
+            parameters.mLatencyMS = 100;
+            CNetworkConditioner conditioner(parameters);
+
+            ENetPeer first;
+            ENetPeer second;
+
+            conditioner.receive(&first, 0, makePacket(1, ENET_PACKET_FLAG_RELIABLE), 0);
+            conditioner.receive(&second, 0, makePacket(2, ENET_PACKET_FLAG_RELIABLE), 0);
+            conditioner.send(&first, 0, makePacket(3, ENET_PACKET_FLAG_RELIABLE), 0);
+
+            conditioner.purge(&first);
+            EXPECT_EQ(conditioner.getQueuedPacketCount(), 1);
+            EXPECT_EQ(drain(conditioner, 100), Support::Vector<Common::U32>({ 2 }));
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
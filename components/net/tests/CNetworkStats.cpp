@@ -0,0 +1,97 @@
+/**
+ *  @file CNetworkStats.cpp
+ *  @brief Testing code for the CNetworkStats class.
+ */
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <net/CNetworkStats.hpp>
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        TEST(CNetworkStats, Throughput)
+        {
+            CNetworkStats stats;
+            stats.sample(nullptr, 1000);
+
+            const Common::U64 totalBytesSent = CNetworkStats::getTotalBytesSent();
+            const Common::U64 totalPacketsReceived = CNetworkStats::getTotalPacketsReceived();
+
+            stats.recordSentPacket(1000);
+            stats.recordSentPacket(1000);
+            stats.recordReceivedPacket(500);
+
+            // Not enough time has passed to close the window
+            stats.sample(nullptr, 1500);
+            EXPECT_EQ(stats.getOutgoingBytesPerSecond(), 0.0f);
+
+            stats.sample(nullptr, 3000);
+            EXPECT_NEAR(stats.getOutgoingBytesPerSecond(), 1000.0f, 0.01f);
+            EXPECT_NEAR(stats.getIncomingBytesPerSecond(), 250.0f, 0.01f);
+
+            EXPECT_EQ(stats.getPacketsSent(), 2);
+            EXPECT_EQ(stats.getBytesSent(), 2000);
+            EXPECT_EQ(stats.getPacketsReceived(), 1);
+            EXPECT_EQ(stats.getBytesReceived(), 500);
+
+            // Process totals are not affected by resetting a connection
+            stats.reset();
+            EXPECT_EQ(CNetworkStats::getTotalBytesSent() - totalBytesSent, 2000);
+            EXPECT_EQ(CNetworkStats::getTotalPacketsReceived() - totalPacketsReceived, 1);
+        }
+
+        TEST(CNetworkStats, PeerSampling)
+        {
+            ENetPeer peer;
+            memset(&peer, 0x00, sizeof(peer));
+            peer.roundTripTime = 120;
+            peer.roundTripTimeVariance = 15;
+            peer.packetLoss = ENET_PEER_PACKET_LOSS_SCALE / 4;
+            peer.reliableDataInTransit = 2048;
+
+            CNetworkStats stats;
+            stats.sample(&peer, 0);
+
+            EXPECT_EQ(stats.getRoundTripTimeMS(), 120);
+            EXPECT_EQ(stats.getRoundTripTimeVarianceMS(), 15);
+            EXPECT_NEAR(stats.getPacketLoss(), 0.25f, 0.0001f);
+            EXPECT_EQ(stats.getReliableBytesInTransit(), 2048);
+        }
+
+        TEST(CNetworkStats, MessageTypes)
+        {
+            CNetworkStats stats;
+
+            // A stream holding two packed messages of different types
+            Support::CBitStream stream(64);
+            stream << static_cast<Common::U32>(3) << static_cast<Common::U32>(0) << static_cast<Common::F32>(1.0f);
+            stats.recordSentMessage(stream, 0);
+
+            const size_t secondStart = stream.getPointer();
+            stream << static_cast<Common::U32>(7) << static_cast<Common::U32>(1);
+            stats.recordSentMessage(stream, secondStart);
+
+            stats.recordReceivedMessage(3, 12);
+            stats.recordReceivedMessage(3, 16);
+
+            const auto& types = stats.getMessageTypeStats();
+            ASSERT_EQ(types.size(), 2);
+
+            EXPECT_EQ(types.at(3).mSentCount, 1);
+            EXPECT_EQ(types.at(3).mSentBytes, 12);
+            EXPECT_EQ(types.at(3).mReceivedCount, 2);
+            EXPECT_EQ(types.at(3).mReceivedBytes, 28);
+
+            EXPECT_EQ(types.at(7).mSentCount, 1);
+            EXPECT_EQ(types.at(7).mSentBytes, 8);
+            EXPECT_EQ(types.at(7).mReceivedCount, 0);
+
+            stats.reset();
+            EXPECT_EQ(stats.getMessageTypeStats().size(), 0);
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
@@ -0,0 +1,111 @@
+/**
+ *  @file SHTTPClient.cpp
+ *  @brief Testing code for the SHTTPClient class.
+ */
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <net/SHTTPClient.hpp>
+
+#include "CHTTPTestServer.hpp"
+
+namespace Kiaro
+{
+    namespace Net
+    {
+        //! Services the client until nothing is pending or we have waited too long.
+        static void waitForRequests(SHTTPClient* client)
+        {
+            for (Common::U32 iteration = 0; iteration < 500 && client->getPendingCount() != 0; ++iteration)
+            {
+                client->update();
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        TEST(SHTTPClient, AsynchronousGET)
+        {
+            CHTTPTestServer server;
+            SHTTPClient* client = SHTTPClient::getInstance();
+
+            CHTTPObject requests[3];
+            Common::U32 completed = 0;
+
+            for (CHTTPObject& request : requests)
+            {
+                request.setURL(server.getURL() + "/");
+                client->dispatch(&request, [&completed](CHTTPObject* finished, const bool success)
+                {
+                    EXPECT_TRUE(success);
+                    EXPECT_EQ(finished->getResponseCode(), 200);
+                    EXPECT_STREQ(reinterpret_cast<Common::C8*>(finished->getResponseBody()), CHTTPTestServer::sGETResponse);
+                    ++completed;
+                });
+            }
+
+            EXPECT_EQ(client->getPendingCount(), 3);
+            EXPECT_THROW(client->dispatch(&requests[0]), std::runtime_error);
+
+            waitForRequests(client);
+            EXPECT_EQ(completed, 3);
+            EXPECT_EQ(client->getPendingCount(), 0);
+
+            SHTTPClient::destroy();
+        }
+
+        TEST(SHTTPClient, ConnectionReuse)
+        {
+            CHTTPTestServer server;
+            SHTTPClient* client = SHTTPClient::getInstance();
+
+            CHTTPObject request;
+            request.setURL(server.getURL() + "/heartbeat");
+
+            // Sequential requests against the same host should share a single connection
+            for (Common::U32 iteration = 0; iteration < 4; ++iteration)
+            {
+                bool succeeded = false;
+                client->dispatch(&request, [&succeeded](CHTTPObject* finished, const bool success)
+                {
+                    succeeded = success;
+                });
+
+                waitForRequests(client);
+                EXPECT_TRUE(succeeded);
+            }
+
+            EXPECT_EQ(server.getConnectionCount(), 1);
+
+            SHTTPClient::destroy();
+        }
+
+        TEST(SHTTPClient, Cancel)
+        {
+            CHTTPTestServer server;
+            SHTTPClient* client = SHTTPClient::getInstance();
+
+            CHTTPObject request;
+            request.setURL(server.getURL() + "/");
+
+            bool called = false;
+            client->dispatch(&request, [&called](CHTTPObject* finished, const bool success)
+            {
+                called = true;
+            });
+
+            EXPECT_TRUE(client->isPending(&request));
+            EXPECT_TRUE(client->cancel(&request));
+            EXPECT_FALSE(client->isPending(&request));
+            EXPECT_FALSE(client->cancel(&request));
+
+            waitForRequests(client);
+            client->update();
+            EXPECT_FALSE(called);
+
+            SHTTPClient::destroy();
+        }
+    } // End NameSpace Net
+} // End NameSpace Kiaro
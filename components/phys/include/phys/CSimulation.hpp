@@ -67,6 +67,14 @@ namespace Kiaro
                  */
                 void update(const Common::F32 deltaTimeSeconds);
 
+                /**
+                 *  @brief Advances the physical simulation by exactly one step of the given length. Unlike update, the
+                 *  step is not subdivided or interpolated internally, so driving this from a fixed timestep keeps the
+                 *  physical simulation in lockstep with the game simulation.
+                 *  @param stepSeconds The length of the step in seconds.
+                 */
+                void step(const Common::F32 stepSeconds);
+
                 /**
                  *  @brief Set the debug renderer of the simulation which will be utilized immediately.
                  *  @param renderer The pointer to the renderer to use. If NULL, then there will be no
@@ -9,6 +9,8 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <support/SProfiler.hpp>
+
 #include <phys/CSimulation.hpp>
 
 namespace Kiaro
@@ -43,6 +45,14 @@ namespace Kiaro
             mPhysicalWorld->stepSimulation(deltaTimeSeconds);
         }
 
+        void CSimulation::step(const Common::F32 stepSeconds)
+        {
+            PROFILER_SCOPE(PhysicsStep);
+
+            // Without substeps, Bullet advances by exactly the given time
+            mPhysicalWorld->stepSimulation(stepSeconds, 0);
+        }
+
         void CSimulation::setDebugRenderer(IDebugRenderer* renderer)
         {
             // We shouldn't already have a debug renderer in here
@@ -13,6 +13,7 @@
 
 #include <sound/CSoundSource.hpp>
 #include <support/Console.hpp>
+#include <support/SAllocationTracker.hpp>
 
 namespace Kiaro
 {
@@ -56,6 +57,7 @@ namespace Kiaro
                 return nullptr;
             }
 
+            ALLOCATION_SCOPE(SoundSources);
             CVoice* voice = new CVoice(channel);
             mVoices.insert(mVoices.end(), voice);
             return voice;
@@ -13,6 +13,7 @@
 #include <fmod_errors.h>
 
 #include <support/Console.hpp>
+#include <support/SAllocationTracker.hpp>
 
 #include <sound/SSoundManager.hpp>
 
@@ -146,6 +147,7 @@ namespace Kiaro
                 return nullptr;
             }
 
+            ALLOCATION_SCOPE(SoundSources);
             CSoundSource* sound = new CSoundSource(mFMod, filename.data());
             mSoundRegistry[filename] = sound;
             return sound;
@@ -121,6 +121,21 @@ namespace Kiaro
                  */
                 void writeString(const Common::C8* string, const size_t length);
 
+                /**
+                 *  @brief Writes a raw block of memory to the CBitStream. No endian swapping is performed on the data.
+                 *  @param data A pointer to the memory to write.
+                 *  @param length The number of bytes to write.
+                 */
+                void writeBytes(const void* data, const size_t length);
+
+                /**
+                 *  @brief Returns a pointer to the raw block of memory of the given length that is currently at the top of the
+                 *  CBitStream while also popping it from the CBitStream.
+                 *  @param length The number of bytes to pop.
+                 *  @return A pointer into the CBitStream's memory block. This is only valid until the CBitStream is next written to.
+                 */
+                const void* popBytes(const size_t length);
+
                 /**
                  *  @brief Returns a pointer to the string that is currently at the top of the CBitStream.
                  *  @return A pointer to the raw C string that is currently at the top of the CBitStream.
@@ -238,7 +253,7 @@ namespace Kiaro
                  *  block the bit stream currently is at.
                  *  @return A reference to the internally stored stream index pointer.
                  */
-                size_t getPointer(void);
+                size_t getPointer(void) const;
 
                 /**
                  *  @brief Returns a pointer to the internal memory block that this bit stream is using.
@@ -246,6 +261,9 @@ namespace Kiaro
                  */
                 void* getBlock(void);
 
+                //! @copydoc getBlock
+                const void* getBlock(void) const;
+
                 /**
                  *  @brief Sets the current location of the stream pointer.
                  *  @param pointer The new pointer value to use.
@@ -0,0 +1,156 @@
+/**
+ *  @file CBoundedMPSCQueue.hpp
+ *  @brief Include file declaring and implementing the CBoundedMPSCQueue class template.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_CBOUNDEDMPSCQUEUE_HPP_
+#define _INCLUDE_SUPPORT_CBOUNDEDMPSCQUEUE_HPP_
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        /**
+         *  @brief A fixed capacity queue any number of threads may push to while a single thread pops, without ever taking a
+         *  lock.
+         *  @details The implementation follows Dmitry Vyukov's bounded queue: every slot carries a sequence number telling
+         *  producers whether it is free and the consumer whether it has been published. Pushing to a full queue fails
+         *  rather than waiting or allocating, so the memory used is fixed at construction.
+         */
+        template <typename elementType>
+        class CBoundedMPSCQueue
+        {
+            // Private Members
+            private:
+                //! A slot of the ring.
+                struct Slot
+                {
+                    //! Equal to the position the slot may be pushed at when free, and one past it once published.
+                    Support::Atomic<size_t> mSequence;
+
+                    //! The stored element.
+                    elementType mElement;
+                };
+
+                //! The ring of slots.
+                Slot* mSlots;
+
+                //! The capacity minus one, used for masking positions.
+                const size_t mMask;
+
+                //! The next position producers claim.
+                alignas(64) Support::Atomic<size_t> mPushPosition;
+
+                //! The next position the consumer pops from.
+                alignas(64) Support::Atomic<size_t> mPopPosition;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the capacity.
+                 *  @param capacity The maximum number of elements held. This must be a power of two.
+                 */
+                CBoundedMPSCQueue(const size_t capacity) : mSlots(new Slot[capacity]), mMask(capacity - 1), mPushPosition(0), mPopPosition(0)
+                {
+                    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+
+                    for (size_t iteration = 0; iteration < capacity; ++iteration)
+                    {
+                        mSlots[iteration].mSequence.store(iteration, std::memory_order_relaxed);
+                    }
+                }
+
+                //! Standard destructor.
+                ~CBoundedMPSCQueue(void)
+                {
+                    delete[] mSlots;
+                }
+
+                /**
+                 *  @brief Pushes an element. May be called from any thread.
+                 *  @param element The element to push.
+                 *  @return True if the element was pushed, false if the queue was full.
+                 */
+                bool tryPush(const elementType& element)
+                {
+                    size_t position = mPushPosition.load(std::memory_order_relaxed);
+
+                    while (true)
+                    {
+                        Slot& slot = mSlots[position & mMask];
+                        const size_t sequence = slot.mSequence.load(std::memory_order_acquire);
+
+                        if (sequence == position)
+                        {
+                            // The slot is free, claim it unless another producer got there first
+                            if (mPushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            {
+                                slot.mElement = element;
+                                slot.mSequence.store(position + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (sequence < position)
+                        {
+                            // The consumer has not freed the slot a lap ago yet
+                            return false;
+                        }
+                        else
+                        {
+                            position = mPushPosition.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                /**
+                 *  @brief Pops the oldest published element. May only be called from the consuming thread.
+                 *  @param element Set to the popped element.
+                 *  @return True if an element was popped, false if the queue was empty or the next element is still being
+                 *  written.
+                 */
+                bool tryPop(elementType& element)
+                {
+                    const size_t position = mPopPosition.load(std::memory_order_relaxed);
+                    Slot& slot = mSlots[position & mMask];
+
+                    if (slot.mSequence.load(std::memory_order_acquire) != position + 1)
+                    {
+                        return false;
+                    }
+
+                    element = slot.mElement;
+                    slot.mSequence.store(position + mMask + 1, std::memory_order_release);
+                    mPopPosition.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+
+                //! Returns the number of elements ever claimed by producers, including ones still being written.
+                size_t getPushCount(void) const
+                {
+                    return mPushPosition.load(std::memory_order_acquire);
+                }
+
+                //! Returns the number of elements ever popped.
+                size_t getPopCount(void) const
+                {
+                    return mPopPosition.load(std::memory_order_acquire);
+                }
+
+                //! Returns the maximum number of elements held.
+                size_t getCapacity(void) const
+                {
+                    return mMask + 1;
+                }
+        };
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_CBOUNDEDMPSCQUEUE_HPP_
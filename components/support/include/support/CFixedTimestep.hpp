@@ -0,0 +1,102 @@
+/**
+ *  @file CFixedTimestep.hpp
+ *  @brief Include file declaring the CFixedTimestep class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_CFIXEDTIMESTEP_HPP_
+#define _INCLUDE_SUPPORT_CFIXEDTIMESTEP_HPP_
+
+#include <support/common.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        /**
+         *  @brief Converts frames of arbitrary length into a sequence of equally sized simulation steps. Elapsed time is
+         *  added to an accumulator and every whole step in it is handed out with its own tick number, so the simulation
+         *  runs at exactly its step rate no matter how fast or slow frames are rendered.
+         *  @details Time is kept in integer microseconds so that steps never drift against the clock. Should a frame take
+         *  long enough to produce more than the maximum number of steps, the excess is dropped rather than caught up
+         *  on, as trying to catch up on an overloaded machine only makes the following frames longer.
+         */
+        class CFixedTimestep
+        {
+            // Private Members
+            private:
+                //! The length of a single step in microseconds.
+                const Common::U64 mStepMicroseconds;
+
+                //! The maximum number of steps handed out per call to addTime.
+                Common::U32 mMaxStepsPerUpdate;
+
+                //! The time added that was not consumed by steps yet, in microseconds.
+                Common::U64 mAccumulatedMicroseconds;
+
+                //! The tick number of the last step consumed. Zero means no step was consumed yet.
+                Common::U64 mTickNumber;
+
+                //! The number of steps dropped because they exceeded mMaxStepsPerUpdate.
+                Common::U64 mDroppedStepCount;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the step length and the catch up limit.
+                 *  @param stepMicroseconds The length of a single step in microseconds. Must not be zero.
+                 *  @param maxStepsPerUpdate The maximum number of steps handed out per call to addTime. Must not be zero.
+                 *  @throw std::logic_error Thrown when either parameter is zero.
+                 */
+                CFixedTimestep(const Common::U64 stepMicroseconds, const Common::U32 maxStepsPerUpdate);
+
+                /**
+                 *  @brief Adds elapsed time to the accumulator. Any whole steps beyond the catch up limit are dropped.
+                 *  @param elapsedMicroseconds The time that has passed since the last call.
+                 *  @return The number of steps that are now ready to be consumed.
+                 */
+                Common::U32 addTime(const Common::U64 elapsedMicroseconds);
+
+                /**
+                 *  @brief Consumes the next ready step, advancing the tick number.
+                 *  @return True if a step was consumed, in which case the caller should simulate tick getTickNumber.
+                 */
+                bool consumeStep(void);
+
+                /**
+                 *  @brief Sets the maximum number of steps handed out per call to addTime.
+                 *  @param maxStepsPerUpdate The new limit. Must not be zero.
+                 *  @throw std::logic_error Thrown when maxStepsPerUpdate is zero.
+                 */
+                void setMaxStepsPerUpdate(const Common::U32 maxStepsPerUpdate);
+
+                //! Returns the tick number of the last step consumed.
+                Common::U64 getTickNumber(void) const;
+
+                //! Returns the length of a single step in seconds.
+                Common::F32 getStepSeconds(void) const;
+
+                //! Returns the length of a single step in microseconds.
+                Common::U64 getStepMicroseconds(void) const;
+
+                /**
+                 *  @brief Returns how far the clock has progressed from the last consumed step towards the next one, for
+                 *  rendering to interpolate between the last two simulated states.
+                 *  @return A value in [0, 1) once all ready steps were consumed.
+                 */
+                Common::F32 getInterpolationAlpha(void) const;
+
+                //! Returns the time until the next step is ready in microseconds, which is zero while steps are ready.
+                Common::U64 getTimeUntilNextStepMicroseconds(void) const;
+
+                //! Returns the number of steps dropped because they exceeded the catch up limit.
+                Common::U64 getDroppedStepCount(void) const;
+        };
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_CFIXEDTIMESTEP_HPP_
@@ -0,0 +1,103 @@
+/**
+ *  @file CLatencyHistogram.hpp
+ *  @brief Include file declaring the CLatencyHistogram class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_CLATENCYHISTOGRAM_HPP_
+#define _INCLUDE_SUPPORT_CLATENCYHISTOGRAM_HPP_
+
+#include <support/common.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        /**
+         *  @brief A histogram of durations in nanoseconds with a fixed relative precision, in the style of an HDR histogram.
+         *  Recording a value is a handful of integer operations and never allocates, and percentiles can be read at any
+         *  time without keeping the recorded values around.
+         *  @details Values below sSubBucketCount are counted exactly. Above that, every power of two is split into
+         *  sSubBucketCount / 2 equally wide buckets, so every value is known to within about 3% up to 2^40 nanoseconds,
+         *  or roughly 18 minutes. Larger values are counted in the last bucket. The minimum and maximum are kept exactly.
+         */
+        class CLatencyHistogram
+        {
+            // Public Members
+            public:
+                //! The number of linear buckets every power of two above the exact range is split into, times two.
+                static const Common::U32 sSubBucketCount = 64;
+
+                //! The number of powers of two covered.
+                static const Common::U32 sMaximumExponent = 40;
+
+                //! The total number of buckets.
+                static const Common::U32 sBucketCount = sSubBucketCount + (sMaximumExponent - 6) * (sSubBucketCount / 2);
+
+            // Private Members
+            private:
+                //! The number of values recorded in each bucket.
+                Common::U32 mCounts[sBucketCount];
+
+                //! The number of values recorded.
+                Common::U64 mTotalCount;
+
+                //! The smallest value recorded.
+                Common::U64 mMinimum;
+
+                //! The largest value recorded.
+                Common::U64 mMaximum;
+
+            // Public Methods
+            public:
+                //! Parameterless constructor creating an empty histogram.
+                CLatencyHistogram(void);
+
+                /**
+                 *  @brief Records a single value.
+                 *  @param nanoseconds The value to record.
+                 */
+                void record(const Common::U64 nanoseconds);
+
+                /**
+                 *  @brief Adds every value recorded in the given histogram to this one.
+                 *  @param other The histogram to add.
+                 */
+                void merge(const CLatencyHistogram& other);
+
+                //! Discards every value recorded.
+                void clear(void);
+
+                //! Returns the number of values recorded.
+                Common::U64 getCount(void) const;
+
+                //! Returns the smallest value recorded, or zero if nothing was recorded.
+                Common::U64 getMinimum(void) const;
+
+                //! Returns the largest value recorded, or zero if nothing was recorded.
+                Common::U64 getMaximum(void) const;
+
+                /**
+                 *  @brief Returns the value at the given percentile: the largest value of the bucket holding it, but never
+                 *  more than the maximum recorded.
+                 *  @param percentile The percentile to look up, from 0 to 100.
+                 *  @return The value at the percentile, or zero if nothing was recorded.
+                 */
+                Common::U64 getPercentile(const Common::F64 percentile) const;
+
+            // Private Methods
+            private:
+                //! Returns the bucket the given value is counted in.
+                static Common::U32 getBucketIndex(const Common::U64 nanoseconds);
+
+                //! Returns the largest value counted in the given bucket.
+                static Common::U64 getBucketUpperBound(const Common::U32 bucket);
+        };
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_CLATENCYHISTOGRAM_HPP_
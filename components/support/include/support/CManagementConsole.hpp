@@ -54,6 +54,9 @@ namespace Kiaro
                  */
                 bool eval(const Support::String& input);
 
+                //! Returns the names of every registered management function in alphabetical order.
+                Support::Vector<Support::String> getFunctionNames(void) const;
+
                 /**
                  *  @brief Registers a callable management function to the CManagementConsole.
                  *  @param name The name of the management function.
@@ -14,6 +14,9 @@
 
 #include <iostream>
 #include <fstream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include <support/common.hpp>
 
@@ -21,6 +24,7 @@
 #include <support/UnorderedMap.hpp>
 
 #include <support/String.hpp>
+#include <support/types.hpp>
 
 #include <easydelegate/easydelegate.hpp>
 
@@ -57,8 +61,6 @@ namespace Kiaro
              */
             typedef void (*LogResponderPointer)(MESSAGE_TYPE type, const Support::String& message);
 
-            extern Support::UnorderedMap<Common::U8, LogResponderSetType> sLogResponders;
-
             inline const Common::C8* messageTypeText(MESSAGE_TYPE type)
             {
                 switch(type)
@@ -82,41 +84,273 @@ namespace Kiaro
                 return "UNKNOWN";
             }
 
+            /**
+             *  @brief Returns how severe the given message type is, from 0 for debug messages up to 4 for fatal errors.
+             *  @param type The message type to look up.
+             */
+            constexpr Common::U8 messageSeverity(const MESSAGE_TYPE type)
+            {
+                return type == MESSAGE_DEBUG ? 0 : type == MESSAGE_WARNING ? 2 : type == MESSAGE_ERROR ? 3 : type == MESSAGE_FATAL ? 4 : 1;
+            }
+
+            //! The least severe message type compiled in. Writes of anything less severe compile to nothing.
+            #ifndef CONSOLE_MINIMUM_SEVERITY
+                #ifdef NDEBUG
+                    #define CONSOLE_MINIMUM_SEVERITY MESSAGE_INFO
+                #else
+                    #define CONSOLE_MINIMUM_SEVERITY MESSAGE_DEBUG
+                #endif
+            #endif
+
+            //! The number of messages the console queue holds. Must be a power of two.
+            #ifndef CONSOLE_QUEUE_CAPACITY
+                #define CONSOLE_QUEUE_CAPACITY 2048
+            #endif
+
+            //! The number of bytes of arguments a queued message holds. Messages with larger arguments are formatted by the writer.
+            #ifndef CONSOLE_RECORD_PAYLOAD_BYTES
+                #define CONSOLE_RECORD_PAYLOAD_BYTES 224
+            #endif
+
+            //! The least severe message type written at runtime, as returned by messageSeverity.
+            extern Support::Atomic<Common::U8> sMinimumSeverity;
+
+            struct LogRecord;
+
+            /**
+             *  @brief A function that formats a queued message.
+             *  @param record The message to format.
+             *  @param output The string to write the message to. When nullptr, the record is only released.
+             */
+            typedef void (*LogFormatter)(const LogRecord& record, Support::String* output);
+
+            /**
+             *  @brief A message waiting in the console queue. Arguments are captured in their binary form and only formatted
+             *  by the console thread.
+             */
+            struct LogRecord
+            {
+                //! The message type.
+                MESSAGE_TYPE mType;
+
+                //! The format string. Must have static storage, as it is read after the write returns.
+                const Common::C8* mFormat;
+
+                //! Formats the payload with mFormat. When nullptr, mFormat is written as is.
+                LogFormatter mFormatter;
+
+                //! The captured arguments.
+                Common::U8 mPayload[CONSOLE_RECORD_PAYLOAD_BYTES];
+            };
+
+            /**
+             *  @brief Captures a single format argument into a record payload. Arguments are copied byte for byte, which
+             *  covers every type printf accepts besides strings.
+             */
+            template <typename argumentType>
+            struct LogArgument
+            {
+                static_assert(std::is_trivially_copyable<argumentType>::value, "Console arguments must be trivially copyable.");
+
+                typedef argumentType DecodedType;
+
+                static size_t getSize(const argumentType&)
+                {
+                    return sizeof(argumentType);
+                }
+
+                static void encode(Common::U8*& cursor, const argumentType& argument)
+                {
+                    memcpy(cursor, &argument, sizeof(argumentType));
+                    cursor += sizeof(argumentType);
+                }
+
+                static DecodedType decode(const Common::U8*& cursor)
+                {
+                    argumentType result;
+                    memcpy(&result, cursor, sizeof(argumentType));
+                    cursor += sizeof(argumentType);
+                    return result;
+                }
+            };
+
+            //! Strings are copied including their terminator, since the memory they point to may be gone by the time they are formatted.
+            template <>
+            struct LogArgument<const Common::C8*>
+            {
+                typedef const Common::C8* DecodedType;
+
+                static size_t getSize(const Common::C8* argument)
+                {
+                    return strlen(argument ? argument : "(null)") + 1;
+                }
+
+                static void encode(Common::U8*& cursor, const Common::C8* argument)
+                {
+                    const size_t size = getSize(argument);
+                    memcpy(cursor, argument ? argument : "(null)", size);
+                    cursor += size;
+                }
+
+                static DecodedType decode(const Common::U8*& cursor)
+                {
+                    const Common::C8* result = reinterpret_cast<const Common::C8*>(cursor);
+                    cursor += strlen(result) + 1;
+                    return result;
+                }
+            };
+
+            template <>
+            struct LogArgument<Common::C8*> : public LogArgument<const Common::C8*>
+            {
+
+            };
+
+            /**
+             *  @brief Formats a string without any length limit.
+             *  @param format The printf style format string.
+             *  @param params The parameters to format.
+             *  @return The formatted string.
+             */
+            template <typename... parameters>
+            static Support::String formatString(const Common::C8* format, parameters... params)
+            {
+                Common::C8 buffer[512];
+                const Common::S32 length = snprintf(buffer, sizeof(buffer), format, params...);
+
+                if (length < 0)
+                {
+                    return format;
+                }
+                else if (static_cast<size_t>(length) < sizeof(buffer))
+                {
+                    return Support::String(buffer, length);
+                }
+
+                Support::String result(length, '\0');
+                snprintf(&result[0], length + 1, format, params...);
+                return result;
+            }
+
+            template <typename... parameters, size_t... indices>
+            static void formatRecordArguments(const LogRecord& record, Support::String* output, std::index_sequence<indices...>)
+            {
+                const Common::U8* cursor = record.mPayload;
+
+                // Braced initializers guarantee left to right evaluation
+                const std::tuple<typename LogArgument<parameters>::DecodedType...> arguments { LogArgument<parameters>::decode(cursor)... };
+                *output = formatString(record.mFormat, std::get<indices>(arguments)...);
+            }
+
+            //! Formats a record holding arguments captured as the given parameter types.
+            template <typename... parameters>
+            static void formatRecord(const LogRecord& record, Support::String* output)
+            {
+                if (output)
+                {
+                    formatRecordArguments<parameters...>(record, output, std::index_sequence_for<parameters...>());
+                }
+            }
+
+            //! Formats a record holding a message that was too large to capture and was formatted by the writer instead.
+            void formatPreformattedRecord(const LogRecord& record, Support::String* output);
+
+            /**
+             *  @brief Hands a record to the console thread. When the queue is full, warnings and worse wait for room while
+             *  anything less severe is dropped and counted. Fatal messages are written before this returns.
+             *  @param record The record to write.
+             */
+            void submit(const LogRecord& record);
+
+            /**
+             *  @brief Blocks until every message written before the call has been printed and passed to the responders.
+             */
+            void flush(void);
+
+            /**
+             *  @brief Sets the least severe message type written. Anything less severe is discarded before its arguments are
+             *  captured.
+             *  @param type The least severe message type to write.
+             */
+            void setMinimumSeverity(const MESSAGE_TYPE type);
+
+            //! Returns whether or not messages of the given type are currently written.
+            inline bool isEnabled(const MESSAGE_TYPE type)
+            {
+                return messageSeverity(type) >= messageSeverity(CONSOLE_MINIMUM_SEVERITY) &&
+                       messageSeverity(type) >= sMinimumSeverity.load(std::memory_order_relaxed);
+            }
+
+            /**
+             *  @brief Registers a responder called with every message of the given type. Responders are called on the
+             *  console thread. Messages still queued are flushed to the existing responders first, so the new responder
+             *  only receives messages logged after it was registered.
+             *  @param responder The responder to register. Ownership is taken.
+             *  @param type The message type to respond to.
+             */
+            void registerListener(LogResponderSetType::StoredDelegateType* responder, MESSAGE_TYPE type);
+
             static void registerListener(LogResponderSetType::StaticDelegateFuncPtr method, MESSAGE_TYPE type)
             {
-                sLogResponders[type].push_back(new LogResponderSetType::StaticDelegateType(method));
+                registerListener(new LogResponderSetType::StaticDelegateType(method), type);
             }
 
             template <typename className>
             static void registerListener(LogResponderSetType::MemberDelegateFuncPtr<className> method, className* thisPtr, MESSAGE_TYPE type)
             {
-                sLogResponders[type].push_back(new LogResponderSetType::MemberDelegateType<className>(method, thisPtr));
+                registerListener(new LogResponderSetType::MemberDelegateType<className>(method, thisPtr), type);
             }
 
+            //! Removes every registered responder. Messages still queued are flushed to the old responders first.
+            void clearListeners(void);
+
             /**
-             *  @brief Writes a formatted message to the console as the given message type.
+             *  @brief Writes a formatted message to the console as the given message type. The arguments are captured and
+             *  formatted later on the console thread, so this neither formats nor blocks on output.
              *  @param type The message type to write as.
-             *  @param format The string to format given the variable length parameter list.
+             *  @param format The string to format given the variable length parameter list. This must have static storage,
+             *  such as a string literal.
              *  @param params The variable length parameter list to format the format string with.
              */
             template <typename... parameters>
-            static void writef(MESSAGE_TYPE type, const Support::String& format, parameters... params)
+            static void writef(MESSAGE_TYPE type, const Common::C8* format, parameters... params)
             {
-                // Call the responders first.
-                Common::C8 buffer[256];
-                sprintf(buffer, format.data(), params...);
-                sLogResponders[type].invoke(type, buffer);
-                printf("(%s) ", messageTypeText(type));
-
-                if (sizeof...(params) >= 1)
-                    printf(format.data(), params...);
-                else
+                if (!isEnabled(type))
                 {
-                    puts(format.data());
                     return;
                 }
 
-                puts("");
+                LogRecord record;
+                record.mType = type;
+                record.mFormat = format;
+                record.mFormatter = nullptr;
+
+                size_t payloadSize = 0;
+                const size_t argumentSizes[] = { 0, LogArgument<parameters>::getSize(params)... };
+
+                for (const size_t argumentSize : argumentSizes)
+                {
+                    payloadSize += argumentSize;
+                }
+
+                if (sizeof...(params) >= 1 && payloadSize <= sizeof(record.mPayload))
+                {
+                    Common::U8* cursor = record.mPayload;
+                    const bool encoded[] = { true, (LogArgument<parameters>::encode(cursor, params), true)... };
+                    (void)encoded;
+
+                    record.mFormatter = formatRecord<parameters...>;
+                }
+                else if (sizeof...(params) >= 1)
+                {
+                    // Too large to capture, the queue takes ownership of the formatted message instead
+                    Support::String* message = new Support::String(formatString(format, params...));
+                    memcpy(record.mPayload, &message, sizeof(message));
+
+                    record.mFormatter = formatPreformattedRecord;
+                }
+
+                submit(record);
             }
 
             /**
@@ -125,9 +359,9 @@ namespace Kiaro
              *  @param params The variable length parameter list to format the format string with.
              */
             template <typename... parameters>
-            static void warningf(const Support::String& format, parameters... params)
+            static void warningf(const Common::C8* format, parameters... params)
             {
-                writef(MESSAGE_WARNING, format.c_str(), params...);
+                writef(MESSAGE_WARNING, format, params...);
             }
 
             /**
@@ -136,9 +370,9 @@ namespace Kiaro
              *  @param params The variable length parameter list to format the format string with.
              */
             template <typename... parameters>
-            static void errorf(const Support::String& format, parameters... params)
+            static void errorf(const Common::C8* format, parameters... params)
             {
-                writef(MESSAGE_ERROR, format.c_str(), params...);
+                writef(MESSAGE_ERROR, format, params...);
             }
 
             /**
@@ -147,9 +381,9 @@ namespace Kiaro
              *  @param params The variable length parameter list to format the format string with.
              */
             template <typename... parameters>
-            static void debugf(const Support::String& format, parameters... params)
+            static void debugf(const Common::C8* format, parameters... params)
             {
-                writef(MESSAGE_DEBUG, format.c_str(), params...);
+                writef(MESSAGE_DEBUG, format, params...);
             }
 
             /**
@@ -158,9 +392,9 @@ namespace Kiaro
              *  @param params The variable length parameter list to format the format string with.
              */
             template <typename... parameters>
-            static void infof(const Support::String& format, parameters... params)
+            static void infof(const Common::C8* format, parameters... params)
             {
-                writef(MESSAGE_INFO, format.c_str(), params...);
+                writef(MESSAGE_INFO, format, params...);
             }
 
             /**
@@ -170,9 +404,7 @@ namespace Kiaro
              */
             static void write(MESSAGE_TYPE type, const Support::String& output)
             {
-                sLogResponders[type].invoke(type, output);
-                printf("(%s) %s", messageTypeText(type), output.data());
-                puts("");
+                writef(type, "%s", output.data());
             }
 
             /**
@@ -226,7 +458,7 @@ namespace Kiaro
              *  @param format The string to format given the variable length parameter list.
              */
             template <typename... parameters>
-            static void consoleAssertf(bool expressionValue, const Support::String& format, parameters... params)
+            static void consoleAssertf(bool expressionValue, const Common::C8* format, parameters... params)
             {
                 if (!expressionValue)
                     errorf(format, params...);
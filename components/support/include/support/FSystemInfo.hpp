@@ -15,6 +15,7 @@
 
 #include <support/Console.hpp>
 #include <support/String.hpp>
+#include <support/platform/thread.hpp>
 
 namespace Kiaro
 {
@@ -67,7 +68,15 @@ namespace Kiaro
          */
         static void getCPUInfo(CPUInfo& output)
         {
-            Common::U32 outputBits = 0;
+            const Platform::Thread::ProcessorTopology& topology = Platform::Thread::getProcessorTopology();
+
+            output.mStepping = 0;
+            output.mModel = 0;
+            output.mFamily = 0;
+            output.mType = 0;
+            output.mExtendedModel = 0;
+            output.mExtendedFamily = 0;
+            output.mCoreCount = static_cast<Common::U16>(topology.mPhysicalCoreCount);
         }
 
         /**
@@ -186,6 +195,9 @@ namespace Kiaro
             CONSOLE_INFOF("Extended Model: %u, Extended Family: %u", sCPUInfo.mExtendedModel, sCPUInfo.mExtendedFamily);
             CONSOLE_INFOF("Stepping: %u", sCPUInfo.mStepping);
             CONSOLE_INFOF("CPU Core Count: %u", sCPUInfo.mCoreCount);
+
+            const Platform::Thread::ProcessorTopology& topology = Platform::Thread::getProcessorTopology();
+            CONSOLE_INFOF("Logical Core Count: %u, NUMA Node Count: %u", static_cast<Common::U32>(topology.mCores.size()), topology.mNodeCount);
             CONSOLE_INFOF("Total System Memory: %f GB", getSystemMemoryTotal());
 
             // Microarchitecture specific data
@@ -20,12 +20,23 @@ namespace Kiaro
 {
     namespace Support
     {
+        /**
+         *  @brief The clocks of the engine. Every function here may be called from any thread.
+         *  @details There are two clocks: the real clock, which is monotonic and never stops, and the simulation clock,
+         *  which only moves when the main loop advances it and which may be paused or scaled. Timestamps of either are
+         *  64 bit nanoseconds, so they do not wrap within the lifetime of any process.
+         *
+         *  For measuring short spans in hot paths, readCounter returns a raw counter that is cheaper to read than the
+         *  real clock. On x86 processors with an invariant TSC this is the TSC, calibrated against the real clock by
+         *  calibrateCounter or, failing that, the first time it is needed.
+         */
         namespace FTime
         {
             typedef Common::U8 timer;
 
             /**
-             *  @brief Starts a new timer and returns the identifier to it to be used in stopTimer.
+             *  @brief Starts a new timer and returns the identifier to it to be used in stopTimer. Every thread has its
+             *  own stack of timers.
              *  @return The identifier of the timer that was started.
              */
             timer startTimer(void);
@@ -38,11 +49,95 @@ namespace Kiaro
             Common::F32 stopTimer(const timer& timerIdentifier);
 
             /**
-             *  @brief Clears all timers in the timing system.
+             *  @brief Clears all timers of the calling thread.
              */
             void clearTimers(void);
 
+            //! Returns the time of the real clock in nanoseconds, counted from the first time any clock was read.
+            Common::U64 getNanoseconds(void) NOTHROW;
+
+            //! Returns the time of the real clock in milliseconds. Use this for anything that must keep time while the
+            //! simulation clock is paused or scaled, such as network timeouts and bandwidth.
+            Common::U64 getMilliseconds(void) NOTHROW;
+
+            /**
+             *  @brief Reads the fast counter. Only the difference of two readings is meaningful, which
+             *  counterToNanoseconds converts.
+             */
+            Common::U64 readCounter(void) NOTHROW;
+
+            //! Converts a difference of two readCounter results to nanoseconds.
+            Common::U64 counterToNanoseconds(const Common::U64 counterDelta) NOTHROW;
+
+            /**
+             *  @brief Calibrates the TSC against the real clock, which takes a few milliseconds of busy waiting. This
+             *  happens on the first conversion otherwise, so call it at startup to keep that stall out of a frame.
+             */
+            void calibrateCounter(void) NOTHROW;
+
+            //! Returns whether or not readCounter is backed by the TSC rather than the real clock.
+            bool isCounterHardwareBacked(void) NOTHROW;
+
+            /**
+             *  @brief Advances the simulation clock by the given real time, applying the current scale. Does nothing
+             *  while the simulation clock is paused.
+             *  @param realNanoseconds The real time that has passed since the last call.
+             */
+            void advanceSimTime(const Common::U64 realNanoseconds) NOTHROW;
+
+            /**
+             *  @brief Sets how fast the simulation clock runs relative to the real clock.
+             *  @param scale The new scale. 1 runs at real time, 0.5 at half speed.
+             *  @throw std::invalid_argument Thrown when the scale is negative.
+             */
+            void setSimTimeScale(const Common::F32 scale);
+
+            //! Returns how fast the simulation clock runs relative to the real clock.
+            Common::F32 getSimTimeScale(void) NOTHROW;
+
+            //! Pauses or resumes the simulation clock.
+            void setSimTimePaused(const bool paused) NOTHROW;
+
+            //! Returns whether or not the simulation clock is paused.
+            bool isSimTimePaused(void) NOTHROW;
+
+            //! Returns the time of the simulation clock in nanoseconds.
+            Common::U64 getSimTimeNanoseconds(void) NOTHROW;
+
+            //! Returns the time of the simulation clock in milliseconds.
             Common::U64 getSimTimeMilliseconds(void) NOTHROW;
+
+            /**
+             *  @brief Measures the lifetime of a scope using the fast counter and adds it to a total on destruction.
+             *  Unlike startTimer and stopTimer, this allocates nothing and may be nested freely.
+             */
+            class CScopedTimer
+            {
+                // Private Members
+                private:
+                    //! The total the measured time is added to.
+                    Common::U64& mTotalNanoseconds;
+
+                    //! The counter reading when the scope was entered.
+                    const Common::U64 mStartCounter;
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Constructor accepting the total to add the measured time to.
+                     *  @param totalNanoseconds The total to add the lifetime of this timer to in nanoseconds.
+                     */
+                    CScopedTimer(Common::U64& totalNanoseconds) : mTotalNanoseconds(totalNanoseconds), mStartCounter(readCounter())
+                    {
+
+                    }
+
+                    //! Standard destructor.
+                    ~CScopedTimer(void)
+                    {
+                        mTotalNanoseconds += counterToNanoseconds(readCounter() - mStartCounter);
+                    }
+            };
         } // End NameSpace Time
     } // End NameSpace Support
 } // End NameSpace Kiaro
@@ -0,0 +1,268 @@
+/**
+ *  @file SAllocationTracker.hpp
+ *  @brief Include file declaring the SAllocationTracker class, the CTrackedAllocator and the allocation scopes.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_SALLOCATIONTRACKER_HPP_
+#define _INCLUDE_SUPPORT_SALLOCATIONTRACKER_HPP_
+
+//! Resolves the tag ID of the given name. Every call site interns its name only once, the first time it runs.
+#define ALLOCATION_TAG(name) ([]() { static const auto tag = Support::SAllocationTracker::internTag(#name); return tag; }())
+
+#define ALLOCATION_SCOPE_VARIABLE_INNER(line) allocationScope##line
+#define ALLOCATION_SCOPE_VARIABLE(line) ALLOCATION_SCOPE_VARIABLE_INNER(line)
+
+#if defined(KIARO_ALLOCATION_TRACKING)
+    //! Attributes every allocation made by the calling thread in the rest of the enclosing scope to the given tag.
+    #define ALLOCATION_SCOPE(name) Support::CAllocationScope ALLOCATION_SCOPE_VARIABLE(__LINE__)(ALLOCATION_TAG(name))
+#else
+    #define ALLOCATION_SCOPE(name)
+#endif
+
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/String.hpp>
+#include <support/Vector.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        /**
+         *  @brief Attributes heap usage to subsystems and call sites, so that the per frame allocation churn of long running
+         *  servers can be found and removed.
+         *  @details Tracking is opt-in: building with KIARO_ALLOCATION_TRACKING defined (--define memtrack=on) replaces the
+         *  global operator new and delete. Every allocation is then counted against two things: the tag of the innermost
+         *  ALLOCATION_SCOPE or CTrackedAllocator it was made through, which names the owning subsystem, and the innermost
+         *  profiler zone open on the allocating thread, which names the call site. Tags keep live bytes as well, as every
+         *  allocation remembers its tag until it is freed. Without the define, the scopes compile away, tracked allocators
+         *  are plain allocators and nothing is counted.
+         *
+         *  Counting costs a few relaxed atomic additions on counters striped by thread, and never locks or allocates.
+         *  Allocation rates are averaged per frame over sRateWindowFrames calls to update, which the profiler makes once
+         *  per frame.
+         */
+        class SAllocationTracker
+        {
+            // Public Members
+            public:
+                //! The allocations counted against a single tag or call site.
+                struct Statistics
+                {
+                    //! The name of the tag or profiler zone.
+                    Support::String mName;
+
+                    //! The number of allocations made so far.
+                    Common::U64 mAllocationCount;
+
+                    //! The number of bytes allocated so far.
+                    Common::U64 mAllocatedBytes;
+
+                    //! The number of allocations not freed yet. Only known for tags.
+                    Common::U64 mLiveAllocations;
+
+                    //! The number of bytes not freed yet. Only known for tags.
+                    Common::U64 mLiveBytes;
+
+                    //! The average number of allocations per frame over the last complete rate window.
+                    Common::F64 mAllocationsPerFrame;
+
+                    //! The average number of bytes allocated per frame over the last complete rate window.
+                    Common::F64 mBytesPerFrame;
+                };
+
+                //! Whether or not the engine was built with allocation tracking.
+                #if defined(KIARO_ALLOCATION_TRACKING)
+                    static const bool sEnabled = true;
+                #else
+                    static const bool sEnabled = false;
+                #endif
+
+                //! The tag of allocations not made in any ALLOCATION_SCOPE.
+                static const Common::U16 sUntagged = 0;
+
+                //! The number of tags that can be interned. Tags interned beyond this count as untagged.
+                static const size_t sTagCapacity = 64;
+
+                //! The number of profiler zones allocations are attributed to. Zones beyond this count as outside of any zone.
+                static const size_t sZoneCapacity = 1024;
+
+                //! Passed to setThreadZone when no profiler zone is open.
+                static const Common::U32 sNoZone = std::numeric_limits<Common::U32>::max();
+
+                //! The number of frames allocation rates are averaged over.
+                static const Common::U32 sRateWindowFrames = 32;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Returns the ID of the tag with the given name, assigning a new one if the name was never seen.
+                 *  IDs stay valid for the lifetime of the process. Use ALLOCATION_TAG rather than calling this directly.
+                 *  @param name The name of the tag.
+                 */
+                static Common::U16 internTag(const Common::C8* name);
+
+                /**
+                 *  @brief Returns the name of the tag with the given ID.
+                 *  @throw std::out_of_range Thrown when no tag has the given ID.
+                 */
+                static Support::String getTagName(const Common::U16 tag);
+
+                //! Returns the tag allocations of the calling thread are currently attributed to.
+                static Common::U16 getThreadTag(void) NOTHROW;
+
+                //! Attributes the following allocations of the calling thread to the given tag.
+                static void setThreadTag(const Common::U16 tag) NOTHROW;
+
+                /**
+                 *  @brief Attributes the following allocations of the calling thread to the given profiler zone. The
+                 *  profiler calls this as scopes begin and end.
+                 *  @param zone The innermost open zone, or sNoZone.
+                 */
+                static void setThreadZone(const Common::U32 zone) NOTHROW;
+
+                /**
+                 *  @brief Counts an allocation against the given tag and the current profiler zone of the calling thread.
+                 *  @param tag The tag to count the allocation against.
+                 *  @param bytes The size of the allocation.
+                 */
+                static void recordAllocation(const Common::U16 tag, const size_t bytes) NOTHROW;
+
+                /**
+                 *  @brief Counts the release of an allocation previously passed to recordAllocation.
+                 *  @param tag The tag the allocation was counted against.
+                 *  @param bytes The size of the allocation.
+                 */
+                static void recordFree(const Common::U16 tag, const size_t bytes) NOTHROW;
+
+                //! Ends a frame, completing the rate window every sRateWindowFrames frames.
+                static void update(void);
+
+                //! Returns the statistics of every tag that allocated anything, the most live bytes first.
+                static Support::Vector<Statistics> getTagStatistics(void);
+
+                //! Returns the statistics of every profiler zone that allocated anything, the most allocations per frame first.
+                static Support::Vector<Statistics> getZoneStatistics(void);
+
+                //! Returns the sum of the statistics of every tag.
+                static Statistics getTotalStatistics(void);
+
+            // Private Methods
+            private:
+                SAllocationTracker(void);
+        };
+
+        /**
+         *  @brief Attributes the allocations of the calling thread to a tag while it lives. Use ALLOCATION_SCOPE rather than
+         *  creating these directly.
+         */
+        class CAllocationScope
+        {
+            // Private Members
+            private:
+                //! The tag that was current before this scope.
+                const Common::U16 mPreviousTag;
+
+            // Public Methods
+            public:
+                CAllocationScope(const Common::U16 tag) : mPreviousTag(SAllocationTracker::getThreadTag())
+                {
+                    SAllocationTracker::setThreadTag(tag);
+                }
+
+                ~CAllocationScope(void)
+                {
+                    SAllocationTracker::setThreadTag(mPreviousTag);
+                }
+        };
+
+        /**
+         *  @brief A standard library allocator counting everything it allocates against a tag, so that containers are
+         *  attributed to their owner no matter where they grow.
+         *  @details Memory comes from malloc rather than operator new, so it is not counted a second time by the global
+         *  hooks. Without KIARO_ALLOCATION_TRACKING, nothing is counted.
+         */
+        template <typename storedType>
+        class CTrackedAllocator
+        {
+            // Public Members
+            public:
+                typedef storedType value_type;
+
+                //! The tag allocations are counted against.
+                Common::U16 mTag;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the tag to count against.
+                 *  @param tag The tag, usually resolved with ALLOCATION_TAG.
+                 */
+                CTrackedAllocator(const Common::U16 tag = SAllocationTracker::sUntagged) : mTag(tag)
+                {
+
+                }
+
+                template <typename otherType>
+                CTrackedAllocator(const CTrackedAllocator<otherType>& other) : mTag(other.mTag)
+                {
+
+                }
+
+                storedType* allocate(const size_t count)
+                {
+                    if (count > std::numeric_limits<size_t>::max() / sizeof(storedType))
+                    {
+                        throw std::bad_alloc();
+                    }
+
+                    storedType* result = reinterpret_cast<storedType*>(malloc(count * sizeof(storedType)));
+
+                    if (!result)
+                    {
+                        throw std::bad_alloc();
+                    }
+
+                    if (SAllocationTracker::sEnabled)
+                    {
+                        SAllocationTracker::recordAllocation(mTag, count * sizeof(storedType));
+                    }
+
+                    return result;
+                }
+
+                void deallocate(storedType* pointer, const size_t count)
+                {
+                    if (SAllocationTracker::sEnabled)
+                    {
+                        SAllocationTracker::recordFree(mTag, count * sizeof(storedType));
+                    }
+
+                    free(pointer);
+                }
+
+                template <typename otherType>
+                bool operator ==(const CTrackedAllocator<otherType>& other) const
+                {
+                    return mTag == other.mTag;
+                }
+
+                template <typename otherType>
+                bool operator !=(const CTrackedAllocator<otherType>& other) const
+                {
+                    return mTag != other.mTag;
+                }
+        };
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_SALLOCATIONTRACKER_HPP_
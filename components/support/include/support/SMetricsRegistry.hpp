@@ -0,0 +1,268 @@
+/**
+ *  @file SMetricsRegistry.hpp
+ *  @brief Include file declaring the SMetricsRegistry singleton class and the metric types it keeps.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_SMETRICSREGISTRY_HPP_
+#define _INCLUDE_SUPPORT_SMETRICSREGISTRY_HPP_
+
+#include <functional>
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/String.hpp>
+#include <support/Vector.hpp>
+#include <support/Map.hpp>
+#include <support/ISingleton.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        //! A value that only ever goes up, such as the number of bytes sent. Safe to update from any thread.
+        class CMetricCounter
+        {
+            // Private Members
+            private:
+                //! The current value.
+                Support::Atomic<Common::U64> mValue;
+
+            // Public Methods
+            public:
+                //! Parameterless constructor starting the counter at zero.
+                CMetricCounter(void) : mValue(0)
+                {
+
+                }
+
+                /**
+                 *  @brief Adds to the counter.
+                 *  @param amount The amount to add.
+                 */
+                void increment(const Common::U64 amount = 1)
+                {
+                    mValue.fetch_add(amount, std::memory_order_relaxed);
+                }
+
+                //! Returns the current value.
+                Common::U64 getValue(void) const
+                {
+                    return mValue.load(std::memory_order_relaxed);
+                }
+        };
+
+        //! A value that may go up and down, such as the number of connected players. Safe to update from any thread.
+        class CMetricGauge
+        {
+            // Private Members
+            private:
+                //! The current value.
+                Support::Atomic<Common::F64> mValue;
+
+            // Public Methods
+            public:
+                //! Parameterless constructor starting the gauge at zero.
+                CMetricGauge(void) : mValue(0.0)
+                {
+
+                }
+
+                /**
+                 *  @brief Sets the gauge.
+                 *  @param value The new value.
+                 */
+                void set(const Common::F64 value)
+                {
+                    mValue.store(value, std::memory_order_relaxed);
+                }
+
+                //! Returns the current value.
+                Common::F64 getValue(void) const
+                {
+                    return mValue.load(std::memory_order_relaxed);
+                }
+        };
+
+        /**
+         *  @brief Counts observed values into buckets with fixed upper bounds, such as the time taken by every tick. Safe to
+         *  update from any thread.
+         */
+        class CMetricHistogram
+        {
+            // Private Members
+            private:
+                //! The inclusive upper bound of every bucket but the last, which takes everything larger, in ascending order.
+                const Support::Vector<Common::F64> mUpperBounds;
+
+                //! The number of values observed in each bucket. Not cumulative.
+                Support::Vector<Support::Atomic<Common::U64>> mBucketCounts;
+
+                //! The sum of all observed values.
+                Support::Atomic<Common::F64> mSum;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Constructor accepting the bucket bounds.
+                 *  @param upperBounds The inclusive upper bound of every bucket in ascending order. A bucket for larger values
+                 *  is added implicitly.
+                 *  @throw std::invalid_argument Thrown when the bounds are not in ascending order.
+                 */
+                CMetricHistogram(const Support::Vector<Common::F64>& upperBounds);
+
+                /**
+                 *  @brief Counts a single value.
+                 *  @param value The value to count.
+                 */
+                void observe(const Common::F64 value) NOTHROW;
+
+                //! Returns the inclusive upper bound of every bucket but the last.
+                const Support::Vector<Common::F64>& getUpperBounds(void) const NOTHROW;
+
+                //! Returns the number of values counted in the given bucket, where getUpperBounds().size() is the last one.
+                Common::U64 getBucketCount(const size_t bucket) const;
+
+                //! Returns the sum of all values counted.
+                Common::F64 getSum(void) const NOTHROW;
+        };
+
+        /**
+         *  @brief The SMetricsRegistry keeps named counters, gauges and histograms that any part of the engine may feed,
+         *  and exports them in the Prometheus text exposition format for monitoring systems to scrape.
+         *  @details Metrics are created on first request and live as long as the registry, so callers should look them
+         *  up once and keep the pointer. Updating a metric is a single atomic operation. Values that are cheaper to read
+         *  when needed than to keep up to date, such as player counts, are set by collectors, which run whenever the
+         *  metrics are exported.
+         *
+         *  Every metric is identified by its name and labels. Metrics of the same name form a family that must share its
+         *  type and help text.
+         */
+        class SMetricsRegistry : public Support::ISingleton<SMetricsRegistry>
+        {
+            // Public Members
+            public:
+                //! Label names paired with their values.
+                typedef Support::Vector<Support::Pair<Support::String, Support::String>> Labels;
+
+                //! A callable run before every export, meant to set gauges.
+                typedef std::function<void(void)> Collector;
+
+            // Private Members
+            private:
+                //! The kinds of metrics.
+                enum MetricType
+                {
+                    METRIC_COUNTER,
+                    METRIC_GAUGE,
+                    METRIC_HISTOGRAM
+                };
+
+                //! All metrics sharing a name.
+                struct MetricFamily
+                {
+                    //! The type of every metric in the family.
+                    MetricType mType;
+
+                    //! The description written along with the family.
+                    Support::String mHelp;
+
+                    //! The metrics keyed by their formatted label lists. Only the one matching mType is set.
+                    Support::Map<Support::String, CMetricCounter*> mCounters;
+                    Support::Map<Support::String, CMetricGauge*> mGauges;
+                    Support::Map<Support::String, CMetricHistogram*> mHistograms;
+                };
+
+                //! Every metric family, ordered by name so that exports are stable.
+                Support::Map<Support::String, MetricFamily> mFamilies;
+
+                //! Protects mFamilies.
+                Support::Mutex mMutex;
+
+                //! The registered collectors, keyed by their IDs.
+                Support::Map<Common::U32, Collector> mCollectors;
+
+                //! The ID given to the next collector.
+                Common::U32 mNextCollectorID;
+
+                //! Protects mCollectors and mNextCollectorID.
+                Support::Mutex mCollectorMutex;
+
+            // Public Methods
+            public:
+                /**
+                 *  @brief Returns the counter of the given name and labels, creating it if necessary.
+                 *  @param name The name of the metric. Counter names should end in _total.
+                 *  @param help The description of the metric.
+                 *  @param labels The labels distinguishing this counter from others of the same name.
+                 *  @throw std::logic_error Thrown when a metric of the same name but another type exists.
+                 */
+                CMetricCounter* getCounter(const Support::String& name, const Support::String& help, const Labels& labels = Labels());
+
+                /**
+                 *  @brief Returns the gauge of the given name and labels, creating it if necessary.
+                 *  @param name The name of the metric.
+                 *  @param help The description of the metric.
+                 *  @param labels The labels distinguishing this gauge from others of the same name.
+                 *  @throw std::logic_error Thrown when a metric of the same name but another type exists.
+                 */
+                CMetricGauge* getGauge(const Support::String& name, const Support::String& help, const Labels& labels = Labels());
+
+                /**
+                 *  @brief Returns the histogram of the given name and labels, creating it if necessary.
+                 *  @param name The name of the metric.
+                 *  @param help The description of the metric.
+                 *  @param upperBounds The bucket bounds of the histogram. Ignored if it exists already.
+                 *  @param labels The labels distinguishing this histogram from others of the same name.
+                 *  @throw std::logic_error Thrown when a metric of the same name but another type exists.
+                 *  @throw std::invalid_argument Thrown when the bounds are not in ascending order.
+                 */
+                CMetricHistogram* getHistogram(const Support::String& name, const Support::String& help, const Support::Vector<Common::F64>& upperBounds,
+                                               const Labels& labels = Labels());
+
+                /**
+                 *  @brief Registers a collector to run before every export, on the exporting thread.
+                 *  @param collector The collector to register.
+                 *  @return The ID to remove the collector with.
+                 */
+                Common::U32 addCollector(const Collector& collector);
+
+                /**
+                 *  @brief Removes a collector.
+                 *  @param id The ID addCollector returned.
+                 */
+                void removeCollector(const Common::U32 id);
+
+                /**
+                 *  @brief Runs every collector and writes every metric in the Prometheus text exposition format, version 0.0.4.
+                 *  @return The exported metrics.
+                 */
+                Support::String exportText(void);
+
+            // Protected Methods
+            protected:
+                //! Parameter-less constructor.
+                SMetricsRegistry(void);
+
+                //! Standard destructor.
+                ~SMetricsRegistry(void);
+
+            // Private Methods
+            private:
+                /**
+                 *  @brief Returns the family of the given name, creating it if necessary. Requires mMutex.
+                 *  @throw std::logic_error Thrown when the family exists with another type.
+                 */
+                MetricFamily& getFamily(const Support::String& name, const Support::String& help, const MetricType type);
+
+                //! Formats the given labels as the contents of a Prometheus label list.
+                static Support::String formatLabels(const Labels& labels);
+        };
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_SMETRICSREGISTRY_HPP_
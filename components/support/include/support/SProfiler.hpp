@@ -12,16 +12,26 @@
 #ifndef _INCLUDE_SUPPORT_SPROFILER_H_
 #define _INCLUDE_SUPPORT_SPROFILER_H_
 
-#define PROFILER_BEGIN(name) Support::SProfiler::getPointer()->scopeBegin(#name)
-#define PROFILER_END(name) Support::SProfiler::getPointer()->scopeEnd(#name)
+//! Resolves the zone ID of the given name. Every call site interns its name only once, the first time it runs.
+#define PROFILER_ZONE(name) ([]() { static const auto zone = Support::SProfiler::internZone(#name); return zone; }())
+#define PROFILER_BEGIN(name) Support::SProfiler::getPointer()->scopeBegin(PROFILER_ZONE(name))
+#define PROFILER_END(name) Support::SProfiler::getPointer()->scopeEnd(PROFILER_ZONE(name))
+
+#define PROFILER_SCOPE_VARIABLE_INNER(line) profilerScope##line
+#define PROFILER_SCOPE_VARIABLE(line) PROFILER_SCOPE_VARIABLE_INNER(line)
+//! Profiles the rest of the enclosing scope.
+#define PROFILER_SCOPE(name) Support::CProfilerScope PROFILER_SCOPE_VARIABLE(__LINE__)(PROFILER_ZONE(name))
 
 #include <support/common.hpp>
+#include <support/types.hpp>
 #include <support/String.hpp>
 #include <support/Vector.hpp>
+#include <support/Deque.hpp>
 #include <support/Set.hpp>
 #include <support/UnorderedMap.hpp>
 #include <support/UnorderedSet.hpp>
 #include <support/FTime.hpp>
+#include <support/CLatencyHistogram.hpp>
 
 namespace Kiaro
 {
@@ -30,28 +40,221 @@ namespace Kiaro
         /**
          *  @brief A built in profiler that monitors application resource usage through scoped
          *  timers placed throughout the running application.
+         *  @details Zones are identified by IDs interned once per call site, so profiling a scope costs two counter reads
+         *  and a write into a ring buffer owned by the calling thread. Nothing on that path locks or allocates once the
+         *  thread has profiled its first scope. Completed scopes are aggregated into per frame samples and a call
+         *  hierarchy whenever update or any of the query methods run.
+         *
+         *  Scopes may be nested, including scopes of the same zone, but every thread must end its scopes in the
+         *  reverse order it began them. Scopes of threads whose ring buffer is full are dropped and counted. The ring
+         *  buffers of threads that exited are freed once aggregated.
+         *
+         *  Besides the per frame samples, the time every zone takes per frame is recorded into histograms covering a
+         *  rolling window of frames, so that rare stalls show up in the tail percentiles rather than vanishing in an
+         *  average. Frames in which a chosen zone exceeds its budget are kept as spikes along with their full breakdown.
+         *
+         *  For diagnosing individual frames, beginCapture records every scope of a number of frames into a trace file.
+         *
+         *  In builds with allocation tracking, the innermost open zone of a thread is the call site its allocations are
+         *  attributed to, and every update ends a frame of the SAllocationTracker rate window.
          */
         class SProfiler
         {
+            // Public Members
+            public:
+                //! A single completed scope, as written by the thread that profiled it.
+                struct ZoneRecord
+                {
+                    //! The zone of the scope.
+                    Common::U32 mZone;
+
+                    //! The number of scopes that were open on the thread when this one began.
+                    Common::U32 mDepth;
+
+                    //! Identifies the chain of zones leading to and including this scope.
+                    Common::U64 mPath;
+
+                    //! The mPath of the enclosing scope, or zero for scopes that were not nested.
+                    Common::U64 mParentPath;
+
+                    //! The FTime::readCounter value when the scope began.
+                    Common::U64 mBeginCounter;
+
+                    //! The FTime::readCounter value when the scope ended.
+                    Common::U64 mEndCounter;
+
+                    //! Whether or not an enclosing scope has the same zone, in which case its time is already counted.
+                    bool mRecursive;
+                };
+
+                //! The aggregated statistics of a single call path.
+                struct HierarchyNode
+                {
+                    //! The name of the zone.
+                    Support::String mName;
+
+                    //! The number of zones enclosing this one on the call path.
+                    Common::U32 mDepth;
+
+                    //! How often the call path was profiled.
+                    Common::U64 mCallCount;
+
+                    //! The total time spent in the call path in seconds.
+                    Common::F64 mTotalSeconds;
+
+                    //! The time spent in the call path outside of any nested zones in seconds.
+                    Common::F64 mSelfSeconds;
+                };
+
+                //! The distribution of the time a zone took per frame across the distribution window.
+                struct ZoneDistribution
+                {
+                    //! The name of the zone.
+                    Support::String mName;
+
+                    //! The number of frames in the window the zone was profiled in.
+                    Common::U64 mFrameCount;
+
+                    //! The median time per frame in seconds.
+                    Common::F64 mMedianSeconds;
+
+                    //! The 95th percentile of the time per frame in seconds.
+                    Common::F64 mP95Seconds;
+
+                    //! The 99th percentile of the time per frame in seconds.
+                    Common::F64 mP99Seconds;
+
+                    //! The longest time of any frame in seconds.
+                    Common::F64 mMaxSeconds;
+                };
+
+                //! A frame in which the spike zone exceeded its budget.
+                struct Spike
+                {
+                    //! The number of the frame, counting calls to update.
+                    Common::U64 mFrame;
+
+                    //! The time spent in the spike zone during the frame in seconds.
+                    Common::F64 mSeconds;
+
+                    //! Every call path profiled during the frame, ordered like getHierarchy.
+                    Support::Vector<HierarchyNode> mBreakdown;
+                };
+
             // Private Members
             private:
+                struct ThreadBuffer;
+                struct ThreadBufferOwner;
+
+                //! A completed scope kept for a capture.
+                struct CapturedRecord
+                {
+                    //! The index of the thread that profiled the scope in mThreadBuffers.
+                    Common::U32 mThreadIndex;
+                    //! The scope itself.
+                    ZoneRecord mRecord;
+                };
+
+                //! The aggregated statistics of a single call path, keyed by its path.
+                struct PathStatistics
+                {
+                    //! The zone at the end of the path.
+                    Common::U32 mZone;
+                    //! The number of zones enclosing the last one.
+                    Common::U32 mDepth;
+                    //! The path without its last zone, or zero if it has a single zone.
+                    Common::U64 mParentPath;
+                    //! How often the path was profiled.
+                    Common::U64 mCallCount;
+                    //! The total time spent in the path.
+                    Common::U64 mTotalNanoseconds;
+                    //! The time spent in paths nested in this one.
+                    Common::U64 mChildNanoseconds;
+                };
+
+                //! The ring buffer of the calling thread.
+                static thread_local ThreadBuffer* sThreadBuffer;
+
+                //! The generation of the profiler sThreadBuffer belongs to.
+                static thread_local Common::U64 sThreadGeneration;
+
+                //! Retires sThreadBuffer when the calling thread exits, so that the next aggregation frees it.
+                static thread_local ThreadBufferOwner sThreadBufferOwner;
+
+                //! Distinguishes this profiler from destroyed ones so that threads notice their buffers are gone.
+                const Common::U64 mGeneration;
+
                 //! The current sample number we're on.
                 size_t mSample;
 
-                //! A vector of all the sample data.
-                Support::Vector<Support::UnorderedMap<Support::String, Common::F32>> mSamples;
+                //! The time spent in every zone for each sample in seconds, indexed by zone. Negative if not profiled.
+                Support::Vector<Support::Vector<Common::F32>> mSamples;
 
-                //! A mapping of sample names to their associated internal timers.
-                Support::UnorderedMap<Support::String, FTime::timer> mTimers;
+                //! The ring buffers of every thread that profiled a scope and did not exit yet, or exited during a capture.
+                Support::Vector<ThreadBuffer*> mThreadBuffers;
+
+                //! The number of scopes dropped by threads whose ring buffers were freed.
+                Common::U64 mRetiredDroppedCount;
+
+                //! The aggregated statistics of every call path profiled.
+                Support::UnorderedMap<Common::U64, PathStatistics> mPaths;
 
                 //! A set of all registered sample names.
                 Support::UnorderedSet<Support::String> mSampleNames;
 
+                //! Protects mThreadBuffers and everything aggregation writes to.
+                Support::Mutex mMutex;
+
+                //! The number of frames the pending or running capture still has to record.
+                Common::U32 mCaptureFramesLeft;
+
+                //! Whether or not a capture is recording. If false while mCaptureFramesLeft is set, it starts next frame.
+                bool mCapturing;
+
+                //! Where the pending or running capture is written to.
+                Support::String mCapturePath;
+
+                //! Every scope the running capture has recorded so far.
+                Support::Vector<CapturedRecord> mCapturedRecords;
+
+                //! The number of the current frame.
+                Common::U64 mFrame;
+
+                //! The time spent in every zone during the current frame, indexed by zone.
+                Support::Vector<Common::U64> mFrameNanoseconds;
+
+                //! The statistics of every call path of the current frame. Only kept while spikes are being recorded.
+                Support::UnorderedMap<Common::U64, PathStatistics> mFramePaths;
+
+                //! The histograms of the distribution window, split into slices that are discarded oldest first. Indexed by slice, then zone.
+                Support::Vector<Support::Vector<CLatencyHistogram>> mDistributionSlices;
+
+                //! The slice of mDistributionSlices frames are currently recorded into.
+                size_t mDistributionSlice;
+
+                //! The number of frames each slice of the distribution window covers.
+                Common::U32 mDistributionSliceFrames;
+
+                //! The number of frames that still fit into the current slice.
+                Common::U32 mDistributionSliceFramesLeft;
+
+                //! The zone spikes are recorded for.
+                Common::U32 mSpikeZone;
+
+                //! The time the spike zone may take per frame before the frame is a spike. Zero if spikes are not recorded.
+                Common::U64 mSpikeBudgetNanoseconds;
+
+                //! The most recent spikes, oldest first.
+                Support::Deque<Spike> mSpikes;
+
             // PUblic Members
             public:
                 //! Total number of samples we're operating with.
                 const size_t mSampleCount;
 
+                //! The number of spikes kept before the oldest are discarded.
+                static const size_t sSpikeCapacity = 16;
+
             // Public Methods
             public:
                 /**
@@ -62,26 +265,52 @@ namespace Kiaro
                 static SProfiler* getPointer(const size_t sampleCount = 32);
 
                 /**
-                 *  @brief Destroys the existing profiler singleton.
+                 *  @brief Destroys the existing profiler singleton. No other thread may be profiling while this runs.
                  */
                 static void destroy(void);
 
                 /**
-                 *  @brief Begins a profiler scope with the given name. There must be an associated
-                 *  scopeEnd later in the application.
-                 *  @param name The name of the resource we are monitoring.
-                 *  @throw std::runtime_error Thrown when there is already a timer running for the
-                 *  given resource.
+                 *  @brief Returns the ID of the zone with the given name, assigning a new one if the name was never seen.
+                 *  IDs stay valid for the lifetime of the process. Use PROFILER_ZONE rather than calling this directly.
+                 *  @param name The name of the zone.
+                 */
+                static Common::U32 internZone(const Common::C8* name);
+
+                /**
+                 *  @brief Returns the name of the zone with the given ID.
+                 *  @throw std::out_of_range Thrown when no zone has the given ID.
                  */
-                void scopeBegin(const Support::String& name);
+                static Support::String getZoneName(const Common::U32 zone);
 
                 /**
-                 *  @brief Ends a profiler scope with the given name. There must be an associated
-                 *  scopeBegin earlier in the application.
-                 *  @param name The name of the resource we are monitoring.
+                 *  @brief Begins a profiler scope of the given zone. There must be an associated
+                 *  scopeEnd later on the same thread.
+                 *  @param zone The zone of the resource we are monitoring.
                  */
-                void scopeEnd(const Support::String& name);
+                void scopeBegin(const Common::U32 zone);
 
+                /**
+                 *  @brief Ends the innermost profiler scope of the calling thread.
+                 *  @param zone The zone of the resource we are monitoring.
+                 *  @throw std::runtime_error Thrown when the innermost scope of the calling thread is not of the given zone.
+                 */
+                void scopeEnd(const Common::U32 zone);
+
+                /**
+                 *  @brief Ends the innermost profiler scope of the given zone on the calling thread without throwing, as
+                 *  needed when scopes end during stack unwinding. Scopes nested in it that were never ended are discarded
+                 *  and the mismatch is logged. If no scope of the zone is open, only the error is logged.
+                 *  @param zone The zone of the resource we are monitoring.
+                 */
+                void scopeEndNoThrow(const Common::U32 zone) NOTHROW;
+
+                /**
+                 *  @brief Discards the open scopes of the calling thread. This is meant for recovering after an exception
+                 *  unwound past scopes that were begun manually.
+                 */
+                void abandonScopes(void);
+
+                //! Aggregates everything profiled so far into the current sample and moves on to the next one.
                 void update(void);
 
                 /**
@@ -94,8 +323,8 @@ namespace Kiaro
                 Common::F32 getSample(const Support::String& name, const size_t sample);
 
                 /**
-                 *  @brief Returns the average of the given resource across all currently recorded
-                 *  samples.
+                 *  @brief Returns the average of the given resource across all recorded samples it was
+                 *  profiled in.
                  *  @param name The resource name to calculate the average of.
                  *  @throw std::out_of_range Thrown when the resource by the given name cannot
                  *  be found.
@@ -114,12 +343,121 @@ namespace Kiaro
                  */
                 Support::Set<std::pair<Support::String, Common::F32>> getSampleAverages(void);
 
+                /**
+                 *  @brief Returns the statistics of every call path profiled since this profiler was created, depth first
+                 *  with the most expensive paths of every level first.
+                 */
+                Support::Vector<HierarchyNode> getHierarchy(void);
+
+                //! Returns the number of scopes dropped because the ring buffer of their thread was full.
+                Common::U64 getDroppedRecordCount(void);
+
+                /**
+                 *  @brief Sets how many of the most recent frames the zone distributions cover. As the window is discarded in
+                 *  slices, it may cover up to a quarter less until enough new frames came in. Changing it discards the
+                 *  distributions recorded so far.
+                 *  @param frameCount The number of frames to cover. Must not be zero.
+                 *  @throw std::logic_error Thrown when frameCount is zero.
+                 */
+                void setDistributionWindow(const Common::U32 frameCount);
+
+                /**
+                 *  @brief Returns the distribution of the time the given zone took per frame.
+                 *  @param name The zone to look up.
+                 *  @throw std::out_of_range Thrown when the zone was not profiled in the distribution window.
+                 */
+                ZoneDistribution getDistribution(const Support::String& name);
+
+                //! Returns the distributions of every zone profiled in the distribution window, the worst 99th percentile first.
+                Support::Vector<ZoneDistribution> getDistributions(void);
+
+                /**
+                 *  @brief Starts recording every frame in which the given zone takes longer than the budget as a spike. Only
+                 *  the most recent sSpikeCapacity spikes are kept.
+                 *  @param name The zone to watch. Only one zone is watched at a time.
+                 *  @param budgetSeconds The time the zone may take per frame. Zero stops recording spikes.
+                 */
+                void setSpikeBudget(const Support::String& name, const Common::F32 budgetSeconds);
+
+                //! Returns the most recent spikes, oldest first.
+                Support::Vector<Spike> getSpikes(void);
+
+                //! Discards every spike recorded so far.
+                void clearSpikes(void);
+
+                /**
+                 *  @brief Names the calling thread in captures.
+                 *  @param name The name of the thread.
+                 */
+                void setThreadName(const Support::String& name);
+
+                /**
+                 *  @brief Records every scope profiled during the given number of frames, starting with the next one, and
+                 *  writes them as a Chrome Trace Event file once done. Frames are delimited by calls to update. The file
+                 *  can be opened with chrome://tracing or the Perfetto UI and shows a track for every named thread.
+                 *  @param frameCount The number of frames to capture.
+                 *  @param path The file to write the trace to.
+                 *  @return False if a capture is already pending or running, in which case nothing changes.
+                 */
+                bool beginCapture(const Common::U32 frameCount, const Support::String& path);
+
+                //! Returns whether or not a capture is pending or running.
+                bool isCapturing(void);
+
             // Private Methods
             private:
                 SProfiler(const size_t sampleCount = 32);
                 ~SProfiler(void);
+
+                //! Returns the ring buffer of the calling thread, creating it on first use.
+                ThreadBuffer* getThreadBuffer(void);
+
+                //! Moves every completed scope out of the ring buffers into the samples and hierarchy. Requires mMutex.
+                void aggregate(void);
+
+                //! Returns the zone of the given name if it was profiled by this profiler. Requires mMutex.
+                bool findProfiledZone(const Support::String& name, Common::U32& zone);
+
+                //! Returns the average of the given zone across the samples it was profiled in. Requires mMutex.
+                Common::F32 calculateAverage(const Common::U32 zone);
+
+                //! Writes the records of the finished capture to mCapturePath. Requires mMutex.
+                bool writeCapture(void);
+
+                //! Records the current frame into the distributions and spikes, then starts the next one. Requires mMutex.
+                void finishFrame(void);
+
+                //! Returns the distribution of the given zone across every slice of the window. Requires mMutex.
+                ZoneDistribution calculateDistribution(const Common::U32 zone);
+
+                //! Orders the given call paths depth first with the most expensive paths of every level first.
+                static Support::Vector<HierarchyNode> buildHierarchy(Support::UnorderedMap<Common::U64, PathStatistics>& paths);
+        };
+
+        /**
+         *  @brief Profiles the scope it lives in, beginning on construction and ending on destruction. Use
+         *  PROFILER_SCOPE rather than creating these directly.
+         */
+        class CProfilerScope
+        {
+            // Private Members
+            private:
+                //! The zone being profiled.
+                const Common::U32 mZone;
+
+            // Public Methods
+            public:
+                CProfilerScope(const Common::U32 zone) : mZone(zone)
+                {
+                    SProfiler::getPointer()->scopeBegin(mZone);
+                }
+
+                ~CProfilerScope(void)
+                {
+                    // Destructors may not throw, least of all while an exception unwinds through the scope
+                    SProfiler::getPointer()->scopeEndNoThrow(mZone);
+                }
         };
     } // End NameSpace Support
 } // End nameSpace Kiaro
 #endif // _INCLUDE_SUPPORT_SPROFILER_H_
-
@@ -126,6 +126,14 @@ namespace Kiaro
 
                 void setStringValue(const Support::String& name, const Support::String& value);
 
+                /**
+                 *  @brief Gets a stored setting value by its name, formatted the way setStringValue reads it.
+                 *  @param name The name of the setting to read.
+                 *  @return The formatted value of the setting.
+                 *  @throw std::runtime_error Thrown when the requested setting does not exist.
+                 */
+                Support::String getStringValue(const Support::String& name);
+
             // Protected Methods
             protected:
                 //! Parameter-less constructor.
@@ -34,6 +34,8 @@ namespace Kiaro
                     Termination,
                     //! A generalized signal for when too much CPU resources are being used. On Linux, this is called when SIGXCPU arrives.
                     CPUUsage,
+                    //! A generalized signal for when a profiler capture was requested from outside the process. On Unix systems, this is triggered by SIGUSR1.
+                    ProfileCapture,
                 };
 
                 //! The callable type to use for handling signals.
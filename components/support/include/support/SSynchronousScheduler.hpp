@@ -23,7 +23,8 @@
 #include <support/support.hpp>
 #include <support/common.hpp>
 #include <support/ISingleton.hpp>
-#include <support/UnorderedSet.hpp>
+#include <support/Vector.hpp>
+#include <support/SAllocationTracker.hpp>
 
 namespace Kiaro
 {
@@ -49,6 +50,13 @@ namespace Kiaro
                 //! How much time to wait in milliseconds before dispatching.
                 Common::U64 mWaitTimeMS;
 
+                //! The position of this event in the heap of the SSynchronousScheduler, or sNotScheduled.
+                size_t mHeapIndex;
+                //! Orders events sharing a trigger time by when they were scheduled.
+                Common::U64 mSequence;
+
+                friend class SSynchronousScheduler;
+
             // Public Methods
             public:
                 /**
@@ -92,8 +100,8 @@ namespace Kiaro
                 void dispatch(void);
 
                 /**
-                 *  @brief Flags the scheduled event for cancellation. It will be removed on the
-                 *  next iteration of the scheduler.
+                 *  @brief Flags the scheduled event for cancellation. This does not touch the scheduler, which
+                 *  deletes the event once it reaches the front of its queue or compacts it away.
                  */
                 void cancel(void) NOTHROW;
 
@@ -120,19 +128,59 @@ namespace Kiaro
                  *  @return A Common::U64 representing the wait time in milliseconds.
                  */
                 Common::U64 getWaitTimeMS(void) NOTHROW;
+
+                /**
+                 *  @brief Returns the absolute sim time in milliseconds at which the scheduled event
+                 *  will be dispatched.
+                 *  @return A Common::U64 representing the trigger time in milliseconds.
+                 */
+                Common::U64 getTriggerTimeMS(void) NOTHROW;
         };
 
         /**
          *  @brief A scheduler singleton used to automate deferred and recurring calls within the context
          *  of the main thread, hence the name SSynchronousScheduler. In contrast, there is the SAsynchronousScheduler
          *  for accurate timings.
+         *  @details Events are kept in a binary min-heap ordered by trigger time, so an update only touches the events
+         *  that are due. Each event knows its position in the heap so that changing its trigger time only moves that
+         *  event. Events sharing a trigger time dispatch in the order they were scheduled. An event is dispatched at
+         *  most once per update, so events scheduled by a dispatched call wait for the next update even if already due.
          */
         class SSynchronousScheduler : public ISingleton<SSynchronousScheduler>
         {
             // Private Members
             private:
-                //! A set of scheduled events for processing.
-                Support::UnorderedSet<CScheduledEvent*> mScheduledEventSet;
+                //! The scheduled events, ordered as a min-heap by trigger time and sequence.
+                Support::Vector<CScheduledEvent*, CTrackedAllocator<CScheduledEvent*>> mEventHeap;
+
+                //! The sequence given to the next event that is scheduled or rescheduled.
+                Common::U64 mNextSequence;
+
+                //! The heap size at which cancelled events are compacted away on the next update.
+                size_t mCompactionSize;
+
+            // Private Methods
+            private:
+                //! Returns whether the event at the given index triggers before the event at the other index.
+                bool isEarlier(const size_t lhs, const size_t rhs) const;
+
+                //! Places the event at the given index in the heap and updates its index.
+                void place(CScheduledEvent* event, const size_t index);
+
+                //! Moves the event at the given index towards the front of the heap until it is in order.
+                void siftUp(size_t index);
+
+                //! Moves the event at the given index towards the back of the heap until it is in order.
+                void siftDown(size_t index);
+
+                //! Removes the event at the given index from the heap without deleting it.
+                void removeAt(const size_t index);
+
+                //! Deletes cancelled events at the front of the heap so that the front is the next event to dispatch.
+                void popCancelledEvents(void);
+
+                //! Deletes every cancelled event and rebuilds the heap.
+                void compact(void);
 
             // Public Methods
             public:
@@ -150,6 +198,7 @@ namespace Kiaro
                 template <typename returnType, typename... parameters>
                 CScheduledEvent* schedule(const Common::U32 waitTimeMS, const bool recurring, EasyDelegate::StaticMethodPointer<returnType, parameters...> method, parameters... params)
                 {
+                    ALLOCATION_SCOPE(Scheduler);
                     return this->schedule(new EasyDelegate::DeferredStaticCaller<returnType, parameters...>(method, params...), waitTimeMS, recurring);
                 }
 
@@ -169,6 +218,7 @@ namespace Kiaro
                 template <typename classType, typename returnType, typename... parameters>
                 CScheduledEvent* schedule(const Common::U32 waitTimeMS, const bool recurring, classType* thisPointer, EasyDelegate::MemberMethodPointer<classType, returnType, parameters...> method, parameters... params)
                 {
+                    ALLOCATION_SCOPE(Scheduler);
                     return this->schedule(new EasyDelegate::DeferredMemberCaller<classType, returnType, parameters...>(method, thisPointer, params...), waitTimeMS, recurring);
                 }
 
@@ -189,12 +239,30 @@ namespace Kiaro
                  */
                 void update(void);
 
+                /**
+                 *  @brief Moves the given event to its place in the heap after its trigger time has changed.
+                 *  CScheduledEvent calls this itself whenever its trigger time is set.
+                 *  @param event The event that was rescheduled.
+                 */
+                void reschedule(CScheduledEvent* event);
+
+                //! Returns the number of events held, including cancelled events that were not deleted yet.
+                size_t getEventCount(void) const;
+
+                /**
+                 *  @brief Returns how long it will be until the next scheduled event is due. The main loop
+                 *  uses this to block rather than spin when there is nothing to do.
+                 *  @return The time in milliseconds until the next event is due, zero if an event is
+                 *  overdue or the maximum Common::U64 value if nothing is scheduled.
+                 */
+                Common::U64 getTimeUntilNextEventMS(void);
+
             // Protected Methods
             protected:
                 //! Parameter-less constructor.
                 SSynchronousScheduler(void);
 
-                //! Standard destructor.
+                //! Standard destructor, deleting every event still scheduled.
                 ~SSynchronousScheduler(void);
         };
     } // End NameSpace Support
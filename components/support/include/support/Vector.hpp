@@ -19,8 +19,8 @@ namespace Kiaro
     namespace Support
     {
         //! A typedef to an std::vector.
-        template <typename storedType>
-        using Vector = std::vector<storedType>;
+        template <typename storedType, typename allocatorType = std::allocator<storedType>>
+        using Vector = std::vector<storedType, allocatorType>;
     } // End NameSpace Support
 } // End NameSpace Kiaro
 #endif // _INCLUDE_SUPPORT_VECTOR_HPP_
@@ -105,6 +105,8 @@ namespace Kiaro
         typedef char C8;
         //! 64-bit integer typedef.
         typedef unsigned long long int U64;
+        //! 64-bit signed integer typedef.
+        typedef signed long long int S64;
     } // End NameSpace Common
 } // End NameSpace Kiaro
 #endif // _INCLUDE_KIARO_ENGINE_COMMON_
@@ -0,0 +1,126 @@
+/**
+ *  @file thread.hpp
+ *  @brief Include file declaring the processor topology detection and thread placement functions of the engine.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_PLATFORM_THREAD_HPP_
+#define _INCLUDE_PLATFORM_THREAD_HPP_
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+
+namespace Kiaro
+{
+    namespace Platform
+    {
+        namespace Thread
+        {
+            /**
+             *  @brief How the threads of a pool are pinned to logical cores. These values are what the
+             *  System::RuntimeThreadAffinity and System::WorkerThreadAffinity settings hold.
+             */
+            enum AFFINITY_POLICY
+            {
+                //! Threads are not pinned and the operating system places them freely.
+                AFFINITY_NONE = 0,
+                //! Each thread is pinned to a single logical core, using every physical core once before any of their siblings.
+                AFFINITY_CORE = 1,
+                //! Each thread is pinned to every logical core of a single NUMA node, spreading threads across the nodes.
+                AFFINITY_NODE = 2,
+            }; // End Enum AFFINITY_POLICY
+
+            //! The scheduling priority classes threads may run at, from least to most latency critical.
+            enum THREAD_PRIORITY
+            {
+                //! Loading and other work that may be starved for a while without anyone noticing.
+                PRIORITY_BACKGROUND = 0,
+                //! The default priority of new threads.
+                PRIORITY_NORMAL = 1,
+                //! Threads running the simulation, whose work the current tick waits on.
+                PRIORITY_SIMULATION = 2,
+                //! The thread pumping the network, which must not be delayed by anything else in the engine.
+                PRIORITY_NETWORK = 3,
+            }; // End Enum THREAD_PRIORITY
+
+            //! A single logical core of the machine.
+            struct ProcessorCore
+            {
+                //! The identifier the operating system uses for this logical core.
+                Common::U32 mID;
+                //! The index of the physical core this logical core belongs to. Hyperthreaded siblings share it.
+                Common::U32 mPhysicalCore;
+                //! The index of the NUMA node this logical core belongs to.
+                Common::U32 mNode;
+            };
+
+            //! The logical cores the engine may run on and how they are grouped.
+            struct ProcessorTopology
+            {
+                //! Every logical core the process is allowed to run on, ordered by their identifiers.
+                Support::Vector<ProcessorCore> mCores;
+                //! The number of distinct physical cores in mCores.
+                Common::U32 mPhysicalCoreCount;
+                //! The number of distinct NUMA nodes in mCores.
+                Common::U32 mNodeCount;
+            };
+
+            /**
+             *  @brief Queries the operating system for the processor topology. On failure, this falls back to a single node
+             *  of std::thread::hardware_concurrency cores without any hyperthreading.
+             *  @param output The topology to write to.
+             */
+            void detectProcessorTopology(ProcessorTopology& output);
+
+            //! Returns the processor topology of the machine, which is detected on the first call.
+            const ProcessorTopology& getProcessorTopology(void);
+
+            /**
+             *  @brief Returns the logical cores a thread of a pool should be pinned to.
+             *  @param topology The topology to place the thread on.
+             *  @param policy The pinning policy of the pool.
+             *  @param slot The index of the thread within the pool. Slots beyond the available cores or nodes wrap around.
+             *  @param fromEnd Whether to place the pool starting at the last cores or nodes rather than the first, so that two
+             *  pools sharing the machine only overlap once there are more threads than cores.
+             *  @return The identifiers of the logical cores to pin to, which is empty for AFFINITY_NONE.
+             */
+            Support::Vector<Common::U32> getPlacementCores(const ProcessorTopology& topology, const AFFINITY_POLICY policy, const Common::U32 slot,
+                                                           const bool fromEnd);
+
+            /**
+             *  @brief Pins the calling thread to the given logical cores.
+             *  @param cores The identifiers of the logical cores. If empty, the thread may run anywhere.
+             *  @return True if the operating system accepted the affinity.
+             */
+            bool setCurrentThreadAffinity(const Support::Vector<Common::U32>& cores);
+
+            /**
+             *  @brief Sets the scheduling priority of the calling thread.
+             *  @param priority The priority class to run at.
+             *  @return True if the operating system accepted the priority. Raising a priority above normal commonly requires
+             *  elevated privileges and fails otherwise, in which case the thread keeps its current priority.
+             */
+            bool setCurrentThreadPriority(const THREAD_PRIORITY priority);
+
+            /**
+             *  @brief Places the calling thread as a member of a pool, setting both its affinity and its priority. Failures
+             *  are logged and otherwise ignored, so the thread keeps running with the placement it had. AFFINITY_NONE and
+             *  PRIORITY_NORMAL are applied as well, undoing whatever placement the thread inherited from its creator.
+             *  @param name The name of the pool, used in log messages.
+             *  @param policy The pinning policy of the pool.
+             *  @param slot The index of the thread within the pool.
+             *  @param fromEnd Whether the pool is placed starting at the last cores or nodes.
+             *  @param priority The priority class to run at.
+             */
+            void placeCurrentThread(const Common::C8* name, const AFFINITY_POLICY policy, const Common::U32 slot, const bool fromEnd,
+                                    const THREAD_PRIORITY priority);
+        } // End NameSpace Thread
+    } // End NameSpace Platform
+} // End NameSpace Kiaro
+#endif // _INCLUDE_PLATFORM_THREAD_HPP_
@@ -0,0 +1,203 @@
+/**
+ *  @file CCommandBuffer.hpp
+ *  @brief Include file declaring the CCommandBuffer class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_CCOMMANDBUFFER_HPP_
+#define _INCLUDE_SUPPORT_TASKING_CCOMMANDBUFFER_HPP_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <support/common.hpp>
+#include <support/Vector.hpp>
+
+#include <easydelegate/easydelegate.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            /**
+             *  @brief A buffer of deferred calls stored back to back in bump allocated memory blocks.
+             *  @details Recording a command copies the callable and its arguments into the current block, so the only heap
+             *  traffic is growing the buffer the first few times it is filled. Executing or clearing the buffer rewinds it
+             *  while keeping its blocks, so a buffer that is reused every frame quickly stops allocating at all. Commands always
+             *  execute in the order they were recorded.
+             */
+            class CCommandBuffer
+            {
+                // Private Members
+                private:
+                    //! The function executing and destroying, or only destroying, the command stored at the given address.
+                    typedef void (*CommandFunction)(void* command, const bool execute);
+
+                    //! The header stored in front of every command.
+                    struct CommandHeader
+                    {
+                        //! The function executing the command.
+                        CommandFunction mFunction;
+
+                        //! The number of bytes from this header to the next one.
+                        size_t mSize;
+                    };
+
+                    //! A single block of memory commands are recorded into.
+                    struct Block
+                    {
+                        //! The memory of the block.
+                        Common::U8* mData;
+
+                        //! The size of the block in bytes.
+                        size_t mCapacity;
+
+                        //! The number of bytes used by recorded commands.
+                        size_t mUsed;
+                    };
+
+                    //! All blocks owned by this buffer. Blocks past mCurrentBlock are empty and waiting to be reused. Only empty
+                    //! after the buffer was moved from.
+                    Support::Vector<Block> mBlocks;
+
+                    //! The index of the block commands are currently recorded into.
+                    size_t mCurrentBlock;
+
+                    //! The number of recorded commands.
+                    size_t mCommandCount;
+
+                // Private Methods
+                private:
+                    //! Rounds the given size up to the alignment of every command.
+                    static size_t align(const size_t size);
+
+                    //! Reserves room for a command of the given size and returns the address of its header.
+                    CommandHeader* allocate(const size_t size);
+
+                    //! Walks every recorded command, executing it if requested, destroys it and rewinds the buffer.
+                    void release(const bool execute);
+
+                    /**
+                     *  @brief Walks the recorded commands starting at the given position, executing them if requested, destroys
+                     *  them and rewinds the buffer. If a command throws, the commands after it are destroyed without executing
+                     *  them before the exception is rethrown, so the buffer is empty either way.
+                     *  @param blockIndex The block of the first command to release.
+                     *  @param offset The offset of the first command to release within its block.
+                     *  @param execute Whether or not to execute the commands before destroying them.
+                     */
+                    void releaseFrom(size_t blockIndex, size_t offset, const bool execute);
+
+                    template <typename functorType>
+                    static void invokeFunctor(void* command, const bool execute)
+                    {
+                        functorType* functor = reinterpret_cast<functorType*>(command);
+
+                        if (execute)
+                        {
+                            try
+                            {
+                                (*functor)();
+                            }
+                            catch (...)
+                            {
+                                functor->~functorType();
+                                throw;
+                            }
+                        }
+
+                        functor->~functorType();
+                    }
+
+                    static void invokeDeferredCaller(void* command, const bool execute);
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Constructor accepting an initial block size.
+                     *  @param blockSize The size of the first block in bytes. Blocks allocated later are at least this big.
+                     */
+                    CCommandBuffer(const size_t blockSize = 4096);
+
+                    //! Standard destructor. Commands that were never executed are destroyed without executing them.
+                    ~CCommandBuffer(void);
+
+                    //! Commands are not copyable in general, so neither are buffers of them.
+                    CCommandBuffer(const CCommandBuffer&) = delete;
+                    CCommandBuffer& operator=(const CCommandBuffer&) = delete;
+
+                    //! Move constructor taking over the blocks and commands of the other buffer, which is left empty.
+                    CCommandBuffer(CCommandBuffer&& other);
+
+                    /**
+                     *  @brief Move assignment. Commands recorded into this buffer are destroyed without executing them, then the
+                     *  blocks and commands of the other buffer are taken over.
+                     */
+                    CCommandBuffer& operator=(CCommandBuffer&& other);
+
+                    /**
+                     *  @brief Records a callable taking no parameters. It is copied into the buffer and destroyed once executed.
+                     *  @param functor The callable to record.
+                     */
+                    template <typename functorType, typename = typename std::enable_if<!std::is_pointer<typename std::decay<functorType>::type>::value>::type>
+                    void push(functorType&& functor)
+                    {
+                        typedef typename std::decay<functorType>::type storedType;
+                        static_assert(alignof(storedType) <= alignof(std::max_align_t), "CCommandBuffer: Command is over aligned.");
+
+                        CommandHeader* header = this->allocate(align(sizeof(CommandHeader)) + align(sizeof(storedType)));
+                        header->mFunction = invokeFunctor<storedType>;
+
+                        new (reinterpret_cast<Common::U8*>(header) + align(sizeof(CommandHeader))) storedType(std::forward<functorType>(functor));
+                    }
+
+                    /**
+                     *  @brief Records a call to a free function. The arguments are copied into the buffer.
+                     *  @param function The function to call.
+                     *  @param arguments The arguments to call it with.
+                     */
+                    template <typename returnType, typename... parameters, typename... argumentTypes>
+                    void push(returnType (*function)(parameters...), argumentTypes... arguments)
+                    {
+                        this->push([=]() { function(arguments...); });
+                    }
+
+                    /**
+                     *  @brief Records a heap allocated deferred caller. The buffer takes ownership and deletes it once executed.
+                     *  @param caller The deferred caller to record.
+                     */
+                    void push(EasyDelegate::IDeferredCaller* caller);
+
+                    /**
+                     *  @brief Executes every recorded command in the order they were recorded, then rewinds the buffer.
+                     *  @throw Whatever a command throws. The commands after it are destroyed without being executed.
+                     */
+                    void execute(void);
+
+                    //! Destroys every recorded command without executing it, then rewinds the buffer.
+                    void clear(void);
+
+                    //! Returns the number of recorded commands.
+                    size_t getCommandCount(void) const;
+
+                    //! Returns whether or not no commands are recorded.
+                    bool empty(void) const;
+
+                    //! Returns the number of bytes used by recorded commands.
+                    size_t getUsedBytes(void) const;
+
+                    //! Returns the number of bytes allocated by this buffer.
+                    size_t getCapacity(void) const;
+            };
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_TASKING_CCOMMANDBUFFER_HPP_
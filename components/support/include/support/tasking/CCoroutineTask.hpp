@@ -0,0 +1,348 @@
+/**
+ *  @file CCoroutineTask.hpp
+ *  @brief Include file declaring the CCoroutine type, the CCoroutineTask class and the awaitables coroutines may use.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_CCOROUTINETASK_HPP_
+#define _INCLUDE_SUPPORT_TASKING_CCOROUTINETASK_HPP_
+
+// Coroutines require C++20, so everything here disappears on older standards
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+    #if __has_include(<coroutine>)
+        #define _SUPPORT_USE_COROUTINES_ 1
+    #endif
+#endif
+
+#if _SUPPORT_USE_COROUTINES_
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/SSynchronousScheduler.hpp>
+
+#include <support/tasking/ITask.hpp>
+#include <support/tasking/CFuture.hpp>
+#include <support/tasking/CJobSystem.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            /**
+             *  @brief The return type of coroutines that run as engine tasks. A coroutine starts suspended and does nothing
+             *  until it is handed to a CCoroutineTask, which resumes it whenever what it awaits is ready.
+             *  @details
+             *  @code
+             *  CCoroutine streamAssets(void)
+             *  {
+             *      CFuture<Common::U32> loaded = SAsynchronousTaskManager::getInstance()->run(loadAssets);
+             *      const Common::U32 assetCount = co_await loaded;
+             *
+             *      co_await CDelay(500);
+             *      const Common::F32 deltaTimeSeconds = co_await CNextTick();
+             *  }
+             *
+             *  SSynchronousTaskManager::getInstance()->addTask(new CCoroutineTask(streamAssets()));
+             *  @endcode
+             */
+            class CCoroutine
+            {
+                // Public Members
+                public:
+                    //! The state of a coroutine shared with whatever it awaits.
+                    struct promise_type
+                    {
+                        //! Returns whether or not the awaited operation has completed. Null when only waiting for the next tick.
+                        bool (*mCanResume)(void* awaiter);
+
+                        //! The awaiter passed to mCanResume. It lives in the coroutine frame for as long as it is awaited.
+                        void* mAwaiter;
+
+                        //! The delta time of the tick that last resumed the coroutine.
+                        Common::F32 mDeltaTimeSeconds;
+
+                        //! The exception that escaped the coroutine, if any.
+                        std::exception_ptr mException;
+
+                        promise_type(void) : mCanResume(nullptr), mAwaiter(nullptr), mDeltaTimeSeconds(0.0f)
+                        {
+
+                        }
+
+                        CCoroutine get_return_object(void)
+                        {
+                            return CCoroutine(std::coroutine_handle<promise_type>::from_promise(*this));
+                        }
+
+                        std::suspend_always initial_suspend(void) noexcept
+                        {
+                            return std::suspend_always();
+                        }
+
+                        std::suspend_always final_suspend(void) noexcept
+                        {
+                            return std::suspend_always();
+                        }
+
+                        void return_void(void)
+                        {
+
+                        }
+
+                        void unhandled_exception(void)
+                        {
+                            mException = std::current_exception();
+                        }
+                    };
+
+                // Private Members
+                private:
+                    //! The coroutine owned by this object.
+                    std::coroutine_handle<promise_type> mHandle;
+
+                // Public Methods
+                public:
+                    explicit CCoroutine(std::coroutine_handle<promise_type> handle) : mHandle(handle)
+                    {
+
+                    }
+
+                    //! Move constructor, taking ownership of the other coroutine.
+                    CCoroutine(CCoroutine&& other) noexcept : mHandle(other.mHandle)
+                    {
+                        other.mHandle = nullptr;
+                    }
+
+                    //! Standard destructor, destroying the coroutine wherever it is suspended.
+                    ~CCoroutine(void)
+                    {
+                        if (mHandle)
+                        {
+                            mHandle.destroy();
+                        }
+                    }
+
+                    //! Returns the coroutine owned by this object.
+                    std::coroutine_handle<promise_type> getHandle(void) const
+                    {
+                        return mHandle;
+                    }
+            };
+
+            /**
+             *  @brief A task driving a CCoroutine. Each tick resumes the coroutine if what it awaits is ready, so the coroutine
+             *  runs on whichever thread the task manager the task was added to ticks it on.
+             */
+            class CCoroutineTask : public ITask
+            {
+                // Private Members
+                private:
+                    //! The coroutine being driven.
+                    CCoroutine mCoroutine;
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Constructor accepting the coroutine to drive.
+                     *  @param coroutine The coroutine. The task takes ownership of it.
+                     */
+                    CCoroutineTask(CCoroutine&& coroutine);
+
+                    void initialize(void);
+                    void deinitialize(void);
+
+                    /**
+                     *  @brief Resumes the coroutine if what it awaits is ready.
+                     *  @return True once the coroutine has finished, whether by returning or by throwing.
+                     */
+                    bool tick(const Common::F32 deltaTimeSeconds);
+
+                    //! Returns the exception that escaped the coroutine, or null if none did.
+                    std::exception_ptr getException(void) const;
+            };
+
+            //! Awaitable suspending a coroutine until the next tick of its task. Awaiting it yields that tick's delta time.
+            struct CNextTick
+            {
+                //! The coroutine awaiting the next tick.
+                CCoroutine::promise_type* mPromise;
+
+                bool await_ready(void) const noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<CCoroutine::promise_type> handle) noexcept
+                {
+                    mPromise = &handle.promise();
+                    mPromise->mCanResume = nullptr;
+                }
+
+                Common::F32 await_resume(void) const noexcept
+                {
+                    return mPromise->mDeltaTimeSeconds;
+                }
+            };
+
+            //! Awaitable suspending a coroutine until every job submitted against the given counter has completed.
+            struct CAwaitJobs
+            {
+                //! The counter to wait on.
+                const CJobSystem::CJobCounter& mCounter;
+
+                CAwaitJobs(const CJobSystem::CJobCounter& counter) : mCounter(counter)
+                {
+
+                }
+
+                static bool canResume(void* awaiter)
+                {
+                    return reinterpret_cast<CAwaitJobs*>(awaiter)->mCounter.isComplete();
+                }
+
+                bool await_ready(void) const noexcept
+                {
+                    return mCounter.isComplete();
+                }
+
+                void await_suspend(std::coroutine_handle<CCoroutine::promise_type> handle) noexcept
+                {
+                    handle.promise().mCanResume = canResume;
+                    handle.promise().mAwaiter = this;
+                }
+
+                void await_resume(void) const noexcept
+                {
+
+                }
+            };
+
+            /**
+             *  @brief Awaitable suspending a coroutine for the given time, measured by a SSynchronousScheduler event.
+             *  @warning The scheduler is not thread safe, so only coroutines ticked on the main thread may await this.
+             */
+            struct CDelay
+            {
+                //! The time to wait in milliseconds.
+                Common::U32 mWaitTimeMS;
+
+                //! Set by the scheduled event once the time has passed. Shared so the event may outlive the coroutine.
+                std::shared_ptr<Support::Atomic<bool>> mElapsed;
+
+                //! The scheduled event, if it has not fired yet.
+                CScheduledEvent* mEvent;
+
+                CDelay(const Common::U32 waitTimeMS) : mWaitTimeMS(waitTimeMS), mElapsed(std::make_shared<Support::Atomic<bool>>(false)), mEvent(nullptr)
+                {
+
+                }
+
+                //! Cancels the scheduled event if the coroutine is destroyed while waiting and the scheduler still exists.
+                ~CDelay(void)
+                {
+                    if (mEvent && !mElapsed->load() && SSynchronousScheduler::getPointer())
+                    {
+                        mEvent->cancel();
+                    }
+                }
+
+                static void elapse(std::shared_ptr<Support::Atomic<bool>> elapsed)
+                {
+                    elapsed->store(true);
+                }
+
+                static bool canResume(void* awaiter)
+                {
+                    return reinterpret_cast<CDelay*>(awaiter)->mElapsed->load();
+                }
+
+                bool await_ready(void) const noexcept
+                {
+                    return mWaitTimeMS == 0;
+                }
+
+                void await_suspend(std::coroutine_handle<CCoroutine::promise_type> handle)
+                {
+                    mEvent = SSynchronousScheduler::getInstance()->schedule(mWaitTimeMS, false, elapse, mElapsed);
+
+                    handle.promise().mCanResume = canResume;
+                    handle.promise().mAwaiter = this;
+                }
+
+                void await_resume(void) const noexcept
+                {
+
+                }
+            };
+
+            /**
+             *  @brief Awaitable suspending a coroutine until the given future completes. Awaiting it yields the value of
+             *  the future, or rethrows its failure inside the coroutine.
+             */
+            template <typename valueType>
+            struct CAwaitFuture
+            {
+                //! The future to wait on.
+                CFuture<valueType> mFuture;
+
+                //! Set once the future has completed. Shared so the future may outlive the coroutine.
+                std::shared_ptr<Support::Atomic<bool>> mReady;
+
+                CAwaitFuture(const CFuture<valueType>& future) : mFuture(future), mReady(std::make_shared<Support::Atomic<bool>>(false))
+                {
+
+                }
+
+                static bool canResume(void* awaiter)
+                {
+                    return reinterpret_cast<CAwaitFuture*>(awaiter)->mReady->load();
+                }
+
+                bool await_ready(void) const
+                {
+                    return mFuture.isReady();
+                }
+
+                void await_suspend(std::coroutine_handle<CCoroutine::promise_type> handle)
+                {
+                    handle.promise().mCanResume = canResume;
+                    handle.promise().mAwaiter = this;
+
+                    std::shared_ptr<Support::Atomic<bool>> ready = mReady;
+                    mFuture.whenReady([ready]() { ready->store(true); });
+                }
+
+                typename FutureReference<valueType>::Type await_resume(void) const
+                {
+                    return mFuture.get();
+                }
+            };
+
+            //! Allows coroutines to co_await a CFuture directly.
+            template <typename valueType>
+            CAwaitFuture<valueType> operator co_await(const CFuture<valueType>& future)
+            {
+                return CAwaitFuture<valueType>(future);
+            }
+
+            //! Allows coroutines to co_await a CJobCounter directly.
+            inline CAwaitJobs operator co_await(const CJobSystem::CJobCounter& counter)
+            {
+                return CAwaitJobs(counter);
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _SUPPORT_USE_COROUTINES_
+#endif // _INCLUDE_SUPPORT_TASKING_CCOROUTINETASK_HPP_
@@ -0,0 +1,563 @@
+/**
+ *  @file CFuture.hpp
+ *  @brief Include file declaring the CFuture, CPromise and CCancellationToken types.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_CFUTURE_HPP_
+#define _INCLUDE_SUPPORT_TASKING_CFUTURE_HPP_
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! The states a future may be in.
+            enum FUTURE_STATUS
+            {
+                //! The result is not available yet.
+                FUTURE_PENDING = 0,
+                //! A value was produced.
+                FUTURE_FULFILLED = 1,
+                //! An exception was thrown while producing the value.
+                FUTURE_FAILED = 2,
+                //! The work was cancelled before producing a value.
+                FUTURE_CANCELLED = 3,
+            }; // End Enum FUTURE_STATUS
+
+            //! Where a continuation is executed once the future it is attached to completes.
+            enum EXECUTION_CONTEXT
+            {
+                //! On the main thread, the next time the SAsynchronousTaskManager is ticked.
+                EXECUTION_MAIN_THREAD = 0,
+                //! On one of the workers of the SAsynchronousTaskManager.
+                EXECUTION_WORKER = 1,
+                //! Immediately, on whichever thread completed the future.
+                EXECUTION_INLINE = 2,
+            }; // End Enum EXECUTION_CONTEXT
+
+            /**
+             *  @brief Executes the given call in the given context.
+             *  @param call The call to execute.
+             *  @param context Where to execute the call.
+             */
+            void dispatchCall(std::function<void(void)> call, const EXECUTION_CONTEXT context);
+
+            /**
+             *  @brief A token shared between the owner of some asynchronous work and the work itself, used to request that the
+             *  work stop early. Copies of a token all refer to the same cancellation state.
+             */
+            class CCancellationToken
+            {
+                // Private Members
+                private:
+                    //! The cancellation state shared by all copies of this token.
+                    std::shared_ptr<Support::Atomic<bool>> mCancelled;
+
+                // Public Methods
+                public:
+                    //! Parameter-less constructor, creating a new cancellation state.
+                    CCancellationToken(void);
+
+                    //! Requests cancellation. Work observing this token should stop as soon as it is able to.
+                    void cancel(void);
+
+                    //! Returns whether or not cancellation was requested.
+                    bool isCancelled(void) const;
+            };
+
+            /**
+             *  @brief The state shared between a promise and its futures.
+             *  @details void results are stored as a placeholder boolean so that the same state serves every result type.
+             */
+            template <typename valueType>
+            class CFutureState
+            {
+                // Public Members
+                public:
+                    typedef typename std::conditional<std::is_void<valueType>::value, bool, valueType>::type StoredType;
+
+                    //! The mutex protecting the state.
+                    Support::Mutex mMutex;
+
+                    //! Signaled once the state leaves FUTURE_PENDING.
+                    Support::ConditionVariable mCondition;
+
+                    //! The current status.
+                    FUTURE_STATUS mStatus;
+
+                    //! The produced value, if fulfilled.
+                    std::unique_ptr<StoredType> mValue;
+
+                    //! The thrown exception, if failed.
+                    std::exception_ptr mException;
+
+                    //! The calls to make once the state leaves FUTURE_PENDING.
+                    Support::Vector<std::function<void(void)>> mContinuations;
+
+                    //! The cancellation token of the work producing the value.
+                    CCancellationToken mToken;
+
+                // Public Methods
+                public:
+                    CFutureState(const CCancellationToken& token) : mStatus(FUTURE_PENDING), mToken(token)
+                    {
+
+                    }
+
+                    /**
+                     *  @brief Completes the state with the given status and runs every continuation.
+                     *  @return True if the state was pending. False if it had already completed, in which case nothing changes.
+                     */
+                    template <typename settleFunction>
+                    bool settle(const FUTURE_STATUS status, settleFunction setResult)
+                    {
+                        Support::Vector<std::function<void(void)>> continuations;
+
+                        {
+                            std::lock_guard<Support::Mutex> lock(mMutex);
+
+                            if (mStatus != FUTURE_PENDING)
+                            {
+                                return false;
+                            }
+
+                            setResult();
+                            mStatus = status;
+                            continuations.swap(mContinuations);
+                        }
+
+                        mCondition.notify_all();
+
+                        for (std::function<void(void)>& continuation : continuations)
+                        {
+                            continuation();
+                        }
+
+                        return true;
+                    }
+
+                    //! Adds a continuation, running it immediately if the state has already completed.
+                    void addContinuation(std::function<void(void)> continuation)
+                    {
+                        {
+                            std::lock_guard<Support::Mutex> lock(mMutex);
+
+                            if (mStatus == FUTURE_PENDING)
+                            {
+                                mContinuations.push_back(continuation);
+                                return;
+                            }
+                        }
+
+                        continuation();
+                    }
+            };
+
+            template <typename valueType>
+            class CFuture;
+
+            /**
+             *  @brief Shared by every copy of a CPromise. Once the last copy is destroyed, a future that was never completed
+             *  fails, so that nobody waits forever on work that was thrown away without running.
+             */
+            template <typename valueType>
+            class CPromiseOwner
+            {
+                // Private Members
+                private:
+                    //! The state shared with the futures.
+                    std::shared_ptr<CFutureState<valueType>> mState;
+
+                // Public Methods
+                public:
+                    CPromiseOwner(const std::shared_ptr<CFutureState<valueType>>& state) : mState(state)
+                    {
+
+                    }
+
+                    ~CPromiseOwner(void)
+                    {
+                        std::shared_ptr<CFutureState<valueType>> state = mState;
+                        state->settle(FUTURE_FAILED, [&state]()
+                        {
+                            state->mException = std::make_exception_ptr(std::runtime_error("CPromise: The promise was destroyed without completing the future."));
+                        });
+                    }
+
+                    CPromiseOwner(const CPromiseOwner&) = delete;
+                    CPromiseOwner& operator=(const CPromiseOwner&) = delete;
+            };
+
+            /**
+             *  @brief The producing side of a CFuture. The first call to setValue, setException or cancel completes every
+             *  future obtained from this promise; later calls are ignored. If every copy of the promise is destroyed before
+             *  that, the future fails with a std::runtime_error.
+             */
+            template <typename valueType>
+            class CPromise
+            {
+                // Private Members
+                private:
+                    //! The state shared with the futures.
+                    std::shared_ptr<CFutureState<valueType>> mState;
+
+                    //! Breaks the promise once the last copy of it goes away.
+                    std::shared_ptr<CPromiseOwner<valueType>> mOwner;
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Constructor accepting a cancellation token.
+                     *  @param token The token the producing work observes. Cancelling the future cancels this token.
+                     */
+                    CPromise(const CCancellationToken& token = CCancellationToken()) : mState(std::make_shared<CFutureState<valueType>>(token)),
+                    mOwner(std::make_shared<CPromiseOwner<valueType>>(mState))
+                    {
+
+                    }
+
+                    //! Returns a future completed by this promise.
+                    CFuture<valueType> getFuture(void) const
+                    {
+                        return CFuture<valueType>(mState);
+                    }
+
+                    //! Returns the cancellation token the producing work should observe.
+                    const CCancellationToken& getToken(void) const
+                    {
+                        return mState->mToken;
+                    }
+
+                    //! Returns whether or not cancellation of the producing work was requested.
+                    bool isCancellationRequested(void) const
+                    {
+                        return mState->mToken.isCancelled();
+                    }
+
+                    /**
+                     *  @brief Fulfills the future with the given value.
+                     *  @return True if this completed the future.
+                     */
+                    template <typename argumentType>
+                    bool setValue(argumentType&& value)
+                    {
+                        std::shared_ptr<CFutureState<valueType>> state = mState;
+                        return state->settle(FUTURE_FULFILLED, [&state, &value]()
+                        {
+                            state->mValue.reset(new typename CFutureState<valueType>::StoredType(std::forward<argumentType>(value)));
+                        });
+                    }
+
+                    /**
+                     *  @brief Fulfills a future without a value.
+                     *  @return True if this completed the future.
+                     */
+                    bool setValue(void)
+                    {
+                        static_assert(std::is_void<valueType>::value, "CPromise: A value is required.");
+                        return this->setValue(true);
+                    }
+
+                    /**
+                     *  @brief Fails the future with the given exception, which is rethrown by CFuture::get.
+                     *  @return True if this completed the future.
+                     */
+                    bool setException(std::exception_ptr exception)
+                    {
+                        std::shared_ptr<CFutureState<valueType>> state = mState;
+                        return state->settle(FUTURE_FAILED, [&state, &exception]()
+                        {
+                            state->mException = exception;
+                        });
+                    }
+
+                    /**
+                     *  @brief Cancels the future and requests cancellation of the producing work.
+                     *  @return True if this completed the future.
+                     */
+                    bool cancel(void)
+                    {
+                        mState->mToken.cancel();
+                        return mState->settle(FUTURE_CANCELLED, []() { });
+                    }
+            };
+
+            //! Calls a continuation with the value of a completed state.
+            template <typename valueType>
+            struct FutureValueCall
+            {
+                template <typename functionType>
+                static auto call(functionType& function, CFutureState<valueType>& state) -> decltype(function(std::declval<valueType&>()))
+                {
+                    return function(*state.mValue);
+                }
+            };
+
+            template <>
+            struct FutureValueCall<void>
+            {
+                template <typename functionType>
+                static auto call(functionType& function, CFutureState<void>& state) -> decltype(function())
+                {
+                    return function();
+                }
+            };
+
+            //! Completes a promise with the result of a call, or with the exception it threw.
+            template <typename resultType>
+            struct FuturePromiseCall
+            {
+                template <typename callType>
+                static void call(CPromise<resultType>& promise, callType call)
+                {
+                    try
+                    {
+                        promise.setValue(call());
+                    }
+                    catch (...)
+                    {
+                        promise.setException(std::current_exception());
+                    }
+                }
+            };
+
+            template <>
+            struct FuturePromiseCall<void>
+            {
+                template <typename callType>
+                static void call(CPromise<void>& promise, callType call)
+                {
+                    try
+                    {
+                        call();
+                        promise.setValue();
+                    }
+                    catch (...)
+                    {
+                        promise.setException(std::current_exception());
+                    }
+                }
+            };
+
+            //! The type CFuture::get returns: a reference to the stored value, or nothing for a void future.
+            template <typename valueType>
+            struct FutureReference
+            {
+                typedef valueType& Type;
+            };
+
+            template <>
+            struct FutureReference<void>
+            {
+                typedef void Type;
+            };
+
+            /**
+             *  @brief The consuming side of a value produced asynchronously. Futures are cheap to copy and every copy refers
+             *  to the same result.
+             */
+            template <typename valueType>
+            class CFuture
+            {
+                // Private Members
+                private:
+                    //! The state shared with the promise.
+                    std::shared_ptr<CFutureState<valueType>> mState;
+
+                // Public Methods
+                public:
+                    //! Parameter-less constructor, creating an invalid future.
+                    CFuture(void)
+                    {
+
+                    }
+
+                    //! Constructor accepting the shared state. Futures are normally obtained from a CPromise.
+                    CFuture(const std::shared_ptr<CFutureState<valueType>>& state) : mState(state)
+                    {
+
+                    }
+
+                    //! Returns whether or not this future refers to a promise.
+                    bool isValid(void) const
+                    {
+                        return mState != nullptr;
+                    }
+
+                    //! Returns the current status.
+                    FUTURE_STATUS getStatus(void) const
+                    {
+                        std::lock_guard<Support::Mutex> lock(mState->mMutex);
+                        return mState->mStatus;
+                    }
+
+                    //! Returns whether or not the future has completed, whether fulfilled, failed or cancelled.
+                    bool isReady(void) const
+                    {
+                        return this->getStatus() != FUTURE_PENDING;
+                    }
+
+                    /**
+                     *  @brief Blocks until the future has completed.
+                     *  @throw std::future_error Thrown with std::future_errc::no_state when the future does not refer to a promise.
+                     */
+                    void wait(void) const
+                    {
+                        this->requireState();
+
+                        std::unique_lock<Support::Mutex> lock(mState->mMutex);
+                        mState->mCondition.wait(lock, [this]() { return mState->mStatus != FUTURE_PENDING; });
+                    }
+
+                    /**
+                     *  @brief Blocks until the future has completed or the timeout elapses.
+                     *  @param timeoutMS The maximum time to wait in milliseconds.
+                     *  @return True if the future has completed.
+                     *  @throw std::future_error Thrown with std::future_errc::no_state when the future does not refer to a promise.
+                     */
+                    bool wait(const Common::U32 timeoutMS) const
+                    {
+                        this->requireState();
+
+                        std::unique_lock<Support::Mutex> lock(mState->mMutex);
+                        return mState->mCondition.wait_for(lock, std::chrono::milliseconds(timeoutMS), [this]() { return mState->mStatus != FUTURE_PENDING; });
+                    }
+
+                    /**
+                     *  @brief Blocks until the future has completed and returns a reference to its value. The value may be moved
+                     *  out of, but every copy of this future refers to the same value.
+                     *  @throw std::runtime_error Thrown when the future was cancelled, or its promise destroyed without completing it.
+                     *  @throw std::future_error Thrown with std::future_errc::no_state when the future does not refer to a promise.
+                     *  @note If the work producing the value threw, the same exception is rethrown here.
+                     */
+                    typename FutureReference<valueType>::Type get(void) const
+                    {
+                        this->wait();
+
+                        if (mState->mStatus == FUTURE_FAILED)
+                        {
+                            std::rethrow_exception(mState->mException);
+                        }
+                        else if (mState->mStatus == FUTURE_CANCELLED)
+                        {
+                            throw std::runtime_error("CFuture: The future was cancelled.");
+                        }
+
+                        return *mState->mValue;
+                    }
+
+                    //! Cancels the future, requesting cancellation of the work producing its value.
+                    bool cancel(void)
+                    {
+                        mState->mToken.cancel();
+                        return mState->settle(FUTURE_CANCELLED, []() { });
+                    }
+
+                    //! Returns the cancellation token of the work producing the value.
+                    const CCancellationToken& getToken(void) const
+                    {
+                        return mState->mToken;
+                    }
+
+                    /**
+                     *  @brief Calls the given function once this future completes, however it completes. The call is made
+                     *  immediately on whichever thread completes the future, or on the calling thread if it already has.
+                     *  @param call The function to call. It should be cheap, as it may run while the producer is finishing up.
+                     */
+                    void whenReady(std::function<void(void)> call)
+                    {
+                        mState->addContinuation(call);
+                    }
+
+                    /**
+                     *  @brief Attaches a continuation called with the value of this future once it is fulfilled. If this future
+                     *  fails or is cancelled, so does the returned one without calling the continuation.
+                     *  @param function The continuation. It takes the value, or nothing for a void future.
+                     *  @param context Where to execute the continuation.
+                     *  @return A future for the value returned by the continuation. It shares the cancellation token of this
+                     *  future, so cancelling either one cancels the whole chain.
+                     */
+                    template <typename functionType>
+                    auto then(functionType function, const EXECUTION_CONTEXT context = EXECUTION_MAIN_THREAD) ->
+                        CFuture<decltype(FutureValueCall<valueType>::call(function, std::declval<CFutureState<valueType>&>()))>
+                    {
+                        typedef decltype(FutureValueCall<valueType>::call(function, std::declval<CFutureState<valueType>&>())) resultType;
+
+                        CPromise<resultType> promise(mState->mToken);
+                        std::shared_ptr<CFutureState<valueType>> state = mState;
+
+                        mState->addContinuation([state, promise, function, context]()
+                        {
+                            dispatchCall([state, promise, function]() mutable
+                            {
+                                if (state->mStatus == FUTURE_FAILED)
+                                {
+                                    promise.setException(state->mException);
+                                }
+                                else if (state->mStatus == FUTURE_CANCELLED || promise.isCancellationRequested())
+                                {
+                                    promise.cancel();
+                                }
+                                else
+                                {
+                                    FuturePromiseCall<resultType>::call(promise, [&state, &function]()
+                                    {
+                                        return FutureValueCall<valueType>::call(function, *state);
+                                    });
+                                }
+                            }, context);
+                        });
+
+                        return promise.getFuture();
+                    }
+
+                // Private Methods
+                private:
+                    //! Throws if this future is default constructed or moved from, rather than dereferencing its missing state.
+                    void requireState(void) const
+                    {
+                        if (!mState)
+                        {
+                            throw std::future_error(std::future_errc::no_state);
+                        }
+                    }
+            };
+
+            template <>
+            inline void CFuture<void>::get(void) const
+            {
+                this->wait();
+
+                if (mState->mStatus == FUTURE_FAILED)
+                {
+                    std::rethrow_exception(mState->mException);
+                }
+                else if (mState->mStatus == FUTURE_CANCELLED)
+                {
+                    throw std::runtime_error("CFuture: The future was cancelled.");
+                }
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_TASKING_CFUTURE_HPP_
@@ -0,0 +1,252 @@
+/**
+ *  @file CJobSystem.hpp
+ *  @brief Include file declaring the CJobSystem class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_CJOBSYSTEM_HPP_
+#define _INCLUDE_SUPPORT_TASKING_CJOBSYSTEM_HPP_
+
+#include <chrono>
+#include <exception>
+
+#include <support/types.hpp>
+#include <support/Deque.hpp>
+#include <support/Vector.hpp>
+#include <support/platform/thread.hpp>
+
+#include <support/tasking/IWorkerPool.hpp>
+#include <support/tasking/CWorkStealingDeque.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            /**
+             *  @brief A work stealing job system. Every worker thread owns a deque of jobs that it pushes to and pops from
+             *  while idle workers steal from the opposite end of the others' deques.
+             *  @details Jobs are small, non-owning descriptors: the storage for a job must remain valid until the counter it
+             *  was submitted against reaches zero. Threads waiting on a counter execute other jobs while they wait rather
+             *  than blocking, so waiting from within a job cannot deadlock the pool. Threads that are not workers of the job
+             *  system submit through a shared queue that the workers drain alongside their own. Threads that find no work spin
+             *  briefly and then park on a condition variable until a submission or completed counter wakes them.
+             *
+             *  Workers place themselves according to the affinity policy and priority the job system was created with before
+             *  allocating their own state, so that on NUMA machines every deque lives in memory local to the node its owner
+             *  is pinned to.
+             *
+             *  Stopping a draining job system lets the workers exit once they find no more jobs, while stopping it outright
+             *  lets them exit right after their current job. Either way, jobs left behind are still executed by whoever
+             *  waits on their counters.
+             *
+             *  A job that throws still completes. The first exception thrown by any job submitted against a counter is kept
+             *  in the counter and rethrown by wait.
+             */
+            class CJobSystem : public IWorkerPool
+            {
+                // Public Members
+                public:
+                    //! The signature of a function executed by a job.
+                    typedef void (*JobFunction)(void* data);
+
+                    /**
+                     *  @brief Counts the number of outstanding jobs submitted against it. Jobs may submit children against the
+                     *  counter of the job they are running in, in which case the counter only reaches zero once the parent and
+                     *  every child have completed.
+                     */
+                    class CJobCounter
+                    {
+                        // Private Members
+                        private:
+                            //! The number of jobs submitted against this counter that have not completed.
+                            Support::Atomic<Common::U32> mPending;
+
+                            //! Set once a job submitted against this counter has thrown.
+                            Support::Atomic<bool> mFailed;
+
+                            //! The first exception thrown by a job submitted against this counter.
+                            std::exception_ptr mException;
+
+                        // Public Methods
+                        public:
+                            //! Parameter-less constructor.
+                            CJobCounter(void);
+
+                            //! Returns whether or not every job submitted against this counter has completed.
+                            bool isComplete(void) const;
+
+                            //! Returns the number of jobs submitted against this counter that have not completed.
+                            Common::U32 getPendingCount(void) const;
+
+                            /**
+                             *  @brief Returns the first exception thrown by a job submitted against this counter and forgets it,
+                             *  so that the counter can be reused. Only call this once the counter is complete.
+                             *  @return The exception, or a null pointer if no job threw.
+                             */
+                            std::exception_ptr takeException(void);
+
+                            friend class CJobSystem;
+                    };
+
+                    //! A single unit of work.
+                    struct Job
+                    {
+                        //! The function to execute.
+                        JobFunction mFunction;
+
+                        //! The data to pass to mFunction.
+                        void* mData;
+
+                        //! The counter this job was submitted against. This is set by submit.
+                        CJobCounter* mCounter;
+                    };
+
+                // Private Members
+                private:
+                    //! The state owned by a single worker thread.
+                    struct Worker
+                    {
+                        //! The jobs pushed by this worker.
+                        CWorkStealingDeque<Job*> mJobs;
+
+                        //! The state of the random number generator used to pick victims to steal from.
+                        Common::U32 mRandom;
+                    };
+
+                    //! All of our workers. These are allocated by the worker threads themselves.
+                    Support::Vector<Worker*> mWorkers;
+
+                    //! The number of workers that have allocated their state. Protected by mParkMutex.
+                    Common::U32 mStartedCount;
+
+                    //! Jobs submitted from threads that are not workers of this job system.
+                    Support::Deque<Job*> mSubmittedJobs;
+
+                    //! The number of elements in mSubmittedJobs, allowing workers to skip the lock when it is empty.
+                    Support::Atomic<Common::U32> mSubmittedJobCount;
+
+                    //! The mutex protecting mSubmittedJobs.
+                    Support::Mutex mSubmittedJobsMutex;
+
+                    //! Incremented whenever there may be new work or a counter has completed, so parking threads can detect a missed wakeup.
+                    Support::Atomic<Common::U32> mWakeEpoch;
+
+                    //! The number of threads currently parked on mParkCondition.
+                    Support::Atomic<Common::U32> mParkedCount;
+
+                    //! The mutex protecting mParkCondition.
+                    Support::Mutex mParkMutex;
+
+                    //! The condition variable idle threads park on.
+                    Support::ConditionVariable mParkCondition;
+
+                // Private Methods
+                private:
+                    /**
+                     *  @brief Finds a job to execute for the calling thread: its own deque is checked first, then the submission
+                     *  queue and finally the deques of the other workers.
+                     *  @param workerIndex The index of the calling worker, or a negative value for threads that are not workers.
+                     *  @return The job to execute or nullptr if there currently is nothing to do.
+                     */
+                    Job* findJob(const Common::S32 workerIndex);
+
+                    //! Executes the given job and decrements its counter afterwards.
+                    void execute(Job* job);
+
+                    //! Pushes the given job to the calling thread's deque or the submission queue.
+                    void enqueue(Job* job);
+
+                    /**
+                     *  @brief Wakes parked threads after new work was made available or a counter has completed.
+                     *  @param all Whether to wake every parked thread rather than a single one.
+                     */
+                    void wake(const bool all);
+
+                    //! Wakes every parked thread so that workers notice a change of state.
+                    void wakeWorkers(void);
+
+                    /**
+                     *  @brief Executes jobs on the calling thread until the given counter reaches zero or the deadline passes. When
+                     *  no work can be found, the thread spins for a short while before parking until it is woken.
+                     *  @param counter The counter to wait on. If nullptr, this only returns once the job system is stopping, or
+                     *  once no job is left while it is draining.
+                     *  @param deadline The time to give up at. If nullptr, this waits indefinitely.
+                     *  @return True if the counter reached zero.
+                     */
+                    bool executeUntil(CJobCounter* counter, const std::chrono::steady_clock::time_point* deadline);
+
+                    //! The logic ran by each worker thread.
+                    static void workerThreadLogic(CJobSystem* system, const Common::U32 workerIndex, const Platform::Thread::AFFINITY_POLICY affinity,
+                                                  const Platform::Thread::THREAD_PRIORITY priority);
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Constructor accepting a worker count. This returns once every worker has started.
+                     *  @param workerCount The number of worker threads to create. If zero, jobs are only executed by threads
+                     *  waiting on a counter.
+                     *  @param affinity How the worker threads are pinned to logical cores.
+                     *  @param priority The priority the worker threads run at.
+                     */
+                    CJobSystem(const Common::U32 workerCount, const Platform::Thread::AFFINITY_POLICY affinity = Platform::Thread::AFFINITY_NONE,
+                               const Platform::Thread::THREAD_PRIORITY priority = Platform::Thread::PRIORITY_NORMAL);
+
+                    //! Standard destructor, stopping the workers if that was not done already. Outstanding jobs must have been waited for.
+                    ~CJobSystem(void);
+
+                    /**
+                     *  @brief Submits a job for execution.
+                     *  @param job The job to submit. This must remain valid until the counter reaches zero.
+                     *  @param counter The counter to submit the job against.
+                     */
+                    void submit(Job& job, CJobCounter& counter);
+
+                    /**
+                     *  @brief Submits several jobs for execution against the same counter.
+                     *  @param jobs The jobs to submit. These must remain valid until the counter reaches zero.
+                     *  @param count The number of jobs.
+                     *  @param counter The counter to submit the jobs against.
+                     */
+                    void submit(Job* jobs, const size_t count, CJobCounter& counter);
+
+                    /**
+                     *  @brief Submits a job against the counter of the job currently executing on the calling thread, so that
+                     *  anyone waiting on the parent also waits on the child.
+                     *  @param job The job to submit. This must remain valid until the parent's counter reaches zero.
+                     *  @throw std::logic_error Thrown when the calling thread is not executing a job.
+                     */
+                    void submitChild(Job& job);
+
+                    /**
+                     *  @brief Blocks until the given counter reaches zero, executing other jobs in the meantime.
+                     *  @param counter The counter to wait on.
+                     *  @throw Whatever the first job submitted against the counter to throw has thrown.
+                     */
+                    void wait(CJobCounter& counter);
+
+                    /**
+                     *  @brief Blocks until the given counter reaches zero or the timeout elapses, executing other jobs in the meantime.
+                     *  @param counter The counter to wait on.
+                     *  @param timeoutMS The maximum time to wait in milliseconds.
+                     *  @return True if the counter reached zero.
+                     *  @throw Whatever the first job submitted against the counter to throw has thrown, once it reached zero.
+                     */
+                    bool wait(CJobCounter& counter, const Common::U32 timeoutMS);
+
+                    //! Returns the number of worker threads.
+                    Common::U32 getWorkerCount(void) const;
+
+                    //! Returns the job currently executing on the calling thread, if any.
+                    static Job* getCurrentJob(void);
+            };
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_TASKING_CJOBSYSTEM_HPP_
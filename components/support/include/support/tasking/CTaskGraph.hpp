@@ -0,0 +1,148 @@
+/**
+ *  @file CTaskGraph.hpp
+ *  @brief Include file declaring the CTaskGraph class and its methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_CTASKGRAPH_HPP_
+#define _INCLUDE_SUPPORT_TASKING_CTASKGRAPH_HPP_
+
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+
+#include <support/tasking/CJobSystem.hpp>
+#include <support/tasking/SThreadSystem.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            /**
+             *  @brief A dependency graph of the threaded tasks in a single phase. Two tasks conflict when one of them writes a
+             *  resource that the other reads or writes; conflicting tasks never run concurrently while everything else does.
+             *  @details The conflict graph is colored greedily, largest degree first, and every conflict is turned into an edge
+             *  running from the lower color to the higher one. Tasks of the same color never conflict, so the number of colors
+             *  bounds the longest chain of tasks that must run one after another. At execution time each task is released as
+             *  soon as the tasks it depends on have completed rather than waiting on everything of a lower color.
+             *
+             *  Ready tasks are started in order of their priority: the estimated cost of the longest chain of tasks starting at
+             *  them, built from each task's measured execution time or declared thread weight. Since idle workers pull the next
+             *  ready task, this is list scheduling with longest-processing-time-first ordering, which keeps a heavy task from
+             *  ending up last on one worker while the others sit idle.
+             */
+            class CTaskGraph
+            {
+                // Public Members
+                public:
+                    //! A single task in the graph.
+                    struct Node
+                    {
+                        //! The task to execute.
+                        SThreadSystem::IThreadedTask* mTask;
+
+                        //! The graph this node belongs to.
+                        CTaskGraph* mGraph;
+
+                        //! The color of this node. Nodes of the same color never conflict.
+                        Common::U32 mColor;
+
+                        //! The nodes that may only start once this node has completed.
+                        Support::Vector<Node*> mSuccessors;
+
+                        //! The number of nodes that must complete before this node may start.
+                        Common::U32 mPredecessorCount;
+
+                        //! The estimated cost of the longest chain of tasks starting at this node. Ready nodes with a higher priority start first.
+                        Common::F32 mPriority;
+
+                        //! The number of predecessors that have yet to complete during the current execution.
+                        Support::Atomic<Common::U32> mRemainingPredecessors;
+
+                        //! The job executing this node.
+                        CJobSystem::Job mJob;
+                    };
+
+                // Private Members
+                private:
+                    //! All nodes, ordered by color and then by the order the tasks were given in.
+                    Support::Vector<Node*> mNodes;
+
+                    //! The number of colors used.
+                    Common::U32 mColorCount;
+
+                    //! The number of edges in the graph.
+                    Common::U32 mEdgeCount;
+
+                    //! The job system used by the current execution.
+                    CJobSystem* mJobSystem;
+
+                // Private Methods
+                private:
+                    //! Deletes all nodes.
+                    void clear(void);
+
+                    //! The job function executing a single node.
+                    static void executeNode(void* data);
+
+                // Public Methods
+                public:
+                    //! Parameter-less constructor.
+                    CTaskGraph(void);
+
+                    //! Standard destructor.
+                    ~CTaskGraph(void);
+
+                    /**
+                     *  @brief Builds the graph from the resources declared by the given tasks.
+                     *  @param tasks The tasks to build from. Their order is used to break ties, so the same input always yields
+                     *  the same graph.
+                     */
+                    void build(const Support::Vector<SThreadSystem::IThreadedTask*>& tasks);
+
+                    /**
+                     *  @brief Builds the graph from explicit thread groups, ignoring declared resources. The tasks of a group run
+                     *  one after another while separate groups run concurrently.
+                     *  @param groups The thread groups to build from.
+                     */
+                    void build(const Support::Vector<Support::Vector<SThreadSystem::IThreadedTask*>>& groups);
+
+                    /**
+                     *  @brief Determines whether or not the two given tasks conflict.
+                     *  @return True if either task writes a resource the other reads or writes.
+                     */
+                    static bool conflicts(SThreadSystem::IThreadedTask* first, SThreadSystem::IThreadedTask* second);
+
+                    /**
+                     *  @brief Submits every task of the graph to the given job system. Tasks are released as their dependencies
+                     *  complete, all against the given counter. Priorities are recalculated from the latest cost estimates first.
+                     *  @param jobs The job system to execute on.
+                     *  @param counter The counter that reaches zero once every task has completed.
+                     */
+                    void execute(CJobSystem& jobs, CJobSystem::CJobCounter& counter);
+
+                    /**
+                     *  @brief Executes the transactions recorded by every task during the last execution. They are executed in
+                     *  node order, so the result never depends on which worker ran which task or when.
+                     */
+                    void commit(void);
+
+                    //! Returns all nodes, ordered by color and then by the order the tasks were given in.
+                    const Support::Vector<Node*>& getNodes(void) const;
+
+                    //! Returns the number of colors used, which is the length of the longest chain of dependent tasks.
+                    Common::U32 getColorCount(void) const;
+
+                    //! Returns the number of dependencies between tasks.
+                    Common::U32 getEdgeCount(void) const;
+            };
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_TASKING_CTASKGRAPH_HPP_
@@ -0,0 +1,217 @@
+/**
+ *  @file CWorkStealingDeque.hpp
+ *  @brief Include file declaring and implementing the CWorkStealingDeque class template.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_CWORKSTEALINGDEQUE_HPP_
+#define _INCLUDE_SUPPORT_TASKING_CWORKSTEALINGDEQUE_HPP_
+
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            /**
+             *  @brief A Chase-Lev work stealing deque. A single owning thread pushes and pops at the bottom while any number of
+             *  other threads may steal from the top without ever taking a lock.
+             *  @details The implementation follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.). The
+             *  element type must be trivially copyable and small enough to be stored in a lock free atomic, so this is typically
+             *  used with pointers. Buffers outgrown by the owner are kept alive until destruction because a concurrent thief may
+             *  still be reading from them.
+             */
+            template <typename elementType>
+            class CWorkStealingDeque
+            {
+                // Private Members
+                private:
+                    //! A ring buffer of elements with a power of two capacity.
+                    class Buffer
+                    {
+                        // Private Members
+                        private:
+                            //! The capacity of the buffer minus one, used for masking indices.
+                            const Common::S64 mMask;
+
+                            //! The stored elements.
+                            Support::Atomic<elementType>* mElements;
+
+                        // Public Methods
+                        public:
+                            Buffer(const Common::S64 capacity) : mMask(capacity - 1), mElements(new Support::Atomic<elementType>[capacity])
+                            {
+
+                            }
+
+                            ~Buffer(void)
+                            {
+                                delete[] mElements;
+                            }
+
+                            Common::S64 getCapacity(void) const
+                            {
+                                return mMask + 1;
+                            }
+
+                            elementType get(const Common::S64 index) const
+                            {
+                                return mElements[index & mMask].load(std::memory_order_relaxed);
+                            }
+
+                            void put(const Common::S64 index, const elementType element)
+                            {
+                                mElements[index & mMask].store(element, std::memory_order_relaxed);
+                            }
+
+                            //! Creates a buffer of twice the capacity holding the elements between top and bottom.
+                            Buffer* grow(const Common::S64 top, const Common::S64 bottom) const
+                            {
+                                Buffer* result = new Buffer(this->getCapacity() * 2);
+
+                                for (Common::S64 iteration = top; iteration < bottom; ++iteration)
+                                {
+                                    result->put(iteration, this->get(iteration));
+                                }
+
+                                return result;
+                            }
+                    };
+
+                    //! The index thieves steal from.
+                    alignas(64) Support::Atomic<Common::S64> mTop;
+
+                    //! The index the owner pushes to and pops from.
+                    alignas(64) Support::Atomic<Common::S64> mBottom;
+
+                    //! The current buffer.
+                    Support::Atomic<Buffer*> mBuffer;
+
+                    //! Buffers that have been outgrown. Only touched by the owner.
+                    Support::Vector<Buffer*> mRetiredBuffers;
+
+                // Public Methods
+                public:
+                    /**
+                     *  @brief Constructor accepting an initial capacity.
+                     *  @param capacity The initial capacity. This must be a power of two.
+                     */
+                    CWorkStealingDeque(const Common::S64 capacity = 256) : mTop(0), mBottom(0), mBuffer(new Buffer(capacity))
+                    {
+                        assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+                    }
+
+                    //! Standard destructor.
+                    ~CWorkStealingDeque(void)
+                    {
+                        delete mBuffer.load(std::memory_order_relaxed);
+
+                        for (Buffer* buffer : mRetiredBuffers)
+                        {
+                            delete buffer;
+                        }
+                    }
+
+                    /**
+                     *  @brief Pushes an element onto the bottom of the deque. Only the owning thread may call this.
+                     *  @param element The element to push.
+                     */
+                    void push(const elementType element)
+                    {
+                        const Common::S64 bottom = mBottom.load(std::memory_order_relaxed);
+                        const Common::S64 top = mTop.load(std::memory_order_acquire);
+                        Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+
+                        if (bottom - top > buffer->getCapacity() - 1)
+                        {
+                            mRetiredBuffers.push_back(buffer);
+                            buffer = buffer->grow(top, bottom);
+                            mBuffer.store(buffer, std::memory_order_release);
+                        }
+
+                        buffer->put(bottom, element);
+                        mBottom.store(bottom + 1, std::memory_order_release);
+                    }
+
+                    /**
+                     *  @brief Pops the most recently pushed element off of the bottom of the deque. Only the owning thread may call this.
+                     *  @param out The popped element is written here on success.
+                     *  @return True if an element was popped. False if the deque was empty.
+                     */
+                    bool pop(elementType& out)
+                    {
+                        const Common::S64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+                        Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+
+                        mBottom.store(bottom, std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        Common::S64 top = mTop.load(std::memory_order_relaxed);
+
+                        if (top > bottom)
+                        {
+                            // Empty
+                            mBottom.store(bottom + 1, std::memory_order_relaxed);
+                            return false;
+                        }
+
+                        out = buffer->get(bottom);
+
+                        if (top == bottom)
+                        {
+                            // This is the last element, so we race any thieves for it
+                            const bool won = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                            mBottom.store(bottom + 1, std::memory_order_relaxed);
+                            return won;
+                        }
+
+                        return true;
+                    }
+
+                    /**
+                     *  @brief Steals the oldest element off of the top of the deque. Any thread may call this.
+                     *  @param out The stolen element is written here on success.
+                     *  @return True if an element was stolen. False if the deque was empty or another thread won the race.
+                     */
+                    bool steal(elementType& out)
+                    {
+                        Common::S64 top = mTop.load(std::memory_order_acquire);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        const Common::S64 bottom = mBottom.load(std::memory_order_acquire);
+
+                        if (top >= bottom)
+                        {
+                            return false;
+                        }
+
+                        Buffer* buffer = mBuffer.load(std::memory_order_acquire);
+                        const elementType element = buffer->get(top);
+
+                        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        {
+                            return false;
+                        }
+
+                        out = element;
+                        return true;
+                    }
+
+                    //! Returns an approximation of the number of elements in the deque.
+                    size_t getSize(void) const
+                    {
+                        const Common::S64 bottom = mBottom.load(std::memory_order_relaxed);
+                        const Common::S64 top = mTop.load(std::memory_order_relaxed);
+                        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+                    }
+            };
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_TASKING_CWORKSTEALINGDEQUE_HPP_
@@ -0,0 +1,304 @@
+/**
+ *  @file FParallel.hpp
+ *  @brief Include file declaring the data parallel helpers running on a CJobSystem.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_FPARALLEL_HPP_
+#define _INCLUDE_SUPPORT_TASKING_FPARALLEL_HPP_
+
+#include <algorithm>
+#include <exception>
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+
+#include <support/tasking/CJobSystem.hpp>
+#include <support/tasking/SThreadSystem.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            /**
+             *  @brief Data parallel loops over index ranges. The range is split into chunks that run as jobs while the calling
+             *  thread helps execute them, so these may be called from the main thread as well as from within other jobs.
+             *  @details Without an explicit grain size, ranges are split into a few chunks per thread so that idle workers have
+             *  something left to steal when chunks take uneven amounts of time. An exception thrown by the loop body stops
+             *  chunks that have not started yet and the first one thrown is rethrown on the calling thread.
+             */
+            namespace FParallel
+            {
+                //! How many chunks per thread ranges are split into when no grain size is given.
+                static const size_t sChunksPerThread = 4;
+
+                //! The state shared by the chunks of a single loop.
+                template <typename functionType>
+                struct ChunkedLoop
+                {
+                    //! The loop body, called with the beginning and end of a chunk and the index of the chunk.
+                    const functionType* mFunction;
+
+                    //! The first index of the range.
+                    size_t mBegin;
+
+                    //! The end of the range.
+                    size_t mEnd;
+
+                    //! The number of indices per chunk.
+                    size_t mGrainSize;
+
+                    //! Set once the loop body has thrown.
+                    Support::Atomic<bool> mFailed;
+
+                    //! The first exception thrown by the loop body.
+                    std::exception_ptr mException;
+                };
+
+                //! A single chunk of a loop.
+                template <typename functionType>
+                struct Chunk
+                {
+                    //! The loop this chunk belongs to.
+                    ChunkedLoop<functionType>* mLoop;
+
+                    //! The index of this chunk.
+                    size_t mIndex;
+                };
+
+                //! The job function executing a single chunk.
+                template <typename functionType>
+                void executeChunk(void* data)
+                {
+                    Chunk<functionType>* chunk = reinterpret_cast<Chunk<functionType>*>(data);
+                    ChunkedLoop<functionType>* loop = chunk->mLoop;
+
+                    if (loop->mFailed.load(std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+
+                    const size_t begin = loop->mBegin + chunk->mIndex * loop->mGrainSize;
+                    const size_t end = std::min(loop->mEnd, begin + loop->mGrainSize);
+
+                    try
+                    {
+                        (*loop->mFunction)(begin, end, chunk->mIndex);
+                    }
+                    catch (...)
+                    {
+                        // Only the first exception is kept, later ones are dropped
+                        if (!loop->mFailed.exchange(true))
+                        {
+                            loop->mException = std::current_exception();
+                        }
+                    }
+                }
+
+                /**
+                 *  @brief Returns the number of indices per chunk used for the given range.
+                 *  @param jobs The job system the range would run on.
+                 *  @param count The number of indices in the range.
+                 *  @param grainSize The requested number of indices per chunk, or zero to choose automatically.
+                 */
+                inline size_t getGrainSize(const CJobSystem& jobs, const size_t count, const size_t grainSize)
+                {
+                    if (grainSize != 0)
+                    {
+                        return grainSize;
+                    }
+
+                    // The calling thread executes chunks as well
+                    const size_t chunkCount = (jobs.getWorkerCount() + 1) * sChunksPerThread;
+                    return std::max<size_t>(1, (count + chunkCount - 1) / chunkCount);
+                }
+
+                /**
+                 *  @brief Calls the given function once per chunk of the given range, with the chunks running in parallel.
+                 *  @param jobs The job system to run on.
+                 *  @param begin The first index of the range.
+                 *  @param end The end of the range, which is not included.
+                 *  @param function The function to call with the beginning and end of every chunk and the index of the chunk.
+                 *  Chunk indices are dense and ordered like the chunks themselves.
+                 *  @param grainSize The number of indices per chunk, or zero to choose automatically.
+                 *  @return The number of chunks the range was split into.
+                 */
+                template <typename functionType>
+                size_t parallelForChunks(CJobSystem& jobs, const size_t begin, const size_t end, const functionType& function, const size_t grainSize = 0)
+                {
+                    if (end <= begin)
+                    {
+                        return 0;
+                    }
+
+                    const size_t count = end - begin;
+                    const size_t chunkGrainSize = getGrainSize(jobs, count, grainSize);
+                    const size_t chunkCount = (count + chunkGrainSize - 1) / chunkGrainSize;
+
+                    // Nothing to split, so skip the job system entirely
+                    if (chunkCount == 1 || jobs.getWorkerCount() == 0)
+                    {
+                        for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+                        {
+                            const size_t chunkBegin = begin + chunkIndex * chunkGrainSize;
+                            function(chunkBegin, std::min(end, chunkBegin + chunkGrainSize), chunkIndex);
+                        }
+
+                        return chunkCount;
+                    }
+
+                    ChunkedLoop<functionType> loop;
+                    loop.mFunction = &function;
+                    loop.mBegin = begin;
+                    loop.mEnd = end;
+                    loop.mGrainSize = chunkGrainSize;
+                    loop.mFailed = false;
+
+                    Support::Vector<Chunk<functionType>> chunks(chunkCount);
+                    Support::Vector<CJobSystem::Job> chunkJobs(chunkCount);
+
+                    for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+                    {
+                        chunks[chunkIndex].mLoop = &loop;
+                        chunks[chunkIndex].mIndex = chunkIndex;
+
+                        chunkJobs[chunkIndex].mFunction = executeChunk<functionType>;
+                        chunkJobs[chunkIndex].mData = &chunks[chunkIndex];
+                    }
+
+                    CJobSystem::CJobCounter counter;
+                    jobs.submit(chunkJobs.data(), chunkJobs.size(), counter);
+                    jobs.wait(counter);
+
+                    if (loop.mException)
+                    {
+                        std::rethrow_exception(loop.mException);
+                    }
+
+                    return chunkCount;
+                }
+
+                /**
+                 *  @brief Calls the given function once for every index of the given range, in parallel.
+                 *  @param jobs The job system to run on.
+                 *  @param begin The first index of the range.
+                 *  @param end The end of the range, which is not included.
+                 *  @param function The function to call with every index.
+                 *  @param grainSize The number of indices per chunk, or zero to choose automatically.
+                 */
+                template <typename functionType>
+                void parallelFor(CJobSystem& jobs, const size_t begin, const size_t end, const functionType& function, const size_t grainSize = 0)
+                {
+                    parallelForChunks(jobs, begin, end, [&function](const size_t chunkBegin, const size_t chunkEnd, const size_t chunkIndex)
+                    {
+                        for (size_t index = chunkBegin; index < chunkEnd; ++index)
+                        {
+                            function(index);
+                        }
+                    }, grainSize);
+                }
+
+                /**
+                 *  @brief Calls the given function once for every index of the given range, in parallel on the job system of
+                 *  the SThreadSystem.
+                 */
+                template <typename functionType>
+                void parallelFor(const size_t begin, const size_t end, const functionType& function, const size_t grainSize = 0)
+                {
+                    parallelFor(*SThreadSystem::getInstance()->getJobSystem(), begin, end, function, grainSize);
+                }
+
+                /**
+                 *  @brief Calls the given function once for every element of the given array, such as the entities of an arena,
+                 *  in parallel.
+                 *  @param jobs The job system to run on.
+                 *  @param elements The first element of the array.
+                 *  @param count The number of elements in the array.
+                 *  @param function The function to call with a reference to every element.
+                 *  @param grainSize The number of elements per chunk, or zero to choose automatically.
+                 */
+                template <typename elementType, typename functionType>
+                void parallelForEach(CJobSystem& jobs, elementType* elements, const size_t count, const functionType& function, const size_t grainSize = 0)
+                {
+                    parallelFor(jobs, 0, count, [elements, &function](const size_t index)
+                    {
+                        function(elements[index]);
+                    }, grainSize);
+                }
+
+                /**
+                 *  @brief Maps every index of the given range to a value and combines all values, in parallel.
+                 *  @param jobs The job system to run on.
+                 *  @param begin The first index of the range.
+                 *  @param end The end of the range, which is not included.
+                 *  @param identity The value that leaves any other value unchanged when combined with it.
+                 *  @param map The function mapping an index to a value.
+                 *  @param reduce The function combining two values. It must be associative but need not be commutative, as the
+                 *  partial results of the chunks are combined in the order of the range on the calling thread. The result is
+                 *  therefore the same on every run for a given grain size.
+                 *  @param grainSize The number of indices per chunk, or zero to choose automatically.
+                 *  @return The combination of every mapped value, or the identity for an empty range.
+                 */
+                template <typename valueType, typename mapFunction, typename reduceFunction>
+                valueType parallelReduce(CJobSystem& jobs, const size_t begin, const size_t end, const valueType& identity, const mapFunction& map,
+                                         const reduceFunction& reduce, const size_t grainSize = 0)
+                {
+                    if (end <= begin)
+                    {
+                        return identity;
+                    }
+
+                    // Wrapped so that each chunk writes a separate object, even for types a Vector would pack together
+                    struct PartialResult
+                    {
+                        valueType mValue;
+                    };
+
+                    const size_t chunkGrainSize = getGrainSize(jobs, end - begin, grainSize);
+                    Support::Vector<PartialResult> partialResults((end - begin + chunkGrainSize - 1) / chunkGrainSize, PartialResult { identity });
+
+                    parallelForChunks(jobs, begin, end, [&partialResults, &map, &reduce](const size_t chunkBegin, const size_t chunkEnd, const size_t chunkIndex)
+                    {
+                        valueType result = partialResults[chunkIndex].mValue;
+
+                        for (size_t index = chunkBegin; index < chunkEnd; ++index)
+                        {
+                            result = reduce(result, map(index));
+                        }
+
+                        partialResults[chunkIndex].mValue = result;
+                    }, chunkGrainSize);
+
+                    valueType result = identity;
+
+                    for (const PartialResult& partialResult : partialResults)
+                    {
+                        result = reduce(result, partialResult.mValue);
+                    }
+
+                    return result;
+                }
+
+                /**
+                 *  @brief Maps every index of the given range to a value and combines all values, in parallel on the job system
+                 *  of the SThreadSystem.
+                 */
+                template <typename valueType, typename mapFunction, typename reduceFunction>
+                valueType parallelReduce(const size_t begin, const size_t end, const valueType& identity, const mapFunction& map, const reduceFunction& reduce,
+                                         const size_t grainSize = 0)
+                {
+                    return parallelReduce(*SThreadSystem::getInstance()->getJobSystem(), begin, end, identity, map, reduce, grainSize);
+                }
+            } // End NameSpace FParallel
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_TASKING_FPARALLEL_HPP_
@@ -30,9 +30,12 @@ namespace Kiaro
             {
                 // Protected Members
                 protected:
-                    //! The resources that this task accesses. This is used for coordinating actions with the multithreaded programming.
+                    //! The resources that this task writes to or otherwise needs exclusive access to. This is used for coordinating actions with the multithreaded programming.
                     Support::UnorderedSet<Common::U32> mResources;
 
+                    //! The resources that this task only reads. Tasks that merely read the same resource may run concurrently.
+                    Support::UnorderedSet<Common::U32> mReadResources;
+
                     //! The processing index to use in the programming. This is used to determine in what order tasks should be executed.
                     Common::U32 mProcessingIndex;
 
@@ -58,6 +61,7 @@ namespace Kiaro
                     Common::U32 getProcessingIndex(void);
                     Common::U32 getThreadWeight(void);
                     const Support::UnorderedSet<Common::U32>& getResources(void);
+                    const Support::UnorderedSet<Common::U32>& getReadResources(void);
 
                     /**
                      *  @brief Ticks the task. This is primarily useful for when the task is being
@@ -0,0 +1,149 @@
+/**
+ *  @file IWorkerPool.hpp
+ *  @brief Include file declaring the IWorkerPool interface shared by every thread pool of the engine.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#ifndef _INCLUDE_SUPPORT_TASKING_IWORKERPOOL_HPP_
+#define _INCLUDE_SUPPORT_TASKING_IWORKERPOOL_HPP_
+
+#include <support/common.hpp>
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+
+#include <support/tasking/CFuture.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! The lifecycle states of a worker pool. A pool only ever moves forward through these.
+            enum POOL_STATE
+            {
+                //! The workers accept and execute work.
+                POOL_RUNNING = 0,
+                //! The workers finish the work already queued and exit once there is none left.
+                POOL_DRAINING = 1,
+                //! The workers exit once the work they are executing returns, leaving queued work behind.
+                POOL_STOPPING = 2,
+                //! Every worker has exited and been joined.
+                POOL_STOPPED = 3,
+            }; // End Enum POOL_STATE
+
+            /**
+             *  @brief The lifecycle shared by the thread pools of the engine. Stopping is cooperative: a stop request moves the
+             *  pool to POOL_DRAINING or POOL_STOPPING and wakes the workers, which exit on their own once they see it. Work
+             *  that runs for a long time should poll the stop token of its pool, which is cancelled once the pool stops
+             *  without draining.
+             *  @details Joining is bounded by a timeout so that a stuck worker is reported instead of hanging the caller. Pools
+             *  still wait for every worker before they are destroyed, as workers reference their pool until they exit.
+             */
+            class IWorkerPool
+            {
+                // Private Members
+                private:
+                    //! The current state.
+                    Support::Atomic<POOL_STATE> mState;
+
+                    //! The mutex protecting mThreads and mRunningWorkerCount.
+                    Support::Mutex mLifecycleMutex;
+
+                    //! Signaled whenever a worker exits.
+                    Support::ConditionVariable mLifecycleCondition;
+
+                    //! The threads of all workers that were not joined yet.
+                    Support::Vector<Support::Thread*> mThreads;
+
+                    //! The number of workers that have not exited yet.
+                    Common::U32 mRunningWorkerCount;
+
+                    //! Cancelled once the pool stops without draining.
+                    CCancellationToken mStopToken;
+
+                // Protected Methods
+                protected:
+                    //! Parameter-less constructor.
+                    IWorkerPool(void);
+
+                    //! Standard destructor. Derived pools must have stopped their workers by now.
+                    virtual ~IWorkerPool(void);
+
+                    /**
+                     *  @brief Starts a worker thread running the given function with the given parameters. The function must
+                     *  call onWorkerExit as the last thing it does.
+                     */
+                    template <typename functionType, typename... parameterTypes>
+                    void startWorker(functionType function, parameterTypes... parameters)
+                    {
+                        std::lock_guard<Support::Mutex> lock(mLifecycleMutex);
+
+                        ++mRunningWorkerCount;
+                        mThreads.push_back(new Support::Thread(function, parameters...));
+                    }
+
+                    //! Called by every worker right before it returns.
+                    void onWorkerExit(void);
+
+                    /**
+                     *  @brief Wakes every worker so that they notice a change of state. This must synchronize with however
+                     *  the workers wait for work so that no wakeup is lost.
+                     */
+                    virtual void wakeWorkers(void) = 0;
+
+                    /**
+                     *  @brief Stops without draining and joins every worker. This is meant for the destructors of derived pools,
+                     *  which must call it before destroying anything the workers use. Should the workers not exit within
+                     *  the standard timeout, this logs an error and keeps waiting.
+                     *  @param name The name of the pool, used in log messages.
+                     */
+                    void stopAndJoin(const Common::C8* name);
+
+                // Public Methods
+                public:
+                    //! Returns the current state.
+                    POOL_STATE getState(void) const;
+
+                    //! Returns whether or not workers should pick up new work, which is the case while running or draining.
+                    bool isAcceptingWork(void) const;
+
+                    //! Returns the token that is cancelled once the pool stops without draining.
+                    const CCancellationToken& getStopToken(void) const;
+
+                    /**
+                     *  @brief Asks the workers to stop. This returns immediately; use join to wait for them. A pool that is
+                     *  already stopping does not go back to draining.
+                     *  @param drain Whether the workers finish the work already queued before exiting.
+                     */
+                    void requestStop(const bool drain);
+
+                    /**
+                     *  @brief Waits for every worker to exit and joins them. If the pool was draining when the timeout elapses,
+                     *  it escalates to POOL_STOPPING and cancels the stop token so a following join may succeed.
+                     *  @param timeoutMS The maximum time to wait in milliseconds.
+                     *  @return True if every worker was joined and the pool is now POOL_STOPPED.
+                     *  @throw std::logic_error Thrown when no stop was requested, as the workers would never exit.
+                     */
+                    bool join(const Common::U32 timeoutMS);
+
+                    /**
+                     *  @brief Requests a stop and then waits for the workers.
+                     *  @param drain Whether the workers finish the work already queued before exiting.
+                     *  @param timeoutMS The maximum time to wait in milliseconds.
+                     *  @return True if every worker was joined and the pool is now POOL_STOPPED.
+                     */
+                    bool shutdown(const bool drain, const Common::U32 timeoutMS);
+
+                    //! Returns the number of workers that have not exited yet.
+                    Common::U32 getRunningWorkerCount(void);
+            };
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _INCLUDE_SUPPORT_TASKING_IWORKERPOOL_HPP_
@@ -13,9 +13,13 @@
 #define _INCLUDE_SASYNCHRONOUSTASKMANAGER_HPP_
 
 #include <support/tasking/ITask.hpp>
+#include <support/tasking/CFuture.hpp>
+#include <support/tasking/IWorkerPool.hpp>
 
 #include <support/types.hpp>
+#include <support/Deque.hpp>
 #include <support/ISingleton.hpp>
+#include <support/platform/thread.hpp>
 
 namespace Kiaro
 {
@@ -25,43 +29,96 @@ namespace Kiaro
         {
             typedef struct
             {
-                //! The internal thread constructed for this worker context.
-                Support::Thread* mThread;
-                //! The task that we are running for this worker context.
+                //! The task that we are running for this worker context, if any.
                 Tasking::ITask* mTask;
-                //! An atomic boolean used as a semaphore for thread completion.
-                Support::Atomic<bool> mIsComplete;
-
             } WorkerContext;
 
             /**
              *  @brief A asynchrnous task manager singleton that allows for the execution of ITask
              *  derivatives in the context of their own thread by assigning the task context to an available
              *  worker thread. If none are available, the task is stowed until a worker becomes available.
+             *  @details Idle workers take the oldest scheduled task themselves, so tasks and calls may be submitted from any
+             *  thread. Completed tasks are deleted on the main thread when it ticks the manager, which is also where calls
+             *  posted to EXECUTION_MAIN_THREAD run. Work returning a value is submitted with run, which yields a CFuture
+             *  that continuations may be chained onto.
+             *
+             *  Workers run at background priority so that loading never starves the simulation or the network. When pinned,
+             *  they are placed starting at the last cores or nodes while the runtime workers start at the first ones.
+             *
+             *  A draining manager keeps ticking scheduled tasks until none are left, while a stopping one leaves them once
+             *  their current tick returns. Tasks added after a stop was requested are delegated to the synchronous task
+             *  manager instead. Tasks that tick for a long time should poll the stop token.
              */
-            class SAsynchronousTaskManager : public Support::ISingleton<SAsynchronousTaskManager>
+            class SAsynchronousTaskManager : public Support::ISingleton<SAsynchronousTaskManager>, public IWorkerPool
             {
                     // Public Methods
                 public:
+                    /**
+                     *  @brief Deletes tasks that have completed and runs every call posted to the main thread. This must be
+                     *  called from the main thread.
+                     */
                     void tick(void);
 
                     /**
-                     *  @brief Adds a new task to the asynchronous task manager for execution.
+                     *  @brief Adds a new task to the asynchronous task manager for execution. This may be called from any thread.
                      *  @param task A pointer to the task.
                      *  @return True if the task was successfully added for asynchronous processing. False if
                      *  it was delegated to the synchronous task manager because the asynchronous task manager
-                     *  was created with no workers.
+                     *  was created with no workers or is stopping.
                      *  @throw std::runtime_error Thrown when a NULL task was attempted to be added.
                      */
                     bool addTask(Support::Tasking::ITask* task);
+
+                    /**
+                     *  @brief Removes a task that has not completed yet. If a worker is currently ticking the task, this blocks
+                     *  until that tick returns. Removed tasks are not deleted, so the caller takes ownership back.
+                     *  @param task A pointer to the task.
+                     *  @return True if the task was scheduled or running and has been removed.
+                     *  @throw std::runtime_error Thrown when a NULL task was attempted to be removed.
+                     */
                     bool removeTask(Support::Tasking::ITask* task);
 
+                    /**
+                     *  @brief Executes the given call in the given context. This may be called from any thread.
+                     *  @param call The call to execute.
+                     *  @param context Where to execute the call.
+                     */
+                    void post(std::function<void(void)> call, const EXECUTION_CONTEXT context = EXECUTION_WORKER);
+
+                    /**
+                     *  @brief Runs the given function on a worker. This may be called from any thread.
+                     *  @param function The function to run. Its return value becomes the value of the returned future and
+                     *  anything it throws fails the future instead.
+                     *  @param token The cancellation token the function may observe. If it is cancelled before a worker picks
+                     *  the function up, the function is skipped and the future cancelled.
+                     *  @return A future for the value returned by the function.
+                     */
+                    template <typename functionType>
+                    auto run(functionType function, const CCancellationToken& token = CCancellationToken()) -> CFuture<decltype(function())>
+                    {
+                        typedef decltype(function()) resultType;
+                        CPromise<resultType> promise(token);
+
+                        this->post([promise, function]() mutable
+                        {
+                            if (promise.isCancellationRequested())
+                            {
+                                promise.cancel();
+                                return;
+                            }
+
+                            FuturePromiseCall<resultType>::call(promise, function);
+                        }, EXECUTION_WORKER);
+
+                        return promise.getFuture();
+                    }
+
                     size_t getIdleWorkerCount(void);
                     size_t getWorkerPoolSize(void);
 
                     //! Parameter-less constructor.
                     SAsynchronousTaskManager(void);
-                    //! Standard destructor.
+                    //! Standard destructor, stopping the workers if that was not done already. Tasks that never completed are deleted and futures of work that never ran fail.
                     ~SAsynchronousTaskManager(void);
 
                     // Private Members
@@ -69,14 +126,41 @@ namespace Kiaro
                     //! The number of workers this asynchronous task manager is handling.
                     const Common::U8 mPoolSize;
 
-                    //! A set of tasks that were not handed off to a worker yet.
-                    Support::Queue<Support::Tasking::ITask*> mScheduledTasks;
+                    //! The workers of this asynchronous task manager.
+                    Support::Vector<WorkerContext*> mWorkers;
+
+                    //! The mutex protecting every member below. Workers wait on mTaskCondition while holding it.
+                    Support::Mutex mMutex;
+
+                    //! Signaled when a task is scheduled or the state of the pool has changed.
+                    Support::ConditionVariable mTaskCondition;
+
+                    //! Signaled when a worker stops ticking a removed task.
+                    Support::ConditionVariable mRemovalCondition;
 
-                    //! A set of workers that are not doing anything.
-                    Support::UnorderedSet<WorkerContext*> mIdleWorkers;
+                    //! Tasks that were not handed off to a worker yet.
+                    Support::Deque<Support::Tasking::ITask*> mScheduledTasks;
+
+                    //! Tasks being ticked by a worker that were asked to be removed.
+                    Support::UnorderedSet<Support::Tasking::ITask*> mRemovedTasks;
+
+                    //! Tasks that have completed and wait to be deleted on the main thread.
+                    Support::Vector<Support::Tasking::ITask*> mCompletedTasks;
+
+                    //! Tasks submitted while running without workers that wait to be handed to the synchronous task manager.
+                    Support::Vector<Support::Tasking::ITask*> mDelegatedTasks;
+
+                    //! Calls waiting to run on the main thread.
+                    Support::Vector<std::function<void(void)>> mMainThreadCalls;
+
+                    // Private Methods
+                private:
+                    //! Wakes every worker so that they notice a change of state.
+                    void wakeWorkers(void);
 
-                    //! A set of workers that are doing some thing.
-                    Support::UnorderedSet<WorkerContext*> mActiveWorkers;
+                    //! The logic run by every worker thread.
+                    static void workerThreadLogic(SAsynchronousTaskManager* manager, WorkerContext* context, const Common::U32 workerIndex,
+                                                  const Platform::Thread::AFFINITY_POLICY affinity);
             };
         } // End NameSpace Tasking
     } // End NameSpace Engine
@@ -18,6 +18,8 @@
 #include <support/Set.hpp>
 #include <support/UnorderedSet.hpp>
 
+#include <support/tasking/CJobSystem.hpp>
+#include <support/tasking/CCommandBuffer.hpp>
 #include <support/tasking/SAsynchronousTaskManager.hpp>
 
 #include <easydelegate/easydelegate.hpp>
@@ -33,10 +35,13 @@ namespace Kiaro
              *  to make the engine more properly utilize many core systems while still supporting machines with less processor cores
              *  available at hand.
              *  @details The threaded runtime is arranged into a series of phases that have thread groups that execute concurrent
-             *  to one another in a read only game state environment. Instead of writing changes directly to the game state,
-             *  we use EasyDelegate to defer calls into a queue and dispatch that as a single transaction once the main thread is
-             *  ready to and a thread group within the current phase has completed.
+             *  to one another in a read only game state environment. The tasks of a phase form a CTaskGraph built from the
+             *  resources they declare and run as jobs on a work stealing CJobSystem. Instead of writing changes directly to the
+             *  game state, tasks record deferred calls into their CCommandBuffer and those are executed as a single transaction once
+             *  the main thread is ready to and the current phase has completed.
              */
+            class CTaskGraph;
+
             class SThreadSystem : public ISingleton<SThreadSystem>
             {
                 // Public Members
@@ -45,49 +50,42 @@ namespace Kiaro
                     {
                         //! Protected Members
                         protected:
-                            //! The queue of transactions to process.
-                            Support::Queue<EasyDelegate::IDeferredCaller*> mTransaction;
-
-                        //! Public methods.
-                        public:
-                            const Support::Queue<EasyDelegate::IDeferredCaller*> getTransaction(void);
-                            void clearTransaction(void);
-                    };
+                            //! The deferred writes to the game state made during the current phase.
+                            CCommandBuffer mTransaction;
 
-                    /**
-                     *  @brief A task context for the thread system to make worker threads execute using.
-                     *  @details The CThreadSystem instance essentially just cycles through any thread actions left to complete for
-                     *  this thread and returns false when there is finally no actions left to execute, causing the executing thread
-                     *  to go into a idle sleeping state.
-                     */
-                    class CThreadContext
-                    {
-                        // Private Members
+                        //! Private Members
                         private:
-                            //! The internal thread constructed for this context.
-                            Support::Thread* mThread;
+                            //! The exponentially smoothed time in microseconds a single execution of this task took. Zero until measured.
+                            Common::F32 mSmoothedExecutionTime;
 
-                        // Public Methods
+                        //! Public methods.
                         public:
-                            CThreadContext(void);
-                            ~CThreadContext(void);
+                            //! Parameter-less constructor.
+                            IThreadedTask(void);
 
-                            //! Mutex used for detecting race conditions
-                            Support::Mutex mDebugMutex;
+                            /**
+                             *  @brief Returns the deferred writes made during the current phase. They are executed and cleared
+                             *  once the phase has completed.
+                             */
+                            CCommandBuffer& getTransaction(void);
 
-                            //! Whether or not the actions queued have completed executed.
-                            Support::Atomic<bool> mIsComplete;
+                            //! Discards the deferred writes made during the current phase without executing them.
+                            void clearTransaction(void);
 
-                            //! Whether or not the thread should terminate.
-                            Support::Atomic<bool> mShouldTerminate;
+                            /**
+                             *  @brief Returns the estimated cost of executing this task in microseconds. This is the smoothed measured
+                             *  execution time once the task has executed and the declared thread weight before that.
+                             */
+                            Common::F32 getEstimatedCost(void);
 
-                        // Public Members
-                        public:
-                            //! A queue of actions for this thread to execute.
-                            Support::Queue<std::pair<Common::U8, IThreadedTask*>> mThreadTasks;
+                            //! Returns the smoothed measured execution time in microseconds, or zero if the task never executed.
+                            Common::F32 getSmoothedExecutionTime(void);
 
-                            //! A queue of generic deferred callers to dispatch for the transaction.
-                            Support::Queue<Support::Queue<EasyDelegate::IDeferredCaller*>> mTransactions;
+                            /**
+                             *  @brief Folds a new execution time measurement into the smoothed execution time.
+                             *  @param microseconds The time a single execution took.
+                             */
+                            void recordExecutionTime(const Common::F32 microseconds);
                     };
 
                 // Private Members
@@ -95,23 +93,23 @@ namespace Kiaro
                     //! The current computation phase we are currently on.
                     Common::U8 mCurrentPhase;
 
-                    //! A set of threads currently executing some code.
-                    Support::UnorderedSet<CThreadContext*> mActiveThreads;
+                    //! The job system the tasks execute on.
+                    CJobSystem* mJobSystem;
 
-                    //! A set of idle threads waiting for something to do.
-                    Support::Vector<CThreadContext*> mInactiveThreads;
+                    //! Whether or not the current phase has been submitted but not yet committed.
+                    bool mPhaseRunning;
 
-                    //! The thread phases we are operating with.
-                    Support::Vector<Support::Vector<Support::Vector<IThreadedTask*>>> mThreadPhases;
+                    //! The counter tracking the tasks of the current phase.
+                    CJobSystem::CJobCounter mPhaseCounter;
 
-                    //! A mirror of the current phase thread groups.
-                    Support::Vector<Support::Vector<CThreadContext*>> mPhaseProcessing;
+                    //! The thread phases we are operating with. These are only regenerated when the task set changes.
+                    Support::Vector<CTaskGraph*> mThreadPhases;
 
-                    //! All tasks to process.
-                    Support::UnorderedSet<IThreadedTask*> mTasks;
+                    //! All tasks to process, in the order they were added.
+                    Support::Vector<IThreadedTask*> mTasks;
 
                     //! All tasks waiting to be added on the next frame.
-                    Support::UnorderedSet<IThreadedTask*> mPendingAddTasks;
+                    Support::Vector<IThreadedTask*> mPendingAddTasks;
 
                     //! All tasks waiting to be removed on the next frame.
                     Support::UnorderedSet<IThreadedTask*> mPendingRemoveTasks;
@@ -121,19 +119,39 @@ namespace Kiaro
                     //! Internal method used to generate the thread phase data.
                     void generatePhases(void);
 
+                    //! Internal method used to delete all thread phase data.
+                    void clearPhases(void);
+
                 // Public Methods
                 public:
                     /**
-                     *  @brief Used to update the threading logic. If all actions for the current phase are completed, this sets up
-                     *  execution for the next phase as well as dispatching pending transactions. If there are tasks still running,
+                     *  @brief Used to update the threading logic. If no phase is running, this submits the next phase to the job
+                     *  system. If the running phase has completed, its transactions are dispatched. If there are tasks still running,
                      *  this call does nothing.
                      *  @return True for if a frame (all phases have completed) has completed on this call. False otherwise.
+                     *  @throw Whatever the first task of the completed phase to throw has thrown, after the phase was committed.
                      */
                     bool update(void);
 
                     /**
-                     *  @brief Adds a new thread phase to this thread system, returning a reference to it.
-                     *  @return A reference to the thread phrase.
+                     *  @brief Blocks the calling thread until the running phase has completed or the timeout elapses, helping to
+                     *  execute the phase in the meantime. This returns immediately if no phase is running.
+                     *  @param timeoutMS The maximum time to wait in milliseconds.
+                     *  @return True if a phase is running and has completed.
+                     *  @throw Whatever the first task of the completed phase to throw has thrown. It is not thrown by update again.
+                     */
+                    bool waitForPhase(const Common::U32 timeoutMS);
+
+                    //! Returns whether or not a phase has been submitted but not yet committed.
+                    bool isPhaseRunning(void);
+
+                    //! Returns the number of phases in a frame.
+                    size_t getPhaseCount(void);
+
+                    /**
+                     *  @brief Adds a new thread phase made of explicit thread groups to this thread system. The tasks of a group
+                     *  run one after another while separate groups run concurrently.
+                     *  @param newPhase The thread groups of the phase.
                      */
                     void addPhase(Support::Vector<Support::Vector<IThreadedTask*>>& newPhase);
 
@@ -142,11 +160,14 @@ namespace Kiaro
                      *  @param phase The phase ID
                      *  @return A reference to the thread phase.
                      */
-                    Support::Vector<Support::Vector<IThreadedTask*>>& getPhase(const size_t phase);
+                    CTaskGraph& getPhase(const size_t phase);
 
                     bool addTask(IThreadedTask* task);
                     bool removeTask(IThreadedTask* task);
 
+                    //! Returns the job system the thread groups execute on. Other fine grained work may be submitted to it as well.
+                    CJobSystem* getJobSystem(void);
+
                 // Private Methods
                 public:
                     //! A parameter-less constructor.
@@ -11,3 +11,7 @@
 
 #include "ITask.hpp"
 #include "SSynchronousTaskManager.hpp"
+#include "CJobSystem.hpp"
+#include "CTaskGraph.hpp"
+#include "CFuture.hpp"
+#include "FParallel.hpp"
@@ -13,6 +13,7 @@
 #define _INCLUDE_SUPPORT_TYPES_HPP_
 
 #include <atomic>
+#include <condition_variable>
 #include <iostream>
 #include <unordered_set>
 #include <map>
@@ -53,6 +54,8 @@ namespace Kiaro
 
         //! A typedef to an std::mutex.
         typedef std::mutex Mutex;
+        //! A typedef to an std::condition_variable.
+        typedef std::condition_variable ConditionVariable;
         //! A typedef to an std::thread.
         typedef std::thread Thread;
         //! A typedef to an std::wstring.
@@ -0,0 +1,125 @@
+/**
+ *  @file thread.cpp
+ *  @brief Source file implementing platform independent portions of the thread placement in the engine.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+
+#include <support/Console.hpp>
+#include <support/platform/thread.hpp>
+
+namespace Kiaro
+{
+    namespace Platform
+    {
+        namespace Thread
+        {
+            const ProcessorTopology& getProcessorTopology(void)
+            {
+                static const ProcessorTopology sTopology = []()
+                {
+                    ProcessorTopology result;
+                    detectProcessorTopology(result);
+                    return result;
+                }();
+
+                return sTopology;
+            }
+
+            Support::Vector<Common::U32> getPlacementCores(const ProcessorTopology& topology, const AFFINITY_POLICY policy, const Common::U32 slot,
+                                                           const bool fromEnd)
+            {
+                Support::Vector<Common::U32> result;
+
+                if (topology.mCores.empty())
+                {
+                    return result;
+                }
+
+                switch (policy)
+                {
+                    case AFFINITY_CORE:
+                    {
+                        // One logical core of every physical core first, so threads only share a core once every core is taken
+                        Support::Vector<ProcessorCore> primaryCores;
+                        Support::Vector<ProcessorCore> siblingCores;
+                        Support::Vector<bool> seenPhysicalCores(topology.mPhysicalCoreCount, false);
+
+                        for (const ProcessorCore& core : topology.mCores)
+                        {
+                            if (core.mPhysicalCore < seenPhysicalCores.size() && !seenPhysicalCores[core.mPhysicalCore])
+                            {
+                                seenPhysicalCores[core.mPhysicalCore] = true;
+                                primaryCores.push_back(core);
+                            }
+                            else
+                            {
+                                siblingCores.push_back(core);
+                            }
+                        }
+
+                        // Keep threads of neighbouring slots on the same node
+                        const auto byNode = [](const ProcessorCore& lhs, const ProcessorCore& rhs) { return lhs.mNode < rhs.mNode; };
+                        std::stable_sort(primaryCores.begin(), primaryCores.end(), byNode);
+                        std::stable_sort(siblingCores.begin(), siblingCores.end(), byNode);
+                        primaryCores.insert(primaryCores.end(), siblingCores.begin(), siblingCores.end());
+
+                        const size_t index = slot % primaryCores.size();
+                        result.push_back(primaryCores[fromEnd ? primaryCores.size() - 1 - index : index].mID);
+                        break;
+                    }
+
+                    case AFFINITY_NODE:
+                    {
+                        const Common::U32 nodeCount = std::max<Common::U32>(1, topology.mNodeCount);
+                        const Common::U32 index = slot % nodeCount;
+                        const Common::U32 node = fromEnd ? nodeCount - 1 - index : index;
+
+                        for (const ProcessorCore& core : topology.mCores)
+                        {
+                            if (core.mNode == node)
+                            {
+                                result.push_back(core.mID);
+                            }
+                        }
+                        break;
+                    }
+
+                    default:
+                        break;
+                }
+
+                return result;
+            }
+
+            void placeCurrentThread(const Common::C8* name, const AFFINITY_POLICY policy, const Common::U32 slot, const bool fromEnd,
+                                    const THREAD_PRIORITY priority)
+            {
+                // Threads inherit the affinity and priority of the thread that created them, so unpinned threads at normal
+                // priority are reset explicitly rather than left as they are
+                if (policy == AFFINITY_NONE)
+                {
+                    if (!setCurrentThreadAffinity(Support::Vector<Common::U32>()))
+                    {
+                        CONSOLE_DEBUGF("%s thread %u: Failed to reset the affinity, keeping the inherited affinity.", name, slot);
+                    }
+                }
+                else if (!setCurrentThreadAffinity(getPlacementCores(getProcessorTopology(), policy, slot, fromEnd)))
+                {
+                    CONSOLE_WARNINGF("%s thread %u: Failed to set the affinity, the thread is not pinned.", name, slot);
+                }
+
+                if (!setCurrentThreadPriority(priority))
+                {
+                    CONSOLE_DEBUGF("%s thread %u: Failed to set the priority to %u, keeping the current priority.", name, slot, priority);
+                }
+            }
+        } // End NameSpace Thread
+    } // End NameSpace Platform
+} // End NameSpace Kiaro
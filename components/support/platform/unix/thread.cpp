@@ -0,0 +1,201 @@
+/**
+ *  @file thread.cpp
+ *  @brief Source file implementing platform Unix specific portions of the thread placement in the engine.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#if defined(__linux__)
+    #include <dirent.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+#endif
+
+#include <support/UnorderedMap.hpp>
+#include <support/platform/thread.hpp>
+
+namespace Kiaro
+{
+    namespace Platform
+    {
+        namespace Thread
+        {
+            #if defined(__linux__)
+            //! The nice values used for each THREAD_PRIORITY.
+            static const int sNiceValues[] = { 10, 0, -5, -10 };
+
+            /**
+             *  @brief Reads a single unsigned value from the given file in sysfs.
+             *  @return True if the value was read.
+             */
+            static bool readSystemValue(const Common::C8* path, Common::U32& output)
+            {
+                FILE* handle = fopen(path, "r");
+
+                if (!handle)
+                {
+                    return false;
+                }
+
+                const bool result = fscanf(handle, "%u", &output) == 1;
+                fclose(handle);
+                return result;
+            }
+            #endif // __linux__
+
+            void detectProcessorTopology(ProcessorTopology& output)
+            {
+                output.mCores.clear();
+                output.mPhysicalCoreCount = 0;
+                output.mNodeCount = 0;
+
+                #if defined(__linux__)
+                // Only the cores we may run on count, which respects taskset and cgroup restrictions
+                cpu_set_t allowedCores;
+                CPU_ZERO(&allowedCores);
+
+                if (sched_getaffinity(0, sizeof(allowedCores), &allowedCores) == 0)
+                {
+                    Support::UnorderedMap<Common::U64, Common::U32> physicalCores;
+                    Support::UnorderedMap<Common::U32, Common::U32> nodes;
+                    Common::C8 path[128];
+
+                    for (Common::U32 coreID = 0; coreID < CPU_SETSIZE; ++coreID)
+                    {
+                        if (!CPU_ISSET(coreID, &allowedCores))
+                        {
+                            continue;
+                        }
+
+                        // Cores without topology information are treated as separate physical cores
+                        Common::U32 packageID = 0;
+                        Common::U32 physicalID = coreID;
+                        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", coreID);
+                        readSystemValue(path, packageID);
+                        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_id", coreID);
+                        readSystemValue(path, physicalID);
+
+                        // The node of a core is the nodeN link in its sysfs directory
+                        Common::U32 nodeID = 0;
+                        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", coreID);
+
+                        if (DIR* directory = opendir(path))
+                        {
+                            while (dirent* entry = readdir(directory))
+                            {
+                                if (sscanf(entry->d_name, "node%u", &nodeID) == 1)
+                                {
+                                    break;
+                                }
+                            }
+
+                            closedir(directory);
+                        }
+
+                        // Identifiers may be sparse, so they are mapped to dense indices
+                        const Common::U64 physicalKey = (static_cast<Common::U64>(packageID) << 32) | physicalID;
+                        auto physicalIt = physicalCores.find(physicalKey);
+                        if (physicalIt == physicalCores.end())
+                        {
+                            physicalIt = physicalCores.insert(std::make_pair(physicalKey, static_cast<Common::U32>(physicalCores.size()))).first;
+                        }
+
+                        auto nodeIt = nodes.find(nodeID);
+                        if (nodeIt == nodes.end())
+                        {
+                            nodeIt = nodes.insert(std::make_pair(nodeID, static_cast<Common::U32>(nodes.size()))).first;
+                        }
+
+                        ProcessorCore core;
+                        core.mID = coreID;
+                        core.mPhysicalCore = physicalIt->second;
+                        core.mNode = nodeIt->second;
+                        output.mCores.push_back(core);
+                    }
+
+                    output.mPhysicalCoreCount = static_cast<Common::U32>(physicalCores.size());
+                    output.mNodeCount = static_cast<Common::U32>(nodes.size());
+                }
+                #endif // __linux__
+
+                if (output.mCores.empty())
+                {
+                    const Common::U32 coreCount = std::max<Common::U32>(1, std::thread::hardware_concurrency());
+
+                    for (Common::U32 coreID = 0; coreID < coreCount; ++coreID)
+                    {
+                        ProcessorCore core;
+                        core.mID = coreID;
+                        core.mPhysicalCore = coreID;
+                        core.mNode = 0;
+                        output.mCores.push_back(core);
+                    }
+
+                    output.mPhysicalCoreCount = coreCount;
+                    output.mNodeCount = 1;
+                }
+            }
+
+            bool setCurrentThreadAffinity(const Support::Vector<Common::U32>& cores)
+            {
+                #if defined(__linux__)
+                cpu_set_t coreSet;
+                CPU_ZERO(&coreSet);
+
+                if (cores.empty())
+                {
+                    for (const ProcessorCore& core : getProcessorTopology().mCores)
+                    {
+                        CPU_SET(core.mID, &coreSet);
+                    }
+
+                    // Without a topology, allow every core; the kernel ignores those that do not exist
+                    if (CPU_COUNT(&coreSet) == 0)
+                    {
+                        for (Common::U32 core = 0; core < CPU_SETSIZE; ++core)
+                        {
+                            CPU_SET(core, &coreSet);
+                        }
+                    }
+                }
+
+                for (const Common::U32 core : cores)
+                {
+                    if (core < CPU_SETSIZE)
+                    {
+                        CPU_SET(core, &coreSet);
+                    }
+                }
+
+                return pthread_setaffinity_np(pthread_self(), sizeof(coreSet), &coreSet) == 0;
+                #else
+                // Other Unix systems offer no way to pin threads, only hints
+                return cores.empty();
+                #endif // __linux__
+            }
+
+            bool setCurrentThreadPriority(const THREAD_PRIORITY priority)
+            {
+                #if defined(__linux__)
+                // Linux applies nice values to individual threads rather than the whole process
+                const pid_t threadID = static_cast<pid_t>(syscall(SYS_gettid));
+                return setpriority(PRIO_PROCESS, threadID, sNiceValues[priority]) == 0;
+                #else
+                return priority == PRIORITY_NORMAL;
+                #endif // __linux__
+            }
+        } // End NameSpace Thread
+    } // End NameSpace Platform
+} // End NameSpace Kiaro
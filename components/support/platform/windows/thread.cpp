@@ -0,0 +1,125 @@
+/**
+ *  @file thread.cpp
+ *  @brief Source file implementing platform Windows specific portions of the thread placement in the engine.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <Windows.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <support/platform/thread.hpp>
+
+namespace Kiaro
+{
+	namespace Platform
+	{
+		namespace Thread
+		{
+			//! The Windows thread priorities used for each THREAD_PRIORITY.
+			static const int sThreadPriorities[] = { THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST };
+
+			void detectProcessorTopology(ProcessorTopology& output)
+			{
+				output.mCores.clear();
+				output.mPhysicalCoreCount = 0;
+				output.mNodeCount = 0;
+
+				// Affinity masks only cover the processor group we run in, which holds at most 64 logical cores
+				DWORD_PTR processMask = 0;
+				DWORD_PTR systemMask = 0;
+				GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+
+				DWORD length = 0;
+				GetLogicalProcessorInformation(nullptr, &length);
+				Support::Vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> information(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+
+				if (!information.empty() && GetLogicalProcessorInformation(information.data(), &length))
+				{
+					const Common::U32 maskBits = sizeof(ULONG_PTR) * 8;
+					Support::Vector<Common::U32> physicalCores(maskBits, 0);
+					Support::Vector<Common::U32> nodes(maskBits, 0);
+
+					for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& entry : information)
+					{
+						if (entry.Relationship == RelationProcessorCore)
+						{
+							for (Common::U32 coreID = 0; coreID < maskBits; ++coreID)
+								if (entry.ProcessorMask & (static_cast<ULONG_PTR>(1) << coreID))
+									physicalCores[coreID] = output.mPhysicalCoreCount;
+
+							++output.mPhysicalCoreCount;
+						}
+						else if (entry.Relationship == RelationNumaNode)
+						{
+							for (Common::U32 coreID = 0; coreID < maskBits; ++coreID)
+								if (entry.ProcessorMask & (static_cast<ULONG_PTR>(1) << coreID))
+									nodes[coreID] = output.mNodeCount;
+
+							++output.mNodeCount;
+						}
+					}
+
+					for (Common::U32 coreID = 0; coreID < maskBits; ++coreID)
+					{
+						if (!(processMask & (static_cast<DWORD_PTR>(1) << coreID)))
+							continue;
+
+						ProcessorCore core;
+						core.mID = coreID;
+						core.mPhysicalCore = physicalCores[coreID];
+						core.mNode = nodes[coreID];
+						output.mCores.push_back(core);
+					}
+
+					output.mNodeCount = std::max<Common::U32>(1, output.mNodeCount);
+				}
+
+				if (output.mCores.empty())
+				{
+					const Common::U32 coreCount = std::max<Common::U32>(1, std::thread::hardware_concurrency());
+
+					for (Common::U32 coreID = 0; coreID < coreCount; ++coreID)
+					{
+						ProcessorCore core;
+						core.mID = coreID;
+						core.mPhysicalCore = coreID;
+						core.mNode = 0;
+						output.mCores.push_back(core);
+					}
+
+					output.mPhysicalCoreCount = coreCount;
+					output.mNodeCount = 1;
+				}
+			}
+
+			bool setCurrentThreadAffinity(const Support::Vector<Common::U32>& cores)
+			{
+				DWORD_PTR mask = 0;
+
+				if (cores.empty())
+				{
+					DWORD_PTR systemMask = 0;
+					GetProcessAffinityMask(GetCurrentProcess(), &mask, &systemMask);
+				}
+
+				for (const Common::U32 core : cores)
+					if (core < sizeof(DWORD_PTR) * 8)
+						mask |= static_cast<DWORD_PTR>(1) << core;
+
+				return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+			}
+
+			bool setCurrentThreadPriority(const THREAD_PRIORITY priority)
+			{
+				return SetThreadPriority(GetCurrentThread(), sThreadPriorities[priority]) != FALSE;
+			}
+		} // End NameSpace Thread
+	} // End NameSpace Platform
+} // End NameSpace Kiaro
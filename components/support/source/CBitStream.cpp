@@ -9,13 +9,35 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include <support/CBitStream.hpp>
+#include <support/SAllocationTracker.hpp>
 
 namespace Kiaro
 {
     namespace Support
     {
-        CBitStream::CBitStream(ISerializable* in) : mTotalSize(in->getRequiredMemory()), mMemoryBlock(new Common::U8[in->getRequiredMemory()]),
+        //! Allocates an owned memory block. Blocks are resized with realloc, so they must come from malloc.
+        static Common::U8* allocateBlock(const size_t size)
+        {
+            Common::U8* result = reinterpret_cast<Common::U8*>(malloc(size));
+
+            if (!result)
+            {
+                throw std::bad_alloc();
+            }
+
+            if (SAllocationTracker::sEnabled)
+            {
+                SAllocationTracker::recordAllocation(ALLOCATION_TAG(BitStreams), size);
+            }
+
+            return result;
+        }
+
+        CBitStream::CBitStream(ISerializable* in) : mTotalSize(in->getRequiredMemory()), mMemoryBlock(allocateBlock(in->getRequiredMemory())),
         mPointer(0), mOwnsMemoryBlock(true), mResizeLength(0), mInverseEndian(false)
         {
             in->packEverything(*this);
@@ -27,7 +49,7 @@ namespace Kiaro
         }
 
         CBitStream::CBitStream(const size_t sizeInBytes, const void* initializer, size_t initializerLength, const size_t resizeLength) :
-        mMemoryBlock(new Common::U8[sizeInBytes]), mPointer(0), mTotalSize(sizeInBytes), mOwnsMemoryBlock(true), mResizeLength(resizeLength),
+        mMemoryBlock(allocateBlock(sizeInBytes)), mPointer(0), mTotalSize(sizeInBytes), mOwnsMemoryBlock(true), mResizeLength(resizeLength),
         mInverseEndian(false)
         {
             memset(mMemoryBlock, 0x00, sizeInBytes);
@@ -54,6 +76,11 @@ namespace Kiaro
         {
             if (mOwnsMemoryBlock)
             {
+                if (SAllocationTracker::sEnabled)
+                {
+                    SAllocationTracker::recordFree(ALLOCATION_TAG(BitStreams), mTotalSize);
+                }
+
                 free(mMemoryBlock);
             }
         }
@@ -106,6 +133,37 @@ namespace Kiaro
             this->writeString(string.data(), string.length());
         }
 
+        void CBitStream::writeBytes(const void* data, const size_t length)
+        {
+            assert(mPointer <= mTotalSize);
+
+            if (mTotalSize - mPointer < length)
+            {
+                if (mResizeLength == 0)
+                {
+                    throw std::overflow_error("Stack Overflow");
+                }
+
+                this->resize(std::max(mTotalSize + mResizeLength, mPointer + length));
+            }
+
+            memcpy(&mMemoryBlock[mPointer], data, length);
+            mPointer += length;
+        }
+
+        const void* CBitStream::popBytes(const size_t length)
+        {
+            if (length > mTotalSize - mPointer)
+            {
+                throw std::underflow_error("Stack Underflow");
+            }
+
+            const void* result = &mMemoryBlock[mPointer];
+            mPointer += length;
+
+            return result;
+        }
+
         const Common::C8* CBitStream::popString(void)
         {
             // Grab the top string
@@ -138,7 +196,7 @@ namespace Kiaro
             return reinterpret_cast<const Common::C8*>(&mMemoryBlock[mPointer + sizeof(Common::U32)]);
         }
 
-        size_t CBitStream::getPointer(void)
+        size_t CBitStream::getPointer(void) const
         {
             return mPointer;
         }
@@ -148,6 +206,11 @@ namespace Kiaro
             return mMemoryBlock;
         }
 
+        const void* CBitStream::getBlock(void) const
+        {
+            return mMemoryBlock;
+        }
+
         void CBitStream::setPointer(const size_t pointer)
         {
             if (pointer < 0 || pointer >= mTotalSize)
@@ -166,10 +229,16 @@ namespace Kiaro
             if (mOwnsMemoryBlock)
             {
                 mMemoryBlock = reinterpret_cast<Common::U8*>(realloc(mMemoryBlock, newSize));
+
+                if (SAllocationTracker::sEnabled)
+                {
+                    SAllocationTracker::recordFree(ALLOCATION_TAG(BitStreams), mTotalSize);
+                    SAllocationTracker::recordAllocation(ALLOCATION_TAG(BitStreams), newSize);
+                }
             }
             else
             {
-                Common::U8* newBlock = reinterpret_cast<Common::U8*>(malloc(newSize));
+                Common::U8* newBlock = allocateBlock(newSize);
 
                 // Only memset the new bytes
                 memset(&newBlock[mPointer + 1], 0x00, newSize - (mPointer + 1));
@@ -0,0 +1,100 @@
+/**
+ *  @file CFixedTimestep.cpp
+ *  @brief Source file implementing the CFixedTimestep class methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <support/CFixedTimestep.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        CFixedTimestep::CFixedTimestep(const Common::U64 stepMicroseconds, const Common::U32 maxStepsPerUpdate) : mStepMicroseconds(stepMicroseconds),
+        mMaxStepsPerUpdate(maxStepsPerUpdate), mAccumulatedMicroseconds(0), mTickNumber(0), mDroppedStepCount(0)
+        {
+            if (stepMicroseconds == 0 || maxStepsPerUpdate == 0)
+            {
+                throw std::logic_error("CFixedTimestep: The step length and the catch up limit must not be zero.");
+            }
+        }
+
+        Common::U32 CFixedTimestep::addTime(const Common::U64 elapsedMicroseconds)
+        {
+            mAccumulatedMicroseconds += elapsedMicroseconds;
+
+            const Common::U64 readySteps = mAccumulatedMicroseconds / mStepMicroseconds;
+
+            // Drop whole steps past the limit but keep the partial step so the interpolation stays continuous
+            if (readySteps > mMaxStepsPerUpdate)
+            {
+                const Common::U64 droppedSteps = readySteps - mMaxStepsPerUpdate;
+
+                mAccumulatedMicroseconds -= droppedSteps * mStepMicroseconds;
+                mDroppedStepCount += droppedSteps;
+                return mMaxStepsPerUpdate;
+            }
+
+            return static_cast<Common::U32>(readySteps);
+        }
+
+        bool CFixedTimestep::consumeStep(void)
+        {
+            if (mAccumulatedMicroseconds < mStepMicroseconds)
+            {
+                return false;
+            }
+
+            mAccumulatedMicroseconds -= mStepMicroseconds;
+            ++mTickNumber;
+            return true;
+        }
+
+        void CFixedTimestep::setMaxStepsPerUpdate(const Common::U32 maxStepsPerUpdate)
+        {
+            if (maxStepsPerUpdate == 0)
+            {
+                throw std::logic_error("CFixedTimestep: The catch up limit must not be zero.");
+            }
+
+            mMaxStepsPerUpdate = maxStepsPerUpdate;
+        }
+
+        Common::U64 CFixedTimestep::getTickNumber(void) const
+        {
+            return mTickNumber;
+        }
+
+        Common::F32 CFixedTimestep::getStepSeconds(void) const
+        {
+            return static_cast<Common::F32>(mStepMicroseconds) / 1000000.0f;
+        }
+
+        Common::U64 CFixedTimestep::getStepMicroseconds(void) const
+        {
+            return mStepMicroseconds;
+        }
+
+        Common::F32 CFixedTimestep::getInterpolationAlpha(void) const
+        {
+            return static_cast<Common::F32>(mAccumulatedMicroseconds % mStepMicroseconds) / static_cast<Common::F32>(mStepMicroseconds);
+        }
+
+        Common::U64 CFixedTimestep::getTimeUntilNextStepMicroseconds(void) const
+        {
+            return mAccumulatedMicroseconds >= mStepMicroseconds ? 0 : mStepMicroseconds - mAccumulatedMicroseconds;
+        }
+
+        Common::U64 CFixedTimestep::getDroppedStepCount(void) const
+        {
+            return mDroppedStepCount;
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
@@ -0,0 +1,143 @@
+/**
+ *  @file CLatencyHistogram.cpp
+ *  @brief Source file implementing the CLatencyHistogram class methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <support/CLatencyHistogram.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        CLatencyHistogram::CLatencyHistogram(void)
+        {
+            this->clear();
+        }
+
+        Common::U32 CLatencyHistogram::getBucketIndex(const Common::U64 nanoseconds)
+        {
+            if (nanoseconds < sSubBucketCount)
+            {
+                return static_cast<Common::U32>(nanoseconds);
+            }
+
+            Common::U32 exponent = 0;
+            for (Common::U64 remaining = nanoseconds >> 1; remaining != 0; remaining >>= 1)
+            {
+                ++exponent;
+            }
+
+            if (exponent >= sMaximumExponent)
+            {
+                return sBucketCount - 1;
+            }
+
+            // The top six bits select the bucket within the power of two, the first of which is always set
+            const Common::U32 shift = exponent - 5;
+            const Common::U32 subBucket = static_cast<Common::U32>(nanoseconds >> shift) - sSubBucketCount / 2;
+            return sSubBucketCount + (exponent - 6) * (sSubBucketCount / 2) + subBucket;
+        }
+
+        Common::U64 CLatencyHistogram::getBucketUpperBound(const Common::U32 bucket)
+        {
+            if (bucket < sSubBucketCount)
+            {
+                return bucket;
+            }
+            else if (bucket == sBucketCount - 1)
+            {
+                return std::numeric_limits<Common::U64>::max();
+            }
+
+            const Common::U32 group = (bucket - sSubBucketCount) / (sSubBucketCount / 2);
+            const Common::U32 subBucket = (bucket - sSubBucketCount) % (sSubBucketCount / 2);
+            const Common::U32 shift = group + 1;
+
+            return ((static_cast<Common::U64>(sSubBucketCount / 2 + subBucket) << shift) | ((1ULL << shift) - 1));
+        }
+
+        void CLatencyHistogram::record(const Common::U64 nanoseconds)
+        {
+            ++mCounts[getBucketIndex(nanoseconds)];
+
+            mMinimum = mTotalCount == 0 ? nanoseconds : std::min(mMinimum, nanoseconds);
+            mMaximum = std::max(mMaximum, nanoseconds);
+            ++mTotalCount;
+        }
+
+        void CLatencyHistogram::merge(const CLatencyHistogram& other)
+        {
+            if (other.mTotalCount == 0)
+            {
+                return;
+            }
+
+            for (Common::U32 bucket = 0; bucket < sBucketCount; ++bucket)
+            {
+                mCounts[bucket] += other.mCounts[bucket];
+            }
+
+            mMinimum = mTotalCount == 0 ? other.mMinimum : std::min(mMinimum, other.mMinimum);
+            mMaximum = std::max(mMaximum, other.mMaximum);
+            mTotalCount += other.mTotalCount;
+        }
+
+        void CLatencyHistogram::clear(void)
+        {
+            std::fill(mCounts, mCounts + sBucketCount, 0);
+            mTotalCount = 0;
+            mMinimum = 0;
+            mMaximum = 0;
+        }
+
+        Common::U64 CLatencyHistogram::getCount(void) const
+        {
+            return mTotalCount;
+        }
+
+        Common::U64 CLatencyHistogram::getMinimum(void) const
+        {
+            return mMinimum;
+        }
+
+        Common::U64 CLatencyHistogram::getMaximum(void) const
+        {
+            return mMaximum;
+        }
+
+        Common::U64 CLatencyHistogram::getPercentile(const Common::F64 percentile) const
+        {
+            if (mTotalCount == 0)
+            {
+                return 0;
+            }
+
+            // The rank of the value we're after, counting from one
+            const Common::F64 clampedPercentile = std::min(100.0, std::max(0.0, percentile));
+            const Common::U64 rank = std::max<Common::U64>(1, static_cast<Common::U64>(std::ceil(clampedPercentile / 100.0 * mTotalCount)));
+
+            Common::U64 seenCount = 0;
+            for (Common::U32 bucket = 0; bucket < sBucketCount; ++bucket)
+            {
+                seenCount += mCounts[bucket];
+
+                if (seenCount >= rank)
+                {
+                    return std::min(getBucketUpperBound(bucket), mMaximum);
+                }
+            }
+
+            return mMaximum;
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
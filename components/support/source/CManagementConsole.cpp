@@ -9,6 +9,8 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <algorithm>
+
 #include <support/Console.hpp>
 #include <support/CManagementConsole.hpp>
 
@@ -56,6 +58,12 @@ namespace Kiaro
                         }
                     }
 
+                    // Nothing but whitespace
+                    if (params.empty())
+                    {
+                        continue;
+                    }
+
                     // Evaluate
                     Support::String commandName = params[0];
                     params.erase(params.begin());
@@ -97,6 +105,19 @@ namespace Kiaro
             mCallmap[name] = called;
         }
 
+        Support::Vector<Support::String> CManagementConsole::getFunctionNames(void) const
+        {
+            Support::Vector<Support::String> result;
+
+            for (auto&& entry : mCallmap)
+            {
+                result.push_back(entry.first);
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
         void CManagementConsole::registerFunction(const Support::String& name, ManagementFunction::StaticDelegateFuncPtr staticPointer)
         {
             this->registerFunction(name, new ManagementFunction::StaticDelegateType(staticPointer));
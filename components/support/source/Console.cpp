@@ -9,7 +9,12 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <chrono>
+#include <cstdlib>
+
 #include <support/Console.hpp>
+#include <support/CBoundedMPSCQueue.hpp>
+#include <support/platform/thread.hpp>
 
 namespace Kiaro
 {
@@ -17,8 +22,320 @@ namespace Kiaro
     {
         namespace Console
         {
-            Support::UnorderedMap<Common::U8, LogResponderSetType> sLogResponders;
+            Support::Atomic<Common::U8> sMinimumSeverity(0);
+
+            //! The responders of every message type, only invoked by the console thread.
+            static LogResponderSetType sLogResponders[MESSAGE_DEBUG + 1];
+
+            //! Guards sLogResponders against registration while the console thread invokes them.
+            static Support::Mutex sLogRespondersMutex;
+
+            /**
+             *  @brief The console thread and the queue feeding it. Created with the first message and stopped at exit, after
+             *  which messages are written synchronously.
+             */
+            class CConsoleBackend
+            {
+                // Private Members
+                private:
+                    //! Messages waiting to be written.
+                    CBoundedMPSCQueue<LogRecord> mQueue;
+
+                    //! Whether or not the console thread should keep running.
+                    Support::Atomic<bool> mRunning;
+
+                    //! Set while the console thread waits for messages, so writers only wake it when it needs waking.
+                    Support::Atomic<bool> mSleeping;
+
+                    //! The number of messages printed and passed to the responders.
+                    Support::Atomic<size_t> mWrittenCount;
+
+                    //! The number of messages dropped because the queue was full.
+                    Support::Atomic<Common::U64> mDroppedCount;
+
+                    //! Guards the condition variables.
+                    Support::Mutex mMutex;
+
+                    //! Signalled when messages arrive.
+                    Support::ConditionVariable mMessagesQueued;
+
+                    //! Signalled when the queue has been drained.
+                    Support::ConditionVariable mMessagesWritten;
+
+                    //! The console thread.
+                    Support::Thread mThread;
+
+                // Public Methods
+                public:
+                    CConsoleBackend(void) : mQueue(CONSOLE_QUEUE_CAPACITY), mRunning(true), mSleeping(false), mWrittenCount(0), mDroppedCount(0)
+                    {
+                        mThread = Support::Thread(&CConsoleBackend::run, this);
+                    }
+
+                    //! Returns whether or not the calling thread is the console thread.
+                    bool isConsoleThread(void) const
+                    {
+                        return std::this_thread::get_id() == mThread.get_id();
+                    }
+
+                    //! Returns whether or not the console thread is still running.
+                    bool isRunning(void) const
+                    {
+                        return mRunning.load(std::memory_order_acquire);
+                    }
+
+                    bool push(const LogRecord& record)
+                    {
+                        // The console thread would wait on itself, and messages below warnings are not worth stalling for
+                        const bool wait = messageSeverity(record.mType) >= messageSeverity(MESSAGE_WARNING) && !this->isConsoleThread();
+
+                        while (!mQueue.tryPush(record))
+                        {
+                            if (!wait)
+                            {
+                                mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+                                return false;
+                            }
+
+                            this->wake();
+                            std::this_thread::yield();
+                        }
+
+                        if (mSleeping.load(std::memory_order_acquire))
+                        {
+                            this->wake();
+                        }
+
+                        return true;
+                    }
+
+                    void flush(void)
+                    {
+                        if (this->isConsoleThread())
+                        {
+                            return;
+                        }
+
+                        const size_t target = mQueue.getPushCount();
+                        std::unique_lock<Support::Mutex> lock(mMutex);
+
+                        while (mWrittenCount.load(std::memory_order_acquire) < target && this->isRunning())
+                        {
+                            mMessagesQueued.notify_one();
+                            mMessagesWritten.wait_for(lock, std::chrono::milliseconds(1));
+                        }
+                    }
+
+                    //! Writes everything still queued and stops the console thread.
+                    void stop(void)
+                    {
+                        {
+                            std::lock_guard<Support::Mutex> lock(mMutex);
+                            mRunning.store(false, std::memory_order_release);
+                        }
+
+                        mMessagesQueued.notify_one();
+                        mThread.join();
+                    }
+
+                // Private Methods
+                private:
+                    void wake(void)
+                    {
+                        std::lock_guard<Support::Mutex> lock(mMutex);
+                        mMessagesQueued.notify_one();
+                    }
+
+                    void run(void)
+                    {
+                        // Do not inherit the pinning or priority of whichever thread happened to log first
+                        Platform::Thread::placeCurrentThread("Console", Platform::Thread::AFFINITY_NONE, 0, false, Platform::Thread::PRIORITY_NORMAL);
+
+                        while (true)
+                        {
+                            LogRecord record;
+
+                            if (mQueue.tryPop(record))
+                            {
+                                writeRecord(record);
+                                mWrittenCount.store(mQueue.getPopCount(), std::memory_order_release);
+                                continue;
+                            }
+
+                            this->reportDropped();
+                            fflush(stdout);
+
+                            std::unique_lock<Support::Mutex> lock(mMutex);
+                            mMessagesWritten.notify_all();
+
+                            // A message still being written by its producer is popped on the next pass
+                            if (mQueue.getPopCount() != mQueue.getPushCount())
+                            {
+                                lock.unlock();
+                                std::this_thread::yield();
+                                continue;
+                            }
+                            else if (!this->isRunning())
+                            {
+                                return;
+                            }
+
+                            // Writers skip the wake up unless we are asleep, so time out in case one raced us
+                            mSleeping.store(true, std::memory_order_release);
+                            mMessagesQueued.wait_for(lock, std::chrono::milliseconds(10));
+                            mSleeping.store(false, std::memory_order_release);
+                        }
+                    }
+
+                    void reportDropped(void)
+                    {
+                        const Common::U64 droppedCount = mDroppedCount.exchange(0, std::memory_order_relaxed);
+
+                        if (droppedCount != 0)
+                        {
+                            LogRecord record;
+                            record.mType = MESSAGE_WARNING;
+                            record.mFormat = "Console: Dropped %llu messages because the console queue was full.";
+                            record.mFormatter = formatRecord<unsigned long long>;
+
+                            Common::U8* cursor = record.mPayload;
+                            LogArgument<unsigned long long>::encode(cursor, droppedCount);
+                            writeRecord(record);
+                        }
+                    }
+
+                // Public Methods
+                public:
+                    //! Formats the given record, prints it and passes it to the responders.
+                    static void writeRecord(const LogRecord& record)
+                    {
+                        Support::String message;
+
+                        if (record.mFormatter)
+                        {
+                            record.mFormatter(record, &message);
+                        }
+                        else
+                        {
+                            message = record.mFormat;
+                        }
+
+                        // Call the responders first.
+                        {
+                            std::lock_guard<Support::Mutex> lock(sLogRespondersMutex);
+                            sLogResponders[record.mType].invoke(record.mType, message);
+                        }
+
+                        const Common::C8* typeText = messageTypeText(record.mType);
+                        Support::String line;
+                        line.reserve(message.size() + strlen(typeText) + 4);
+                        line += "(";
+                        line += typeText;
+                        line += ") ";
+                        line += message;
+                        line += "\n";
+
+                        fwrite(line.data(), 1, line.size(), stdout);
+                    }
+            };
+
+            //! Set once the backend has been stopped at exit.
+            static Support::Atomic<bool> sBackendStopped(false);
+
+            static CConsoleBackend* getBackend(void);
+
+            static void stopBackend(void)
+            {
+                getBackend()->stop();
+                sBackendStopped.store(true, std::memory_order_release);
+            }
+
+            static CConsoleBackend* getBackend(void)
+            {
+                // Never destroyed, so messages written during static destruction still find it
+                static CConsoleBackend* backend = []()
+                {
+                    CConsoleBackend* result = new CConsoleBackend();
+                    std::atexit(stopBackend);
+                    return result;
+                }();
+
+                return backend;
+            }
+
+            void formatPreformattedRecord(const LogRecord& record, Support::String* output)
+            {
+                Support::String* message;
+                memcpy(&message, record.mPayload, sizeof(message));
+
+                if (output)
+                {
+                    *output = std::move(*message);
+                }
+
+                delete message;
+            }
+
+            void submit(const LogRecord& record)
+            {
+                if (sBackendStopped.load(std::memory_order_acquire))
+                {
+                    CConsoleBackend::writeRecord(record);
+                    fflush(stdout);
+                    return;
+                }
+
+                CConsoleBackend* backend = getBackend();
+
+                if (!backend->push(record))
+                {
+                    if (record.mFormatter)
+                    {
+                        record.mFormatter(record, nullptr);
+                    }
+
+                    return;
+                }
+
+                if (record.mType == MESSAGE_FATAL)
+                {
+                    backend->flush();
+                }
+            }
+
+            void flush(void)
+            {
+                if (!sBackendStopped.load(std::memory_order_acquire))
+                {
+                    getBackend()->flush();
+                }
+            }
+
+            void setMinimumSeverity(const MESSAGE_TYPE type)
+            {
+                sMinimumSeverity.store(messageSeverity(type), std::memory_order_relaxed);
+            }
+
+            void registerListener(LogResponderSetType::StoredDelegateType* responder, MESSAGE_TYPE type)
+            {
+                // Responders are matched as the console thread dequeues, so earlier messages must be out of the queue first
+                flush();
+
+                std::lock_guard<Support::Mutex> lock(sLogRespondersMutex);
+                sLogResponders[type].push_back(responder);
+            }
+
+            void clearListeners(void)
+            {
+                flush();
+
+                std::lock_guard<Support::Mutex> lock(sLogRespondersMutex);
+
+                for (LogResponderSetType& responders : sLogResponders)
+                {
+                    responders.clear();
+                }
+            }
         }
     }
 }
-
@@ -9,9 +9,22 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <atomic>
 #include <chrono>
 #include <numeric>
 #include <algorithm>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #include <cpuid.h>
+    #include <x86intrin.h>
+
+    #define _FTIME_USE_TSC_ 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+
+    #define _FTIME_USE_TSC_ 1
+#endif
 
 #include <support/FTime.hpp>
 #include <support/Stack.hpp>
@@ -25,12 +38,93 @@ namespace Kiaro
     {
         namespace FTime
         {
-            static Support::Stack<std::chrono::time_point<std::chrono::high_resolution_clock>> sTimerStack;
-            static Common::U32 sCurrentSimTime = 0;
+            //! How long the TSC is measured against the real clock to calibrate it.
+            static const Common::U32 sCalibrationMicroseconds = 10000;
+
+            //! The timer stack of each thread.
+            static thread_local Support::Stack<std::chrono::steady_clock::time_point> sTimerStack;
+
+            //! The time of the simulation clock in nanoseconds.
+            static std::atomic<Common::U64> sSimTimeNanoseconds(0);
+            //! How fast the simulation clock runs relative to the real clock.
+            static std::atomic<Common::F32> sSimTimeScale(1.0f);
+            //! Whether or not the simulation clock is paused.
+            static std::atomic<bool> sSimTimePaused(false);
+
+            //! Returns the time point all real clock readings are relative to.
+            static std::chrono::steady_clock::time_point getEpoch(void)
+            {
+                static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+                return epoch;
+            }
+
+            //! Returns whether or not the processor has a TSC that ticks at a constant rate across all cores and power states.
+            static bool detectInvariantTSC(void)
+            {
+                #if defined(_FTIME_USE_TSC_) && defined(_MSC_VER)
+                int registers[4];
+                __cpuid(registers, 0x80000000);
+
+                if (static_cast<Common::U32>(registers[0]) < 0x80000007)
+                {
+                    return false;
+                }
+
+                __cpuid(registers, 0x80000007);
+                return (registers[3] & (1 << 8)) != 0;
+                #elif defined(_FTIME_USE_TSC_)
+                unsigned int eax, ebx, ecx, edx;
+
+                if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+                {
+                    return false;
+                }
+
+                __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+                return (edx & (1 << 8)) != 0;
+                #else
+                return false;
+                #endif // _FTIME_USE_TSC_
+            }
+
+            //! Returns whether or not the counter reads the TSC. Detected once as it never changes.
+            static bool usesTSC(void)
+            {
+                static const bool result = detectInvariantTSC();
+                return result;
+            }
+
+            //! Measures the TSC against the real clock and returns the nanoseconds per tick.
+            static Common::F64 calibrateTSC(void)
+            {
+                #if defined(_FTIME_USE_TSC_)
+                const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+                const Common::U64 startCounter = __rdtsc();
+
+                std::chrono::steady_clock::time_point endTime = startTime;
+                while (endTime - startTime < std::chrono::microseconds(sCalibrationMicroseconds))
+                {
+                    endTime = std::chrono::steady_clock::now();
+                }
+
+                const Common::U64 endCounter = __rdtsc();
+                const std::chrono::duration<Common::F64, std::nano> elapsed = endTime - startTime;
+                return elapsed.count() / static_cast<Common::F64>(std::max<Common::U64>(1, endCounter - startCounter));
+                #else
+                return 1.0;
+                #endif // _FTIME_USE_TSC_
+            }
+
+            //! Returns the nanoseconds per TSC tick, calibrating the TSC the first time this is called.
+            static Common::F64 getNanosecondsPerTick(void)
+            {
+                static const Common::F64 nanosecondsPerTick = calibrateTSC();
+                return nanosecondsPerTick;
+            }
 
             Support::FTime::timer startTimer(void)
             {
-                sTimerStack.push(std::chrono::high_resolution_clock::now());
+                sTimerStack.push(std::chrono::steady_clock::now());
                 return sTimerStack.size();
             }
 
@@ -55,26 +149,107 @@ namespace Kiaro
 
                 const auto lastTimePoint = sTimerStack.top();
 
-                std::chrono::duration<Common::F32> deltaTimePoint = std::chrono::high_resolution_clock::now() - lastTimePoint;
+                std::chrono::duration<Common::F32> deltaTimePoint = std::chrono::steady_clock::now() - lastTimePoint;
+
+                sTimerStack.pop();
+                return deltaTimePoint.count();
+            }
 
-                // Only add deltas if we're the upper most timer
-                if(timerIdentifier == 1)
+            void clearTimers(void)
+            {
+                sTimerStack = Support::Stack<std::chrono::steady_clock::time_point>();
+            }
+
+            Common::U64 getNanoseconds(void)
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - getEpoch()).count();
+            }
+
+            Common::U64 getMilliseconds(void)
+            {
+                return getNanoseconds() / 1000000ULL;
+            }
+
+            Common::U64 readCounter(void)
+            {
+                #if defined(_FTIME_USE_TSC_)
+                if (usesTSC())
                 {
-                    sCurrentSimTime += deltaTimePoint.count() * 1000000;
+                    return __rdtsc();
                 }
+                #endif // _FTIME_USE_TSC_
 
-                sTimerStack.pop();
-                return deltaTimePoint.count();
+                return getNanoseconds();
             }
 
-            Common::U64 getSimTimeMilliseconds(void)
+            Common::U64 counterToNanoseconds(const Common::U64 counterDelta)
             {
-                return sCurrentSimTime / 1000ULL;
+                if (!usesTSC())
+                {
+                    return counterDelta;
+                }
+
+                return static_cast<Common::U64>(static_cast<Common::F64>(counterDelta) * getNanosecondsPerTick());
             }
 
-            void clearTimers(void)
+            void calibrateCounter(void)
+            {
+                if (usesTSC())
+                {
+                    getNanosecondsPerTick();
+                }
+            }
+
+            bool isCounterHardwareBacked(void)
+            {
+                return usesTSC();
+            }
+
+            void advanceSimTime(const Common::U64 realNanoseconds)
+            {
+                if (sSimTimePaused.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+
+                const Common::F32 scale = sSimTimeScale.load(std::memory_order_relaxed);
+                const Common::U64 simNanoseconds = scale == 1.0f ? realNanoseconds : static_cast<Common::U64>(static_cast<Common::F64>(realNanoseconds) * scale);
+                sSimTimeNanoseconds.fetch_add(simNanoseconds, std::memory_order_release);
+            }
+
+            void setSimTimeScale(const Common::F32 scale)
+            {
+                if (scale < 0.0f)
+                {
+                    throw std::invalid_argument("FTime: The sim time scale must not be negative.");
+                }
+
+                sSimTimeScale.store(scale, std::memory_order_relaxed);
+            }
+
+            Common::F32 getSimTimeScale(void)
+            {
+                return sSimTimeScale.load(std::memory_order_relaxed);
+            }
+
+            void setSimTimePaused(const bool paused)
+            {
+                sSimTimePaused.store(paused, std::memory_order_relaxed);
+            }
+
+            bool isSimTimePaused(void)
+            {
+                return sSimTimePaused.load(std::memory_order_relaxed);
+            }
+
+            Common::U64 getSimTimeNanoseconds(void)
+            {
+                return sSimTimeNanoseconds.load(std::memory_order_acquire);
+            }
+
+            Common::U64 getSimTimeMilliseconds(void)
             {
-                sTimerStack = Support::Stack<std::chrono::time_point<std::chrono::high_resolution_clock>>();
+                return getSimTimeNanoseconds() / 1000000ULL;
             }
         } // End NameSpace Time
     } // End NameSpace Support
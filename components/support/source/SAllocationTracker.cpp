@@ -0,0 +1,435 @@
+/**
+ *  @file SAllocationTracker.cpp
+ *  @brief Source file implementing the SAllocationTracker class methods and the global allocation hooks.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <support/UnorderedMap.hpp>
+#include <support/SProfiler.hpp>
+#include <support/SAllocationTracker.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        const bool SAllocationTracker::sEnabled;
+        const Common::U16 SAllocationTracker::sUntagged;
+        const size_t SAllocationTracker::sTagCapacity;
+        const size_t SAllocationTracker::sZoneCapacity;
+        const Common::U32 SAllocationTracker::sNoZone;
+        const Common::U32 SAllocationTracker::sRateWindowFrames;
+
+        //! The number of counter stripes threads are spread across. Must be a power of two.
+        static const Common::U32 sStripeCount = 8;
+
+        //! The counters of a single tag or zone in a single stripe. Zones never count frees.
+        struct AllocationCounters
+        {
+            Support::Atomic<Common::U64> mAllocationCount;
+            Support::Atomic<Common::U64> mAllocatedBytes;
+            Support::Atomic<Common::U64> mFreeCount;
+            Support::Atomic<Common::U64> mFreedBytes;
+        };
+
+        /**
+         *  @brief The counters of every tag and zone in a single stripe. Zone index zero counts allocations made outside of
+         *  any zone. Aligned so that stripes do not share cache lines.
+         */
+        struct alignas(64) AllocationStripe
+        {
+            AllocationCounters mTags[SAllocationTracker::sTagCapacity];
+            AllocationCounters mZones[SAllocationTracker::sZoneCapacity + 1];
+        };
+
+        //! The rate window state of a single tag or zone.
+        struct AllocationRate
+        {
+            //! The allocation count when the current window began.
+            Common::U64 mWindowAllocationCount;
+            //! The allocated bytes when the current window began.
+            Common::U64 mWindowAllocatedBytes;
+            //! The allocations per frame over the last complete window.
+            Common::F64 mAllocationsPerFrame;
+            //! The bytes allocated per frame over the last complete window.
+            Common::F64 mBytesPerFrame;
+        };
+
+        // Only zero initialized, so that they are usable by allocations made before static initialization
+        static AllocationStripe sStripes[sStripeCount];
+        static Support::Atomic<Common::U32> sNextStripe;
+
+        //! The stripe of the calling thread plus one, or zero until the first allocation.
+        static thread_local Common::U32 sThreadStripe = 0;
+        //! The tag allocations of the calling thread are attributed to.
+        static thread_local Common::U16 sThreadTag = SAllocationTracker::sUntagged;
+        //! The zone allocations of the calling thread are attributed to, plus one. Zero outside of any zone.
+        static thread_local Common::U32 sThreadZone = 0;
+
+        //! The names of every tag, indexed by tag ID.
+        static Support::Vector<Support::String> sTagNames;
+        //! Maps tag names to their IDs.
+        static Support::UnorderedMap<Support::String, Common::U16> sTagIDs;
+        //! Protects sTagNames and sTagIDs.
+        static Support::Mutex sTagMutex;
+
+        static AllocationRate sTagRates[SAllocationTracker::sTagCapacity];
+        static AllocationRate sZoneRates[SAllocationTracker::sZoneCapacity + 1];
+        //! The number of frames of the current rate window that have passed.
+        static Common::U32 sWindowFrames = 0;
+        //! Protects the rates.
+        static Support::Mutex sRateMutex;
+
+        //! Returns the stripe of the calling thread.
+        static AllocationStripe& getThreadStripe(void)
+        {
+            if (!sThreadStripe)
+            {
+                sThreadStripe = (sNextStripe.fetch_add(1, std::memory_order_relaxed) & (sStripeCount - 1)) + 1;
+            }
+
+            return sStripes[sThreadStripe - 1];
+        }
+
+        //! Sums the counters of the given tag or zone across every stripe.
+        static void sumCounters(const size_t index, const bool zone, Common::U64 sums[4])
+        {
+            sums[0] = sums[1] = sums[2] = sums[3] = 0;
+
+            for (AllocationStripe& stripe : sStripes)
+            {
+                const AllocationCounters& counters = zone ? stripe.mZones[index] : stripe.mTags[index];
+                sums[0] += counters.mAllocationCount.load(std::memory_order_relaxed);
+                sums[1] += counters.mAllocatedBytes.load(std::memory_order_relaxed);
+                sums[2] += counters.mFreeCount.load(std::memory_order_relaxed);
+                sums[3] += counters.mFreedBytes.load(std::memory_order_relaxed);
+            }
+        }
+
+        //! Builds the statistics of the given tag or zone. Requires sRateMutex.
+        static SAllocationTracker::Statistics buildStatistics(const size_t index, const bool zone)
+        {
+            Common::U64 sums[4];
+            sumCounters(index, zone, sums);
+
+            const AllocationRate& rate = zone ? sZoneRates[index] : sTagRates[index];
+
+            SAllocationTracker::Statistics result;
+            result.mAllocationCount = sums[0];
+            result.mAllocatedBytes = sums[1];
+
+            // Frees racing the sums may briefly outnumber the allocations
+            result.mLiveAllocations = sums[0] - std::min(sums[2], sums[0]);
+            result.mLiveBytes = sums[1] - std::min(sums[3], sums[1]);
+            result.mAllocationsPerFrame = rate.mAllocationsPerFrame;
+            result.mBytesPerFrame = rate.mBytesPerFrame;
+            return result;
+        }
+
+        Common::U16 SAllocationTracker::internTag(const Common::C8* name)
+        {
+            std::lock_guard<Support::Mutex> lock(sTagMutex);
+
+            if (sTagNames.empty())
+            {
+                sTagNames.push_back("Untagged");
+                sTagIDs["Untagged"] = sUntagged;
+            }
+
+            auto searchResult = sTagIDs.find(name);
+            if (searchResult != sTagIDs.end())
+            {
+                return searchResult->second;
+            }
+            else if (sTagNames.size() >= sTagCapacity)
+            {
+                return sUntagged;
+            }
+
+            const Common::U16 tag = static_cast<Common::U16>(sTagNames.size());
+            sTagNames.push_back(name);
+            sTagIDs[name] = tag;
+            return tag;
+        }
+
+        Support::String SAllocationTracker::getTagName(const Common::U16 tag)
+        {
+            std::lock_guard<Support::Mutex> lock(sTagMutex);
+
+            if (tag == sUntagged)
+            {
+                return "Untagged";
+            }
+            else if (tag >= sTagNames.size())
+            {
+                throw std::out_of_range("No such allocation tag!");
+            }
+
+            return sTagNames[tag];
+        }
+
+        Common::U16 SAllocationTracker::getThreadTag(void)
+        {
+            return sThreadTag;
+        }
+
+        void SAllocationTracker::setThreadTag(const Common::U16 tag)
+        {
+            sThreadTag = tag;
+        }
+
+        void SAllocationTracker::setThreadZone(const Common::U32 zone)
+        {
+            sThreadZone = zone < sZoneCapacity ? zone + 1 : 0;
+        }
+
+        void SAllocationTracker::recordAllocation(const Common::U16 tag, const size_t bytes)
+        {
+            AllocationStripe& stripe = getThreadStripe();
+
+            AllocationCounters& tagCounters = stripe.mTags[tag < sTagCapacity ? tag : sUntagged];
+            tagCounters.mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+            tagCounters.mAllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+            AllocationCounters& zoneCounters = stripe.mZones[sThreadZone];
+            zoneCounters.mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+            zoneCounters.mAllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void SAllocationTracker::recordFree(const Common::U16 tag, const size_t bytes)
+        {
+            AllocationCounters& tagCounters = getThreadStripe().mTags[tag < sTagCapacity ? tag : sUntagged];
+            tagCounters.mFreeCount.fetch_add(1, std::memory_order_relaxed);
+            tagCounters.mFreedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void SAllocationTracker::update(void)
+        {
+            std::lock_guard<Support::Mutex> lock(sRateMutex);
+
+            if (++sWindowFrames < sRateWindowFrames)
+            {
+                return;
+            }
+
+            const size_t entryCount = sTagCapacity + sZoneCapacity + 1;
+            for (size_t entry = 0; entry < entryCount; ++entry)
+            {
+                const bool zone = entry >= sTagCapacity;
+                const size_t index = zone ? entry - sTagCapacity : entry;
+                AllocationRate& rate = zone ? sZoneRates[index] : sTagRates[index];
+
+                Common::U64 sums[4];
+                sumCounters(index, zone, sums);
+
+                rate.mAllocationsPerFrame = static_cast<Common::F64>(sums[0] - rate.mWindowAllocationCount) / sWindowFrames;
+                rate.mBytesPerFrame = static_cast<Common::F64>(sums[1] - rate.mWindowAllocatedBytes) / sWindowFrames;
+                rate.mWindowAllocationCount = sums[0];
+                rate.mWindowAllocatedBytes = sums[1];
+            }
+
+            sWindowFrames = 0;
+        }
+
+        Support::Vector<SAllocationTracker::Statistics> SAllocationTracker::getTagStatistics(void)
+        {
+            Support::Vector<Statistics> result;
+
+            {
+                std::lock_guard<Support::Mutex> lock(sRateMutex);
+
+                for (size_t tag = 0; tag < sTagCapacity; ++tag)
+                {
+                    Statistics statistics = buildStatistics(tag, false);
+
+                    if (statistics.mAllocationCount)
+                    {
+                        statistics.mName = getTagName(static_cast<Common::U16>(tag));
+                        result.push_back(statistics);
+                    }
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const Statistics& lhs, const Statistics& rhs)
+            {
+                return lhs.mLiveBytes > rhs.mLiveBytes;
+            });
+
+            return result;
+        }
+
+        Support::Vector<SAllocationTracker::Statistics> SAllocationTracker::getZoneStatistics(void)
+        {
+            Support::Vector<Statistics> result;
+
+            {
+                std::lock_guard<Support::Mutex> lock(sRateMutex);
+
+                for (size_t zone = 0; zone <= sZoneCapacity; ++zone)
+                {
+                    Statistics statistics = buildStatistics(zone, true);
+
+                    if (statistics.mAllocationCount)
+                    {
+                        statistics.mName = zone ? SProfiler::getZoneName(static_cast<Common::U32>(zone - 1)) : "(No Zone)";
+                        statistics.mLiveAllocations = 0;
+                        statistics.mLiveBytes = 0;
+                        result.push_back(statistics);
+                    }
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const Statistics& lhs, const Statistics& rhs)
+            {
+                return lhs.mAllocationsPerFrame > rhs.mAllocationsPerFrame ||
+                       (lhs.mAllocationsPerFrame == rhs.mAllocationsPerFrame && lhs.mAllocationCount > rhs.mAllocationCount);
+            });
+
+            return result;
+        }
+
+        SAllocationTracker::Statistics SAllocationTracker::getTotalStatistics(void)
+        {
+            Statistics result;
+            result.mName = "Total";
+            result.mAllocationCount = 0;
+            result.mAllocatedBytes = 0;
+            result.mLiveAllocations = 0;
+            result.mLiveBytes = 0;
+            result.mAllocationsPerFrame = 0.0;
+            result.mBytesPerFrame = 0.0;
+
+            std::lock_guard<Support::Mutex> lock(sRateMutex);
+
+            for (size_t tag = 0; tag < sTagCapacity; ++tag)
+            {
+                const Statistics statistics = buildStatistics(tag, false);
+                result.mAllocationCount += statistics.mAllocationCount;
+                result.mAllocatedBytes += statistics.mAllocatedBytes;
+                result.mLiveAllocations += statistics.mLiveAllocations;
+                result.mLiveBytes += statistics.mLiveBytes;
+                result.mAllocationsPerFrame += statistics.mAllocationsPerFrame;
+                result.mBytesPerFrame += statistics.mBytesPerFrame;
+            }
+
+            return result;
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+
+#if defined(KIARO_ALLOCATION_TRACKING)
+    /**
+     *  @brief Placed in front of every allocation made through the global operator new, so that delete knows what to
+     *  count the release against.
+     */
+    struct AllocationHeader
+    {
+        //! The size that was requested.
+        Kiaro::Common::U64 mSize;
+        //! The distance from the start of the underlying block to the allocation.
+        Kiaro::Common::U32 mOffset;
+        //! The tag the allocation was counted against.
+        Kiaro::Common::U16 mTag;
+        Kiaro::Common::U16 mReserved;
+    };
+
+    static_assert(sizeof(AllocationHeader) == 16, "Allocation headers must keep malloc's alignment.");
+
+    //! Allocates and counts the given number of bytes, or returns nullptr on failure.
+    static void* trackedAllocate(const size_t size, size_t alignment) noexcept
+    {
+        alignment = std::max<size_t>(alignment, sizeof(AllocationHeader));
+
+        // Every block has room for the header right in front of the aligned allocation
+        const size_t padding = alignment + sizeof(AllocationHeader) - 1;
+        if (size > std::numeric_limits<size_t>::max() - padding)
+        {
+            return nullptr;
+        }
+
+        Kiaro::Common::U8* block = reinterpret_cast<Kiaro::Common::U8*>(malloc(size + padding));
+        if (!block)
+        {
+            return nullptr;
+        }
+
+        const uintptr_t address = (reinterpret_cast<uintptr_t>(block) + sizeof(AllocationHeader) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        Kiaro::Common::U8* result = reinterpret_cast<Kiaro::Common::U8*>(address);
+
+        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(result) - 1;
+        header->mSize = size;
+        header->mOffset = static_cast<Kiaro::Common::U32>(result - block);
+        header->mTag = Kiaro::Support::SAllocationTracker::getThreadTag();
+        header->mReserved = 0;
+
+        Kiaro::Support::SAllocationTracker::recordAllocation(header->mTag, size);
+        return result;
+    }
+
+    //! Allocates like trackedAllocate, but calls the new handler and throws std::bad_alloc on failure.
+    static void* trackedAllocateOrThrow(const size_t size, const size_t alignment)
+    {
+        while (true)
+        {
+            void* result = trackedAllocate(size, alignment);
+            if (result)
+            {
+                return result;
+            }
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+
+            handler();
+        }
+    }
+
+    //! Counts the release of an allocation made by trackedAllocate and frees it.
+    static void trackedFree(void* pointer) noexcept
+    {
+        if (!pointer)
+        {
+            return;
+        }
+
+        const AllocationHeader* header = reinterpret_cast<const AllocationHeader*>(pointer) - 1;
+        Kiaro::Support::SAllocationTracker::recordFree(header->mTag, header->mSize);
+        free(reinterpret_cast<Kiaro::Common::U8*>(pointer) - header->mOffset);
+    }
+
+    void* operator new(size_t size) { return trackedAllocateOrThrow(size, 0); }
+    void* operator new[](size_t size) { return trackedAllocateOrThrow(size, 0); }
+    void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size, 0); }
+    void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size, 0); }
+
+    void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+    void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+    void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+    void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+    void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+    void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+
+    #if defined(__cpp_aligned_new)
+        void* operator new(size_t size, std::align_val_t alignment) { return trackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+        void* operator new[](size_t size, std::align_val_t alignment) { return trackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+        void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAllocate(size, static_cast<size_t>(alignment)); }
+        void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAllocate(size, static_cast<size_t>(alignment)); }
+
+        void operator delete(void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+        void operator delete[](void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+        void operator delete(void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+        void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+        void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+        void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+    #endif // __cpp_aligned_new
+#endif // KIARO_ALLOCATION_TRACKING
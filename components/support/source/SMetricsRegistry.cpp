@@ -0,0 +1,305 @@
+/**
+ *  @file SMetricsRegistry.cpp
+ *  @brief Source file implementing the SMetricsRegistry singleton class and the metric types it keeps.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <support/SMetricsRegistry.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        //! Formats a sample value the way Prometheus expects it.
+        static Support::String formatValue(const Common::F64 value)
+        {
+            if (std::isnan(value))
+            {
+                return "NaN";
+            }
+            else if (std::isinf(value))
+            {
+                return value > 0.0 ? "+Inf" : "-Inf";
+            }
+
+            // Use the shortest precision that still reads back as the same value
+            Common::C8 buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.15g", value);
+
+            if (std::strtod(buffer, nullptr) != value)
+            {
+                snprintf(buffer, sizeof(buffer), "%.17g", value);
+            }
+
+            return buffer;
+        }
+
+        //! Joins a formatted label list and one more label into the braces of a sample.
+        static Support::String joinLabels(const Support::String& labels, const Support::String& extra)
+        {
+            if (labels.empty() && extra.empty())
+            {
+                return "";
+            }
+
+            return "{" + labels + (labels.empty() || extra.empty() ? "" : ",") + extra + "}";
+        }
+
+        CMetricHistogram::CMetricHistogram(const Support::Vector<Common::F64>& upperBounds) : mUpperBounds(upperBounds),
+        mBucketCounts(upperBounds.size() + 1), mSum(0.0)
+        {
+            if (!std::is_sorted(mUpperBounds.begin(), mUpperBounds.end()) || std::adjacent_find(mUpperBounds.begin(), mUpperBounds.end()) != mUpperBounds.end())
+            {
+                throw std::invalid_argument("CMetricHistogram: Bucket bounds must be strictly ascending.");
+            }
+        }
+
+        void CMetricHistogram::observe(const Common::F64 value)
+        {
+            const size_t bucket = std::lower_bound(mUpperBounds.begin(), mUpperBounds.end(), value) - mUpperBounds.begin();
+            mBucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+            Common::F64 sum = mSum.load(std::memory_order_relaxed);
+            while (!mSum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        const Support::Vector<Common::F64>& CMetricHistogram::getUpperBounds(void) const
+        {
+            return mUpperBounds;
+        }
+
+        Common::U64 CMetricHistogram::getBucketCount(const size_t bucket) const
+        {
+            return mBucketCounts.at(bucket).load(std::memory_order_relaxed);
+        }
+
+        Common::F64 CMetricHistogram::getSum(void) const
+        {
+            return mSum.load(std::memory_order_relaxed);
+        }
+
+        SMetricsRegistry::SMetricsRegistry(void) : mNextCollectorID(0)
+        {
+
+        }
+
+        SMetricsRegistry::~SMetricsRegistry(void)
+        {
+            for (auto&& family : mFamilies)
+            {
+                for (auto&& counter : family.second.mCounters)
+                {
+                    delete counter.second;
+                }
+
+                for (auto&& gauge : family.second.mGauges)
+                {
+                    delete gauge.second;
+                }
+
+                for (auto&& histogram : family.second.mHistograms)
+                {
+                    delete histogram.second;
+                }
+            }
+        }
+
+        Support::String SMetricsRegistry::formatLabels(const Labels& labels)
+        {
+            Support::String result;
+
+            for (const Support::Pair<Support::String, Support::String>& label : labels)
+            {
+                if (!result.empty())
+                {
+                    result += ",";
+                }
+
+                result += label.first + "=\"";
+
+                // Label values escape backslashes, quotes and line feeds
+                for (const Common::C8 character : label.second)
+                {
+                    if (character == '\\' || character == '"')
+                    {
+                        result += '\\';
+                        result += character;
+                    }
+                    else if (character == '\n')
+                    {
+                        result += "\\n";
+                    }
+                    else
+                    {
+                        result += character;
+                    }
+                }
+
+                result += "\"";
+            }
+
+            return result;
+        }
+
+        SMetricsRegistry::MetricFamily& SMetricsRegistry::getFamily(const Support::String& name, const Support::String& help, const MetricType type)
+        {
+            auto searchResult = mFamilies.find(name);
+            if (searchResult != mFamilies.end())
+            {
+                if (searchResult->second.mType != type)
+                {
+                    throw std::logic_error("SMetricsRegistry: A metric named '" + name + "' exists with another type.");
+                }
+
+                return searchResult->second;
+            }
+
+            MetricFamily& family = mFamilies[name];
+            family.mType = type;
+            family.mHelp = help;
+            return family;
+        }
+
+        CMetricCounter* SMetricsRegistry::getCounter(const Support::String& name, const Support::String& help, const Labels& labels)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+
+            CMetricCounter*& result = this->getFamily(name, help, METRIC_COUNTER).mCounters[formatLabels(labels)];
+            if (!result)
+            {
+                result = new CMetricCounter();
+            }
+
+            return result;
+        }
+
+        CMetricGauge* SMetricsRegistry::getGauge(const Support::String& name, const Support::String& help, const Labels& labels)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+
+            CMetricGauge*& result = this->getFamily(name, help, METRIC_GAUGE).mGauges[formatLabels(labels)];
+            if (!result)
+            {
+                result = new CMetricGauge();
+            }
+
+            return result;
+        }
+
+        CMetricHistogram* SMetricsRegistry::getHistogram(const Support::String& name, const Support::String& help, const Support::Vector<Common::F64>& upperBounds,
+                                                         const Labels& labels)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+
+            MetricFamily& family = this->getFamily(name, help, METRIC_HISTOGRAM);
+            const Support::String formattedLabels = formatLabels(labels);
+
+            auto searchResult = family.mHistograms.find(formattedLabels);
+            if (searchResult != family.mHistograms.end())
+            {
+                return searchResult->second;
+            }
+
+            try
+            {
+                CMetricHistogram* result = new CMetricHistogram(upperBounds);
+                family.mHistograms[formattedLabels] = result;
+                return result;
+            }
+            catch (std::invalid_argument&)
+            {
+                // Don't leave a family without metrics behind
+                if (family.mHistograms.empty())
+                {
+                    mFamilies.erase(name);
+                }
+
+                throw;
+            }
+        }
+
+        Common::U32 SMetricsRegistry::addCollector(const Collector& collector)
+        {
+            std::lock_guard<Support::Mutex> lock(mCollectorMutex);
+
+            const Common::U32 id = mNextCollectorID++;
+            mCollectors[id] = collector;
+            return id;
+        }
+
+        void SMetricsRegistry::removeCollector(const Common::U32 id)
+        {
+            std::lock_guard<Support::Mutex> lock(mCollectorMutex);
+            mCollectors.erase(id);
+        }
+
+        Support::String SMetricsRegistry::exportText(void)
+        {
+            // Collectors set metrics themselves, so they run without mMutex held
+            {
+                std::lock_guard<Support::Mutex> lock(mCollectorMutex);
+
+                for (auto&& collector : mCollectors)
+                {
+                    collector.second();
+                }
+            }
+
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            Support::String result;
+
+            for (auto&& familyEntry : mFamilies)
+            {
+                const Support::String& name = familyEntry.first;
+                const MetricFamily& family = familyEntry.second;
+
+                static const Common::C8* typeNames[] = { "counter", "gauge", "histogram" };
+                result += "# HELP " + name + " " + family.mHelp + "\n";
+                result += "# TYPE " + name + " " + typeNames[family.mType] + "\n";
+
+                for (auto&& counter : family.mCounters)
+                {
+                    result += name + joinLabels(counter.first, "") + " " + std::to_string(counter.second->getValue()) + "\n";
+                }
+
+                for (auto&& gauge : family.mGauges)
+                {
+                    result += name + joinLabels(gauge.first, "") + " " + formatValue(gauge.second->getValue()) + "\n";
+                }
+
+                // Histogram buckets are cumulative in the exposition format
+                for (auto&& histogram : family.mHistograms)
+                {
+                    const Support::Vector<Common::F64>& upperBounds = histogram.second->getUpperBounds();
+                    Common::U64 cumulativeCount = 0;
+
+                    for (size_t bucket = 0; bucket <= upperBounds.size(); ++bucket)
+                    {
+                        cumulativeCount += histogram.second->getBucketCount(bucket);
+
+                        const Support::String bound = bucket < upperBounds.size() ? formatValue(upperBounds[bucket]) : "+Inf";
+                        result += name + "_bucket" + joinLabels(histogram.first, "le=\"" + bound + "\"") + " " + std::to_string(cumulativeCount) + "\n";
+                    }
+
+                    result += name + "_sum" + joinLabels(histogram.first, "") + " " + formatValue(histogram.second->getSum()) + "\n";
+                    result += name + "_count" + joinLabels(histogram.first, "") + " " + std::to_string(cumulativeCount) + "\n";
+                }
+            }
+
+            return result;
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
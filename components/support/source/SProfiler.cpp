@@ -9,110 +9,584 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+#include <support/Console.hpp>
 #include <support/SProfiler.hpp>
+#include <support/SAllocationTracker.hpp>
 
 namespace Kiaro
 {
     namespace Support
     {
-        static SProfiler* sInstance = nullptr;
+        //! The number of completed scopes each thread can buffer between aggregations. Must be a power of two.
+        static const Common::U64 sRingCapacity = 4096;
+
+        //! The number of slices the distribution window is split into.
+        static const size_t sDistributionSliceCount = 4;
+
+        static Support::Atomic<SProfiler*> sInstance(nullptr);
+        static Support::Mutex sInstanceMutex;
+
+        //! The generation handed to the next profiler created.
+        static Support::Atomic<Common::U64> sNextGeneration(1);
+
+        //! The names of every zone, indexed by zone ID.
+        static Support::Vector<Support::String> sZoneNames;
+        //! Maps zone names to their IDs.
+        static Support::UnorderedMap<Support::String, Common::U32> sZoneIDs;
+        //! Protects sZoneNames and sZoneIDs.
+        static Support::Mutex sZoneMutex;
+
+        /**
+         *  @brief The profiling state of a single thread. Only the owning thread touches mOpenScopes and writes
+         *  records, while aggregation only reads records, so the ring needs no lock.
+         */
+        struct SProfiler::ThreadBuffer
+        {
+            //! A scope that was begun but not ended yet.
+            struct OpenScope
+            {
+                Common::U32 mZone;
+                Common::U64 mPath;
+                Common::U64 mBeginCounter;
+                bool mRecursive;
+            };
+
+            //! The ring of completed scopes. Allocated with the first record, so threads that only have a name cost little.
+            Support::Vector<ZoneRecord> mRecords;
+
+            //! The number of records ever written. Only the owning thread changes this.
+            Support::Atomic<Common::U64> mWriteIndex;
+
+            //! The number of records ever aggregated. Only aggregation changes this.
+            Support::Atomic<Common::U64> mReadIndex;
+
+            //! The number of records dropped because the ring was full.
+            Support::Atomic<Common::U64> mDroppedCount;
+
+            //! The scopes of the owning thread that were not ended yet, innermost last.
+            Support::Vector<OpenScope> mOpenScopes;
+
+            //! The name of the owning thread in captures. Protected by the mMutex of the profiler.
+            Support::String mName;
+
+            //! Set once the owning thread exited, after which nothing writes to the buffer anymore.
+            Support::Atomic<bool> mRetired;
+
+            ThreadBuffer(void) : mWriteIndex(0), mReadIndex(0), mDroppedCount(0), mRetired(false)
+            {
+                mOpenScopes.reserve(64);
+            }
+        };
+
+        /**
+         *  @brief Retires the ring buffer of its thread as the thread exits. Buffers of profilers that were destroyed in
+         *  the meantime were already freed along with them, so those are left alone.
+         */
+        struct SProfiler::ThreadBufferOwner
+        {
+            ~ThreadBufferOwner(void)
+            {
+                std::lock_guard<Support::Mutex> lock(sInstanceMutex);
+                SProfiler* profiler = sInstance.load(std::memory_order_relaxed);
+
+                if (profiler && sThreadGeneration == profiler->mGeneration)
+                {
+                    sThreadBuffer->mRetired.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        const size_t SProfiler::sSpikeCapacity;
+
+        thread_local SProfiler::ThreadBuffer* SProfiler::sThreadBuffer = nullptr;
+        thread_local Common::U64 SProfiler::sThreadGeneration = 0;
+        thread_local SProfiler::ThreadBufferOwner SProfiler::sThreadBufferOwner;
+
+        //! Identifies the call path made of the given parent path and zone. Zero is reserved for having no parent.
+        static Common::U64 combinePath(const Common::U64 parentPath, const Common::U32 zone)
+        {
+            Common::U64 result = (parentPath ^ (zone + 1ULL)) * 0x9E3779B97F4A7C15ULL;
+            result ^= result >> 29;
+            return result ? result : 1;
+        }
 
         SProfiler* SProfiler::getPointer(const size_t sampleCount)
         {
-            if (!sInstance)
+            SProfiler* result = sInstance.load(std::memory_order_acquire);
+
+            if (!result)
             {
-                sInstance = new SProfiler(sampleCount);
+                std::lock_guard<Support::Mutex> lock(sInstanceMutex);
+                result = sInstance.load(std::memory_order_relaxed);
+
+                if (!result)
+                {
+                    result = new SProfiler(sampleCount);
+                    sInstance.store(result, std::memory_order_release);
+                }
             }
 
-            return sInstance;
+            return result;
         }
 
         void SProfiler::destroy(void)
         {
-            delete sInstance;
-            sInstance = nullptr;
+            std::lock_guard<Support::Mutex> lock(sInstanceMutex);
+
+            delete sInstance.load(std::memory_order_relaxed);
+            sInstance.store(nullptr, std::memory_order_release);
         }
 
-        SProfiler::SProfiler(const size_t sampleCount) : mSample(0), mSampleCount(sampleCount)
+        Common::U32 SProfiler::internZone(const Common::C8* name)
+        {
+            std::lock_guard<Support::Mutex> lock(sZoneMutex);
+
+            auto searchResult = sZoneIDs.find(name);
+            if (searchResult != sZoneIDs.end())
+            {
+                return searchResult->second;
+            }
+
+            const Common::U32 zone = static_cast<Common::U32>(sZoneNames.size());
+            sZoneNames.push_back(name);
+            sZoneIDs[name] = zone;
+            return zone;
+        }
+
+        Support::String SProfiler::getZoneName(const Common::U32 zone)
+        {
+            std::lock_guard<Support::Mutex> lock(sZoneMutex);
+
+            if (zone >= sZoneNames.size())
+            {
+                throw std::out_of_range("No such profiler zone!");
+            }
+
+            return sZoneNames[zone];
+        }
+
+        //! Writes the given text as the contents of a JSON string.
+        static void writeJSONString(FILE* handle, const Support::String& text)
+        {
+            for (const Common::C8 character : text)
+            {
+                if (character == '"' || character == '\\')
+                {
+                    fputc('\\', handle);
+                }
+
+                fputc(static_cast<unsigned char>(character) < 0x20 ? ' ' : character, handle);
+            }
+        }
+
+        SProfiler::SProfiler(const size_t sampleCount) : mGeneration(sNextGeneration.fetch_add(1)), mSample(0), mRetiredDroppedCount(0), mCaptureFramesLeft(0), mCapturing(false),
+        mFrame(0), mDistributionSlice(0), mDistributionSliceFrames(256), mDistributionSliceFramesLeft(256), mSpikeZone(0), mSpikeBudgetNanoseconds(0),
+        mSampleCount(sampleCount)
         {
             // Populate the set
             for (size_t iteration = 0; iteration < mSampleCount; ++iteration)
             {
-                mSamples.insert(mSamples.end(), Support::UnorderedMap<Support::String, Common::F32>());
+                mSamples.insert(mSamples.end(), Support::Vector<Common::F32>());
             }
+
+            mDistributionSlices.resize(sDistributionSliceCount);
         }
 
         SProfiler::~SProfiler(void)
         {
+            for (ThreadBuffer* buffer : mThreadBuffers)
+            {
+                delete buffer;
+            }
         }
 
-        void SProfiler::scopeBegin(const Support::String& name)
+        SProfiler::ThreadBuffer* SProfiler::getThreadBuffer(void)
         {
-            mSamples[mSample][name] = 0;
-            mSampleNames.insert(name);
+            if (sThreadGeneration == mGeneration)
+            {
+                return sThreadBuffer;
+            }
 
-            // If there's already a timer, we're in a bad situation
-            if (mTimers.find(name) != mTimers.end())
+            // First scope of this thread since this profiler was created
+            ThreadBuffer* buffer = new ThreadBuffer();
             {
-                throw std::runtime_error("Broken profiler scope!");
+                std::lock_guard<Support::Mutex> lock(mMutex);
+                mThreadBuffers.push_back(buffer);
             }
 
-            mTimers[name] = FTime::startTimer();
+            sThreadBuffer = buffer;
+            sThreadGeneration = mGeneration;
+
+            // Touching the owner registers its destructor with this thread
+            static_cast<void>(&sThreadBufferOwner);
+            return buffer;
         }
 
-        void SProfiler::scopeEnd(const Support::String& name)
+        void SProfiler::scopeBegin(const Common::U32 zone)
         {
-            auto it = mSamples[mSample].find(name);
+            ThreadBuffer* buffer = this->getThreadBuffer();
 
-            if (it != mSamples[mSample].end() && mTimers.find(name) != mTimers.end())
+            ThreadBuffer::OpenScope scope;
+            scope.mZone = zone;
+            scope.mPath = combinePath(buffer->mOpenScopes.empty() ? 0 : buffer->mOpenScopes.back().mPath, zone);
+            scope.mRecursive = false;
+
+            for (const ThreadBuffer::OpenScope& openScope : buffer->mOpenScopes)
             {
-                mSamples[mSample][name] = FTime::stopTimer(mTimers[name]);
-                mTimers.erase(name);
+                if (openScope.mZone == zone)
+                {
+                    scope.mRecursive = true;
+                    break;
+                }
             }
-            else // If we don't find anything here, we've got broken code somewhere
+
+            // Read the counter last so that the bookkeeping above is not measured
+            scope.mBeginCounter = FTime::readCounter();
+            buffer->mOpenScopes.push_back(scope);
+
+            // Allocations made from here on are made by this zone
+            if (SAllocationTracker::sEnabled)
+            {
+                SAllocationTracker::setThreadZone(zone);
+            }
+        }
+
+        void SProfiler::scopeEnd(const Common::U32 zone)
+        {
+            const Common::U64 endCounter = FTime::readCounter();
+            ThreadBuffer* buffer = this->getThreadBuffer();
+
+            // If the innermost scope is a different one, we've got broken code somewhere
+            if (buffer->mOpenScopes.empty() || buffer->mOpenScopes.back().mZone != zone)
             {
                 throw std::runtime_error("No such profiler context!");
             }
+
+            const ThreadBuffer::OpenScope scope = buffer->mOpenScopes.back();
+            buffer->mOpenScopes.pop_back();
+
+            if (SAllocationTracker::sEnabled)
+            {
+                SAllocationTracker::setThreadZone(buffer->mOpenScopes.empty() ? SAllocationTracker::sNoZone : buffer->mOpenScopes.back().mZone);
+            }
+
+            if (buffer->mRecords.empty())
+            {
+                buffer->mRecords.resize(sRingCapacity);
+            }
+
+            const Common::U64 writeIndex = buffer->mWriteIndex.load(std::memory_order_relaxed);
+            if (writeIndex - buffer->mReadIndex.load(std::memory_order_acquire) >= sRingCapacity)
+            {
+                buffer->mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            ZoneRecord& record = buffer->mRecords[writeIndex & (sRingCapacity - 1)];
+            record.mZone = zone;
+            record.mDepth = static_cast<Common::U32>(buffer->mOpenScopes.size());
+            record.mPath = scope.mPath;
+            record.mParentPath = buffer->mOpenScopes.empty() ? 0 : buffer->mOpenScopes.back().mPath;
+            record.mBeginCounter = scope.mBeginCounter;
+            record.mEndCounter = endCounter;
+            record.mRecursive = scope.mRecursive;
+
+            buffer->mWriteIndex.store(writeIndex + 1, std::memory_order_release);
         }
 
-        Common::F32 SProfiler::getSample(const Support::String& name, const size_t sample)
+        void SProfiler::scopeEndNoThrow(const Common::U32 zone)
         {
-            if (sample >= mSampleCount || mSamples[sample].find(name) == mSamples[sample].end())
+            try
             {
-                throw std::out_of_range("No such sample!");
+                ThreadBuffer* buffer = this->getThreadBuffer();
+
+                // Normally the innermost scope, unless scopes begun manually within it were skipped by an exception
+                size_t scopeCount = buffer->mOpenScopes.size();
+                while (scopeCount != 0 && buffer->mOpenScopes[scopeCount - 1].mZone != zone)
+                {
+                    --scopeCount;
+                }
+
+                if (scopeCount == 0)
+                {
+                    CONSOLE_ERRORF("SProfiler: Ended zone '%s', which has no open scope.", getZoneName(zone).data());
+                    return;
+                }
+
+                const size_t discardedCount = buffer->mOpenScopes.size() - scopeCount;
+                buffer->mOpenScopes.erase(buffer->mOpenScopes.begin() + scopeCount, buffer->mOpenScopes.end());
+                this->scopeEnd(zone);
+
+                if (discardedCount != 0)
+                {
+                    CONSOLE_ERRORF("SProfiler: Ended zone '%s' with %u scopes nested in it still open, discarding them.", getZoneName(zone).data(),
+                                   static_cast<Common::U32>(discardedCount));
+                }
             }
+            catch (...)
+            {
+                // Running out of memory here leaves nothing to report it with
+            }
+        }
 
-            return mSamples[sample][name];
+        void SProfiler::abandonScopes(void)
+        {
+            this->getThreadBuffer()->mOpenScopes.clear();
+
+            if (SAllocationTracker::sEnabled)
+            {
+                SAllocationTracker::setThreadZone(SAllocationTracker::sNoZone);
+            }
         }
 
-        Common::F32 SProfiler::getAverage(const Support::String& name)
+        void SProfiler::aggregate(void)
         {
-            if(mSampleNames.find(name) == mSampleNames.end())
+            Support::Vector<Common::F32>& sample = mSamples[mSample];
+
+            for (size_t threadIndex = 0; threadIndex < mThreadBuffers.size();)
             {
-                throw std::out_of_range("No such sample!");
+                ThreadBuffer* buffer = mThreadBuffers[threadIndex];
+
+                // Read before the write index, so that every record of a retired buffer is seen below
+                const bool retired = buffer->mRetired.load(std::memory_order_acquire);
+                const Common::U64 writeIndex = buffer->mWriteIndex.load(std::memory_order_acquire);
+
+                for (Common::U64 readIndex = buffer->mReadIndex.load(std::memory_order_relaxed); readIndex < writeIndex; ++readIndex)
+                {
+                    const ZoneRecord& record = buffer->mRecords[readIndex & (sRingCapacity - 1)];
+                    const Common::U64 nanoseconds = FTime::counterToNanoseconds(record.mEndCounter - record.mBeginCounter);
+
+                    if (mCapturing)
+                    {
+                        CapturedRecord captured;
+                        captured.mThreadIndex = static_cast<Common::U32>(threadIndex);
+                        captured.mRecord = record;
+                        mCapturedRecords.push_back(captured);
+                    }
+
+                    PathStatistics& statistics = mPaths[record.mPath];
+                    statistics.mZone = record.mZone;
+                    statistics.mDepth = record.mDepth;
+                    statistics.mParentPath = record.mParentPath;
+                    ++statistics.mCallCount;
+                    statistics.mTotalNanoseconds += nanoseconds;
+
+                    // The parent completes after its children, so its entry may not exist yet
+                    if (record.mParentPath)
+                    {
+                        mPaths[record.mParentPath].mChildNanoseconds += nanoseconds;
+                    }
+
+                    if (mSpikeBudgetNanoseconds)
+                    {
+                        PathStatistics& frameStatistics = mFramePaths[record.mPath];
+                        frameStatistics.mZone = record.mZone;
+                        frameStatistics.mDepth = record.mDepth;
+                        frameStatistics.mParentPath = record.mParentPath;
+                        ++frameStatistics.mCallCount;
+                        frameStatistics.mTotalNanoseconds += nanoseconds;
+
+                        if (record.mParentPath)
+                        {
+                            mFramePaths[record.mParentPath].mChildNanoseconds += nanoseconds;
+                        }
+                    }
+
+                    // Recursive scopes are already contained in the time of the outer scope
+                    if (record.mRecursive)
+                    {
+                        continue;
+                    }
+
+                    if (record.mZone >= sample.size())
+                    {
+                        sample.resize(record.mZone + 1, -1.0f);
+                    }
+
+                    if (record.mZone >= mFrameNanoseconds.size())
+                    {
+                        mFrameNanoseconds.resize(record.mZone + 1, 0);
+                    }
+
+                    mFrameNanoseconds[record.mZone] += nanoseconds;
+
+                    if (sample[record.mZone] < 0.0f)
+                    {
+                        sample[record.mZone] = 0.0f;
+                        mSampleNames.insert(getZoneName(record.mZone));
+                    }
+
+                    sample[record.mZone] += static_cast<Common::F32>(nanoseconds) / 1000000000.0f;
+                }
+
+                buffer->mReadIndex.store(writeIndex, std::memory_order_release);
+
+                // Captured records refer to threads by index, so exited threads stay until the capture is written
+                if (retired && !mCapturing)
+                {
+                    mRetiredDroppedCount += buffer->mDroppedCount.load(std::memory_order_relaxed);
+                    mThreadBuffers.erase(mThreadBuffers.begin() + threadIndex);
+                    delete buffer;
+                    continue;
+                }
+
+                ++threadIndex;
             }
+        }
 
+        bool SProfiler::findProfiledZone(const Support::String& name, Common::U32& zone)
+        {
+            if (mSampleNames.find(name) == mSampleNames.end())
+            {
+                return false;
+            }
+
+            std::lock_guard<Support::Mutex> lock(sZoneMutex);
+            zone = sZoneIDs[name];
+            return true;
+        }
+
+        Common::F32 SProfiler::calculateAverage(const Common::U32 zone)
+        {
             Common::F32 sampleSum = 0;
+            size_t recordedSamples = 0;
+
             for (size_t iteration = 0; iteration < mSampleCount; iteration++)
             {
-                sampleSum += mSamples[iteration][name];
+                const Support::Vector<Common::F32>& sample = mSamples[iteration];
+
+                if (zone < sample.size() && sample[zone] >= 0.0f)
+                {
+                    sampleSum += sample[zone];
+                    ++recordedSamples;
+                }
+            }
+
+            return recordedSamples ? sampleSum / recordedSamples : 0.0f;
+        }
+
+        Common::F32 SProfiler::getSample(const Support::String& name, const size_t sample)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
+            Common::U32 zone = 0;
+            if (sample >= mSampleCount || !this->findProfiledZone(name, zone) || zone >= mSamples[sample].size() || mSamples[sample][zone] < 0.0f)
+            {
+                throw std::out_of_range("No such sample!");
+            }
+
+            return mSamples[sample][zone];
+        }
+
+        Common::F32 SProfiler::getAverage(const Support::String& name)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
+            Common::U32 zone = 0;
+            if (!this->findProfiledZone(name, zone))
+            {
+                throw std::out_of_range("No such sample!");
             }
 
-            return sampleSum / mSampleCount;
+            return this->calculateAverage(zone);
         }
 
         const Support::UnorderedSet<Support::String>& SProfiler::getSampleNames(void)
         {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
             return mSampleNames;
         }
 
         Support::Set<std::pair<Support::String, Common::F32>> SProfiler::getSampleAverages(void)
         {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
             Support::Set<std::pair<Support::String, Common::F32>> result;
 
-            for (const std::string& name: mSampleNames)
+            for (const Support::String& name: mSampleNames)
             {
-                result.insert(std::make_pair(name, this->getAverage(name)));
+                Common::U32 zone = 0;
+                this->findProfiledZone(name, zone);
+                result.insert(std::make_pair(name, this->calculateAverage(zone)));
+            }
+
+            return result;
+        }
+
+        Support::Vector<SProfiler::HierarchyNode> SProfiler::getHierarchy(void)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
+            return buildHierarchy(mPaths);
+        }
+
+        Support::Vector<SProfiler::HierarchyNode> SProfiler::buildHierarchy(Support::UnorderedMap<Common::U64, PathStatistics>& paths)
+        {
+            // Paths that were only seen as parents had their own scope dropped, so they and their children are left out
+            Support::UnorderedMap<Common::U64, Support::Vector<Common::U64>> children;
+            for (auto&& path : paths)
+            {
+                if (path.second.mCallCount)
+                {
+                    children[path.second.mParentPath].push_back(path.first);
+                }
+            }
+
+            for (auto&& siblings : children)
+            {
+                std::sort(siblings.second.begin(), siblings.second.end(), [&paths](const Common::U64 lhs, const Common::U64 rhs)
+                {
+                    return paths[lhs].mTotalNanoseconds > paths[rhs].mTotalNanoseconds;
+                });
+            }
+
+            Support::Vector<HierarchyNode> result;
+            Support::Vector<Common::U64> pending(children[0].rbegin(), children[0].rend());
+
+            while (!pending.empty())
+            {
+                const Common::U64 path = pending.back();
+                pending.pop_back();
+
+                const PathStatistics& statistics = paths[path];
+
+                HierarchyNode node;
+                node.mName = getZoneName(statistics.mZone);
+                node.mDepth = statistics.mDepth;
+                node.mCallCount = statistics.mCallCount;
+                node.mTotalSeconds = statistics.mTotalNanoseconds / 1000000000.0;
+                node.mSelfSeconds = (statistics.mTotalNanoseconds - std::min(statistics.mChildNanoseconds, statistics.mTotalNanoseconds)) / 1000000000.0;
+                result.push_back(node);
+
+                auto searchResult = children.find(path);
+                if (searchResult != children.end())
+                {
+                    pending.insert(pending.end(), searchResult->second.rbegin(), searchResult->second.rend());
+                }
+            }
+
+            return result;
+        }
+
+        Common::U64 SProfiler::getDroppedRecordCount(void)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+
+            Common::U64 result = mRetiredDroppedCount;
+            for (ThreadBuffer* buffer : mThreadBuffers)
+            {
+                result += buffer->mDroppedCount.load(std::memory_order_relaxed);
             }
 
             return result;
@@ -120,7 +594,288 @@ namespace Kiaro
 
         void SProfiler::update(void)
         {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+            this->finishFrame();
+
+            // Allocation rates are measured per frame as well
+            if (SAllocationTracker::sEnabled)
+            {
+                SAllocationTracker::update();
+            }
+
             ++mSample %= mSampleCount;
+            std::fill(mSamples[mSample].begin(), mSamples[mSample].end(), -1.0f);
+
+            // Captures start on a frame boundary, so the first frame recorded is complete
+            if (mCaptureFramesLeft != 0 && !mCapturing)
+            {
+                mCapturing = true;
+            }
+            else if (mCapturing && --mCaptureFramesLeft == 0)
+            {
+                mCapturing = false;
+                this->writeCapture();
+                mCapturedRecords.clear();
+                mCapturedRecords.shrink_to_fit();
+            }
+        }
+
+        void SProfiler::finishFrame(void)
+        {
+            const Support::Vector<Common::F32>& sample = mSamples[mSample];
+            Support::Vector<CLatencyHistogram>& slice = mDistributionSlices[mDistributionSlice];
+
+            for (size_t zone = 0; zone < sample.size(); ++zone)
+            {
+                if (sample[zone] < 0.0f)
+                {
+                    continue;
+                }
+
+                if (zone >= slice.size())
+                {
+                    slice.resize(zone + 1);
+                }
+
+                slice[zone].record(mFrameNanoseconds[zone]);
+            }
+
+            if (mSpikeBudgetNanoseconds && mSpikeZone < mFrameNanoseconds.size() && mFrameNanoseconds[mSpikeZone] > mSpikeBudgetNanoseconds)
+            {
+                Spike spike;
+                spike.mFrame = mFrame;
+                spike.mSeconds = mFrameNanoseconds[mSpikeZone] / 1000000000.0;
+                spike.mBreakdown = buildHierarchy(mFramePaths);
+
+                CONSOLE_WARNINGF("SProfiler: Frame %llu spent %.2f ms in '%s', over its budget of %.2f ms.", static_cast<unsigned long long>(mFrame),
+                                 spike.mSeconds * 1000.0, getZoneName(mSpikeZone).data(), mSpikeBudgetNanoseconds / 1000000.0);
+
+                mSpikes.push_back(spike);
+                if (mSpikes.size() > sSpikeCapacity)
+                {
+                    mSpikes.pop_front();
+                }
+            }
+
+            mFramePaths.clear();
+            std::fill(mFrameNanoseconds.begin(), mFrameNanoseconds.end(), 0);
+            ++mFrame;
+
+            // Once the current slice is full, the oldest one is discarded to make room for the next frames
+            if (--mDistributionSliceFramesLeft == 0)
+            {
+                mDistributionSlice = (mDistributionSlice + 1) % sDistributionSliceCount;
+                mDistributionSliceFramesLeft = mDistributionSliceFrames;
+
+                for (CLatencyHistogram& histogram : mDistributionSlices[mDistributionSlice])
+                {
+                    histogram.clear();
+                }
+            }
+        }
+
+        SProfiler::ZoneDistribution SProfiler::calculateDistribution(const Common::U32 zone)
+        {
+            CLatencyHistogram histogram;
+            for (const Support::Vector<CLatencyHistogram>& slice : mDistributionSlices)
+            {
+                if (zone < slice.size())
+                {
+                    histogram.merge(slice[zone]);
+                }
+            }
+
+            ZoneDistribution result;
+            result.mName = getZoneName(zone);
+            result.mFrameCount = histogram.getCount();
+            result.mMedianSeconds = histogram.getPercentile(50.0) / 1000000000.0;
+            result.mP95Seconds = histogram.getPercentile(95.0) / 1000000000.0;
+            result.mP99Seconds = histogram.getPercentile(99.0) / 1000000000.0;
+            result.mMaxSeconds = histogram.getMaximum() / 1000000000.0;
+            return result;
+        }
+
+        void SProfiler::setDistributionWindow(const Common::U32 frameCount)
+        {
+            if (frameCount == 0)
+            {
+                throw std::logic_error("SProfiler: The distribution window must cover at least one frame.");
+            }
+
+            std::lock_guard<Support::Mutex> lock(mMutex);
+
+            mDistributionSliceFrames = std::max<Common::U32>(1, frameCount / sDistributionSliceCount);
+            mDistributionSliceFramesLeft = mDistributionSliceFrames;
+
+            for (Support::Vector<CLatencyHistogram>& slice : mDistributionSlices)
+            {
+                slice.clear();
+            }
+        }
+
+        SProfiler::ZoneDistribution SProfiler::getDistribution(const Support::String& name)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
+            Common::U32 zone = 0;
+            if (!this->findProfiledZone(name, zone))
+            {
+                throw std::out_of_range("No such sample!");
+            }
+
+            const ZoneDistribution result = this->calculateDistribution(zone);
+            if (result.mFrameCount == 0)
+            {
+                throw std::out_of_range("No such sample!");
+            }
+
+            return result;
+        }
+
+        Support::Vector<SProfiler::ZoneDistribution> SProfiler::getDistributions(void)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
+            Support::Vector<ZoneDistribution> result;
+            for (const Support::String& name : mSampleNames)
+            {
+                Common::U32 zone = 0;
+                this->findProfiledZone(name, zone);
+
+                const ZoneDistribution distribution = this->calculateDistribution(zone);
+                if (distribution.mFrameCount != 0)
+                {
+                    result.push_back(distribution);
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const ZoneDistribution& lhs, const ZoneDistribution& rhs)
+            {
+                return lhs.mP99Seconds > rhs.mP99Seconds;
+            });
+
+            return result;
+        }
+
+        void SProfiler::setSpikeBudget(const Support::String& name, const Common::F32 budgetSeconds)
+        {
+            // The zone may well not have been profiled yet, so it is interned here
+            const Common::U32 zone = internZone(name.data());
+
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            this->aggregate();
+
+            mSpikeZone = zone;
+            mSpikeBudgetNanoseconds = budgetSeconds > 0.0f ? static_cast<Common::U64>(static_cast<Common::F64>(budgetSeconds) * 1000000000.0) : 0;
+            mFramePaths.clear();
+        }
+
+        Support::Vector<SProfiler::Spike> SProfiler::getSpikes(void)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            return Support::Vector<Spike>(mSpikes.begin(), mSpikes.end());
+        }
+
+        void SProfiler::clearSpikes(void)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            mSpikes.clear();
+        }
+
+        void SProfiler::setThreadName(const Support::String& name)
+        {
+            ThreadBuffer* buffer = this->getThreadBuffer();
+
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            buffer->mName = name;
+        }
+
+        bool SProfiler::beginCapture(const Common::U32 frameCount, const Support::String& path)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+
+            if (mCaptureFramesLeft != 0 || frameCount == 0)
+            {
+                return false;
+            }
+
+            mCaptureFramesLeft = frameCount;
+            mCapturePath = path;
+            return true;
+        }
+
+        bool SProfiler::isCapturing(void)
+        {
+            std::lock_guard<Support::Mutex> lock(mMutex);
+            return mCaptureFramesLeft != 0;
+        }
+
+        bool SProfiler::writeCapture(void)
+        {
+            FILE* handle = fopen(mCapturePath.data(), "w");
+
+            if (!handle)
+            {
+                CONSOLE_ERRORF("SProfiler: Failed to open '%s' for writing the capture.", mCapturePath.data());
+                return false;
+            }
+
+            // Timestamps are relative to the earliest scope, as the counter has no meaningful origin
+            Common::U64 baseCounter = std::numeric_limits<Common::U64>::max();
+            for (const CapturedRecord& captured : mCapturedRecords)
+            {
+                baseCounter = std::min(baseCounter, captured.mRecord.mBeginCounter);
+            }
+
+            fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", handle);
+
+            for (size_t threadIndex = 0; threadIndex < mThreadBuffers.size(); ++threadIndex)
+            {
+                const Support::String& name = mThreadBuffers[threadIndex]->mName;
+
+                fprintf(handle, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", threadIndex == 0 ? "" : ",",
+                        static_cast<Common::U32>(threadIndex));
+
+                if (name.empty())
+                {
+                    fprintf(handle, "Thread %u", static_cast<Common::U32>(threadIndex));
+                }
+                else
+                {
+                    writeJSONString(handle, name);
+                }
+
+                fputs("\"}}", handle);
+            }
+
+            for (const CapturedRecord& captured : mCapturedRecords)
+            {
+                const Common::U64 beginNanoseconds = FTime::counterToNanoseconds(captured.mRecord.mBeginCounter - baseCounter);
+                const Common::U64 durationNanoseconds = FTime::counterToNanoseconds(captured.mRecord.mEndCounter - captured.mRecord.mBeginCounter);
+
+                fputs(",\n{\"name\":\"", handle);
+                writeJSONString(handle, getZoneName(captured.mRecord.mZone));
+                fprintf(handle, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", captured.mThreadIndex, beginNanoseconds / 1000.0,
+                        durationNanoseconds / 1000.0);
+            }
+
+            fputs("\n]}\n", handle);
+            const bool result = ferror(handle) == 0;
+            fclose(handle);
+
+            if (result)
+            {
+                CONSOLE_INFOF("SProfiler: Wrote %u scopes to '%s'.", static_cast<Common::U32>(mCapturedRecords.size()), mCapturePath.data());
+            }
+            else
+            {
+                CONSOLE_ERRORF("SProfiler: Failed to write the capture to '%s'.", mCapturePath.data());
+            }
+
+            return result;
         }
     } // End NameSpace Support
 } // End nameSpace Kiaro
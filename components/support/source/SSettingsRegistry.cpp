@@ -9,6 +9,8 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <algorithm>
+
 #include <allegro5/allegro.h>
 
 #include <support/Console.hpp>
@@ -17,6 +19,7 @@
 #include <support/support.hpp>
 
 #include <support/SSettingsRegistry.hpp>
+#include <support/platform/thread.hpp>
 
 namespace Kiaro
 {
@@ -29,12 +32,23 @@ namespace Kiaro
             this->setValue<Common::U16>("Server::ListenPort", 11595);
             this->setValue<Common::U32>("Server::MaximumClientCount", 32);
             this->setValue<Common::U32>("Server::MessagesPerTick", 8);
-            this->setValue<Common::U32>("Server::MaxQueuedStreams", 3);
+            this->setValue<Common::U32>("Server::MaxQueuedStreams", 32);
+            this->setValue<Common::U32>("Server::MaxQueuedBytes", 65536);
 
             this->setValue<Common::U32>("Server::MaxOutgoingBandwidth", 0);
             this->setValue<Common::U32>("Server::MaxIncomingBandwidth", 0);
             this->setValue<Common::U32>("Server::DatablocksPerTick", 16);
 
+            // Network Condition Simulator
+            this->setValue<bool>("NetSimulator::Enabled", false);
+            this->setValue<Common::U32>("NetSimulator::LatencyMS", 0);
+            this->setValue<Common::U32>("NetSimulator::JitterMS", 0);
+            this->setValue<Common::U32>("NetSimulator::LossPercent", 0);
+            this->setValue<Common::U32>("NetSimulator::DuplicatePercent", 0);
+            this->setValue<Common::U32>("NetSimulator::ReorderPercent", 0);
+            this->setValue<Common::U32>("NetSimulator::Bandwidth", 0);
+            this->setValue<Common::U32>("NetSimulator::Seed", 1337);
+
             // Video
             this->setValue<bool>("Video::Fullscreen", false);
             this->setValue<Support::Dimension2DU>("Video::Resolution", Support::Dimension2DU(640, 480));
@@ -42,11 +56,31 @@ namespace Kiaro
             this->setValue<Common::U16>("Video::InactiveFPS", 15);
 
             // Internal System
-            this->setValue<Common::U8>("System::WorkerThreadCount", 6);
-            this->setValue<Common::U8>("System::RuntimeThreadCount", 6);
+            // Thread counts follow the hardware: the runtime workers get every physical core but the one the main thread
+            // runs on and a few workers are left for loading, which mostly waits on IO.
+            const Platform::Thread::ProcessorTopology& topology = Platform::Thread::getProcessorTopology();
+            const Common::U32 runtimeThreadCount = std::min<Common::U32>(255, std::max<Common::U32>(1, topology.mPhysicalCoreCount - 1));
+            const Common::U32 workerThreadCount = std::min<Common::U32>(4, std::max<Common::U32>(1, static_cast<Common::U32>(topology.mCores.size()) / 4));
+
+            this->setValue<Common::U8>("System::WorkerThreadCount", static_cast<Common::U8>(workerThreadCount));
+            this->setValue<Common::U8>("System::RuntimeThreadCount", static_cast<Common::U8>(runtimeThreadCount));
+            this->setValue<Common::U8>("System::WorkerThreadAffinity", Platform::Thread::AFFINITY_NONE);
+            this->setValue<Common::U8>("System::RuntimeThreadAffinity", Platform::Thread::AFFINITY_NONE);
+            this->setValue<Common::U32>("System::ShutdownTimeoutMS", 2000);
+            this->setValue<Common::U32>("System::MaxCatchUpSteps", 5);
             this->setValue<Common::U32>("System::ArenaAllocationSize", 256);
             this->setValue<bool>("System::ManagementConsoleEnabled", true);
             this->setValue("System::ManagementConsoleBind", Support::String("127.0.0.1"));
+            this->setValue<Common::U16>("System::ManagementConsolePort", 11596);
+            this->setValue<bool>("System::MetricsEnabled", false);
+            this->setValue("System::MetricsBind", Support::String("127.0.0.1"));
+            this->setValue<Common::U16>("System::MetricsPort", 11597);
+
+            // Profiler
+            this->setValue<Common::U32>("Profiler::CaptureFrames", 120);
+            this->setValue("Profiler::CapturePath", Support::String("profile.json"));
+            this->setValue<Common::U32>("Profiler::DistributionFrames", 1024);
+            this->setValue<Common::U32>("Profiler::SpikeBudgetMS", 50);
         }
 
         SSettingsRegistry::SSettingsRegistry(void)
@@ -133,10 +167,15 @@ namespace Kiaro
 
                 // Max queued streams
                 sprintf(tempBuffer, "%u", this->getValue<Common::U32>("Server::MaxQueuedStreams"));
-                al_add_config_comment(config, "Server", "MaxQueuedStreams specifies the maximum number of queued message streams for clients before we disconnect them.");
-                al_add_config_comment(config, "Server", "If zero, then no limit is enforced.");
+                al_add_config_comment(config, "Server", "MaxQueuedStreams specifies the maximum number of received packets buffered per client before we disconnect them.");
+                al_add_config_comment(config, "Server", "If zero, then there is no limit besides MaxQueuedBytes.");
                 al_set_config_value(config, "Server", "MaxQueuedStreams", tempBuffer);
 
+                // Max queued bytes
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("Server::MaxQueuedBytes"));
+                al_add_config_comment(config, "Server", "MaxQueuedBytes specifies the maximum number of received bytes buffered per client before we disconnect them.");
+                al_set_config_value(config, "Server", "MaxQueuedBytes", tempBuffer);
+
                 // Max outgoing bandwidth
                 sprintf(tempBuffer, "%u", this->getValue<Common::U32>("Server::MaxOutgoingBandwidth"));
                 al_add_config_comment(config, "Server", "MaxOutgoingBandwidth specifies the maximum outgoing bandwidth the game server will use. This is specified in bytes/second.");
@@ -149,6 +188,41 @@ namespace Kiaro
                 al_add_config_comment(config, "Server", "If zero, then no limit is enforced.");
                 al_set_config_value(config, "Server", "MaxIncomingBandwidth", tempBuffer);
 
+                // Write network condition simulator configuration
+                al_add_config_section(config, "NetSimulator");
+                al_add_config_comment(config, "NetSimulator", "Configuration values for the network condition simulator, which impairs local traffic for testing purposes");
+                al_add_config_comment(config, "NetSimulator", "Enabled controls whether or not any impairment is applied. This should never be enabled in production");
+                al_set_config_value(config, "NetSimulator", "Enabled", this->getValue<bool>("NetSimulator::Enabled") ? "1" : "0");
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("NetSimulator::LatencyMS"));
+                al_add_config_comment(config, "NetSimulator", "LatencyMS specifies the delay in milliseconds added to every packet in each direction.");
+                al_set_config_value(config, "NetSimulator", "LatencyMS", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("NetSimulator::JitterMS"));
+                al_add_config_comment(config, "NetSimulator", "JitterMS specifies the maximum random delay in milliseconds added on top of LatencyMS.");
+                al_set_config_value(config, "NetSimulator", "JitterMS", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("NetSimulator::LossPercent"));
+                al_add_config_comment(config, "NetSimulator", "LossPercent specifies the chance in percent that a packet is lost. Lost reliable packets are delayed by a retransmission instead.");
+                al_set_config_value(config, "NetSimulator", "LossPercent", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("NetSimulator::DuplicatePercent"));
+                al_add_config_comment(config, "NetSimulator", "DuplicatePercent specifies the chance in percent that an unreliable packet is delivered twice.");
+                al_set_config_value(config, "NetSimulator", "DuplicatePercent", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("NetSimulator::ReorderPercent"));
+                al_add_config_comment(config, "NetSimulator", "ReorderPercent specifies the chance in percent that an unreliable packet is held back and delivered out of order.");
+                al_set_config_value(config, "NetSimulator", "ReorderPercent", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("NetSimulator::Bandwidth"));
+                al_add_config_comment(config, "NetSimulator", "Bandwidth specifies the maximum throughput in each direction. This is specified in bytes/second.");
+                al_add_config_comment(config, "NetSimulator", "If zero, then no limit is enforced.");
+                al_set_config_value(config, "NetSimulator", "Bandwidth", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("NetSimulator::Seed"));
+                al_add_config_comment(config, "NetSimulator", "Seed specifies the random seed so that impairments are reproducible between runs.");
+                al_set_config_value(config, "NetSimulator", "Seed", tempBuffer);
+
                 // Write video section-----------------------
                 al_add_config_section(config, "Video");
                 al_add_config_comment(config, "Video", "Video output configuration");
@@ -186,6 +260,27 @@ namespace Kiaro
                 al_add_config_comment(config, "System", "RuntimeThreadCount dictates how many worker threads will be used for the engine runtime.");
                 al_set_config_value(config, "System", "RuntimeThreadCount", tempBuffer);
 
+                // Thread Affinity
+                sprintf(tempBuffer, "%u", this->getValue<Common::U8>("System::WorkerThreadAffinity"));
+                al_add_config_comment(config, "System", "WorkerThreadAffinity and RuntimeThreadAffinity dictate how the threads of either pool are pinned to cores.");
+                al_add_config_comment(config, "System", "0 leaves placement to the operating system, 1 pins every thread to its own core and 2 pins every thread to a NUMA node.");
+                al_add_config_comment(config, "System", "Runtime threads are placed starting at the first cores or nodes and worker threads starting at the last ones.");
+                al_set_config_value(config, "System", "WorkerThreadAffinity", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U8>("System::RuntimeThreadAffinity"));
+                al_set_config_value(config, "System", "RuntimeThreadAffinity", tempBuffer);
+
+                // Shutdown Timeout
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("System::ShutdownTimeoutMS"));
+                al_add_config_comment(config, "System", "ShutdownTimeoutMS dictates how long the engine lets its threads finish their work when shutting down before abandoning it.");
+                al_set_config_value(config, "System", "ShutdownTimeoutMS", tempBuffer);
+
+                // Max Catch Up Steps
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("System::MaxCatchUpSteps"));
+                al_add_config_comment(config, "System", "MaxCatchUpSteps dictates how many simulation ticks may run in a single frame to catch up after a stall.");
+                al_add_config_comment(config, "System", "Any ticks beyond that are dropped, slowing the simulation down rather than stalling the following frames too.");
+                al_set_config_value(config, "System", "MaxCatchUpSteps", tempBuffer);
+
                 sprintf(tempBuffer, "%u", this->getValue<Common::U32>("System::ArenaAllocationSize"));
                 al_add_config_comment(config, "System", "ArenaAllocationSize is an experimental feature.");
                 al_set_config_value(config, "System", "ArenaAllocationSize", tempBuffer);
@@ -194,8 +289,45 @@ namespace Kiaro
                 al_set_config_value(config, "System", "ManagementConsoleEnabled", this->getValue<bool>("System::ManagementConsoleEnabled") ? "1" : "0");
 
                 al_add_config_comment(config, "System", "ManagementConsoleBind specifies what the management console will bind to, if enabled.");
+                al_add_config_comment(config, "System", "The management console needs POSIX sockets; on Windows it logs an error and stays off.");
+                al_add_config_comment(config, "System", "Use unix:<path> to listen on a Unix domain socket only the engine's user can open instead.");
                 al_set_config_value(config, "System", "ManagementConsoleBind", this->getValue<Support::String>("System::ManagementConsoleBind").data());
 
+                sprintf(tempBuffer, "%u", this->getValue<Common::U16>("System::ManagementConsolePort"));
+                al_add_config_comment(config, "System", "ManagementConsolePort specifies what TCP port the management console will listen on, if enabled.");
+                al_set_config_value(config, "System", "ManagementConsolePort", tempBuffer);
+
+                al_add_config_comment(config, "System", "MetricsEnabled serves Prometheus compatible metrics over HTTP at /metrics, for monitoring dedicated servers.");
+                al_set_config_value(config, "System", "MetricsEnabled", this->getValue<bool>("System::MetricsEnabled") ? "1" : "0");
+
+                al_add_config_comment(config, "System", "MetricsBind specifies what IPv4 address the metrics endpoint will bind to, if enabled.");
+                al_add_config_comment(config, "System", "The metrics endpoint needs POSIX sockets; on Windows it logs an error and stays off.");
+                al_set_config_value(config, "System", "MetricsBind", this->getValue<Support::String>("System::MetricsBind").data());
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U16>("System::MetricsPort"));
+                al_add_config_comment(config, "System", "MetricsPort specifies what port the metrics endpoint will listen on, if enabled.");
+                al_set_config_value(config, "System", "MetricsPort", tempBuffer);
+
+                // Write profiler section--------------------
+                al_add_config_section(config, "Profiler");
+                al_add_config_comment(config, "Profiler", "Configuration values for profiler captures, which are requested with the 'profile' console command or SIGUSR1.");
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("Profiler::CaptureFrames"));
+                al_add_config_comment(config, "Profiler", "CaptureFrames specifies how many frames a capture records when the request does not say otherwise.");
+                al_set_config_value(config, "Profiler", "CaptureFrames", tempBuffer);
+
+                al_add_config_comment(config, "Profiler", "CapturePath specifies the file captures are written to. They can be opened with chrome://tracing or the Perfetto UI.");
+                al_set_config_value(config, "Profiler", "CapturePath", this->getValue<Support::String>("Profiler::CapturePath").data());
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("Profiler::DistributionFrames"));
+                al_add_config_comment(config, "Profiler", "DistributionFrames specifies how many of the most recent frames the perf stat percentiles cover.");
+                al_set_config_value(config, "Profiler", "DistributionFrames", tempBuffer);
+
+                sprintf(tempBuffer, "%u", this->getValue<Common::U32>("Profiler::SpikeBudgetMS"));
+                al_add_config_comment(config, "Profiler", "SpikeBudgetMS specifies how long the work of a single frame may take before the frame is kept as a spike, listed by the 'spikes' console command.");
+                al_add_config_comment(config, "Profiler", "If zero, then no spikes are kept.");
+                al_set_config_value(config, "Profiler", "SpikeBudgetMS", tempBuffer);
+
                 // We're done
                 al_save_config_file("config.cfg", config);
                 al_destroy_config(config);
@@ -269,7 +401,13 @@ namespace Kiaro
         {
             // Does an entry exist?
             auto searchResult = mStoredProperties.find(name);
-            if (searchResult != mStoredProperties.end() && ((*searchResult).second.second) == Support::PROPERTY_STRING)
+            if (searchResult == mStoredProperties.end())
+            {
+                CONSOLE_ERRORF("No such setting key: '%s'.", name.data());
+                return;
+            }
+
+            if (((*searchResult).second.second) == Support::PROPERTY_STRING)
             {
                 this->setValue<Support::String>(name, value);
                 return;
@@ -372,5 +510,60 @@ namespace Kiaro
                 }
             }
         }
+
+        Support::String SSettingsRegistry::getStringValue(const Support::String& name)
+        {
+            auto searchResult = mStoredProperties.find(name);
+            if (searchResult == mStoredProperties.end())
+            {
+                throw std::runtime_error("SSettingsRegistry: No such setting key: " + name);
+            }
+
+            void* value = searchResult->second.first;
+            Common::C8 tempBuffer[64];
+
+            switch (searchResult->second.second)
+            {
+                case Support::PROPERTY_BOOL:
+                    return *reinterpret_cast<bool*>(value) ? "1" : "0";
+
+                case Support::PROPERTY_STRING:
+                    return *reinterpret_cast<Support::String*>(value);
+
+                case Support::PROPERTY_F32:
+                    sprintf(tempBuffer, "%f", *reinterpret_cast<Common::F32*>(value));
+                    return tempBuffer;
+
+                case Support::PROPERTY_F64:
+                    sprintf(tempBuffer, "%f", *reinterpret_cast<Common::F64*>(value));
+                    return tempBuffer;
+
+                case Support::PROPERTY_U8:
+                    sprintf(tempBuffer, "%u", *reinterpret_cast<Common::U8*>(value));
+                    return tempBuffer;
+
+                case Support::PROPERTY_U16:
+                    sprintf(tempBuffer, "%u", *reinterpret_cast<Common::U16*>(value));
+                    return tempBuffer;
+
+                case Support::PROPERTY_U32:
+                    sprintf(tempBuffer, "%u", *reinterpret_cast<Common::U32*>(value));
+                    return tempBuffer;
+
+                case Support::PROPERTY_U64:
+                    sprintf(tempBuffer, "%llu", static_cast<unsigned long long>(*reinterpret_cast<Common::U64*>(value)));
+                    return tempBuffer;
+
+                case Support::PROPERTY_DIMENSION:
+                {
+                    const Support::Dimension2DU& dimension = *reinterpret_cast<Support::Dimension2DU*>(value);
+                    sprintf(tempBuffer, "%ux%u", dimension.x, dimension.y);
+                    return tempBuffer;
+                }
+
+                default:
+                    return "<unknown type>";
+            }
+        }
     } // End NameSpace Core
 } // End NameSpace Kiaro
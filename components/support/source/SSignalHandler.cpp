@@ -44,12 +44,22 @@ namespace Kiaro
             }
         }
 
+        static void handleProfileCapture(int signal)
+        {
+            SSignalHandler* handler = SSignalHandler::getPointer();
+            if (handler->mSignalHandlers.find(SSignalHandler::SignalType::ProfileCapture) != handler->mSignalHandlers.end())
+            {
+                handler->mSignalHandlers[SSignalHandler::SignalType::ProfileCapture]->invoke();
+            }
+        }
+
         SSignalHandler::SSignalHandler(void)
         {
             signal(SIGINT, handleProcessTermination);
             signal(SIGTERM, handleProcessTermination);
 
             signal(SIGXCPU, handleCPUOverload);
+            signal(SIGUSR1, handleProfileCapture);
 
             signal(SIGBUS, handleProcessCrash);
             signal(SIGSEGV, handleProcessCrash);
@@ -11,17 +11,24 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
+#include <algorithm>
+#include <limits>
+
 #include <support/SSynchronousScheduler.hpp>
 
 namespace Kiaro
 {
     namespace Support
     {
-        static SSynchronousScheduler* sInstance = nullptr;
+        //! The heap index of events that are not held by a scheduler.
+        static const size_t sNotScheduled = static_cast<size_t>(-1);
+
+        //! The smallest heap size at which cancelled events are compacted away.
+        static const size_t sMinimumCompactionSize = 64;
 
         CScheduledEvent::CScheduledEvent(EasyDelegate::IDeferredCaller* deferredCaller, const Common::U64 waitTimeMS, const bool recurring) :
             mCancelled(false), mTriggerTimeMS(Support::FTime::getSimTimeMilliseconds() + waitTimeMS), mInternalDeferredCaller(deferredCaller),
-            mRecurring(recurring), mWaitTimeMS(waitTimeMS)
+            mRecurring(recurring), mWaitTimeMS(waitTimeMS), mHeapIndex(sNotScheduled), mSequence(0)
         {
         }
 
@@ -39,6 +46,11 @@ namespace Kiaro
         void CScheduledEvent::setTriggerTimeMS(const Common::U64 triggerTime)
         {
             mTriggerTimeMS = triggerTime;
+
+            if (mHeapIndex != sNotScheduled)
+            {
+                SSynchronousScheduler::getInstance()->reschedule(this);
+            }
         }
 
         void CScheduledEvent::setWaitTimeMS(const Common::U64 waitTimeMS, const bool refresh)
@@ -47,7 +59,7 @@ namespace Kiaro
 
             if (refresh)
             {
-                mTriggerTimeMS = Support::FTime::getSimTimeMilliseconds() + waitTimeMS;
+                this->setTriggerTimeMS(Support::FTime::getSimTimeMilliseconds() + waitTimeMS);
             }
         }
 
@@ -76,59 +88,233 @@ namespace Kiaro
             return mWaitTimeMS;
         }
 
-        SSynchronousScheduler::SSynchronousScheduler(void)
+        Common::U64 CScheduledEvent::getTriggerTimeMS(void)
+        {
+            return mTriggerTimeMS;
+        }
+
+        SSynchronousScheduler::SSynchronousScheduler(void) : mEventHeap(CTrackedAllocator<CScheduledEvent*>(ALLOCATION_TAG(Scheduler))), mNextSequence(0), mCompactionSize(sMinimumCompactionSize)
         {
 
         }
 
         SSynchronousScheduler::~SSynchronousScheduler(void)
         {
+            for (CScheduledEvent* event : mEventHeap)
+            {
+                delete event;
+            }
+        }
+
+        bool SSynchronousScheduler::isEarlier(const size_t lhs, const size_t rhs) const
+        {
+            const CScheduledEvent* lhsEvent = mEventHeap[lhs];
+            const CScheduledEvent* rhsEvent = mEventHeap[rhs];
+
+            if (lhsEvent->mTriggerTimeMS != rhsEvent->mTriggerTimeMS)
+            {
+                return lhsEvent->mTriggerTimeMS < rhsEvent->mTriggerTimeMS;
+            }
+
+            return lhsEvent->mSequence < rhsEvent->mSequence;
+        }
+
+        void SSynchronousScheduler::place(CScheduledEvent* event, const size_t index)
+        {
+            mEventHeap[index] = event;
+            event->mHeapIndex = index;
+        }
+
+        void SSynchronousScheduler::siftUp(size_t index)
+        {
+            while (index > 0)
+            {
+                const size_t parent = (index - 1) / 2;
+
+                if (!this->isEarlier(index, parent))
+                {
+                    break;
+                }
+
+                CScheduledEvent* event = mEventHeap[index];
+                this->place(mEventHeap[parent], index);
+                this->place(event, parent);
+                index = parent;
+            }
+        }
+
+        void SSynchronousScheduler::siftDown(size_t index)
+        {
+            const size_t count = mEventHeap.size();
+
+            while (true)
+            {
+                const size_t left = index * 2 + 1;
+                const size_t right = left + 1;
+                size_t earliest = index;
+
+                if (left < count && this->isEarlier(left, earliest))
+                {
+                    earliest = left;
+                }
+
+                if (right < count && this->isEarlier(right, earliest))
+                {
+                    earliest = right;
+                }
+
+                if (earliest == index)
+                {
+                    break;
+                }
+
+                CScheduledEvent* event = mEventHeap[index];
+                this->place(mEventHeap[earliest], index);
+                this->place(event, earliest);
+                index = earliest;
+            }
+        }
+
+        void SSynchronousScheduler::removeAt(const size_t index)
+        {
+            CScheduledEvent* removed = mEventHeap[index];
+            CScheduledEvent* last = mEventHeap.back();
+            mEventHeap.pop_back();
+            removed->mHeapIndex = sNotScheduled;
+
+            if (last != removed)
+            {
+                this->place(last, index);
+                this->siftUp(index);
+                this->siftDown(last->mHeapIndex);
+            }
+        }
 
+        void SSynchronousScheduler::popCancelledEvents(void)
+        {
+            while (!mEventHeap.empty() && mEventHeap.front()->isCancelled())
+            {
+                CScheduledEvent* event = mEventHeap.front();
+                this->removeAt(0);
+                delete event;
+            }
+        }
+
+        void SSynchronousScheduler::compact(void)
+        {
+            size_t kept = 0;
+
+            for (CScheduledEvent* event : mEventHeap)
+            {
+                if (event->isCancelled())
+                {
+                    delete event;
+                }
+                else
+                {
+                    mEventHeap[kept++] = event;
+                }
+            }
+
+            mEventHeap.resize(kept);
+
+            for (size_t index = 0; index < kept; ++index)
+            {
+                mEventHeap[index]->mHeapIndex = index;
+            }
+
+            // Bottom up heap construction is linear in the number of events
+            for (size_t index = kept / 2; index-- > 0;)
+            {
+                this->siftDown(index);
+            }
+
+            mCompactionSize = std::max(sMinimumCompactionSize, kept * 2);
         }
 
         CScheduledEvent* SSynchronousScheduler::schedule(EasyDelegate::IDeferredCaller* deferredCaller, const Common::U32 waitTimeMS, const bool recurring)
         {
-            return *mScheduledEventSet.insert(mScheduledEventSet.end(), new CScheduledEvent(deferredCaller, waitTimeMS, recurring));
+            ALLOCATION_SCOPE(Scheduler);
+            CScheduledEvent* event = new CScheduledEvent(deferredCaller, waitTimeMS, recurring);
+            event->mSequence = mNextSequence++;
+
+            mEventHeap.push_back(event);
+            event->mHeapIndex = mEventHeap.size() - 1;
+            this->siftUp(event->mHeapIndex);
+            return event;
+        }
+
+        void SSynchronousScheduler::reschedule(CScheduledEvent* event)
+        {
+            // Rescheduled events line up behind everything else due at the same time
+            event->mSequence = mNextSequence++;
+
+            this->siftUp(event->mHeapIndex);
+            this->siftDown(event->mHeapIndex);
+        }
+
+        size_t SSynchronousScheduler::getEventCount(void) const
+        {
+            return mEventHeap.size();
         }
 
         void SSynchronousScheduler::update(void)
         {
+            // Cancelled events are only deleted once they reach the front, so sweep them whenever the heap has doubled. This is
+            // done before dispatching anything as calls may cancel the event being dispatched.
+            if (mEventHeap.size() >= mCompactionSize)
+            {
+                this->compact();
+            }
+
             const Common::U64 currentSimTimeMS = Support::FTime::getSimTimeMilliseconds();
-            Support::UnorderedSet<CScheduledEvent*> removedEvents;
 
-            for (CScheduledEvent* currentEvent : mScheduledEventSet)
+            // Anything scheduled or rescheduled from here on waits for the next update
+            const Common::U64 firstNewSequence = mNextSequence;
+
+            while (!mEventHeap.empty())
             {
-                bool shouldRemoveCurrentEvent = false;
+                CScheduledEvent* currentEvent = mEventHeap.front();
 
-                if (currentEvent->shouldDispatch(currentSimTimeMS))
+                if (currentEvent->isCancelled())
                 {
-                    currentEvent->dispatch();
-
-                    if (currentEvent->isRecurring())
-                    {
-                        currentEvent->setTriggerTimeMS(Support::FTime::getSimTimeMilliseconds() + currentEvent->getWaitTimeMS());
-                    }
-                    else
-                    {
-                        shouldRemoveCurrentEvent = true;
-                    }
+                    this->removeAt(0);
+                    delete currentEvent;
+                    continue;
                 }
-                else if (currentEvent->isCancelled())
+
+                if (currentEvent->mTriggerTimeMS > currentSimTimeMS || currentEvent->mSequence >= firstNewSequence)
                 {
-                    shouldRemoveCurrentEvent = true;
+                    break;
                 }
 
-                if (shouldRemoveCurrentEvent)
+                // The event stays in the heap while dispatching, so the call may reschedule or cancel it
+                currentEvent->dispatch();
+
+                if (currentEvent->isRecurring() && !currentEvent->isCancelled())
+                {
+                    currentEvent->setTriggerTimeMS(Support::FTime::getSimTimeMilliseconds() + currentEvent->getWaitTimeMS());
+                }
+                else
                 {
-                    removedEvents.insert(currentEvent);
+                    this->removeAt(currentEvent->mHeapIndex);
+                    delete currentEvent;
                 }
             }
+        }
+
+        Common::U64 SSynchronousScheduler::getTimeUntilNextEventMS(void)
+        {
+            this->popCancelledEvents();
 
-            for (CScheduledEvent* currentEvent : removedEvents)
+            if (mEventHeap.empty())
             {
-                mScheduledEventSet.erase(currentEvent);
-                delete currentEvent;
+                return std::numeric_limits<Common::U64>::max();
             }
+
+            const Common::U64 currentSimTimeMS = Support::FTime::getSimTimeMilliseconds();
+            const Common::U64 triggerTimeMS = mEventHeap.front()->getTriggerTimeMS();
+            return triggerTimeMS <= currentSimTimeMS ? 0 : triggerTimeMS - currentSimTimeMS;
         }
     } // End Namespace Support
 } // End Namespace Kiaro
@@ -0,0 +1,210 @@
+/**
+ *  @file CCommandBuffer.cpp
+ *  @brief Source file implementing the CCommandBuffer class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+
+#include <support/tasking/CCommandBuffer.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            CCommandBuffer::CCommandBuffer(const size_t blockSize) : mCurrentBlock(0), mCommandCount(0)
+            {
+                Block block;
+                block.mCapacity = align(std::max(blockSize, sizeof(CommandHeader)));
+                block.mData = reinterpret_cast<Common::U8*>(::operator new(block.mCapacity));
+                block.mUsed = 0;
+
+                mBlocks.push_back(block);
+            }
+
+            CCommandBuffer::~CCommandBuffer(void)
+            {
+                this->clear();
+
+                for (Block& block : mBlocks)
+                {
+                    ::operator delete(block.mData);
+                }
+            }
+
+            CCommandBuffer::CCommandBuffer(CCommandBuffer&& other) : mBlocks(std::move(other.mBlocks)), mCurrentBlock(other.mCurrentBlock),
+            mCommandCount(other.mCommandCount)
+            {
+                other.mBlocks.clear();
+                other.mCurrentBlock = 0;
+                other.mCommandCount = 0;
+            }
+
+            CCommandBuffer& CCommandBuffer::operator=(CCommandBuffer&& other)
+            {
+                if (this != &other)
+                {
+                    // Our blocks go to the other buffer, which frees them when it is destroyed
+                    this->clear();
+                    std::swap(mBlocks, other.mBlocks);
+                    std::swap(mCurrentBlock, other.mCurrentBlock);
+                    std::swap(mCommandCount, other.mCommandCount);
+                }
+
+                return *this;
+            }
+
+            size_t CCommandBuffer::align(const size_t size)
+            {
+                const size_t alignment = alignof(std::max_align_t);
+                return (size + alignment - 1) & ~(alignment - 1);
+            }
+
+            CCommandBuffer::CommandHeader* CCommandBuffer::allocate(const size_t size)
+            {
+                // Move on to the next block that fits, allocating one if there is none
+                while (mCurrentBlock < mBlocks.size() && mBlocks[mCurrentBlock].mUsed + size > mBlocks[mCurrentBlock].mCapacity)
+                {
+                    ++mCurrentBlock;
+                }
+
+                if (mCurrentBlock == mBlocks.size())
+                {
+                    Block block;
+                    block.mCapacity = mBlocks.empty() ? size : std::max(size, mBlocks.back().mCapacity * 2);
+                    block.mData = reinterpret_cast<Common::U8*>(::operator new(block.mCapacity));
+                    block.mUsed = 0;
+
+                    mBlocks.push_back(block);
+                }
+
+                Block& block = mBlocks[mCurrentBlock];
+                CommandHeader* header = reinterpret_cast<CommandHeader*>(block.mData + block.mUsed);
+                header->mSize = size;
+
+                block.mUsed += size;
+                ++mCommandCount;
+                return header;
+            }
+
+            void CCommandBuffer::release(const bool execute)
+            {
+                this->releaseFrom(0, 0, execute);
+            }
+
+            void CCommandBuffer::releaseFrom(size_t blockIndex, size_t offset, const bool execute)
+            {
+                const size_t headerSize = align(sizeof(CommandHeader));
+
+                for (; blockIndex <= mCurrentBlock && blockIndex < mBlocks.size(); ++blockIndex, offset = 0)
+                {
+                    Block& block = mBlocks[blockIndex];
+
+                    while (offset < block.mUsed)
+                    {
+                        CommandHeader* header = reinterpret_cast<CommandHeader*>(block.mData + offset);
+                        Common::U8* command = block.mData + offset + headerSize;
+
+                        // Step past the command before invoking it, so that it is never invoked twice
+                        offset += header->mSize;
+
+                        try
+                        {
+                            header->mFunction(command, execute);
+                        }
+                        catch (...)
+                        {
+                            // Destroying commands does not throw, so this always leaves the buffer empty
+                            this->releaseFrom(blockIndex, offset, false);
+                            throw;
+                        }
+                    }
+
+                    block.mUsed = 0;
+                }
+
+                mCurrentBlock = 0;
+                mCommandCount = 0;
+            }
+
+            void CCommandBuffer::invokeDeferredCaller(void* command, const bool execute)
+            {
+                EasyDelegate::IDeferredCaller* caller = *reinterpret_cast<EasyDelegate::IDeferredCaller**>(command);
+
+                if (execute)
+                {
+                    try
+                    {
+                        caller->genericDispatch();
+                    }
+                    catch (...)
+                    {
+                        delete caller;
+                        throw;
+                    }
+                }
+
+                delete caller;
+            }
+
+            void CCommandBuffer::push(EasyDelegate::IDeferredCaller* caller)
+            {
+                CommandHeader* header = this->allocate(align(sizeof(CommandHeader)) + align(sizeof(EasyDelegate::IDeferredCaller*)));
+                header->mFunction = invokeDeferredCaller;
+
+                *reinterpret_cast<EasyDelegate::IDeferredCaller**>(reinterpret_cast<Common::U8*>(header) + align(sizeof(CommandHeader))) = caller;
+            }
+
+            void CCommandBuffer::execute(void)
+            {
+                this->release(true);
+            }
+
+            void CCommandBuffer::clear(void)
+            {
+                this->release(false);
+            }
+
+            size_t CCommandBuffer::getCommandCount(void) const
+            {
+                return mCommandCount;
+            }
+
+            bool CCommandBuffer::empty(void) const
+            {
+                return mCommandCount == 0;
+            }
+
+            size_t CCommandBuffer::getUsedBytes(void) const
+            {
+                size_t result = 0;
+
+                for (size_t blockIndex = 0; blockIndex <= mCurrentBlock && blockIndex < mBlocks.size(); ++blockIndex)
+                {
+                    result += mBlocks[blockIndex].mUsed;
+                }
+
+                return result;
+            }
+
+            size_t CCommandBuffer::getCapacity(void) const
+            {
+                size_t result = 0;
+
+                for (const Block& block : mBlocks)
+                {
+                    result += block.mCapacity;
+                }
+
+                return result;
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
@@ -0,0 +1,82 @@
+/**
+ *  @file CCoroutineTask.cpp
+ *  @brief Source file implementing the CCoroutineTask class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <support/Console.hpp>
+
+#include <support/tasking/CCoroutineTask.hpp>
+
+#if _SUPPORT_USE_COROUTINES_
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            CCoroutineTask::CCoroutineTask(CCoroutine&& coroutine) : mCoroutine(std::move(coroutine))
+            {
+
+            }
+
+            void CCoroutineTask::initialize(void)
+            {
+
+            }
+
+            void CCoroutineTask::deinitialize(void)
+            {
+
+            }
+
+            bool CCoroutineTask::tick(const Common::F32 deltaTimeSeconds)
+            {
+                std::coroutine_handle<CCoroutine::promise_type> handle = mCoroutine.getHandle();
+
+                if (!handle || handle.done())
+                {
+                    return true;
+                }
+
+                // Polling the awaited operation costs nothing while it is pending and needs no callbacks into the coroutine
+                CCoroutine::promise_type& promise = handle.promise();
+
+                if (promise.mCanResume && !promise.mCanResume(promise.mAwaiter))
+                {
+                    return false;
+                }
+
+                promise.mCanResume = nullptr;
+                promise.mAwaiter = nullptr;
+                promise.mDeltaTimeSeconds = deltaTimeSeconds;
+                handle.resume();
+
+                if (!handle.done())
+                {
+                    return false;
+                }
+
+                if (promise.mException)
+                {
+                    CONSOLE_ERROR("A coroutine task was terminated by an exception.");
+                }
+
+                return true;
+            }
+
+            std::exception_ptr CCoroutineTask::getException(void) const
+            {
+                std::coroutine_handle<CCoroutine::promise_type> handle = mCoroutine.getHandle();
+                return handle ? handle.promise().mException : nullptr;
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
+#endif // _SUPPORT_USE_COROUTINES_
@@ -0,0 +1,48 @@
+/**
+ *  @file CFuture.cpp
+ *  @brief Source file implementing the non template parts of the CFuture types.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <support/tasking/CFuture.hpp>
+#include <support/tasking/SAsynchronousTaskManager.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            void dispatchCall(std::function<void(void)> call, const EXECUTION_CONTEXT context)
+            {
+                if (context == EXECUTION_INLINE)
+                {
+                    call();
+                    return;
+                }
+
+                SAsynchronousTaskManager::getInstance()->post(call, context);
+            }
+
+            CCancellationToken::CCancellationToken(void) : mCancelled(std::make_shared<Support::Atomic<bool>>(false))
+            {
+
+            }
+
+            void CCancellationToken::cancel(void)
+            {
+                mCancelled->store(true);
+            }
+
+            bool CCancellationToken::isCancelled(void) const
+            {
+                return mCancelled->load();
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
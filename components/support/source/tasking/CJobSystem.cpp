@@ -0,0 +1,358 @@
+/**
+ *  @file CJobSystem.cpp
+ *  @brief Source file implementing the CJobSystem class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <support/SProfiler.hpp>
+#include <support/tasking/CJobSystem.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! The job system the calling thread is a worker of, if any.
+            static thread_local CJobSystem* sWorkerSystem = nullptr;
+
+            //! The index of the calling thread within sWorkerSystem.
+            static thread_local Common::S32 sWorkerIndex = -1;
+
+            //! The job currently executing on the calling thread.
+            static thread_local CJobSystem::Job* sCurrentJob = nullptr;
+
+            //! How many times a thread that found no work looks again before parking.
+            static const Common::U32 sSpinIterations = 64;
+
+            CJobSystem::CJobCounter::CJobCounter(void) : mPending(0), mFailed(false)
+            {
+
+            }
+
+            bool CJobSystem::CJobCounter::isComplete(void) const
+            {
+                return mPending.load(std::memory_order_acquire) == 0;
+            }
+
+            Common::U32 CJobSystem::CJobCounter::getPendingCount(void) const
+            {
+                return mPending.load(std::memory_order_acquire);
+            }
+
+            std::exception_ptr CJobSystem::CJobCounter::takeException(void)
+            {
+                std::exception_ptr result;
+                std::swap(result, mException);
+                mFailed.store(false, std::memory_order_relaxed);
+                return result;
+            }
+
+            CJobSystem::CJobSystem(const Common::U32 workerCount, const Platform::Thread::AFFINITY_POLICY affinity, const Platform::Thread::THREAD_PRIORITY priority) :
+            mWorkers(workerCount, nullptr), mStartedCount(0), mSubmittedJobCount(0), mWakeEpoch(0), mParkedCount(0)
+            {
+                for (Common::U32 iteration = 0; iteration < workerCount; ++iteration)
+                {
+                    this->startWorker(workerThreadLogic, this, iteration, affinity, priority);
+                }
+
+                // Jobs may be submitted as soon as we return, so every worker must be stealable by then
+                std::unique_lock<Support::Mutex> lock(mParkMutex);
+                mParkCondition.wait(lock, [this]() { return mStartedCount == mWorkers.size(); });
+            }
+
+            CJobSystem::~CJobSystem(void)
+            {
+                this->stopAndJoin("CJobSystem");
+
+                for (Worker* worker : mWorkers)
+                {
+                    delete worker;
+                }
+            }
+
+            void CJobSystem::workerThreadLogic(CJobSystem* system, const Common::U32 workerIndex, const Platform::Thread::AFFINITY_POLICY affinity,
+                                               const Platform::Thread::THREAD_PRIORITY priority)
+            {
+                Platform::Thread::placeCurrentThread("CJobSystem", affinity, workerIndex, false, priority);
+                Support::SProfiler::getPointer()->setThreadName(Support::String("Job Worker ") + std::to_string(workerIndex));
+
+                // Allocated after placement so that the memory is first touched on the node this worker runs on
+                Worker* worker = new Worker();
+                worker->mRandom = workerIndex * 2654435761u + 1;
+
+                {
+                    std::unique_lock<Support::Mutex> lock(system->mParkMutex);
+                    system->mWorkers[workerIndex] = worker;
+                    ++system->mStartedCount;
+                    system->mParkCondition.notify_all();
+
+                    // Workers steal from each other right away, so wait until none of them is missing
+                    system->mParkCondition.wait(lock, [system]() { return system->mStartedCount == system->mWorkers.size(); });
+                }
+
+                sWorkerSystem = system;
+                sWorkerIndex = workerIndex;
+
+                system->executeUntil(nullptr, nullptr);
+
+                sWorkerSystem = nullptr;
+                sWorkerIndex = -1;
+
+                system->onWorkerExit();
+            }
+
+            CJobSystem::Job* CJobSystem::findJob(const Common::S32 workerIndex)
+            {
+                Job* result = nullptr;
+
+                if (workerIndex >= 0 && mWorkers[workerIndex]->mJobs.pop(result))
+                {
+                    return result;
+                }
+
+                if (mSubmittedJobCount.load(std::memory_order_acquire) != 0)
+                {
+                    std::lock_guard<Support::Mutex> lock(mSubmittedJobsMutex);
+
+                    if (!mSubmittedJobs.empty())
+                    {
+                        result = mSubmittedJobs.front();
+                        mSubmittedJobs.pop_front();
+                        mSubmittedJobCount.fetch_sub(1, std::memory_order_release);
+                        return result;
+                    }
+                }
+
+                const Common::U32 workerCount = static_cast<Common::U32>(mWorkers.size());
+
+                if (workerCount == 0)
+                {
+                    return nullptr;
+                }
+
+                // Start at a random victim so that thieves spread out instead of all hammering the same deque
+                Common::U32 start = 0;
+
+                if (workerIndex >= 0)
+                {
+                    Common::U32& random = mWorkers[workerIndex]->mRandom;
+                    random ^= random << 13;
+                    random ^= random >> 17;
+                    random ^= random << 5;
+                    start = random % workerCount;
+                }
+
+                for (Common::U32 iteration = 0; iteration < workerCount; ++iteration)
+                {
+                    const Common::U32 victim = (start + iteration) % workerCount;
+
+                    if (static_cast<Common::S32>(victim) != workerIndex && mWorkers[victim]->mJobs.steal(result))
+                    {
+                        return result;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            void CJobSystem::execute(Job* job)
+            {
+                Job* previousJob = sCurrentJob;
+                sCurrentJob = job;
+
+                try
+                {
+                    job->mFunction(job->mData);
+                }
+                catch (...)
+                {
+                    // The job still completes, its exception goes to whoever waits on the counter. Only the first one is kept.
+                    if (!job->mCounter->mFailed.exchange(true, std::memory_order_relaxed))
+                    {
+                        job->mCounter->mException = std::current_exception();
+                    }
+                }
+
+                sCurrentJob = previousJob;
+
+                // The counter may be destroyed by its waiter as soon as it reaches zero, so it must not be touched afterwards
+                if (job->mCounter->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    this->wake(true);
+                }
+            }
+
+            void CJobSystem::wakeWorkers(void)
+            {
+                this->wake(true);
+            }
+
+            void CJobSystem::wake(const bool all)
+            {
+                mWakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+                // A thread about to park increments mParkedCount before checking mWakeEpoch, so one of us always sees the other
+                if (mParkedCount.load(std::memory_order_seq_cst) != 0)
+                {
+                    std::lock_guard<Support::Mutex> lock(mParkMutex);
+
+                    if (all)
+                    {
+                        mParkCondition.notify_all();
+                    }
+                    else
+                    {
+                        mParkCondition.notify_one();
+                    }
+                }
+            }
+
+            bool CJobSystem::executeUntil(CJobCounter* counter, const std::chrono::steady_clock::time_point* deadline)
+            {
+                const Common::S32 workerIndex = sWorkerSystem == this ? sWorkerIndex : -1;
+                Common::U32 idleIterations = 0;
+
+                while (counter ? !counter->isComplete() : this->isAcceptingWork())
+                {
+                    // Read the epoch before looking for work so that anything submitted afterwards prevents us from parking
+                    const Common::U32 epoch = mWakeEpoch.load(std::memory_order_seq_cst);
+                    Job* job = this->findJob(workerIndex);
+
+                    if (job)
+                    {
+                        this->execute(job);
+                        idleIterations = 0;
+                        continue;
+                    }
+
+                    // Draining workers are done once there is nothing left to find
+                    if (!counter && this->getState() == POOL_DRAINING)
+                    {
+                        break;
+                    }
+
+                    if (deadline && std::chrono::steady_clock::now() >= *deadline)
+                    {
+                        break;
+                    }
+
+                    if (idleIterations < sSpinIterations)
+                    {
+                        ++idleIterations;
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    std::unique_lock<Support::Mutex> lock(mParkMutex);
+                    mParkedCount.fetch_add(1, std::memory_order_seq_cst);
+
+                    while (mWakeEpoch.load(std::memory_order_seq_cst) == epoch && !(counter ? counter->isComplete() : this->getState() != POOL_RUNNING))
+                    {
+                        if (!deadline)
+                        {
+                            mParkCondition.wait(lock);
+                        }
+                        else if (mParkCondition.wait_until(lock, *deadline) == std::cv_status::timeout)
+                        {
+                            break;
+                        }
+                    }
+
+                    mParkedCount.fetch_sub(1, std::memory_order_seq_cst);
+                    idleIterations = 0;
+                }
+
+                return counter && counter->isComplete();
+            }
+
+            void CJobSystem::enqueue(Job* job)
+            {
+                if (sWorkerSystem == this)
+                {
+                    mWorkers[sWorkerIndex]->mJobs.push(job);
+                    return;
+                }
+
+                std::lock_guard<Support::Mutex> lock(mSubmittedJobsMutex);
+                mSubmittedJobs.push_back(job);
+                mSubmittedJobCount.fetch_add(1, std::memory_order_release);
+            }
+
+            void CJobSystem::submit(Job& job, CJobCounter& counter)
+            {
+                this->submit(&job, 1, counter);
+            }
+
+            void CJobSystem::submit(Job* jobs, const size_t count, CJobCounter& counter)
+            {
+                // The counter must account for every job before any of them can complete
+                counter.mPending.fetch_add(static_cast<Common::U32>(count), std::memory_order_relaxed);
+
+                for (size_t iteration = 0; iteration < count; ++iteration)
+                {
+                    jobs[iteration].mCounter = &counter;
+                    this->enqueue(&jobs[iteration]);
+                }
+
+                this->wake(count > 1);
+            }
+
+            void CJobSystem::submitChild(Job& job)
+            {
+                if (!sCurrentJob)
+                {
+                    throw std::logic_error("CJobSystem: Cannot submit a child job outside of a job.");
+                }
+
+                this->submit(job, *sCurrentJob->mCounter);
+            }
+
+            void CJobSystem::wait(CJobCounter& counter)
+            {
+                this->executeUntil(&counter, nullptr);
+
+                std::exception_ptr exception = counter.takeException();
+                if (exception)
+                {
+                    std::rethrow_exception(exception);
+                }
+            }
+
+            bool CJobSystem::wait(CJobCounter& counter, const Common::U32 timeoutMS)
+            {
+                const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+
+                if (!this->executeUntil(&counter, &deadline))
+                {
+                    return false;
+                }
+
+                std::exception_ptr exception = counter.takeException();
+                if (exception)
+                {
+                    std::rethrow_exception(exception);
+                }
+
+                return true;
+            }
+
+            Common::U32 CJobSystem::getWorkerCount(void) const
+            {
+                return static_cast<Common::U32>(mWorkers.size());
+            }
+
+            CJobSystem::Job* CJobSystem::getCurrentJob(void)
+            {
+                return sCurrentJob;
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
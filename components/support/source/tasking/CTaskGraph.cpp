@@ -0,0 +1,348 @@
+/**
+ *  @file CTaskGraph.cpp
+ *  @brief Source file implementing the CTaskGraph class.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include <support/Set.hpp>
+#include <support/UnorderedMap.hpp>
+#include <support/SProfiler.hpp>
+
+#include <support/tasking/CTaskGraph.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            CTaskGraph::CTaskGraph(void) : mColorCount(0), mEdgeCount(0), mJobSystem(nullptr)
+            {
+
+            }
+
+            CTaskGraph::~CTaskGraph(void)
+            {
+                this->clear();
+            }
+
+            void CTaskGraph::clear(void)
+            {
+                for (Node* node : mNodes)
+                {
+                    delete node;
+                }
+
+                mNodes.clear();
+                mColorCount = 0;
+                mEdgeCount = 0;
+            }
+
+            bool CTaskGraph::conflicts(SThreadSystem::IThreadedTask* first, SThreadSystem::IThreadedTask* second)
+            {
+                for (const Common::U32 resource : first->getResources())
+                {
+                    if (second->getResources().count(resource) != 0 || second->getReadResources().count(resource) != 0)
+                    {
+                        return true;
+                    }
+                }
+
+                for (const Common::U32 resource : second->getResources())
+                {
+                    if (first->getReadResources().count(resource) != 0)
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void CTaskGraph::build(const Support::Vector<SThreadSystem::IThreadedTask*>& tasks)
+            {
+                this->clear();
+
+                // Bucket the tasks by resource so that only tasks that actually share something are ever compared
+                Support::UnorderedMap<Common::U32, Support::Vector<size_t>> writers;
+                Support::UnorderedMap<Common::U32, Support::Vector<size_t>> readers;
+
+                for (size_t iteration = 0; iteration < tasks.size(); ++iteration)
+                {
+                    SThreadSystem::IThreadedTask* task = tasks[iteration];
+
+                    for (const Common::U32 resource : task->getResources())
+                    {
+                        writers[resource].push_back(iteration);
+                    }
+
+                    for (const Common::U32 resource : task->getReadResources())
+                    {
+                        // Writing a resource already implies reading it
+                        if (task->getResources().count(resource) == 0)
+                        {
+                            readers[resource].push_back(iteration);
+                        }
+                    }
+                }
+
+                // Writers conflict with every other writer and with every reader of the same resource
+                Support::Vector<Support::Set<size_t>> neighbors(tasks.size());
+
+                for (auto& resourceWriters : writers)
+                {
+                    const Support::Vector<size_t>& resourceWriterList = resourceWriters.second;
+                    auto resourceReaders = readers.find(resourceWriters.first);
+
+                    for (size_t first = 0; first < resourceWriterList.size(); ++first)
+                    {
+                        for (size_t second = first + 1; second < resourceWriterList.size(); ++second)
+                        {
+                            neighbors[resourceWriterList[first]].insert(resourceWriterList[second]);
+                            neighbors[resourceWriterList[second]].insert(resourceWriterList[first]);
+                        }
+
+                        if (resourceReaders != readers.end())
+                        {
+                            for (const size_t reader : resourceReaders->second)
+                            {
+                                neighbors[resourceWriterList[first]].insert(reader);
+                                neighbors[reader].insert(resourceWriterList[first]);
+                            }
+                        }
+                    }
+                }
+
+                // Color greedily, visiting the most constrained tasks first
+                Support::Vector<size_t> coloringOrder(tasks.size());
+                for (size_t iteration = 0; iteration < tasks.size(); ++iteration)
+                {
+                    coloringOrder[iteration] = iteration;
+                }
+
+                std::stable_sort(coloringOrder.begin(), coloringOrder.end(), [&neighbors](const size_t first, const size_t second)
+                {
+                    return neighbors[first].size() > neighbors[second].size();
+                });
+
+                const Common::U32 uncolored = static_cast<Common::U32>(-1);
+                Support::Vector<Common::U32> colors(tasks.size(), uncolored);
+                Support::Vector<bool> usedColors;
+
+                for (const size_t current : coloringOrder)
+                {
+                    usedColors.assign(neighbors[current].size() + 1, false);
+
+                    for (const size_t neighbor : neighbors[current])
+                    {
+                        if (colors[neighbor] != uncolored && colors[neighbor] < usedColors.size())
+                        {
+                            usedColors[colors[neighbor]] = true;
+                        }
+                    }
+
+                    Common::U32 color = 0;
+                    while (usedColors[color])
+                    {
+                        ++color;
+                    }
+
+                    colors[current] = color;
+                    mColorCount = std::max(mColorCount, color + 1);
+                }
+
+                // Create the nodes in color order, using the input order to break ties
+                Support::Vector<size_t> nodeOrder(coloringOrder);
+                std::sort(nodeOrder.begin(), nodeOrder.end(), [&colors](const size_t first, const size_t second)
+                {
+                    return colors[first] != colors[second] ? colors[first] < colors[second] : first < second;
+                });
+
+                Support::Vector<Node*> nodesByTask(tasks.size());
+
+                for (const size_t taskIndex : nodeOrder)
+                {
+                    Node* node = new Node();
+                    node->mTask = tasks[taskIndex];
+                    node->mGraph = this;
+                    node->mColor = colors[taskIndex];
+                    node->mPredecessorCount = 0;
+
+                    nodesByTask[taskIndex] = node;
+                    mNodes.push_back(node);
+                }
+
+                // Every conflict becomes an edge from the lower color to the higher one, which can never form a cycle
+                for (const size_t taskIndex : nodeOrder)
+                {
+                    for (const size_t neighbor : neighbors[taskIndex])
+                    {
+                        if (colors[neighbor] > colors[taskIndex])
+                        {
+                            nodesByTask[taskIndex]->mSuccessors.push_back(nodesByTask[neighbor]);
+                            ++nodesByTask[neighbor]->mPredecessorCount;
+                            ++mEdgeCount;
+                        }
+                    }
+                }
+            }
+
+            void CTaskGraph::build(const Support::Vector<Support::Vector<SThreadSystem::IThreadedTask*>>& groups)
+            {
+                this->clear();
+
+                // The position within a group doubles as the color, so every group is a chain
+                Support::Vector<Support::Vector<Node*>> chains;
+
+                for (const Support::Vector<SThreadSystem::IThreadedTask*>& group : groups)
+                {
+                    Support::Vector<Node*> chain;
+
+                    for (size_t iteration = 0; iteration < group.size(); ++iteration)
+                    {
+                        Node* node = new Node();
+                        node->mTask = group[iteration];
+                        node->mGraph = this;
+                        node->mColor = static_cast<Common::U32>(iteration);
+                        node->mPredecessorCount = iteration == 0 ? 0 : 1;
+
+                        if (iteration != 0)
+                        {
+                            chain.back()->mSuccessors.push_back(node);
+                            ++mEdgeCount;
+                        }
+
+                        chain.push_back(node);
+                        mColorCount = std::max(mColorCount, node->mColor + 1);
+                    }
+
+                    chains.push_back(chain);
+                }
+
+                for (Common::U32 color = 0; color < mColorCount; ++color)
+                {
+                    for (const Support::Vector<Node*>& chain : chains)
+                    {
+                        if (color < chain.size())
+                        {
+                            mNodes.push_back(chain[color]);
+                        }
+                    }
+                }
+            }
+
+            void CTaskGraph::execute(CJobSystem& jobs, CJobSystem::CJobCounter& counter)
+            {
+                mJobSystem = &jobs;
+
+                // Edges only run towards higher colors, so walking the nodes backwards visits every successor first
+                for (auto iterator = mNodes.rbegin(); iterator != mNodes.rend(); ++iterator)
+                {
+                    Node* node = *iterator;
+                    Common::F32 longestSuccessorChain = 0.0f;
+
+                    for (Node* successor : node->mSuccessors)
+                    {
+                        longestSuccessorChain = std::max(longestSuccessorChain, successor->mPriority);
+                    }
+
+                    node->mPriority = node->mTask->getEstimatedCost() + longestSuccessorChain;
+                }
+
+                // Every node must be reset before anything is submitted, as submitted nodes immediately release others
+                Support::Vector<Node*> roots;
+
+                for (Node* node : mNodes)
+                {
+                    node->mRemainingPredecessors.store(node->mPredecessorCount, std::memory_order_relaxed);
+                    node->mJob.mFunction = executeNode;
+                    node->mJob.mData = node;
+
+                    // Successors released together are pushed in this order and the last one pushed is the first one popped
+                    std::stable_sort(node->mSuccessors.begin(), node->mSuccessors.end(), [](const Node* first, const Node* second)
+                    {
+                        return first->mPriority < second->mPriority;
+                    });
+
+                    if (node->mPredecessorCount == 0)
+                    {
+                        roots.push_back(node);
+                    }
+                }
+
+                // Submissions from outside of the job system are taken first in first out, so the heaviest chains go first
+                std::stable_sort(roots.begin(), roots.end(), [](const Node* first, const Node* second)
+                {
+                    return first->mPriority > second->mPriority;
+                });
+
+                for (Node* node : roots)
+                {
+                    jobs.submit(node->mJob, counter);
+                }
+            }
+
+            void CTaskGraph::executeNode(void* data)
+            {
+                Node* node = reinterpret_cast<Node*>(data);
+                SThreadSystem::IThreadedTask* task = node->mTask;
+
+                PROFILER_SCOPE(ThreadedTask);
+
+                // Tasks are ticked until they report completion
+                const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+                do
+                {
+                    task->mIsComplete = task->tick(0.00f);
+                }
+                while (!task->mIsComplete);
+
+                task->recordExecutionTime(std::chrono::duration<Common::F32, std::micro>(std::chrono::steady_clock::now() - startTime).count());
+
+                // Release every successor whose dependencies have now all completed. They are children of this job so that
+                // the counter cannot reach zero before they have run.
+                for (Node* successor : node->mSuccessors)
+                {
+                    if (successor->mRemainingPredecessors.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        node->mGraph->mJobSystem->submitChild(successor->mJob);
+                    }
+                }
+            }
+
+            void CTaskGraph::commit(void)
+            {
+                PROFILER_SCOPE(PhaseCommit);
+
+                for (Node* node : mNodes)
+                {
+                    node->mTask->getTransaction().execute();
+                }
+            }
+
+            const Support::Vector<CTaskGraph::Node*>& CTaskGraph::getNodes(void) const
+            {
+                return mNodes;
+            }
+
+            Common::U32 CTaskGraph::getColorCount(void) const
+            {
+                return mColorCount;
+            }
+
+            Common::U32 CTaskGraph::getEdgeCount(void) const
+            {
+                return mEdgeCount;
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
@@ -41,6 +41,11 @@ namespace Kiaro
             {
                 return mResources;
             }
+
+            const Support::UnorderedSet<Common::U32>& ITask::getReadResources(void)
+            {
+                return mReadResources;
+            }
         } // End NameSpace Tasking
     } // End NameSpace Engine
 } // End NameSpace Kiaro
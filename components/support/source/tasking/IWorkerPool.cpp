@@ -0,0 +1,146 @@
+/**
+ *  @file IWorkerPool.cpp
+ *  @brief Source file implementing the IWorkerPool interface methods.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <support/Console.hpp>
+
+#include <support/tasking/IWorkerPool.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! How long destructors wait for their workers before reporting them as stuck.
+            static const Common::U32 sStopTimeoutMS = 5000;
+
+            IWorkerPool::IWorkerPool(void) : mState(POOL_RUNNING), mRunningWorkerCount(0)
+            {
+
+            }
+
+            IWorkerPool::~IWorkerPool(void)
+            {
+                // Derived pools stop in their destructors, this only catches those that never started any workers
+                for (Support::Thread* thread : mThreads)
+                {
+                    thread->join();
+                    delete thread;
+                }
+            }
+
+            void IWorkerPool::onWorkerExit(void)
+            {
+                std::lock_guard<Support::Mutex> lock(mLifecycleMutex);
+
+                --mRunningWorkerCount;
+                mLifecycleCondition.notify_all();
+            }
+
+            void IWorkerPool::stopAndJoin(const Common::C8* name)
+            {
+                if (this->shutdown(false, sStopTimeoutMS))
+                {
+                    return;
+                }
+
+                CONSOLE_ERRORF("%s: %u workers did not stop within %u ms, waiting for them indefinitely.", name, this->getRunningWorkerCount(), sStopTimeoutMS);
+
+                while (!this->join(sStopTimeoutMS))
+                {
+                }
+            }
+
+            POOL_STATE IWorkerPool::getState(void) const
+            {
+                return mState.load(std::memory_order_acquire);
+            }
+
+            bool IWorkerPool::isAcceptingWork(void) const
+            {
+                const POOL_STATE state = this->getState();
+                return state == POOL_RUNNING || state == POOL_DRAINING;
+            }
+
+            const CCancellationToken& IWorkerPool::getStopToken(void) const
+            {
+                return mStopToken;
+            }
+
+            void IWorkerPool::requestStop(const bool drain)
+            {
+                const POOL_STATE requestedState = drain ? POOL_DRAINING : POOL_STOPPING;
+                POOL_STATE state = mState.load(std::memory_order_acquire);
+
+                // States only move forward, so draining never undoes a stop
+                while (state < requestedState && !mState.compare_exchange_weak(state, requestedState, std::memory_order_acq_rel))
+                {
+                }
+
+                if (requestedState == POOL_STOPPING)
+                {
+                    mStopToken.cancel();
+                }
+
+                this->wakeWorkers();
+            }
+
+            bool IWorkerPool::join(const Common::U32 timeoutMS)
+            {
+                if (this->getState() == POOL_RUNNING)
+                {
+                    throw std::logic_error("IWorkerPool: Cannot join workers that were not asked to stop.");
+                }
+
+                std::unique_lock<Support::Mutex> lock(mLifecycleMutex);
+
+                const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+                if (!mLifecycleCondition.wait_until(lock, deadline, [this]() { return mRunningWorkerCount == 0; }))
+                {
+                    lock.unlock();
+
+                    // Draining took too long, so ask whatever is still running to give up
+                    if (this->getState() == POOL_DRAINING)
+                    {
+                        this->requestStop(false);
+                    }
+
+                    return false;
+                }
+
+                // Every worker has returned by now, so these joins do not block
+                for (Support::Thread* thread : mThreads)
+                {
+                    thread->join();
+                    delete thread;
+                }
+
+                mThreads.clear();
+                mState.store(POOL_STOPPED, std::memory_order_release);
+                return true;
+            }
+
+            bool IWorkerPool::shutdown(const bool drain, const Common::U32 timeoutMS)
+            {
+                this->requestStop(drain);
+                return this->join(timeoutMS);
+            }
+
+            Common::U32 IWorkerPool::getRunningWorkerCount(void)
+            {
+                std::lock_guard<Support::Mutex> lock(mLifecycleMutex);
+                return mRunningWorkerCount;
+            }
+        } // End NameSpace Tasking
+    } // End NameSpace Support
+} // End NameSpace Kiaro
@@ -9,11 +9,12 @@
  *  @copyright (c) 2016 Draconic Entity
  */
 
-#include <chrono>
-#include <thread>
+#include <algorithm>
 
+#include <support/FTime.hpp>
 #include <support/Console.hpp>
 #include <support/SSettingsRegistry.hpp>
+#include <support/SProfiler.hpp>
 
 #include <support/tasking/SSynchronousTaskManager.hpp>
 #include <support/tasking/SAsynchronousTaskManager.hpp>
@@ -24,22 +25,111 @@ namespace Kiaro
     {
         namespace Tasking
         {
-            static void workerThreadLogic(WorkerContext* context)
+            /**
+             *  @brief A task executing a single call, used to run posted calls on the workers. A task deleted without running
+             *  destroys its call along with any CPromise captured by it, which fails the future if nothing else completes it.
+             */
+            class CCallTask : public ITask
+            {
+                // Private Members
+                private:
+                    //! The call to execute.
+                    std::function<void(void)> mCall;
+
+                // Public Methods
+                public:
+                    CCallTask(std::function<void(void)> call) : mCall(call)
+                    {
+
+                    }
+
+                    void initialize(void)
+                    {
+
+                    }
+
+                    void deinitialize(void)
+                    {
+
+                    }
+
+                    bool tick(const Common::F32)
+                    {
+                        mCall();
+                        return true;
+                    }
+            };
+
+            void SAsynchronousTaskManager::workerThreadLogic(SAsynchronousTaskManager* manager, WorkerContext* context, const Common::U32 workerIndex,
+                                                             const Platform::Thread::AFFINITY_POLICY affinity)
             {
                 assert(context);
 
-                // Keep running, wait for tasks
+                Platform::Thread::placeCurrentThread("SAsynchronousTaskManager", affinity, workerIndex, true, Platform::Thread::PRIORITY_BACKGROUND);
+                Support::SProfiler::getPointer()->setThreadName(Support::String("Async Worker ") + std::to_string(workerIndex));
+
+                std::unique_lock<Support::Mutex> lock(manager->mMutex);
+
+                // Keep running until asked to stop, or until nothing is left to do while draining
                 while (true)
                 {
-                    if (context->mIsComplete || !context->mTask)
+                    // Nothing to do, so park until a task is scheduled.
+                    manager->mTaskCondition.wait(lock, [manager]() { return manager->getState() != POOL_RUNNING || !manager->mScheduledTasks.empty(); });
+
+                    if (!manager->isAcceptingWork() || manager->mScheduledTasks.empty())
+                    {
+                        break;
+                    }
+
+                    ITask* task = manager->mScheduledTasks.front();
+                    manager->mScheduledTasks.pop_front();
+                    context->mTask = task;
+
+                    // Tick without holding the lock, checking whether we were asked to stop between ticks
+                    bool isComplete = false;
+                    bool isRemoved = false;
+                    Common::U64 lastTickNanoseconds = Support::FTime::getNanoseconds();
+
+                    while (!isComplete && !isRemoved && manager->isAcceptingWork())
                     {
-                        // Nothing to do, just sleep for a moment before restarting the loop.
-                        std::this_thread::sleep_for(std::chrono::milliseconds(32));
-                        continue;
+                        lock.unlock();
+
+                        // Workers tick as often as they can rather than once a frame, so each tick is given the real time
+                        // since the previous one
+                        const Common::U64 tickNanoseconds = Support::FTime::getNanoseconds();
+                        const Common::F32 deltaTimeSeconds = static_cast<Common::F32>(tickNanoseconds - lastTickNanoseconds) / 1000000000.0f;
+                        lastTickNanoseconds = tickNanoseconds;
+
+                        {
+                            PROFILER_SCOPE(AsyncTask);
+                            isComplete = task->tick(deltaTimeSeconds);
+                        }
+
+                        lock.lock();
+
+                        isRemoved = manager->mRemovedTasks.erase(task) != 0;
                     }
 
-                    context->mIsComplete = context->mTask->tick(0.00f);
+                    context->mTask = nullptr;
+
+                    if (isRemoved)
+                    {
+                        manager->mRemovalCondition.notify_all();
+                    }
+                    else if (isComplete)
+                    {
+                        task->mIsComplete = true;
+                        manager->mCompletedTasks.push_back(task);
+                    }
+                    else
+                    {
+                        // We are stopping, so leave the task to be deleted along with everything else still scheduled
+                        manager->mScheduledTasks.push_front(task);
+                    }
                 }
+
+                lock.unlock();
+                manager->onWorkerExit();
             }
 
             SAsynchronousTaskManager::SAsynchronousTaskManager(void) : mPoolSize(Support::SSettingsRegistry::getInstance()->getValue<Common::U8>("System::WorkerThreadCount"))
@@ -50,15 +140,16 @@ namespace Kiaro
                     return;
                 }
 
+                const Platform::Thread::AFFINITY_POLICY affinity = static_cast<Platform::Thread::AFFINITY_POLICY>(
+                    Support::SSettingsRegistry::getInstance()->getValue<Common::U8>("System::WorkerThreadAffinity"));
+
                 for (Common::U8 iteration = 0; iteration < mPoolSize; ++iteration)
                 {
                     WorkerContext* currentWorker = new WorkerContext();
                     currentWorker->mTask = nullptr;
-                    currentWorker->mIsComplete = true;
-                    currentWorker->mThread = new Support::Thread(workerThreadLogic, currentWorker);
-                    currentWorker->mThread->detach();
+                    mWorkers.push_back(currentWorker);
 
-                    mIdleWorkers.insert(mIdleWorkers.end(), currentWorker);
+                    this->startWorker(workerThreadLogic, this, currentWorker, iteration, affinity);
                 }
 
                 CONSOLE_INFOF("Initialized with %u workers.", mPoolSize);
@@ -66,51 +157,96 @@ namespace Kiaro
 
             SAsynchronousTaskManager::~SAsynchronousTaskManager(void)
             {
-                // Kill any active workers
-                for (WorkerContext* worker : mActiveWorkers)
+                // Workers stop after their current tick returns
+                this->stopAndJoin("SAsynchronousTaskManager");
+
+                for (WorkerContext* worker : mWorkers)
                 {
                     delete worker;
                 }
 
-                // Kill inactive workers
-                for (WorkerContext* worker : mIdleWorkers)
+                // Anything left was never completed. Deleting calls breaks the promises they hold, and the continuations
+                // of those may post further calls, so keep going until nothing is left
+                while (!mScheduledTasks.empty() || !mCompletedTasks.empty() || !mDelegatedTasks.empty() || !mMainThreadCalls.empty())
                 {
-                    delete worker;
+                    Support::Deque<ITask*> scheduledTasks;
+                    Support::Vector<ITask*> completedTasks;
+                    Support::Vector<ITask*> delegatedTasks;
+                    Support::Vector<std::function<void(void)>> mainThreadCalls;
+
+                    {
+                        std::lock_guard<Support::Mutex> lock(mMutex);
+                        scheduledTasks.swap(mScheduledTasks);
+                        completedTasks.swap(mCompletedTasks);
+                        delegatedTasks.swap(mDelegatedTasks);
+                        mainThreadCalls.swap(mMainThreadCalls);
+                    }
+
+                    for (ITask* task : scheduledTasks)
+                    {
+                        delete task;
+                    }
+
+                    for (ITask* task : completedTasks)
+                    {
+                        delete task;
+                    }
+
+                    for (ITask* task : delegatedTasks)
+                    {
+                        delete task;
+                    }
                 }
             }
 
             void SAsynchronousTaskManager::tick(void)
             {
-                // If we've got any scheduled tasks, hand it off to some idle worker
-                for (size_t iteration = 0; iteration < mScheduledTasks.size() && iteration < mIdleWorkers.size(); ++iteration)
+                Support::Vector<ITask*> completedTasks;
+                Support::Vector<ITask*> delegatedTasks;
+                Support::Vector<std::function<void(void)>> mainThreadCalls;
+
                 {
-                    // TODO (Robert MacGregor#9): More efficiency?
-                    WorkerContext* currentWorker = *mIdleWorkers.begin();
-                    mIdleWorkers.erase(currentWorker);
-                    ITask* currentTask = mScheduledTasks.front();
-                    mScheduledTasks.pop();
-                    currentWorker->mTask = currentTask;
-                    currentWorker->mIsComplete = false;
-                    mActiveWorkers.insert(mActiveWorkers.end(), currentWorker);
+                    std::lock_guard<Support::Mutex> lock(mMutex);
+                    completedTasks.swap(mCompletedTasks);
+                    delegatedTasks.swap(mDelegatedTasks);
+                    mainThreadCalls.swap(mMainThreadCalls);
                 }
 
-                // Do we have any tasks that have completed?
-                for (WorkerContext* currentWorker : mActiveWorkers)
+                for (ITask* task : delegatedTasks)
                 {
-                    if (currentWorker->mIsComplete)
-                    {
-                        // TODO (Robert MacGregor#9): Task completion notice?
-                        delete currentWorker->mTask;
-                        currentWorker->mTask = nullptr;
-                        mActiveWorkers.erase(currentWorker);
-                        mIdleWorkers.insert(mIdleWorkers.end(), currentWorker);
-                    }
+                    SSynchronousTaskManager::getInstance()->addTask(task);
+                }
+
+                for (ITask* task : completedTasks)
+                {
+                    delete task;
+                }
+
+                // Calls may post further calls; those run on the next tick
+                for (std::function<void(void)>& call : mainThreadCalls)
+                {
+                    call();
                 }
             }
 
+            void SAsynchronousTaskManager::wakeWorkers(void)
+            {
+                // Taking the lock orders the state change before any worker checks it again
+                {
+                    std::lock_guard<Support::Mutex> lock(mMutex);
+                }
+
+                mTaskCondition.notify_all();
+            }
+
             size_t SAsynchronousTaskManager::getIdleWorkerCount(void)
             {
-                return mIdleWorkers.size();
+                std::lock_guard<Support::Mutex> lock(mMutex);
+
+                return std::count_if(mWorkers.begin(), mWorkers.end(), [](const WorkerContext* worker)
+                {
+                    return worker->mTask == nullptr;
+                });
             }
 
             size_t SAsynchronousTaskManager::getWorkerPoolSize(void)
@@ -125,14 +261,21 @@ namespace Kiaro
                     throw std::runtime_error("SAsynchronousTaskManager: Cannot add a NULL task.");
                 }
 
-                // Config demands that we don't do anything asynchronously, so we delegate to the synchronous tasker
-                if (mPoolSize == 0)
                 {
-                    SSynchronousTaskManager::getInstance()->addTask(task);
-                    return false;
+                    std::lock_guard<Support::Mutex> lock(mMutex);
+
+                    // Config demands that we don't do anything asynchronously or the workers are going away, so we delegate to
+                    // the synchronous tasker on the next tick
+                    if (mPoolSize == 0 || !this->isAcceptingWork())
+                    {
+                        mDelegatedTasks.push_back(task);
+                        return false;
+                    }
+
+                    mScheduledTasks.push_back(task);
                 }
 
-                mScheduledTasks.push(task);
+                mTaskCondition.notify_one();
                 return true;
             }
 
@@ -143,18 +286,60 @@ namespace Kiaro
                     throw std::runtime_error("SAsynchronousTaskManager: Cannot remove a NULL task.");
                 }
 
-                for (WorkerContext* currentWorker: mActiveWorkers)
+                std::unique_lock<Support::Mutex> lock(mMutex);
+
+                auto delegated = std::find(mDelegatedTasks.begin(), mDelegatedTasks.end(), task);
+                if (delegated != mDelegatedTasks.end())
+                {
+                    mDelegatedTasks.erase(delegated);
+                    return true;
+                }
+
+                if (mPoolSize == 0)
+                {
+                    lock.unlock();
+                    return SSynchronousTaskManager::getInstance()->removeTask(task);
+                }
+
+                auto scheduled = std::find(mScheduledTasks.begin(), mScheduledTasks.end(), task);
+                if (scheduled != mScheduledTasks.end())
+                {
+                    mScheduledTasks.erase(scheduled);
+                    return true;
+                }
+
+                for (WorkerContext* currentWorker : mWorkers)
                 {
                     if (currentWorker->mTask == task)
                     {
-                        currentWorker->mIsComplete = true;
-                        currentWorker->mTask = nullptr;
+                        // The worker notices the removal once its current tick returns
+                        mRemovedTasks.insert(task);
+                        mRemovalCondition.wait(lock, [currentWorker, task]() { return currentWorker->mTask != task; });
                         return true;
                     }
                 }
 
                 return false;
             }
+
+            void SAsynchronousTaskManager::post(std::function<void(void)> call, const EXECUTION_CONTEXT context)
+            {
+                if (context == EXECUTION_INLINE)
+                {
+                    call();
+                    return;
+                }
+
+                // Without workers, calls meant for them run on the main thread instead
+                if (context == EXECUTION_WORKER && mPoolSize != 0 && this->isAcceptingWork())
+                {
+                    this->addTask(new CCallTask(call));
+                    return;
+                }
+
+                std::lock_guard<Support::Mutex> lock(mMutex);
+                mMainThreadCalls.push_back(call);
+            }
         } // End NameSpace Tasking
     } // End NameSpace Engine
 } // End NameSpace Kiaro
@@ -20,11 +20,15 @@ namespace Kiaro
         {
             void SSynchronousTaskManager::tick(const Common::F32 deltaTime)
             {
-                for (auto it = mTaskList.begin(); it != mTaskList.end(); it++)
+                for (auto it = mTaskList.begin(); it != mTaskList.end();)
                 {
                     if ((*it)->tick(deltaTime))
                     {
-                        mTaskList.erase(it);
+                        it = mTaskList.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
                     }
                 }
             }
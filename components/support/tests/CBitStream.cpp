@@ -169,6 +169,25 @@ namespace Kiaro
             }
         }
 
+        TEST(BitStream, RawBytes)
+        {
+            CBitStream stream(4, nullptr, 0, 4);
+            const Common::C8 payload[] = "Raw payload data";
+
+            // Writing more than the resize length at once must still fit
+            stream << static_cast<Common::U16>(1337);
+            EXPECT_NO_THROW(stream.writeBytes(payload, sizeof(payload)));
+            EXPECT_EQ(stream.getPointer(), sizeof(Common::U16) + sizeof(payload));
+
+            stream.setPointer(0);
+            EXPECT_EQ(stream.pop<Common::U16>(), 1337);
+            EXPECT_FALSE(memcmp(stream.popBytes(sizeof(payload)), payload, sizeof(payload)));
+            EXPECT_THROW(stream.popBytes(1), std::underflow_error);
+
+            CBitStream fixedStream(4);
+            EXPECT_THROW(fixedStream.writeBytes(payload, sizeof(payload)), std::overflow_error);
+        }
+
         TEST(BitStream, EndianSwapping)
         {
             CBitStream stream(32);
@@ -0,0 +1,93 @@
+/**
+ *  @file CBoundedMPSCQueue.cpp
+ *  @brief Source file containing coding for the CBoundedMPSCQueue tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <gtest/gtest.h>
+
+#include <support/types.hpp>
+#include <support/Vector.hpp>
+#include <support/CBoundedMPSCQueue.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        TEST(CBoundedMPSCQueue, Capacity)
+        {
+            CBoundedMPSCQueue<Common::U32> queue(4);
+            Common::U32 element = 0;
+
+            EXPECT_FALSE(queue.tryPop(element));
+
+            for (Common::U32 iteration = 0; iteration < 4; ++iteration)
+            {
+                EXPECT_TRUE(queue.tryPush(iteration));
+            }
+
+            // Full until the consumer frees a slot
+            EXPECT_FALSE(queue.tryPush(4));
+            EXPECT_TRUE(queue.tryPop(element));
+            EXPECT_EQ(element, 0);
+            EXPECT_TRUE(queue.tryPush(4));
+
+            for (Common::U32 iteration = 1; iteration < 5; ++iteration)
+            {
+                EXPECT_TRUE(queue.tryPop(element));
+                EXPECT_EQ(element, iteration);
+            }
+
+            EXPECT_FALSE(queue.tryPop(element));
+            EXPECT_EQ(queue.getPushCount(), 5);
+            EXPECT_EQ(queue.getPopCount(), 5);
+        }
+
+        TEST(CBoundedMPSCQueue, Producers)
+        {
+            const Common::U32 producerCount = 4;
+            const Common::U32 elementCount = 10000;
+
+            CBoundedMPSCQueue<Common::U32> queue(64);
+            Support::Vector<Support::Thread> producers;
+
+            for (Common::U32 producerIndex = 0; producerIndex < producerCount; ++producerIndex)
+            {
+                producers.push_back(Support::Thread([&queue, producerIndex, elementCount]()
+                {
+                    for (Common::U32 iteration = 0; iteration < elementCount; ++iteration)
+                    {
+                        while (!queue.tryPush(producerIndex * elementCount + iteration))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                }));
+            }
+
+            // Every element arrives once, in order per producer
+            Support::Vector<Common::U32> nextElements(producerCount, 0);
+            for (Common::U32 received = 0; received < producerCount * elementCount;)
+            {
+                Common::U32 element = 0;
+
+                if (queue.tryPop(element))
+                {
+                    const Common::U32 producerIndex = element / elementCount;
+                    EXPECT_EQ(element % elementCount, nextElements[producerIndex]++);
+                    ++received;
+                }
+            }
+
+            for (Support::Thread& producer : producers)
+            {
+                producer.join();
+            }
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
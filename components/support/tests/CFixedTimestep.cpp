@@ -0,0 +1,84 @@
+/**
+ *  @file CFixedTimestep.cpp
+ *  @brief Source file containing coding for the CFixedTimestep tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <support/CFixedTimestep.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        TEST(CFixedTimestep, Accumulation)
+        {
+            CFixedTimestep timestep(32000, 4);
+
+            // Frames shorter than a step only accumulate
+            EXPECT_EQ(timestep.addTime(16000), 0);
+            EXPECT_FALSE(timestep.consumeStep());
+            EXPECT_FLOAT_EQ(timestep.getInterpolationAlpha(), 0.5f);
+            EXPECT_EQ(timestep.getTimeUntilNextStepMicroseconds(), 16000);
+
+            EXPECT_EQ(timestep.addTime(56000), 2);
+            EXPECT_EQ(timestep.getTimeUntilNextStepMicroseconds(), 0);
+
+            EXPECT_TRUE(timestep.consumeStep());
+            EXPECT_EQ(timestep.getTickNumber(), 1);
+            EXPECT_TRUE(timestep.consumeStep());
+            EXPECT_EQ(timestep.getTickNumber(), 2);
+            EXPECT_FALSE(timestep.consumeStep());
+
+            EXPECT_FLOAT_EQ(timestep.getInterpolationAlpha(), 0.25f);
+            EXPECT_FLOAT_EQ(timestep.getStepSeconds(), 0.032f);
+
+            // Many uneven frames produce exactly as many steps as the total time holds
+            for (Common::U32 iteration = 0; iteration < 1000; ++iteration)
+            {
+                timestep.addTime(iteration % 2 == 0 ? 7000 : 13000);
+
+                while (timestep.consumeStep())
+                {
+                }
+            }
+
+            EXPECT_EQ(timestep.getTickNumber(), (72000 + 10000000) / 32000);
+            EXPECT_EQ(timestep.getDroppedStepCount(), 0);
+        }
+
+        TEST(CFixedTimestep, CatchUpLimit)
+        {
+            CFixedTimestep timestep(10000, 3);
+
+            // A long stall hands out at most the limit and drops the rest, keeping the partial step
+            EXPECT_EQ(timestep.addTime(105000), 3);
+            EXPECT_EQ(timestep.getDroppedStepCount(), 7);
+
+            Common::U32 consumedSteps = 0;
+            while (timestep.consumeStep())
+            {
+                ++consumedSteps;
+            }
+
+            EXPECT_EQ(consumedSteps, 3);
+            EXPECT_EQ(timestep.getTickNumber(), 3);
+            EXPECT_FLOAT_EQ(timestep.getInterpolationAlpha(), 0.5f);
+
+            timestep.setMaxStepsPerUpdate(1);
+            EXPECT_EQ(timestep.addTime(25000), 1);
+            EXPECT_EQ(timestep.getDroppedStepCount(), 9);
+
+            EXPECT_THROW(timestep.setMaxStepsPerUpdate(0), std::logic_error);
+            EXPECT_THROW(CFixedTimestep(0, 1), std::logic_error);
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
@@ -0,0 +1,94 @@
+/**
+ *  @file CLatencyHistogram.cpp
+ *  @brief Source file containing coding for the CLatencyHistogram tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <gtest/gtest.h>
+
+#include <support/CLatencyHistogram.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        TEST(CLatencyHistogram, Percentiles)
+        {
+            CLatencyHistogram histogram;
+            EXPECT_EQ(histogram.getPercentile(50.0), 0);
+
+            // Values below the sub bucket count are exact
+            for (Common::U64 value = 1; value <= 50; ++value)
+            {
+                histogram.record(value);
+            }
+
+            EXPECT_EQ(histogram.getCount(), 50);
+            EXPECT_EQ(histogram.getMinimum(), 1);
+            EXPECT_EQ(histogram.getMaximum(), 50);
+            EXPECT_EQ(histogram.getPercentile(50.0), 25);
+            EXPECT_EQ(histogram.getPercentile(100.0), 50);
+            EXPECT_EQ(histogram.getPercentile(0.0), 1);
+
+            // A single stall among many fast frames shows up in the tail but not the median
+            histogram.clear();
+            for (Common::U32 iteration = 0; iteration < 990; ++iteration)
+            {
+                histogram.record(2000000);
+            }
+
+            for (Common::U32 iteration = 0; iteration < 10; ++iteration)
+            {
+                histogram.record(80000000);
+            }
+
+            EXPECT_NEAR(histogram.getPercentile(50.0), 2000000, 2000000 / 32);
+            EXPECT_NEAR(histogram.getPercentile(99.0), 2000000, 2000000 / 32);
+            EXPECT_NEAR(histogram.getPercentile(99.5), 80000000, 80000000 / 32);
+            EXPECT_EQ(histogram.getMaximum(), 80000000);
+        }
+
+        TEST(CLatencyHistogram, Precision)
+        {
+            // Every value lands in a bucket no wider than about 3% of it
+            for (Common::U64 value = 64; value < (1ULL << 40); value = value * 3 / 2 + 7)
+            {
+                CLatencyHistogram histogram;
+                histogram.record(value);
+                histogram.record(value * 2);
+
+                const Common::U64 median = histogram.getPercentile(50.0);
+                EXPECT_GE(median, value);
+                EXPECT_LE(median, value + value / 32);
+            }
+
+            // Values beyond the covered range still count and keep their exact maximum
+            CLatencyHistogram histogram;
+            histogram.record(1ULL << 50);
+            EXPECT_EQ(histogram.getPercentile(50.0), 1ULL << 50);
+        }
+
+        TEST(CLatencyHistogram, Merge)
+        {
+            CLatencyHistogram first;
+            CLatencyHistogram second;
+
+            first.record(100);
+            second.record(5);
+            second.record(900);
+
+            first.merge(second);
+            first.merge(CLatencyHistogram());
+
+            EXPECT_EQ(first.getCount(), 3);
+            EXPECT_EQ(first.getMinimum(), 5);
+            EXPECT_EQ(first.getMaximum(), 900);
+            EXPECT_NEAR(first.getPercentile(50.0), 100, 100 / 32);
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
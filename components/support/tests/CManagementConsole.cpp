@@ -11,6 +11,7 @@
 
 #include <gtest/gtest.h>
 
+#include <support/Console.hpp>
 #include <support/CManagementConsole.hpp>
 
 namespace Kiaro
@@ -88,6 +89,28 @@ namespace Kiaro
             EXPECT_EQ("b", testInstance.mGotParams[1]);
             EXPECT_EQ("c", testInstance.mGotParams[2]);
         }
+
+        TEST(CManagementConsole, Input)
+        {
+            sFunctionCalled = false;
+            CManagementConsole console;
+
+            EXPECT_NO_THROW(console.registerFunction("testStatic", testStatic));
+            EXPECT_NO_THROW(console.registerFunction("another", testStatic));
+
+            // Remote input may be blank or carry stray separators
+            EXPECT_TRUE(console.eval(""));
+            EXPECT_TRUE(console.eval("    ;  ; "));
+            EXPECT_FALSE(sFunctionCalled);
+            EXPECT_FALSE(console.eval("missing"));
+
+            const Support::Vector<Support::String> names = console.getFunctionNames();
+            ASSERT_EQ(2, names.size());
+            EXPECT_EQ("another", names[0]);
+            EXPECT_EQ("testStatic", names[1]);
+
+            // The error logged for the missing function must not reach listeners registered by later tests
+            Console::flush();
+        }
     } // End Namespace Support
 } // End namespace Kiaro
-
@@ -12,6 +12,8 @@
 #include <gtest/gtest.h>
 
 #include <support/UnorderedMap.hpp>
+#include <support/Vector.hpp>
+#include <support/types.hpp>
 #include <support/Console.hpp>
 
 namespace Kiaro
@@ -46,13 +48,108 @@ namespace Kiaro
                 for (Common::U32 iteration = 0; iteration < 10; iteration++)
                 {
                     WriteLog(MESSAGE_INFO);
+                    Console::flush();
                     EXPECT_EQ(sLogCounts[MESSAGE_INFO], iteration + 1);
                     EXPECT_EQ(sLogCounts[MESSAGE_ERROR], 0);
                 }
 
-                sLogResponders.clear();
+                Console::clearListeners();
                 sLogCounts.clear();
             }
+
+            static Support::Vector<Support::String> sMessages;
+
+            static void RecordingListener(MESSAGE_TYPE type, const Support::String& message)
+            {
+                sMessages.push_back(message);
+            }
+
+            TEST(Console, Arguments)
+            {
+                Console::registerListener(RecordingListener, MESSAGE_INFO);
+
+                // Strings are copied when written, so changing them afterwards has no effect
+                Common::C8 name[] = "first";
+                Console::writef(MESSAGE_INFO, "%s %d %.2f %llu %c", name, -5, 1.5, 1ULL << 40, 'x');
+                name[0] = 'F';
+
+                // Anything longer than the old fixed buffer arrives whole
+                const Support::String longText(1000, 'a');
+                Console::writef(MESSAGE_INFO, "%s|%s", longText.data(), "end");
+                Console::write(MESSAGE_INFO, "No %s formatting");
+
+                Console::flush();
+                ASSERT_EQ(sMessages.size(), 3);
+                EXPECT_EQ(sMessages[0], "first -5 1.50 1099511627776 x");
+                EXPECT_EQ(sMessages[1], longText + "|end");
+                EXPECT_EQ(sMessages[2], "No %s formatting");
+
+                Console::clearListeners();
+                sMessages.clear();
+            }
+
+            TEST(Console, Severity)
+            {
+                Console::registerListener(RecordingListener, MESSAGE_INFO);
+                Console::registerListener(RecordingListener, MESSAGE_WARNING);
+
+                Console::setMinimumSeverity(MESSAGE_WARNING);
+                Console::writef(MESSAGE_INFO, "Filtered %u", 1);
+                Console::writef(MESSAGE_WARNING, "Written %u", 2);
+
+                Console::setMinimumSeverity(MESSAGE_DEBUG);
+                Console::writef(MESSAGE_INFO, "Written %u", 3);
+
+                Console::flush();
+                ASSERT_EQ(sMessages.size(), 2);
+                EXPECT_EQ(sMessages[0], "Written 2");
+                EXPECT_EQ(sMessages[1], "Written 3");
+
+                Console::clearListeners();
+                sMessages.clear();
+            }
+
+            TEST(Console, Threads)
+            {
+                Console::registerListener(RecordingListener, MESSAGE_WARNING);
+
+                // Warnings wait for room rather than being dropped, so every message must arrive in order per thread
+                const Common::U32 threadCount = 4;
+                const Common::U32 messageCount = CONSOLE_QUEUE_CAPACITY / 2;
+                Support::Vector<Support::Thread> threads;
+
+                for (Common::U32 threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+                {
+                    threads.push_back(Support::Thread([threadIndex, messageCount]()
+                    {
+                        for (Common::U32 iteration = 0; iteration < messageCount; ++iteration)
+                        {
+                            Console::writef(MESSAGE_WARNING, "%u %u", threadIndex, iteration);
+                        }
+                    }));
+                }
+
+                for (Support::Thread& thread : threads)
+                {
+                    thread.join();
+                }
+
+                Console::flush();
+                ASSERT_EQ(sMessages.size(), threadCount * messageCount);
+
+                Support::Vector<Common::U32> nextMessages(threadCount, 0);
+                for (const Support::String& message : sMessages)
+                {
+                    Common::U32 threadIndex = 0;
+                    Common::U32 iteration = 0;
+                    ASSERT_EQ(sscanf(message.data(), "%u %u", &threadIndex, &iteration), 2);
+                    ASSERT_LT(threadIndex, threadCount);
+                    EXPECT_EQ(iteration, nextMessages[threadIndex]++);
+                }
+
+                Console::clearListeners();
+                sMessages.clear();
+            }
         }
     } // End Namespace Support
 } // End namespace Kiaro
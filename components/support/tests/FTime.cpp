@@ -10,6 +10,7 @@
  */
 
 #include <chrono>
+#include <stdexcept>
 #include <thread>
 
 #include <gtest/gtest.h>
@@ -48,6 +49,81 @@ namespace Kiaro
 
                 FTime::clearTimers();
             }
+
+            TEST(FTime, ThreadTimers)
+            {
+                // Every thread has its own timer stack, so a timer elsewhere does not change our identifiers
+                FTime::timer timer = FTime::startTimer();
+
+                std::thread thread([]()
+                {
+                    FTime::timer otherTimer = FTime::startTimer();
+                    EXPECT_EQ(1, otherTimer);
+                    EXPECT_NO_THROW(FTime::stopTimer(otherTimer));
+                });
+                thread.join();
+
+                EXPECT_EQ(2, FTime::startTimer());
+                FTime::clearTimers();
+                EXPECT_THROW(FTime::stopTimer(timer), std::runtime_error);
+            }
+
+            TEST(FTime, ScopedTimer)
+            {
+                // Calibrating up front means the conversions below do not wait
+                FTime::calibrateCounter();
+
+                Common::U64 totalNanoseconds = 0;
+
+                const Common::U64 startNanoseconds = FTime::getNanoseconds();
+                {
+                    FTime::CScopedTimer scope(totalNanoseconds);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                }
+                const Common::U64 elapsedNanoseconds = FTime::getNanoseconds() - startNanoseconds;
+
+                // The fast counter agrees with the real clock after calibration
+                EXPECT_GE(totalNanoseconds, 15000000);
+                EXPECT_LE(totalNanoseconds, elapsedNanoseconds + 1000000);
+
+                // Timers add to their total rather than replacing it
+                {
+                    FTime::CScopedTimer scope(totalNanoseconds);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                }
+                EXPECT_GE(totalNanoseconds, 31000000);
+            }
+
+            TEST(FTime, SimulationClock)
+            {
+                const Common::U64 startNanoseconds = FTime::getSimTimeNanoseconds();
+
+                FTime::advanceSimTime(5000000);
+                EXPECT_EQ(FTime::getSimTimeNanoseconds(), startNanoseconds + 5000000);
+
+                FTime::setSimTimePaused(true);
+                EXPECT_TRUE(FTime::isSimTimePaused());
+                FTime::advanceSimTime(5000000);
+                EXPECT_EQ(FTime::getSimTimeNanoseconds(), startNanoseconds + 5000000);
+
+                // The real clock keeps going regardless
+                const Common::U64 realStartMilliseconds = FTime::getMilliseconds();
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                EXPECT_GE(FTime::getMilliseconds(), realStartMilliseconds + 2);
+                FTime::setSimTimePaused(false);
+
+                FTime::setSimTimeScale(0.5f);
+                FTime::advanceSimTime(4000000);
+                EXPECT_EQ(FTime::getSimTimeNanoseconds(), startNanoseconds + 7000000);
+                FTime::setSimTimeScale(1.0f);
+
+                EXPECT_THROW(FTime::setSimTimeScale(-1.0f), std::invalid_argument);
+
+                // Sim time is kept in 64 bits, so days of it do not wrap
+                const Common::U64 dayNanoseconds = 24ULL * 60ULL * 60ULL * 1000000000ULL;
+                FTime::advanceSimTime(dayNanoseconds);
+                EXPECT_EQ(FTime::getSimTimeMilliseconds(), (startNanoseconds + 7000000 + dayNanoseconds) / 1000000);
+            }
         }
     } // End Namespace Support
 } // End namespace Kiaro
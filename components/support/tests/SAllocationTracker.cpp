@@ -0,0 +1,209 @@
+/**
+ *  @file SAllocationTracker.cpp
+ *  @brief Source file containing coding for the SAllocationTracker tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <support/SProfiler.hpp>
+#include <support/SAllocationTracker.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        //! Returns the statistics of the tag or zone by the given name, or statistics of nothing if it never allocated.
+        static SAllocationTracker::Statistics findStatistics(const Support::Vector<SAllocationTracker::Statistics>& statistics, const Support::String& name)
+        {
+            for (const SAllocationTracker::Statistics& entry : statistics)
+            {
+                if (entry.mName == name)
+                {
+                    return entry;
+                }
+            }
+
+            SAllocationTracker::Statistics result;
+            result.mName = name;
+            result.mAllocationCount = result.mAllocatedBytes = result.mLiveAllocations = result.mLiveBytes = 0;
+            result.mAllocationsPerFrame = result.mBytesPerFrame = 0.0;
+            return result;
+        }
+
+        TEST(SAllocationTracker, Tags)
+        {
+            const Common::U16 tag = SAllocationTracker::internTag("TestTags");
+            EXPECT_NE(tag, SAllocationTracker::sUntagged);
+            EXPECT_EQ(tag, SAllocationTracker::internTag("TestTags"));
+            EXPECT_EQ(SAllocationTracker::getTagName(tag), "TestTags");
+            EXPECT_EQ(SAllocationTracker::getTagName(SAllocationTracker::sUntagged), "Untagged");
+            EXPECT_THROW(SAllocationTracker::getTagName(SAllocationTracker::sTagCapacity), std::out_of_range);
+
+            // Scopes nest and restore the previous tag
+            EXPECT_EQ(SAllocationTracker::getThreadTag(), SAllocationTracker::sUntagged);
+            {
+                CAllocationScope outer(tag);
+                {
+                    CAllocationScope inner(ALLOCATION_TAG(TestTagsInner));
+                    EXPECT_EQ(SAllocationTracker::getTagName(SAllocationTracker::getThreadTag()), "TestTagsInner");
+                }
+
+                EXPECT_EQ(SAllocationTracker::getThreadTag(), tag);
+            }
+
+            EXPECT_EQ(SAllocationTracker::getThreadTag(), SAllocationTracker::sUntagged);
+        }
+
+        TEST(SAllocationTracker, Statistics)
+        {
+            const Common::U16 tag = ALLOCATION_TAG(TestStatistics);
+            const Common::U32 zone = PROFILER_ZONE(TestStatisticsZone);
+
+            // Allocations go to the zone open at the time, frees only to the tag
+            SAllocationTracker::setThreadZone(zone);
+            for (Common::U32 iteration = 0; iteration < 64; ++iteration)
+            {
+                SAllocationTracker::recordAllocation(tag, 100);
+            }
+            SAllocationTracker::setThreadZone(SAllocationTracker::sNoZone);
+
+            for (Common::U32 iteration = 0; iteration < 16; ++iteration)
+            {
+                SAllocationTracker::recordFree(tag, 100);
+            }
+
+            SAllocationTracker::Statistics statistics = findStatistics(SAllocationTracker::getTagStatistics(), "TestStatistics");
+            EXPECT_EQ(statistics.mAllocationCount, 64);
+            EXPECT_EQ(statistics.mAllocatedBytes, 6400);
+            EXPECT_EQ(statistics.mLiveAllocations, 48);
+            EXPECT_EQ(statistics.mLiveBytes, 4800);
+
+            statistics = findStatistics(SAllocationTracker::getZoneStatistics(), "TestStatisticsZone");
+            EXPECT_EQ(statistics.mAllocationCount, 64);
+            EXPECT_EQ(statistics.mAllocatedBytes, 6400);
+
+            const SAllocationTracker::Statistics totals = SAllocationTracker::getTotalStatistics();
+            EXPECT_GE(totals.mLiveBytes, 4800);
+            EXPECT_GE(totals.mAllocationCount, 64);
+
+            // Every rate window spans the same number of frames, whichever frame it started at
+            Common::U32 frames = 0;
+            while (findStatistics(SAllocationTracker::getTagStatistics(), "TestStatistics").mAllocationsPerFrame == 0.0 && frames++ < SAllocationTracker::sRateWindowFrames)
+            {
+                SAllocationTracker::update();
+            }
+
+            statistics = findStatistics(SAllocationTracker::getTagStatistics(), "TestStatistics");
+            EXPECT_DOUBLE_EQ(statistics.mAllocationsPerFrame, 64.0 / SAllocationTracker::sRateWindowFrames);
+            EXPECT_DOUBLE_EQ(statistics.mBytesPerFrame, 6400.0 / SAllocationTracker::sRateWindowFrames);
+            EXPECT_DOUBLE_EQ(findStatistics(SAllocationTracker::getZoneStatistics(), "TestStatisticsZone").mAllocationsPerFrame, 64.0 / SAllocationTracker::sRateWindowFrames);
+
+            // Without allocations, the next window drops back to zero
+            for (Common::U32 frame = 0; frame < SAllocationTracker::sRateWindowFrames; ++frame)
+            {
+                SAllocationTracker::update();
+            }
+
+            EXPECT_DOUBLE_EQ(findStatistics(SAllocationTracker::getTagStatistics(), "TestStatistics").mAllocationsPerFrame, 0.0);
+        }
+
+        TEST(SAllocationTracker, Threads)
+        {
+            const Common::U16 tag = ALLOCATION_TAG(TestThreads);
+            const Common::U32 threadCount = 8;
+            const Common::U32 allocationCount = 10000;
+
+            Support::Vector<Support::Thread> threads;
+            for (Common::U32 thread = 0; thread < threadCount; ++thread)
+            {
+                threads.push_back(Support::Thread([tag, thread]()
+                {
+                    for (Common::U32 iteration = 0; iteration < allocationCount; ++iteration)
+                    {
+                        SAllocationTracker::recordAllocation(tag, thread + 1);
+
+                        if (iteration % 2)
+                        {
+                            SAllocationTracker::recordFree(tag, thread + 1);
+                        }
+                    }
+                }));
+            }
+
+            for (Support::Thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            const SAllocationTracker::Statistics statistics = findStatistics(SAllocationTracker::getTagStatistics(), "TestThreads");
+            EXPECT_EQ(statistics.mAllocationCount, threadCount * allocationCount);
+            EXPECT_EQ(statistics.mLiveAllocations, threadCount * allocationCount / 2);
+            EXPECT_EQ(statistics.mLiveBytes, (threadCount * (threadCount + 1) / 2) * allocationCount / 2);
+        }
+
+        TEST(SAllocationTracker, TrackedAllocator)
+        {
+            {
+                Support::Vector<Common::U64, CTrackedAllocator<Common::U64>> values(CTrackedAllocator<Common::U64>(ALLOCATION_TAG(TestAllocator)));
+                values.resize(1000, 7);
+                EXPECT_EQ(values[999], 7);
+
+                const SAllocationTracker::Statistics statistics = findStatistics(SAllocationTracker::getTagStatistics(), "TestAllocator");
+                EXPECT_EQ(statistics.mLiveBytes, SAllocationTracker::sEnabled ? values.capacity() * sizeof(Common::U64) : 0);
+            }
+
+            const SAllocationTracker::Statistics statistics = findStatistics(SAllocationTracker::getTagStatistics(), "TestAllocator");
+            EXPECT_EQ(statistics.mLiveBytes, 0);
+            EXPECT_EQ(statistics.mAllocationCount != 0, SAllocationTracker::sEnabled);
+        }
+
+        #if defined(KIARO_ALLOCATION_TRACKING)
+            TEST(SAllocationTracker, Hooks)
+            {
+                struct alignas(128) AlignedValue
+                {
+                    Common::U8 mBytes[128];
+                };
+
+                Common::U32* values = nullptr;
+                AlignedValue* aligned = nullptr;
+                {
+                    ALLOCATION_SCOPE(TestHooks);
+                    values = new Common::U32[100];
+                    aligned = new AlignedValue();
+                }
+
+                // Allocations outside of the scope are not counted against it
+                Common::U32* untagged = new Common::U32(1);
+
+                // Used, so that the allocations are not optimized away
+                values[99] = 99;
+                EXPECT_EQ(values[99], 99);
+                EXPECT_EQ(*untagged, 1);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % alignof(AlignedValue), 0);
+
+                SAllocationTracker::Statistics statistics = findStatistics(SAllocationTracker::getTagStatistics(), "TestHooks");
+                EXPECT_EQ(statistics.mLiveAllocations, 2);
+                EXPECT_EQ(statistics.mLiveBytes, sizeof(Common::U32) * 100 + sizeof(AlignedValue));
+
+                // Frees are counted against the tag of the allocation, wherever they happen
+                delete[] values;
+                delete aligned;
+                delete untagged;
+
+                statistics = findStatistics(SAllocationTracker::getTagStatistics(), "TestHooks");
+                EXPECT_EQ(statistics.mLiveAllocations, 0);
+                EXPECT_EQ(statistics.mAllocationCount, 2);
+            }
+        #endif // KIARO_ALLOCATION_TRACKING
+    } // End NameSpace Support
+} // End NameSpace Kiaro
@@ -0,0 +1,78 @@
+/**
+ *  @file SMetricsRegistry.cpp
+ *  @brief Source file containing coding for the SMetricsRegistry tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <support/SMetricsRegistry.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        TEST(SMetricsRegistry, Export)
+        {
+            SMetricsRegistry* registry = SMetricsRegistry::getInstance();
+
+            // Looking a metric up again returns the same one
+            CMetricCounter* counter = registry->getCounter("test_packets_total", "Packets sent.");
+            counter->increment();
+            registry->getCounter("test_packets_total", "Packets sent.")->increment(2);
+            EXPECT_EQ(counter->getValue(), 3);
+
+            registry->getGauge("test_players", "Connected players.", { { "server", "Main \"One\"" } })->set(12);
+
+            CMetricHistogram* histogram = registry->getHistogram("test_tick_seconds", "Tick time.", { 0.01, 0.05 });
+            histogram->observe(0.005);
+            histogram->observe(0.01);
+            histogram->observe(0.02);
+            histogram->observe(1.0);
+
+            const Support::String text = registry->exportText();
+
+            EXPECT_NE(Support::String::npos, text.find("# TYPE test_packets_total counter\ntest_packets_total 3\n"));
+            EXPECT_NE(Support::String::npos, text.find("# HELP test_players Connected players.\n# TYPE test_players gauge\ntest_players{server=\"Main \\\"One\\\"\"} 12\n"));
+            EXPECT_NE(Support::String::npos, text.find("# TYPE test_tick_seconds histogram\n"));
+            EXPECT_NE(Support::String::npos, text.find("test_tick_seconds_bucket{le=\"0.01\"} 2\n"));
+            EXPECT_NE(Support::String::npos, text.find("test_tick_seconds_bucket{le=\"0.05\"} 3\n"));
+            EXPECT_NE(Support::String::npos, text.find("test_tick_seconds_bucket{le=\"+Inf\"} 4\n"));
+            EXPECT_NE(Support::String::npos, text.find("test_tick_seconds_count 4\n"));
+
+            SMetricsRegistry::destroy();
+        }
+
+        TEST(SMetricsRegistry, Collectors)
+        {
+            SMetricsRegistry* registry = SMetricsRegistry::getInstance();
+
+            Common::U32 collectCount = 0;
+            const Common::U32 collector = registry->addCollector([registry, &collectCount]()
+            {
+                registry->getGauge("test_collected", "Set by a collector.")->set(++collectCount);
+            });
+
+            EXPECT_NE(Support::String::npos, registry->exportText().find("test_collected 1\n"));
+            EXPECT_NE(Support::String::npos, registry->exportText().find("test_collected 2\n"));
+
+            registry->removeCollector(collector);
+            registry->exportText();
+            EXPECT_EQ(collectCount, 2);
+
+            // Names are unique across types, and histogram buckets must be ascending
+            EXPECT_THROW(registry->getCounter("test_collected", "Wrong type."), std::logic_error);
+            EXPECT_THROW(registry->getHistogram("test_bad_seconds", "Bad bounds.", { 0.5, 0.1 }), std::invalid_argument);
+            EXPECT_EQ(Support::String::npos, registry->exportText().find("test_bad_seconds"));
+
+            SMetricsRegistry::destroy();
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
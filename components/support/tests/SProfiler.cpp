@@ -12,6 +12,9 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <thread>
 
 #include <support/SProfiler.hpp>
@@ -32,13 +35,211 @@ namespace Kiaro
 
             TEST(SProfiler, BrokenBegin)
             {
+                // Scopes must end innermost first
                 EXPECT_NO_THROW(PROFILER_BEGIN(TestScope));
-                EXPECT_THROW(PROFILER_BEGIN(TestScope), std::runtime_error);
+                EXPECT_NO_THROW(PROFILER_BEGIN(AnotherScope));
+                EXPECT_THROW(PROFILER_END(TestScope), std::runtime_error);
                 Support::SProfiler::destroy();
 
                 FTime::clearTimers();
             }
 
+            TEST(SProfiler, Recursion)
+            {
+                Support::SProfiler* profiler = Support::SProfiler::getPointer(4);
+
+                // The same zone may nest, but only the outermost scope counts towards its samples
+                EXPECT_NO_THROW(PROFILER_BEGIN(TestScope));
+                EXPECT_NO_THROW(PROFILER_BEGIN(TestScope));
+                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                EXPECT_NO_THROW(PROFILER_END(TestScope));
+                EXPECT_NO_THROW(PROFILER_END(TestScope));
+
+                // Counting the inner scope as well would double the time
+                const Common::F32 measuredTime = profiler->getSample("TestScope", 0);
+                EXPECT_TRUE(measuredTime < 0.030f && measuredTime >= 0.014f);
+
+                // Nothing is left open afterwards
+                EXPECT_THROW(PROFILER_END(TestScope), std::runtime_error);
+                Support::SProfiler::destroy();
+            }
+
+            TEST(SProfiler, Unwinding)
+            {
+                Support::SProfiler* profiler = Support::SProfiler::getPointer(4);
+
+                // A scope begun manually and skipped by an exception is discarded by the enclosing scope rather than terminating
+                try
+                {
+                    PROFILER_SCOPE(TestScope);
+                    PROFILER_BEGIN(AnotherScope);
+                    throw std::runtime_error("Unwinding");
+                }
+                catch (std::runtime_error& error)
+                {
+                    EXPECT_STREQ(error.what(), "Unwinding");
+                }
+
+                EXPECT_NO_THROW(profiler->getSample("TestScope", 0));
+                EXPECT_THROW(profiler->getSample("AnotherScope", 0), std::out_of_range);
+                EXPECT_THROW(PROFILER_END(AnotherScope), std::runtime_error);
+                EXPECT_THROW(PROFILER_END(TestScope), std::runtime_error);
+
+                // Without any scope of its zone open, nothing happens
+                EXPECT_NO_THROW(profiler->scopeEndNoThrow(PROFILER_ZONE(TestScope)));
+                Support::SProfiler::destroy();
+            }
+
+            TEST(SProfiler, Hierarchy)
+            {
+                Support::SProfiler* profiler = Support::SProfiler::getPointer(4);
+
+                for (size_t iteration = 0; iteration < 3; iteration++)
+                {
+                    PROFILER_SCOPE(OuterScope);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(4));
+
+                    {
+                        PROFILER_SCOPE(InnerScope);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(8));
+                    }
+                }
+
+                // Every thread has its own scopes, so other threads may profile at the same time
+                std::thread thread([]()
+                {
+                    PROFILER_SCOPE(InnerScope);
+                });
+                thread.join();
+
+                const Support::Vector<Support::SProfiler::HierarchyNode> hierarchy = profiler->getHierarchy();
+                ASSERT_EQ(3, hierarchy.size());
+
+                // Depth first with the most expensive paths first
+                EXPECT_EQ("OuterScope", hierarchy[0].mName);
+                EXPECT_EQ(0, hierarchy[0].mDepth);
+                EXPECT_EQ(3, hierarchy[0].mCallCount);
+                EXPECT_EQ("InnerScope", hierarchy[1].mName);
+                EXPECT_EQ(1, hierarchy[1].mDepth);
+                EXPECT_EQ(3, hierarchy[1].mCallCount);
+                EXPECT_EQ("InnerScope", hierarchy[2].mName);
+                EXPECT_EQ(0, hierarchy[2].mDepth);
+                EXPECT_EQ(1, hierarchy[2].mCallCount);
+
+                EXPECT_GE(hierarchy[0].mTotalSeconds, 0.036);
+                EXPECT_GE(hierarchy[0].mSelfSeconds, 0.012);
+                EXPECT_LT(hierarchy[0].mSelfSeconds, hierarchy[1].mTotalSeconds);
+                EXPECT_EQ(0, profiler->getDroppedRecordCount());
+
+                Support::SProfiler::destroy();
+            }
+
+            TEST(SProfiler, Distribution)
+            {
+                Support::SProfiler* profiler = Support::SProfiler::getPointer(4);
+                profiler->setDistributionWindow(64);
+
+                // A single slow frame among fast ones leaves the median alone but shows in the tail
+                for (size_t iteration = 0; iteration < 11; iteration++)
+                {
+                    PROFILER_BEGIN(TestScope);
+                    if (iteration == 5)
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                    }
+                    PROFILER_END(TestScope);
+
+                    profiler->update();
+                }
+
+                const Support::SProfiler::ZoneDistribution distribution = profiler->getDistribution("TestScope");
+                EXPECT_EQ("TestScope", distribution.mName);
+                EXPECT_EQ(11, distribution.mFrameCount);
+                EXPECT_LT(distribution.mMedianSeconds, 0.005);
+                EXPECT_GE(distribution.mP99Seconds, 0.016);
+                EXPECT_GE(distribution.mMaxSeconds, 0.016);
+                EXPECT_LE(distribution.mP99Seconds, distribution.mMaxSeconds);
+
+                EXPECT_EQ(1, profiler->getDistributions().size());
+                EXPECT_THROW(profiler->getDistribution("RandomScope"), std::out_of_range);
+                EXPECT_THROW(profiler->setDistributionWindow(0), std::logic_error);
+
+                // Changing the window discards what was recorded
+                profiler->setDistributionWindow(4);
+                EXPECT_THROW(profiler->getDistribution("TestScope"), std::out_of_range);
+
+                // Frames older than the window are discarded a slice at a time
+                for (size_t iteration = 0; iteration < 9; iteration++)
+                {
+                    PROFILER_SCOPE(TestScope);
+                    profiler->update();
+                }
+
+                EXPECT_EQ(3, profiler->getDistribution("TestScope").mFrameCount);
+                Support::SProfiler::destroy();
+            }
+
+            TEST(SProfiler, Spikes)
+            {
+                Support::SProfiler* profiler = Support::SProfiler::getPointer(4);
+                profiler->setSpikeBudget("FrameScope", 0.010f);
+
+                for (size_t iteration = 0; iteration < 4; iteration++)
+                {
+                    {
+                        PROFILER_SCOPE(FrameScope);
+
+                        if (iteration == 2)
+                        {
+                            PROFILER_SCOPE(SlowScope);
+                            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                        }
+                    }
+
+                    profiler->update();
+                }
+
+                // Only the slow frame is kept, explained by its breakdown
+                const Support::Vector<Support::SProfiler::Spike> spikes = profiler->getSpikes();
+                ASSERT_EQ(1, spikes.size());
+                EXPECT_EQ(2, spikes[0].mFrame);
+                EXPECT_GE(spikes[0].mSeconds, 0.016);
+
+                ASSERT_EQ(2, spikes[0].mBreakdown.size());
+                EXPECT_EQ("FrameScope", spikes[0].mBreakdown[0].mName);
+                EXPECT_EQ("SlowScope", spikes[0].mBreakdown[1].mName);
+                EXPECT_EQ(1, spikes[0].mBreakdown[1].mDepth);
+                EXPECT_GE(spikes[0].mBreakdown[1].mTotalSeconds, 0.016);
+
+                // Old spikes make way for new ones
+                for (size_t iteration = 0; iteration < Support::SProfiler::sSpikeCapacity + 1; iteration++)
+                {
+                    {
+                        PROFILER_SCOPE(FrameScope);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(11));
+                    }
+
+                    profiler->update();
+                }
+
+                EXPECT_EQ(Support::SProfiler::sSpikeCapacity, profiler->getSpikes().size());
+                EXPECT_EQ(5, profiler->getSpikes()[0].mFrame);
+
+                profiler->clearSpikes();
+                EXPECT_EQ(0, profiler->getSpikes().size());
+
+                // Without a budget nothing is recorded
+                profiler->setSpikeBudget("FrameScope", 0.0f);
+                {
+                    PROFILER_SCOPE(FrameScope);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(11));
+                }
+                profiler->update();
+
+                EXPECT_EQ(0, profiler->getSpikes().size());
+                Support::SProfiler::destroy();
+            }
+
             TEST(SProfiler, Measure)
             {
                 EXPECT_NO_THROW(PROFILER_BEGIN(TestScope));
@@ -140,6 +341,97 @@ namespace Kiaro
 
                 FTime::clearTimers();
             }
+
+            TEST(SProfiler, Capture)
+            {
+                Support::SProfiler* profiler = Support::SProfiler::getPointer(4);
+                profiler->setThreadName("Main");
+
+                const Support::String path = "SProfilerCapture.json";
+                EXPECT_TRUE(profiler->beginCapture(2, path));
+                EXPECT_FALSE(profiler->beginCapture(2, path));
+                EXPECT_TRUE(profiler->isCapturing());
+
+                // Scopes of the frame running when the capture was requested are not recorded
+                {
+                    PROFILER_SCOPE(EarlyScope);
+                }
+                profiler->update();
+
+                for (size_t iteration = 0; iteration < 2; iteration++)
+                {
+                    {
+                        PROFILER_SCOPE(FrameScope);
+
+                        std::thread thread([]()
+                        {
+                            Support::SProfiler::getPointer()->setThreadName("Helper \"Thread\"");
+                            PROFILER_SCOPE(HelperScope);
+                        });
+                        thread.join();
+                    }
+
+                    profiler->update();
+                }
+
+                EXPECT_FALSE(profiler->isCapturing());
+
+                std::ifstream input(path);
+                ASSERT_TRUE(input.is_open());
+                std::stringstream contents;
+                contents << input.rdbuf();
+                const Support::String trace = contents.str();
+
+                EXPECT_NE(Support::String::npos, trace.find("\"traceEvents\""));
+                EXPECT_NE(Support::String::npos, trace.find("{\"name\":\"Main\"}"));
+                EXPECT_NE(Support::String::npos, trace.find("{\"name\":\"Helper \\\"Thread\\\"\"}"));
+                EXPECT_NE(Support::String::npos, trace.find("\"name\":\"FrameScope\",\"ph\":\"X\""));
+                EXPECT_NE(Support::String::npos, trace.find("\"name\":\"HelperScope\",\"ph\":\"X\""));
+                EXPECT_EQ(Support::String::npos, trace.find("EarlyScope"));
+
+                input.close();
+                std::remove(path.data());
+                Support::SProfiler::destroy();
+            }
+
+            TEST(SProfiler, ExitedThreads)
+            {
+                Support::SProfiler* profiler = Support::SProfiler::getPointer(4);
+                profiler->setThreadName("Main");
+
+                std::thread thread([]()
+                {
+                    Support::SProfiler::getPointer()->setThreadName("Exited");
+                    PROFILER_SCOPE(HelperScope);
+                });
+                thread.join();
+
+                // The scopes of the thread are still aggregated, after which its buffer is freed
+                profiler->update();
+                EXPECT_NO_THROW(profiler->getSample("HelperScope", 0));
+
+                // So it no longer shows up in captures
+                const Support::String path = "SProfilerExitedThreads.json";
+                EXPECT_TRUE(profiler->beginCapture(1, path));
+                profiler->update();
+                {
+                    PROFILER_SCOPE(FrameScope);
+                }
+                profiler->update();
+
+                std::ifstream input(path);
+                ASSERT_TRUE(input.is_open());
+                std::stringstream contents;
+                contents << input.rdbuf();
+                const Support::String trace = contents.str();
+
+                EXPECT_NE(Support::String::npos, trace.find("{\"name\":\"Main\"}"));
+                EXPECT_EQ(Support::String::npos, trace.find("Exited"));
+
+                input.close();
+                std::remove(path.data());
+                Support::SProfiler::destroy();
+            }
         }
     } // End Namespace Support
 } // End namespace Kiaro
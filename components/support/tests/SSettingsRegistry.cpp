@@ -32,6 +32,12 @@ namespace Kiaro
             // Different addresses?
             EXPECT_NE(&integerSetting, &settings->getValue<Common::U32>("integer"));
             EXPECT_NE(&floatSetting, &settings->getValue<Common::F32>("float"));
+
+            // String access converts to and from the stored type
+            settings->setStringValue("integer", "42");
+            EXPECT_EQ(42, settings->getValue<Common::U32>("integer"));
+            EXPECT_EQ("42", settings->getStringValue("integer"));
+            EXPECT_THROW(settings->getStringValue("missing"), std::runtime_error);
             SSettingsRegistry::destroy();
         }
 
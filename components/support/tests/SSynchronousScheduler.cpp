@@ -0,0 +1,133 @@
+/**
+ *  @file SSynchronousScheduler.cpp
+ *  @brief Source file containing coding for the SSynchronousScheduler tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include <support/SSynchronousScheduler.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        //! The values written by dispatched events, in dispatch order.
+        static Support::Vector<Common::U32> DispatchedValues;
+
+        static void recordValue(const Common::U32 value)
+        {
+            DispatchedValues.push_back(value);
+        }
+
+        TEST(SSynchronousScheduler, Ordering)
+        {
+            DispatchedValues.clear();
+            SSynchronousScheduler* scheduler = SSynchronousScheduler::getInstance();
+
+            const Common::U32 values[] = { 30, 10, 20, 0, 1 };
+            const Common::U32 waitTimesMS[] = { 30, 10, 20, 0, 0 };
+            for (Common::U32 iteration = 0; iteration < 5; ++iteration)
+            {
+                scheduler->schedule(waitTimesMS[iteration], false, recordValue, values[iteration]);
+            }
+
+            FTime::advanceSimTime(40000000);
+            scheduler->update();
+
+            // Earliest first, with events due at the same time keeping the order they were scheduled in
+            const Support::Vector<Common::U32> expectedValues = { 0, 1, 10, 20, 30 };
+            EXPECT_EQ(DispatchedValues, expectedValues);
+            EXPECT_EQ(scheduler->getEventCount(), 0);
+            EXPECT_EQ(scheduler->getTimeUntilNextEventMS(), std::numeric_limits<Common::U64>::max());
+
+            SSynchronousScheduler::destroy();
+        }
+
+        TEST(SSynchronousScheduler, Cancellation)
+        {
+            DispatchedValues.clear();
+            SSynchronousScheduler* scheduler = SSynchronousScheduler::getInstance();
+
+            Support::Vector<CScheduledEvent*> events;
+            for (Common::U32 iteration = 0; iteration < 200; ++iteration)
+            {
+                events.push_back(scheduler->schedule(100000, false, recordValue, iteration));
+            }
+
+            // Cancelling only flags the events, they are swept once the heap has grown enough
+            for (Common::U32 iteration = 0; iteration < 150; ++iteration)
+            {
+                events[iteration]->cancel();
+            }
+            EXPECT_EQ(scheduler->getEventCount(), 200);
+
+            const Common::U32 dueValue = 1337;
+            scheduler->schedule(0, false, recordValue, dueValue);
+            scheduler->update();
+
+            ASSERT_EQ(DispatchedValues.size(), 1);
+            EXPECT_EQ(DispatchedValues[0], dueValue);
+            EXPECT_EQ(scheduler->getEventCount(), 50);
+
+            // Cancelled events at the front never hide the next live event
+            for (Common::U32 iteration = 150; iteration < 199; ++iteration)
+            {
+                events[iteration]->cancel();
+            }
+            EXPECT_GT(scheduler->getTimeUntilNextEventMS(), 90000);
+            EXPECT_EQ(scheduler->getEventCount(), 1);
+
+            events[199]->cancel();
+            EXPECT_EQ(scheduler->getTimeUntilNextEventMS(), std::numeric_limits<Common::U64>::max());
+            EXPECT_EQ(scheduler->getEventCount(), 0);
+
+            SSynchronousScheduler::destroy();
+        }
+
+        //! The recurring event cancelling itself on its third dispatch.
+        static CScheduledEvent* RecurringEvent = nullptr;
+
+        static void recordRecurring(const Common::U32 value)
+        {
+            recordValue(value);
+
+            if (DispatchedValues.size() == 3)
+            {
+                RecurringEvent->cancel();
+            }
+        }
+
+        TEST(SSynchronousScheduler, Recurring)
+        {
+            DispatchedValues.clear();
+            SSynchronousScheduler* scheduler = SSynchronousScheduler::getInstance();
+
+            // A recurring event that is always due still dispatches only once per update
+            const Common::U32 value = 7;
+            RecurringEvent = scheduler->schedule(0, true, recordRecurring, value);
+
+            scheduler->update();
+            EXPECT_EQ(DispatchedValues.size(), 1);
+            scheduler->update();
+            EXPECT_EQ(DispatchedValues.size(), 2);
+            EXPECT_EQ(scheduler->getEventCount(), 1);
+
+            scheduler->update();
+            EXPECT_EQ(DispatchedValues.size(), 3);
+            EXPECT_EQ(scheduler->getEventCount(), 0);
+
+            scheduler->update();
+            EXPECT_EQ(DispatchedValues.size(), 3);
+
+            SSynchronousScheduler::destroy();
+        }
+    } // End NameSpace Support
+} // End NameSpace Kiaro
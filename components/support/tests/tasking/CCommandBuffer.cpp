@@ -0,0 +1,156 @@
+/**
+ *  @file CCommandBuffer.cpp
+ *  @brief Source file containing coding for the CCommandBuffer tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <memory>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <support/tasking/CCommandBuffer.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! The values written by executed commands, in execution order.
+            static Support::Vector<Common::U32> WrittenValues;
+
+            static void writeValue(const Common::U32 value)
+            {
+                WrittenValues.push_back(value);
+            }
+
+            TEST(CCommandBuffer, Ordering)
+            {
+                WrittenValues.clear();
+
+                // A tiny block forces the buffer to spread its commands across several blocks
+                CCommandBuffer buffer(32);
+                Common::U32 capturedValue = 2;
+
+                buffer.push(writeValue, 1);
+                buffer.push([capturedValue]() { writeValue(capturedValue); });
+                buffer.push(new EasyDelegate::DeferredStaticCaller<void, const Common::U32>(writeValue, 3));
+
+                for (Common::U32 iteration = 4; iteration < 100; ++iteration)
+                {
+                    buffer.push(writeValue, iteration);
+                }
+
+                EXPECT_EQ(buffer.getCommandCount(), 99);
+                EXPECT_TRUE(WrittenValues.empty());
+
+                buffer.execute();
+                EXPECT_TRUE(buffer.empty());
+                EXPECT_EQ(buffer.getUsedBytes(), 0);
+
+                ASSERT_EQ(WrittenValues.size(), 99);
+                for (Common::U32 iteration = 0; iteration < WrittenValues.size(); ++iteration)
+                {
+                    EXPECT_EQ(WrittenValues[iteration], iteration + 1);
+                }
+            }
+
+            TEST(CCommandBuffer, Reuse)
+            {
+                WrittenValues.clear();
+
+                CCommandBuffer buffer(64);
+                for (Common::U32 iteration = 0; iteration < 256; ++iteration)
+                {
+                    buffer.push(writeValue, iteration);
+                }
+                buffer.execute();
+
+                // Once grown, filling the buffer the same way again does not allocate any further blocks
+                const size_t capacity = buffer.getCapacity();
+                for (Common::U32 iteration = 0; iteration < 256; ++iteration)
+                {
+                    buffer.push(writeValue, iteration);
+                }
+                EXPECT_EQ(buffer.getCapacity(), capacity);
+
+                // Cleared commands are destroyed without executing them
+                std::shared_ptr<Common::U32> shared = std::make_shared<Common::U32>(0);
+                buffer.push([shared]() { ++*shared; });
+                EXPECT_EQ(shared.use_count(), 2);
+
+                buffer.clear();
+                EXPECT_EQ(shared.use_count(), 1);
+                EXPECT_EQ(*shared, 0);
+                EXPECT_EQ(WrittenValues.size(), 256);
+            }
+
+            TEST(CCommandBuffer, Move)
+            {
+                static_assert(!std::is_copy_constructible<CCommandBuffer>::value, "CCommandBuffer must not be copyable.");
+                static_assert(!std::is_copy_assignable<CCommandBuffer>::value, "CCommandBuffer must not be copyable.");
+
+                WrittenValues.clear();
+
+                CCommandBuffer source(64);
+                source.push(writeValue, 1u);
+                source.push(writeValue, 2u);
+
+                // Commands move along with the blocks
+                CCommandBuffer moved(std::move(source));
+                EXPECT_EQ(moved.getCommandCount(), 2);
+                EXPECT_TRUE(source.empty());
+                EXPECT_EQ(source.getUsedBytes(), 0);
+
+                // A moved from buffer is still usable
+                source.push(writeValue, 3u);
+                source.execute();
+                EXPECT_EQ(WrittenValues, Support::Vector<Common::U32>({ 3 }));
+
+                // Assigning over a buffer destroys its commands without executing them
+                std::shared_ptr<Common::U32> shared = std::make_shared<Common::U32>(0);
+                source.push([shared]() { ++*shared; });
+
+                source = std::move(moved);
+                EXPECT_EQ(shared.use_count(), 1);
+                EXPECT_EQ(source.getCommandCount(), 2);
+
+                source.execute();
+                EXPECT_EQ(WrittenValues, Support::Vector<Common::U32>({ 3, 1, 2 }));
+                EXPECT_EQ(*shared, 0);
+            }
+
+            TEST(CCommandBuffer, Exceptions)
+            {
+                WrittenValues.clear();
+
+                CCommandBuffer buffer(64);
+                std::shared_ptr<Common::U32> shared = std::make_shared<Common::U32>(0);
+
+                buffer.push(writeValue, 1u);
+                buffer.push([shared]() { throw std::runtime_error("Failed"); });
+                buffer.push([shared]() { ++*shared; });
+                buffer.push(writeValue, 2u);
+
+                // Everything after the throwing command is destroyed without running, including the command itself
+                EXPECT_THROW(buffer.execute(), std::runtime_error);
+                EXPECT_EQ(WrittenValues, Support::Vector<Common::U32>({ 1 }));
+                EXPECT_EQ(shared.use_count(), 1);
+                EXPECT_EQ(*shared, 0);
+                EXPECT_TRUE(buffer.empty());
+                EXPECT_EQ(buffer.getUsedBytes(), 0);
+
+                // Executing again runs nothing twice
+                buffer.push(writeValue, 3u);
+                buffer.execute();
+                EXPECT_EQ(WrittenValues, Support::Vector<Common::U32>({ 1, 3 }));
+            }
+        } // End NameSpace Tasking
+    } // End Namespace Support
+} // End namespace Kiaro
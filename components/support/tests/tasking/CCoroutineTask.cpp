@@ -0,0 +1,113 @@
+/**
+ *  @file CCoroutineTask.cpp
+ *  @brief Source file containing coding for the CCoroutineTask tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <gtest/gtest.h>
+
+#include <support/tasking/CCoroutineTask.hpp>
+
+#if _SUPPORT_USE_COROUTINES_
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! The progress made by the test coroutine.
+            static Common::U32 CoroutineStage = 0;
+
+            static void doNothing(void* data)
+            {
+
+            }
+
+            static CCoroutine runStages(CFuture<Common::U32> future, CJobSystem::CJobCounter& counter)
+            {
+                CoroutineStage = 1;
+                const Common::F32 deltaTimeSeconds = co_await CNextTick();
+                EXPECT_EQ(deltaTimeSeconds, 0.5f);
+
+                CoroutineStage = 2;
+                CoroutineStage = co_await future;
+
+                co_await counter;
+                CoroutineStage = 4;
+
+                co_await CDelay(5);
+                CoroutineStage = 5;
+            }
+
+            static CCoroutine throwException(void)
+            {
+                co_await CNextTick();
+                throw std::logic_error("Failed");
+            }
+
+            TEST(CCoroutineTask, Stages)
+            {
+                CPromise<Common::U32> promise;
+                CJobSystem jobs(0);
+                CJobSystem::CJobCounter counter;
+
+                CJobSystem::Job job;
+                job.mFunction = doNothing;
+                job.mData = nullptr;
+                jobs.submit(job, counter);
+
+                // Coroutines only start once ticked
+                CCoroutineTask task(runStages(promise.getFuture(), counter));
+                EXPECT_EQ(CoroutineStage, 0);
+
+                EXPECT_FALSE(task.tick(0.25f));
+                EXPECT_EQ(CoroutineStage, 1);
+                EXPECT_FALSE(task.tick(0.5f));
+                EXPECT_EQ(CoroutineStage, 2);
+
+                // Nothing resumes the coroutine until what it awaits is ready
+                EXPECT_FALSE(task.tick(0.5f));
+                EXPECT_EQ(CoroutineStage, 2);
+
+                promise.setValue(3u);
+                EXPECT_FALSE(task.tick(0.5f));
+                EXPECT_EQ(CoroutineStage, 3);
+
+                jobs.wait(counter);
+                EXPECT_FALSE(task.tick(0.5f));
+                EXPECT_EQ(CoroutineStage, 4);
+
+                // Delays are measured by the scheduler in sim time
+                SSynchronousScheduler* scheduler = SSynchronousScheduler::getInstance();
+                bool isComplete = false;
+
+                while (!isComplete)
+                {
+                    Support::FTime::advanceSimTime(1000000);
+
+                    scheduler->update();
+                    isComplete = task.tick(0.5f);
+                }
+
+                EXPECT_EQ(CoroutineStage, 5);
+                EXPECT_EQ(task.getException(), nullptr);
+                SSynchronousScheduler::destroy();
+            }
+
+            TEST(CCoroutineTask, Exceptions)
+            {
+                CCoroutineTask task(throwException());
+                EXPECT_FALSE(task.tick(0.0f));
+                EXPECT_TRUE(task.tick(0.0f));
+                EXPECT_THROW(std::rethrow_exception(task.getException()), std::logic_error);
+            }
+        } // End NameSpace Tasking
+    } // End Namespace Support
+} // End namespace Kiaro
+#endif // _SUPPORT_USE_COROUTINES_
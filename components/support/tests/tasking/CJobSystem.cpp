@@ -0,0 +1,262 @@
+/**
+ *  @file CJobSystem.cpp
+ *  @brief Source file containing coding for the CJobSystem tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <support/tasking/CJobSystem.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            static void incrementCounter(void* data)
+            {
+                reinterpret_cast<Support::Atomic<Common::U32>*>(data)->fetch_add(1);
+            }
+
+            //! The state shared by a parent job and the children it spawns.
+            struct ParentState
+            {
+                CJobSystem* mSystem;
+                Support::Vector<CJobSystem::Job> mChildren;
+                Support::Atomic<Common::U32> mExecuted;
+            };
+
+            static void spawnChildren(void* data)
+            {
+                ParentState* state = reinterpret_cast<ParentState*>(data);
+
+                for (CJobSystem::Job& child : state->mChildren)
+                {
+                    child.mFunction = incrementCounter;
+                    child.mData = &state->mExecuted;
+                    state->mSystem->submitChild(child);
+                }
+            }
+
+            //! The state of a job that blocks until released.
+            struct BlockingState
+            {
+                Support::Atomic<bool> mStarted;
+                Support::Atomic<bool> mReleased;
+            };
+
+            static void waitForRelease(void* data)
+            {
+                BlockingState* state = reinterpret_cast<BlockingState*>(data);
+                state->mStarted = true;
+
+                while (!state->mReleased.load())
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            TEST(CWorkStealingDeque, OwnerAndThief)
+            {
+                CWorkStealingDeque<Common::U32*> deque(2);
+                Common::U32 values[5] = { 0, 1, 2, 3, 4 };
+
+                // Pushing past the initial capacity grows the deque
+                for (Common::U32& value : values)
+                {
+                    deque.push(&value);
+                }
+                EXPECT_EQ(deque.getSize(), 5);
+
+                // The owner pops the newest element while thieves steal the oldest
+                Common::U32* result = nullptr;
+                EXPECT_TRUE(deque.pop(result));
+                EXPECT_EQ(*result, 4);
+                EXPECT_TRUE(deque.steal(result));
+                EXPECT_EQ(*result, 0);
+                EXPECT_TRUE(deque.steal(result));
+                EXPECT_EQ(*result, 1);
+                EXPECT_TRUE(deque.pop(result));
+                EXPECT_EQ(*result, 3);
+                EXPECT_TRUE(deque.pop(result));
+                EXPECT_EQ(*result, 2);
+
+                EXPECT_FALSE(deque.pop(result));
+                EXPECT_FALSE(deque.steal(result));
+                EXPECT_EQ(deque.getSize(), 0);
+            }
+
+            TEST(CJobSystem, ManyJobs)
+            {
+                CJobSystem jobs(4);
+                Support::Atomic<Common::U32> executed(0);
+
+                Support::Vector<CJobSystem::Job> submitted(10000);
+                for (CJobSystem::Job& job : submitted)
+                {
+                    job.mFunction = incrementCounter;
+                    job.mData = &executed;
+                }
+
+                CJobSystem::CJobCounter counter;
+                jobs.submit(submitted.data(), submitted.size(), counter);
+                jobs.wait(counter);
+
+                EXPECT_TRUE(counter.isComplete());
+                EXPECT_EQ(executed.load(), 10000);
+            }
+
+            TEST(CJobSystem, ChildJobs)
+            {
+                CJobSystem jobs(4);
+
+                Support::Vector<ParentState> states(16);
+                Support::Vector<CJobSystem::Job> parents(states.size());
+
+                for (size_t iteration = 0; iteration < states.size(); ++iteration)
+                {
+                    states[iteration].mSystem = &jobs;
+                    states[iteration].mChildren.resize(64);
+                    states[iteration].mExecuted = 0;
+
+                    parents[iteration].mFunction = spawnChildren;
+                    parents[iteration].mData = &states[iteration];
+                }
+
+                // Waiting on the parents also waits on every child they spawned
+                CJobSystem::CJobCounter counter;
+                jobs.submit(parents.data(), parents.size(), counter);
+                jobs.wait(counter);
+
+                for (ParentState& state : states)
+                {
+                    EXPECT_EQ(state.mExecuted.load(), 64);
+                }
+
+                // Children may only be spawned from within a job
+                EXPECT_THROW(jobs.submitChild(parents[0]), std::logic_error);
+            }
+
+            TEST(CJobSystem, WaitTimeout)
+            {
+                CJobSystem jobs(1);
+
+                BlockingState state;
+                state.mStarted = false;
+                state.mReleased = false;
+
+                // Give the worker time to park so that the submission has to wake it
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+                CJobSystem::Job job;
+                job.mFunction = waitForRelease;
+                job.mData = &state;
+
+                CJobSystem::CJobCounter counter;
+                jobs.submit(job, counter);
+
+                // The worker must pick the job up on its own, as waiting here would otherwise execute it on this thread
+                while (!state.mStarted)
+                {
+                    std::this_thread::yield();
+                }
+
+                EXPECT_FALSE(jobs.wait(counter, 10));
+                state.mReleased = true;
+                EXPECT_TRUE(jobs.wait(counter, 1000));
+            }
+
+            static void throwError(void* data)
+            {
+                incrementCounter(data);
+                throw std::runtime_error("Job failed");
+            }
+
+            TEST(CJobSystem, Exceptions)
+            {
+                CJobSystem jobs(2);
+                Support::Atomic<Common::U32> executed(0);
+
+                Support::Vector<CJobSystem::Job> submitted(64);
+                for (size_t iteration = 0; iteration < submitted.size(); ++iteration)
+                {
+                    submitted[iteration].mFunction = iteration % 8 ? incrementCounter : throwError;
+                    submitted[iteration].mData = &executed;
+                }
+
+                // Failing jobs still complete, and the waiter gets the exception
+                CJobSystem::CJobCounter counter;
+                jobs.submit(submitted.data(), submitted.size(), counter);
+                EXPECT_THROW(jobs.wait(counter), std::runtime_error);
+                EXPECT_TRUE(counter.isComplete());
+                EXPECT_EQ(executed.load(), 64);
+                EXPECT_EQ(jobs.getCurrentJob(), nullptr);
+
+                // The exception is only reported once, so the counter can be reused
+                submitted.resize(8);
+                jobs.submit(submitted.data() + 1, 7, counter);
+                EXPECT_NO_THROW(jobs.wait(counter));
+                EXPECT_EQ(executed.load(), 71);
+
+                // A job executed by the waiting thread itself must not escape either
+                CJobSystem single(0);
+                single.submit(submitted[0], counter);
+                EXPECT_THROW(single.wait(counter, 1000), std::runtime_error);
+                EXPECT_EQ(single.getCurrentJob(), nullptr);
+            }
+
+            TEST(CJobSystem, NoWorkers)
+            {
+                // Without workers, the waiting thread executes everything itself
+                CJobSystem jobs(0);
+                Support::Atomic<Common::U32> executed(0);
+
+                CJobSystem::Job job;
+                job.mFunction = incrementCounter;
+                job.mData = &executed;
+
+                CJobSystem::CJobCounter counter;
+                jobs.submit(job, counter);
+                EXPECT_EQ(counter.getPendingCount(), 1);
+
+                jobs.wait(counter);
+                EXPECT_EQ(executed.load(), 1);
+            }
+
+            TEST(CJobSystem, Drain)
+            {
+                CJobSystem jobs(2);
+                Support::Atomic<Common::U32> executed(0);
+
+                Support::Vector<CJobSystem::Job> submitted(200);
+                for (CJobSystem::Job& job : submitted)
+                {
+                    job.mFunction = incrementCounter;
+                    job.mData = &executed;
+                }
+
+                // Draining workers execute everything queued before exiting, without anyone waiting on the counter
+                CJobSystem::CJobCounter counter;
+                jobs.submit(submitted.data(), submitted.size(), counter);
+                EXPECT_TRUE(jobs.shutdown(true, 5000));
+                EXPECT_EQ(jobs.getState(), POOL_STOPPED);
+                EXPECT_EQ(jobs.getRunningWorkerCount(), 0);
+                EXPECT_EQ(executed.load(), 200);
+                EXPECT_TRUE(counter.isComplete());
+
+                // Jobs submitted once stopped are executed by whoever waits on them
+                jobs.submit(submitted.data(), submitted.size(), counter);
+                jobs.wait(counter);
+                EXPECT_EQ(executed.load(), 400);
+            }
+        } // End NameSpace Tasking
+    } // End Namespace Support
+} // End namespace Kiaro
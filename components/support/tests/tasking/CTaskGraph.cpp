@@ -0,0 +1,211 @@
+/**
+ *  @file CTaskGraph.cpp
+ *  @brief Source file containing coding for the CTaskGraph tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <gtest/gtest.h>
+
+#include <support/tasking/CTaskGraph.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! The number of tasks currently inside of tick per resource.
+            static Support::Atomic<Common::U32> ResourceUsers[4];
+
+            //! Whether or not two conflicting tasks were ever observed running concurrently.
+            static Support::Atomic<bool> ObservedConflict(false);
+
+            class ResourceTask : public SThreadSystem::IThreadedTask
+            {
+                public:
+                    Common::U32 mTickCount;
+
+                    ResourceTask(const Support::Vector<Common::U32>& writes, const Support::Vector<Common::U32>& reads) : mTickCount(0)
+                    {
+                        mResources.insert(writes.begin(), writes.end());
+                        mReadResources.insert(reads.begin(), reads.end());
+                    }
+
+                    void initialize(void)
+                    {
+
+                    }
+
+                    void deinitialize(void)
+                    {
+
+                    }
+
+                    bool tick(const Common::F32 deltaTimeSeconds)
+                    {
+                        for (const Common::U32 resource : mResources)
+                        {
+                            if (ResourceUsers[resource].fetch_add(1) != 0)
+                            {
+                                ObservedConflict = true;
+                            }
+                        }
+
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+                        for (const Common::U32 resource : mResources)
+                        {
+                            ResourceUsers[resource].fetch_sub(1);
+                        }
+
+                        ++mTickCount;
+                        return true;
+                    }
+            };
+
+            //! The order weighted tasks were started in.
+            static Support::Vector<Common::U32> StartOrder;
+
+            class WeightedTask : public SThreadSystem::IThreadedTask
+            {
+                public:
+                    WeightedTask(const Common::U32 weight)
+                    {
+                        mThreadWeight = weight;
+                    }
+
+                    void initialize(void)
+                    {
+
+                    }
+
+                    void deinitialize(void)
+                    {
+
+                    }
+
+                    bool tick(const Common::F32 deltaTimeSeconds)
+                    {
+                        StartOrder.push_back(mThreadWeight);
+                        return true;
+                    }
+            };
+
+            TEST(CTaskGraph, Coloring)
+            {
+                // Readers of the same resource never conflict
+                ResourceTask readerOne({ }, { 0 });
+                ResourceTask readerTwo({ }, { 0 });
+                EXPECT_FALSE(CTaskGraph::conflicts(&readerOne, &readerTwo));
+
+                // A writer conflicts with readers and other writers
+                ResourceTask writerOne({ 0 }, { });
+                ResourceTask writerTwo({ 0, 1 }, { });
+                EXPECT_TRUE(CTaskGraph::conflicts(&writerOne, &readerOne));
+                EXPECT_TRUE(CTaskGraph::conflicts(&readerTwo, &writerOne));
+                EXPECT_TRUE(CTaskGraph::conflicts(&writerOne, &writerTwo));
+
+                CTaskGraph readers;
+                readers.build(Support::Vector<SThreadSystem::IThreadedTask*>({ &readerOne, &readerTwo }));
+                EXPECT_EQ(readers.getColorCount(), 1);
+                EXPECT_EQ(readers.getEdgeCount(), 0);
+
+                // Two independent pairs of conflicting tasks only form two short chains
+                ResourceTask first({ 1 }, { });
+                ResourceTask second({ 1 }, { });
+                ResourceTask third({ 2 }, { });
+                ResourceTask fourth({ 2 }, { });
+
+                CTaskGraph pairs;
+                pairs.build(Support::Vector<SThreadSystem::IThreadedTask*>({ &first, &second, &third, &fourth }));
+                EXPECT_EQ(pairs.getColorCount(), 2);
+                EXPECT_EQ(pairs.getEdgeCount(), 2);
+
+                const Support::Vector<CTaskGraph::Node*>& nodes = pairs.getNodes();
+                ASSERT_EQ(nodes.size(), 4);
+                EXPECT_EQ(nodes[0]->mTask, &first);
+                EXPECT_EQ(nodes[1]->mTask, &third);
+                ASSERT_EQ(nodes[0]->mSuccessors.size(), 1);
+                EXPECT_EQ(nodes[0]->mSuccessors[0]->mTask, &second);
+                ASSERT_EQ(nodes[1]->mSuccessors.size(), 1);
+                EXPECT_EQ(nodes[1]->mSuccessors[0]->mTask, &fourth);
+
+                // A task that conflicts with everything is colored first and the rest share the next color
+                ResourceTask hub({ 0, 1, 2 }, { });
+                CTaskGraph star;
+                star.build(Support::Vector<SThreadSystem::IThreadedTask*>({ &readerOne, &first, &third, &hub }));
+                EXPECT_EQ(star.getColorCount(), 2);
+                EXPECT_EQ(star.getEdgeCount(), 3);
+                EXPECT_EQ(star.getNodes()[0]->mTask, &hub);
+            }
+
+            TEST(CTaskGraph, Execution)
+            {
+                CJobSystem jobs(4);
+
+                Support::Vector<ResourceTask*> tasks;
+                for (Common::U32 iteration = 0; iteration < 32; ++iteration)
+                {
+                    tasks.push_back(new ResourceTask({ iteration % 4 }, { (iteration + 1) % 4 }));
+                }
+
+                CTaskGraph graph;
+                graph.build(Support::Vector<SThreadSystem::IThreadedTask*>(tasks.begin(), tasks.end()));
+
+                for (Common::U32 iteration = 0; iteration < 8; ++iteration)
+                {
+                    CJobSystem::CJobCounter counter;
+                    graph.execute(jobs, counter);
+                    jobs.wait(counter);
+                    graph.commit();
+                }
+
+                EXPECT_FALSE(ObservedConflict);
+
+                for (ResourceTask* task : tasks)
+                {
+                    EXPECT_EQ(task->mTickCount, 8);
+                    delete task;
+                }
+            }
+
+            TEST(CTaskGraph, Priorities)
+            {
+                // Without measurements the declared weight is the estimate
+                WeightedTask light(1);
+                WeightedTask heavy(50);
+                WeightedTask medium(10);
+                EXPECT_EQ(heavy.getEstimatedCost(), 50.0f);
+
+                CTaskGraph graph;
+                graph.build(Support::Vector<SThreadSystem::IThreadedTask*>({ &light, &heavy, &medium }));
+
+                // Without workers the waiting thread takes the roots in submission order, which must be heaviest first
+                CJobSystem jobs(0);
+                CJobSystem::CJobCounter counter;
+                graph.execute(jobs, counter);
+                jobs.wait(counter);
+
+                ASSERT_EQ(StartOrder.size(), 3);
+                EXPECT_EQ(StartOrder[0], 50);
+                EXPECT_EQ(StartOrder[1], 10);
+                EXPECT_EQ(StartOrder[2], 1);
+
+                // Executing measured every task, and measurements replace the declared weight
+                EXPECT_GT(light.getSmoothedExecutionTime(), 0.0f);
+
+                WeightedTask measured(1000);
+                measured.recordExecutionTime(100.0f);
+                EXPECT_EQ(measured.getEstimatedCost(), 100.0f);
+                measured.recordExecutionTime(200.0f);
+                EXPECT_GT(measured.getSmoothedExecutionTime(), 100.0f);
+                EXPECT_LT(measured.getSmoothedExecutionTime(), 200.0f);
+            }
+        } // End NameSpace Tasking
+    } // End Namespace Support
+} // End namespace Kiaro
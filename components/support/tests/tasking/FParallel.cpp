@@ -0,0 +1,104 @@
+/**
+ *  @file FParallel.cpp
+ *  @brief Source file containing coding for the FParallel tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <gtest/gtest.h>
+
+#include <support/String.hpp>
+#include <support/tasking/FParallel.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            TEST(FParallel, ParallelFor)
+            {
+                CJobSystem jobs(4);
+
+                // Every index is visited exactly once
+                Support::Vector<Common::U32> visits(10007, 0);
+                FParallel::parallelFor(jobs, 0, visits.size(), [&visits](const size_t index)
+                {
+                    ++visits[index];
+                });
+
+                for (const Common::U32 visitCount : visits)
+                {
+                    EXPECT_EQ(visitCount, 1);
+                }
+
+                // Arrays are visited by reference
+                Common::U32 elements[100] = { };
+                FParallel::parallelForEach(jobs, elements, 100, [](Common::U32& element)
+                {
+                    element = 7;
+                }, 3);
+
+                for (const Common::U32 element : elements)
+                {
+                    EXPECT_EQ(element, 7);
+                }
+
+                // Loops may nest, with the inner loop running from within a job
+                Support::Atomic<Common::U32> nestedVisits(0);
+                FParallel::parallelFor(jobs, 0, 16, [&jobs, &nestedVisits](const size_t index)
+                {
+                    FParallel::parallelFor(jobs, 0, 64, [&nestedVisits](const size_t nestedIndex)
+                    {
+                        ++nestedVisits;
+                    });
+                }, 1);
+                EXPECT_EQ(nestedVisits.load(), 16 * 64);
+
+                // Exceptions reach the caller
+                EXPECT_THROW(FParallel::parallelFor(jobs, 0, 1000, [](const size_t index)
+                {
+                    if (index == 500)
+                    {
+                        throw std::out_of_range("Index");
+                    }
+                }), std::out_of_range);
+            }
+
+            TEST(FParallel, ParallelReduce)
+            {
+                CJobSystem jobs(4);
+
+                const Common::U64 sum = FParallel::parallelReduce(jobs, 1, 100001, Common::U64(0), [](const size_t index)
+                {
+                    return Common::U64(index);
+                }, [](const Common::U64 first, const Common::U64 second)
+                {
+                    return first + second;
+                });
+                EXPECT_EQ(sum, 5000050000ULL);
+
+                // Chunks are combined in order, so operations that are not commutative still work
+                const Support::String digits = FParallel::parallelReduce(jobs, 0, 1000, Support::String(), [](const size_t index)
+                {
+                    return Support::String(1, static_cast<char>('0' + index % 10));
+                }, [](const Support::String& first, const Support::String& second)
+                {
+                    return first + second;
+                }, 7);
+
+                ASSERT_EQ(digits.size(), 1000);
+                for (size_t index = 0; index < digits.size(); ++index)
+                {
+                    EXPECT_EQ(digits[index], static_cast<char>('0' + index % 10));
+                }
+
+                EXPECT_EQ(FParallel::parallelReduce(jobs, 5, 5, 42, [](const size_t index) { return 0; }, [](const int first, const int second) { return first + second; }), 42);
+            }
+        } // End NameSpace Tasking
+    } // End Namespace Support
+} // End namespace Kiaro
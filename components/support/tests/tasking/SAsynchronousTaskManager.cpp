@@ -0,0 +1,385 @@
+/**
+ *  @file SAsynchronousTaskManager.cpp
+ *  @brief Source file containing coding for the SAsynchronousTaskManager tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <support/SSettingsRegistry.hpp>
+#include <support/tasking/SAsynchronousTaskManager.hpp>
+
+namespace Kiaro
+{
+    namespace Support
+    {
+        namespace Tasking
+        {
+            //! A task that never completes on its own.
+            class EndlessTask : public ITask
+            {
+                public:
+                    Support::Atomic<Common::U32> mTickCount;
+
+                    EndlessTask(void) : mTickCount(0)
+                    {
+
+                    }
+
+                    void initialize(void)
+                    {
+
+                    }
+
+                    void deinitialize(void)
+                    {
+
+                    }
+
+                    bool tick(const Common::F32 deltaTimeSeconds)
+                    {
+                        ++mTickCount;
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                        return false;
+                    }
+            };
+
+            //! A task whose only tick runs until the stop token of its manager is cancelled.
+            class CooperativeTask : public ITask
+            {
+                public:
+                    Support::Atomic<bool> mStarted;
+
+                    CooperativeTask(void) : mStarted(false)
+                    {
+
+                    }
+
+                    void initialize(void)
+                    {
+
+                    }
+
+                    void deinitialize(void)
+                    {
+
+                    }
+
+                    bool tick(const Common::F32 deltaTimeSeconds)
+                    {
+                        mStarted = true;
+
+                        const CCancellationToken& token = SAsynchronousTaskManager::getPointer()->getStopToken();
+                        while (!token.isCancelled())
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                        }
+
+                        return true;
+                    }
+            };
+
+            //! A task recording the delta time of each of its ticks.
+            class TimedTask : public ITask
+            {
+                public:
+                    Support::Vector<Common::F32> mDeltas;
+
+                    Support::Atomic<bool> mCompleted;
+
+                    TimedTask(void) : mCompleted(false)
+                    {
+
+                    }
+
+                    void initialize(void)
+                    {
+
+                    }
+
+                    void deinitialize(void)
+                    {
+
+                    }
+
+                    bool tick(const Common::F32 deltaTimeSeconds)
+                    {
+                        mDeltas.push_back(deltaTimeSeconds);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+                        mCompleted = mDeltas.size() == 3;
+                        return mCompleted;
+                    }
+            };
+
+            //! Ticks the manager until the given future has completed.
+            template <typename valueType>
+            static void tickUntilReady(SAsynchronousTaskManager* manager, const CFuture<valueType>& future)
+            {
+                while (!future.isReady())
+                {
+                    manager->tick();
+                    std::this_thread::yield();
+                }
+            }
+
+            TEST(SAsynchronousTaskManager, Continuations)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 4);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                const std::thread::id mainThread = std::this_thread::get_id();
+                Support::Atomic<bool> ranOnWorker(false);
+                Support::Atomic<bool> ranOnMainThread(false);
+
+                CFuture<Common::U32> future = manager->run([]() { return 21u; }).then([&ranOnWorker, mainThread](const Common::U32 value)
+                {
+                    ranOnWorker = std::this_thread::get_id() != mainThread;
+                    return value * 2;
+                }, EXECUTION_WORKER).then([&ranOnMainThread, mainThread](const Common::U32 value)
+                {
+                    ranOnMainThread = std::this_thread::get_id() == mainThread;
+                    return value + 1;
+                });
+
+                tickUntilReady(manager, future);
+                EXPECT_EQ(future.getStatus(), FUTURE_FULFILLED);
+                EXPECT_EQ(future.get(), 43);
+                EXPECT_TRUE(ranOnWorker);
+                EXPECT_TRUE(ranOnMainThread);
+
+                // Failures skip continuations and are rethrown by get
+                bool calledContinuation = false;
+                CFuture<void> failed = manager->run([]() -> Common::U32 { throw std::logic_error("Failed"); }).then([&calledContinuation](const Common::U32 value)
+                {
+                    calledContinuation = true;
+                });
+
+                tickUntilReady(manager, failed);
+                EXPECT_EQ(failed.getStatus(), FUTURE_FAILED);
+                EXPECT_THROW(failed.get(), std::logic_error);
+                EXPECT_FALSE(calledContinuation);
+
+                SAsynchronousTaskManager::destroy();
+            }
+
+            TEST(SAsynchronousTaskManager, MoveOnlyValues)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 2);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                CFuture<std::unique_ptr<Common::U32>> future = manager->run([]() { return std::unique_ptr<Common::U32>(new Common::U32(7)); });
+                tickUntilReady(manager, future);
+
+                // The value is returned by reference, so it can be moved out
+                std::unique_ptr<Common::U32> value = std::move(future.get());
+                ASSERT_TRUE(value != nullptr);
+                EXPECT_EQ(*value, 7);
+                EXPECT_EQ(future.get(), nullptr);
+
+                // Futures without a promise throw rather than touching state they do not have
+                CFuture<std::unique_ptr<Common::U32>> moved = std::move(future);
+                EXPECT_FALSE(future.isValid());
+                EXPECT_THROW(future.get(), std::future_error);
+                EXPECT_THROW(CFuture<void>().get(), std::future_error);
+                EXPECT_EQ(moved.get(), nullptr);
+
+                SAsynchronousTaskManager::destroy();
+            }
+
+            TEST(SAsynchronousTaskManager, DestroyWithQueuedTasks)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 1);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                // Keep the only worker busy until the manager is destroyed, so the work below never runs
+                CooperativeTask* task = new CooperativeTask();
+                EXPECT_TRUE(manager->addTask(task));
+
+                while (!task->mStarted)
+                {
+                    std::this_thread::yield();
+                }
+
+                bool ran = false;
+                CFuture<Common::U32> queued = manager->run([&ran]() { ran = true; return 1u; });
+                CFuture<void> chained = manager->run([&ran]() { ran = true; }).then([&ran]() { ran = true; });
+
+                SAsynchronousTaskManager::destroy();
+
+                // Nobody waits forever on work that was thrown away
+                EXPECT_TRUE(queued.wait(5000));
+                EXPECT_EQ(queued.getStatus(), FUTURE_FAILED);
+                EXPECT_THROW(queued.get(), std::runtime_error);
+
+                EXPECT_TRUE(chained.wait(5000));
+                EXPECT_EQ(chained.getStatus(), FUTURE_FAILED);
+                EXPECT_FALSE(ran);
+
+                // The same goes for a promise destroyed by anything else
+                CFuture<Common::U32> abandoned;
+                {
+                    CPromise<Common::U32> promise;
+                    abandoned = promise.getFuture();
+                }
+
+                EXPECT_EQ(abandoned.getStatus(), FUTURE_FAILED);
+            }
+
+            TEST(SAsynchronousTaskManager, Cancellation)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 2);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                // Work cancelled before a worker picks it up never runs
+                CCancellationToken token;
+                token.cancel();
+
+                bool ran = false;
+                CFuture<void> skipped = manager->run([&ran]() { ran = true; }, token);
+                tickUntilReady(manager, skipped);
+                EXPECT_EQ(skipped.getStatus(), FUTURE_CANCELLED);
+                EXPECT_THROW(skipped.get(), std::runtime_error);
+                EXPECT_FALSE(ran);
+
+                // Cancelling a chained future completes it immediately and signals the producer through the shared token
+                CPromise<Common::U32> promise;
+                CFuture<Common::U32> chained = promise.getFuture().then([](const Common::U32 value) { return value; }, EXECUTION_INLINE);
+                chained.cancel();
+                EXPECT_EQ(chained.getStatus(), FUTURE_CANCELLED);
+                EXPECT_TRUE(promise.isCancellationRequested());
+
+                // A value produced anyway does not revive the chain
+                EXPECT_TRUE(promise.setValue(5u));
+                EXPECT_EQ(chained.getStatus(), FUTURE_CANCELLED);
+                EXPECT_FALSE(promise.cancel());
+
+                SAsynchronousTaskManager::destroy();
+            }
+
+            TEST(SAsynchronousTaskManager, ConcurrentSubmission)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 4);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                Support::Atomic<Common::U32> executed(0);
+                Support::Vector<std::thread> submitters;
+                Support::Vector<CFuture<void>> futures[4];
+
+                for (Common::U32 iteration = 0; iteration < 4; ++iteration)
+                {
+                    submitters.push_back(std::thread([manager, &executed, &futures, iteration]()
+                    {
+                        for (Common::U32 submission = 0; submission < 250; ++submission)
+                        {
+                            futures[iteration].push_back(manager->run([&executed]() { ++executed; }));
+                        }
+                    }));
+                }
+
+                for (std::thread& submitter : submitters)
+                {
+                    submitter.join();
+                }
+
+                for (Support::Vector<CFuture<void>>& submitted : futures)
+                {
+                    for (CFuture<void>& future : submitted)
+                    {
+                        future.wait();
+                    }
+                }
+
+                EXPECT_EQ(executed.load(), 1000);
+
+                // Completed tasks are deleted on the main thread
+                manager->tick();
+                SAsynchronousTaskManager::destroy();
+            }
+
+            TEST(SAsynchronousTaskManager, RemoveRunningTask)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 1);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                EndlessTask* task = new EndlessTask();
+                EXPECT_TRUE(manager->addTask(task));
+
+                while (task->mTickCount == 0)
+                {
+                    std::this_thread::yield();
+                }
+
+                // Once removed, the worker no longer touches the task and it is ours to delete
+                EXPECT_TRUE(manager->removeTask(task));
+                const Common::U32 tickCount = task->mTickCount;
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                EXPECT_EQ(task->mTickCount, tickCount);
+                EXPECT_FALSE(manager->removeTask(task));
+                EXPECT_EQ(manager->getIdleWorkerCount(), 1);
+                delete task;
+
+                SAsynchronousTaskManager::destroy();
+            }
+
+            TEST(SAsynchronousTaskManager, TickDelta)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 1);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                TimedTask* task = new TimedTask();
+                EXPECT_TRUE(manager->addTask(task));
+
+                while (!task->mCompleted)
+                {
+                    std::this_thread::yield();
+                }
+
+                // Every tick after the first is given the real time since the previous one
+                ASSERT_EQ(task->mDeltas.size(), 3);
+                EXPECT_GE(task->mDeltas[1], 0.002f);
+                EXPECT_GE(task->mDeltas[2], 0.002f);
+
+                SAsynchronousTaskManager::destroy();
+            }
+
+            TEST(SAsynchronousTaskManager, BoundedShutdown)
+            {
+                Support::SSettingsRegistry::getInstance()->setValue<Common::U8>("System::WorkerThreadCount", 1);
+                SAsynchronousTaskManager* manager = SAsynchronousTaskManager::getInstance();
+
+                CooperativeTask* task = new CooperativeTask();
+                EXPECT_TRUE(manager->addTask(task));
+
+                while (!task->mStarted)
+                {
+                    std::this_thread::yield();
+                }
+
+                // Draining cannot finish while the task runs, so the join times out and escalates to a cooperative stop
+                EXPECT_FALSE(manager->shutdown(true, 20));
+                EXPECT_EQ(manager->getState(), POOL_STOPPING);
+                EXPECT_TRUE(manager->getStopToken().isCancelled());
+
+                EXPECT_TRUE(manager->join(5000));
+                EXPECT_EQ(manager->getState(), POOL_STOPPED);
+                EXPECT_EQ(manager->getRunningWorkerCount(), 0);
+
+                // Once stopped, new tasks are handed to the synchronous task manager instead
+                EndlessTask* lateTask = new EndlessTask();
+                EXPECT_FALSE(manager->addTask(lateTask));
+                EXPECT_TRUE(manager->removeTask(lateTask));
+                delete lateTask;
+
+                SAsynchronousTaskManager::destroy();
+            }
+        } // End NameSpace Tasking
+    } // End Namespace Support
+} // End namespace Kiaro
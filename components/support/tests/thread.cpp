@@ -0,0 +1,133 @@
+/**
+ *  @file thread.cpp
+ *  @brief Source file containing coding for the thread placement tests.
+ *
+ *  This software is licensed under the Draconic Free License version 1. Please refer
+ *  to LICENSE.txt for more information.
+ *
+ *  @author Robert MacGregor
+ *  @copyright (c) 2016 Draconic Entity
+ */
+
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#include <support/common.hpp>
+#include <support/platform/thread.hpp>
+
+namespace Kiaro
+{
+    namespace Platform
+    {
+        /**
+         *  @brief Builds a topology of two nodes with two hyperthreaded cores each, numbered the way Linux commonly does:
+         *  the first logical core of every physical core comes first and their siblings follow.
+         */
+        static Thread::ProcessorTopology createTopology(void)
+        {
+            Thread::ProcessorTopology result;
+
+            for (Common::U32 coreID = 0; coreID < 8; ++coreID)
+            {
+                Thread::ProcessorCore core;
+                core.mID = coreID;
+                core.mPhysicalCore = coreID % 4;
+                core.mNode = (coreID % 4) / 2;
+                result.mCores.push_back(core);
+            }
+
+            result.mPhysicalCoreCount = 4;
+            result.mNodeCount = 2;
+            return result;
+        }
+
+        TEST(Platform, ThreadDetectTopology)
+        {
+            const Thread::ProcessorTopology& topology = Thread::getProcessorTopology();
+
+            ASSERT_FALSE(topology.mCores.empty());
+            EXPECT_GE(topology.mPhysicalCoreCount, 1);
+            EXPECT_LE(topology.mPhysicalCoreCount, topology.mCores.size());
+            EXPECT_GE(topology.mNodeCount, 1);
+
+            for (const Thread::ProcessorCore& core : topology.mCores)
+            {
+                EXPECT_LT(core.mPhysicalCore, topology.mPhysicalCoreCount);
+                EXPECT_LT(core.mNode, topology.mNodeCount);
+            }
+
+            // Resetting the affinity to every core is always allowed
+            EXPECT_TRUE(Thread::setCurrentThreadAffinity(Support::Vector<Common::U32>()));
+        }
+
+        TEST(Platform, ThreadPlacement)
+        {
+            const Thread::ProcessorTopology topology = createTopology();
+
+            EXPECT_TRUE(Thread::getPlacementCores(topology, Thread::AFFINITY_NONE, 0, false).empty());
+
+            // Every physical core is used once before any sibling, with neighbouring slots sharing a node
+            const Common::U32 expectedCores[] = { 0, 1, 2, 3, 4, 5, 6, 7, 0 };
+            for (Common::U32 slot = 0; slot < 9; ++slot)
+            {
+                const Support::Vector<Common::U32> cores = Thread::getPlacementCores(topology, Thread::AFFINITY_CORE, slot, false);
+                ASSERT_EQ(cores.size(), 1);
+                EXPECT_EQ(cores[0], expectedCores[slot]);
+            }
+
+            // Placing from the end starts at the siblings of the last node
+            EXPECT_EQ(Thread::getPlacementCores(topology, Thread::AFFINITY_CORE, 0, true)[0], 7);
+            EXPECT_EQ(Thread::getPlacementCores(topology, Thread::AFFINITY_CORE, 1, true)[0], 6);
+
+            const Support::Vector<Common::U32> firstNode = Thread::getPlacementCores(topology, Thread::AFFINITY_NODE, 0, false);
+            const Support::Vector<Common::U32> expectedFirstNode = { 0, 1, 4, 5 };
+            EXPECT_EQ(firstNode, expectedFirstNode);
+
+            const Support::Vector<Common::U32> lastNode = Thread::getPlacementCores(topology, Thread::AFFINITY_NODE, 0, true);
+            const Support::Vector<Common::U32> expectedLastNode = { 2, 3, 6, 7 };
+            EXPECT_EQ(lastNode, expectedLastNode);
+
+            EXPECT_EQ(Thread::getPlacementCores(topology, Thread::AFFINITY_NODE, 2, false), expectedFirstNode);
+        }
+
+        #if defined(__linux__)
+            TEST(Platform, ThreadPlacementReset)
+            {
+                // Everything the process may run on, as the test runner does not pin its main thread
+                cpu_set_t allowedSet;
+                pthread_getaffinity_np(pthread_self(), sizeof(allowedSet), &allowedSet);
+
+                size_t inheritedCount = 0;
+                size_t resetCount = 0;
+
+                // A thread started by a pinned thread inherits its pinning until it is placed without affinity
+                Support::Thread pinned([&inheritedCount, &resetCount]()
+                {
+                    Thread::placeCurrentThread("Pinned", Thread::AFFINITY_CORE, 0, false, Thread::PRIORITY_NORMAL);
+
+                    Support::Thread child([&inheritedCount, &resetCount]()
+                    {
+                        cpu_set_t coreSet;
+                        pthread_getaffinity_np(pthread_self(), sizeof(coreSet), &coreSet);
+                        inheritedCount = CPU_COUNT(&coreSet);
+
+                        Thread::placeCurrentThread("Child", Thread::AFFINITY_NONE, 0, false, Thread::PRIORITY_NORMAL);
+                        pthread_getaffinity_np(pthread_self(), sizeof(coreSet), &coreSet);
+                        resetCount = CPU_COUNT(&coreSet);
+                    });
+
+                    child.join();
+                });
+
+                pinned.join();
+
+                EXPECT_EQ(inheritedCount, 1);
+                EXPECT_EQ(resetCount, CPU_COUNT(&allowedSet));
+            }
+        #endif // __linux__
+    } // End NameSpace Platform
+} // End NameSpace Kiaro